@@ -1,8 +1,29 @@
+use concrete_cpu::c_api::bootstrap::{
+    concrete_cpu_bootstrap_key_convert_u64_to_fourier,
+    concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch, concrete_cpu_bootstrap_key_size_u64,
+    concrete_cpu_bootstrap_lwe_ciphertext_u64, concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch,
+    concrete_cpu_fourier_bootstrap_key_size_u64,
+    concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64,
+    concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier,
+    concrete_cpu_multi_bit_bootstrap_key_size_u64,
+    concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64,
+};
+use concrete_cpu::c_api::fft::{
+    concrete_cpu_construct_concrete_fft, concrete_cpu_destroy_concrete_fft, Fft,
+    CONCRETE_FFT_ALIGN, CONCRETE_FFT_SIZE,
+};
+use concrete_cpu::c_api::keyswitch::{
+    concrete_cpu_batched_keyswitch_lwe_ciphertext_u64, concrete_cpu_keyswitch_key_size_u64,
+    concrete_cpu_keyswitch_lwe_ciphertext_u64,
+};
 use concrete_cpu::c_api::linear_op::{
     concrete_cpu_add_lwe_ciphertext_u64, concrete_cpu_add_plaintext_lwe_ciphertext_u64,
     concrete_cpu_mul_cleartext_lwe_ciphertext_u64, concrete_cpu_negate_lwe_ciphertext_u64,
 };
-use criterion::{criterion_group, criterion_main, Criterion};
+use concrete_cpu::c_api::types::{Parallelism, ScratchStatus};
+use concrete_fft::c64;
+use criterion::{criterion_group, criterion_main, Criterion, Throughput};
+use std::alloc::{alloc, dealloc, Layout};
 
 pub fn criterion_benchmark(c: &mut Criterion) {
     for lwe_dimension in [128, 256, 512] {
@@ -63,5 +84,237 @@ pub fn criterion_benchmark(c: &mut Criterion) {
     }
 }
 
-criterion_group!(benches, criterion_benchmark);
+// Bootstrap parameters of a 4 bits lookup table, the input lwe dimension being a multiple of all the
+// benchmarked grouping factors
+const DECOMPOSITION_LEVEL_COUNT: usize = 1;
+const DECOMPOSITION_BASE_LOG: usize = 23;
+const GLWE_DIMENSION: usize = 1;
+const POLYNOMIAL_SIZE: usize = 2048;
+const INPUT_LWE_DIMENSION: usize = 744;
+
+pub fn bootstrap_benchmark(c: &mut Criterion) {
+    let output_lwe_dimension = GLWE_DIMENSION * POLYNOMIAL_SIZE;
+    let ct_in = vec![0_u64; INPUT_LWE_DIMENSION + 1];
+    let accumulator = vec![0_u64; (GLWE_DIMENSION + 1) * POLYNOMIAL_SIZE];
+
+    c.bench_function(
+        &format!("bootstrap-lwe-ciphertext-u64-{INPUT_LWE_DIMENSION}"),
+        |b| unsafe {
+            let fft_layout =
+                Layout::from_size_align(CONCRETE_FFT_SIZE, CONCRETE_FFT_ALIGN).unwrap();
+            let fft = alloc(fft_layout) as *mut Fft;
+            concrete_cpu_construct_concrete_fft(fft, POLYNOMIAL_SIZE);
+
+            let standard_bsk = vec![
+                0_u64;
+                concrete_cpu_bootstrap_key_size_u64(
+                    DECOMPOSITION_LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                )
+            ];
+            let mut fourier_bsk = vec![
+                c64::default();
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    DECOMPOSITION_LEVEL_COUNT,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                )
+            ];
+
+            let mut stack_size = 0;
+            let mut stack_align = 0;
+            assert!(matches!(
+                concrete_cpu_bootstrap_key_convert_u64_to_fourier_scratch(
+                    &mut stack_size,
+                    &mut stack_align,
+                    fft,
+                ),
+                ScratchStatus::Valid
+            ));
+            let stack_layout = Layout::from_size_align(stack_size, stack_align).unwrap();
+            let stack = alloc(stack_layout);
+            concrete_cpu_bootstrap_key_convert_u64_to_fourier(
+                standard_bsk.as_ptr(),
+                fourier_bsk.as_mut_ptr(),
+                DECOMPOSITION_LEVEL_COUNT,
+                DECOMPOSITION_BASE_LOG,
+                GLWE_DIMENSION,
+                POLYNOMIAL_SIZE,
+                INPUT_LWE_DIMENSION,
+                fft,
+                stack,
+                stack_size,
+            );
+            dealloc(stack, stack_layout);
+
+            assert!(matches!(
+                concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+                    &mut stack_size,
+                    &mut stack_align,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    fft,
+                ),
+                ScratchStatus::Valid
+            ));
+            let stack_layout = Layout::from_size_align(stack_size, stack_align).unwrap();
+            let stack = alloc(stack_layout);
+
+            let mut ct_out = vec![0_u64; output_lwe_dimension + 1];
+            b.iter(|| {
+                concrete_cpu_bootstrap_lwe_ciphertext_u64(
+                    ct_out.as_mut_ptr(),
+                    ct_in.as_ptr(),
+                    accumulator.as_ptr(),
+                    fourier_bsk.as_ptr(),
+                    DECOMPOSITION_LEVEL_COUNT,
+                    DECOMPOSITION_BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    fft,
+                    stack,
+                    stack_size,
+                );
+            });
+
+            dealloc(stack, stack_layout);
+            concrete_cpu_destroy_concrete_fft(fft);
+            dealloc(fft as *mut u8, fft_layout);
+        },
+    );
+
+    let thread_count = std::thread::available_parallelism().map_or(1, |n| n.get());
+
+    for grouping_factor in [2, 3] {
+        c.bench_function(
+            &format!(
+                "multi-bit-bootstrap-lwe-ciphertext-u64-{INPUT_LWE_DIMENSION}-{grouping_factor}"
+            ),
+            |b| unsafe {
+                let standard_bsk = vec![
+                    0_u64;
+                    concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                        DECOMPOSITION_LEVEL_COUNT,
+                        GLWE_DIMENSION,
+                        POLYNOMIAL_SIZE,
+                        INPUT_LWE_DIMENSION,
+                        grouping_factor,
+                    )
+                ];
+                let mut fourier_bsk = vec![
+                    c64::default();
+                    concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                        DECOMPOSITION_LEVEL_COUNT,
+                        GLWE_DIMENSION,
+                        POLYNOMIAL_SIZE,
+                        INPUT_LWE_DIMENSION,
+                        grouping_factor,
+                    )
+                ];
+                concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(
+                    standard_bsk.as_ptr(),
+                    fourier_bsk.as_mut_ptr(),
+                    DECOMPOSITION_LEVEL_COUNT,
+                    DECOMPOSITION_BASE_LOG,
+                    GLWE_DIMENSION,
+                    POLYNOMIAL_SIZE,
+                    INPUT_LWE_DIMENSION,
+                    grouping_factor,
+                    Parallelism::Rayon,
+                );
+
+                let mut ct_out = vec![0_u64; output_lwe_dimension + 1];
+                b.iter(|| {
+                    concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+                        ct_out.as_mut_ptr(),
+                        ct_in.as_ptr(),
+                        accumulator.as_ptr(),
+                        fourier_bsk.as_ptr(),
+                        DECOMPOSITION_LEVEL_COUNT,
+                        DECOMPOSITION_BASE_LOG,
+                        GLWE_DIMENSION,
+                        POLYNOMIAL_SIZE,
+                        INPUT_LWE_DIMENSION,
+                        grouping_factor,
+                        thread_count,
+                    );
+                });
+            },
+        );
+    }
+}
+
+// Keyswitch parameters of a 4 bits lookup table
+const KEYSWITCH_DECOMPOSITION_LEVEL_COUNT: usize = 5;
+const KEYSWITCH_DECOMPOSITION_BASE_LOG: usize = 3;
+const KEYSWITCH_INPUT_LWE_DIMENSION: usize = 2048;
+const KEYSWITCH_OUTPUT_LWE_DIMENSION: usize = 744;
+
+pub fn keyswitch_benchmark(c: &mut Criterion) {
+    let input_size = KEYSWITCH_INPUT_LWE_DIMENSION + 1;
+    let output_size = KEYSWITCH_OUTPUT_LWE_DIMENSION + 1;
+    let keyswitch_key = vec![
+        0_u64;
+        unsafe {
+            concrete_cpu_keyswitch_key_size_u64(
+                KEYSWITCH_DECOMPOSITION_LEVEL_COUNT,
+                KEYSWITCH_INPUT_LWE_DIMENSION,
+                KEYSWITCH_OUTPUT_LWE_DIMENSION,
+            )
+        }
+    ];
+
+    let mut group = c.benchmark_group("keyswitch-lwe-ciphertext-u64");
+    for ciphertext_count in [1, 16, 64] {
+        let ct_in = vec![0_u64; ciphertext_count * input_size];
+        let mut ct_out = vec![0_u64; ciphertext_count * output_size];
+        group.throughput(Throughput::Elements(ciphertext_count as u64));
+
+        group.bench_function(format!("loop-{ciphertext_count}"), |b| {
+            b.iter(|| unsafe {
+                for (out, input) in ct_out
+                    .chunks_exact_mut(output_size)
+                    .zip(ct_in.chunks_exact(input_size))
+                {
+                    concrete_cpu_keyswitch_lwe_ciphertext_u64(
+                        out.as_mut_ptr(),
+                        input.as_ptr(),
+                        keyswitch_key.as_ptr(),
+                        KEYSWITCH_DECOMPOSITION_LEVEL_COUNT,
+                        KEYSWITCH_DECOMPOSITION_BASE_LOG,
+                        KEYSWITCH_INPUT_LWE_DIMENSION,
+                        KEYSWITCH_OUTPUT_LWE_DIMENSION,
+                    );
+                }
+            });
+        });
+
+        group.bench_function(format!("batched-{ciphertext_count}"), |b| {
+            b.iter(|| unsafe {
+                concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+                    ct_out.as_mut_ptr(),
+                    ct_in.as_ptr(),
+                    keyswitch_key.as_ptr(),
+                    KEYSWITCH_DECOMPOSITION_LEVEL_COUNT,
+                    KEYSWITCH_DECOMPOSITION_BASE_LOG,
+                    KEYSWITCH_INPUT_LWE_DIMENSION,
+                    KEYSWITCH_OUTPUT_LWE_DIMENSION,
+                    ciphertext_count,
+                );
+            });
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    criterion_benchmark,
+    bootstrap_benchmark,
+    keyswitch_benchmark
+);
 criterion_main!(benches);
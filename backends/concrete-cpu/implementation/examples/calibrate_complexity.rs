@@ -0,0 +1,288 @@
+//! Calibrates the complexity model of the concrete-optimizer on this host.
+//!
+//! Measures the levelled addition, the keyswitch and the bootstrap of concrete-cpu over a grid of
+//! parameters, and writes their timings to the model file given as argument, which is read back by
+//! the optimizer with `--optimizer-complexity-model`. The bootstrap is only measured for a small
+//! input lwe dimension, the calibration fails if its timings do not grow linearly with it:
+//! ```text
+//! cargo run --release --example calibrate_complexity -- complexity_model.txt
+//! ```
+use concrete_cpu::c_api::bootstrap::{
+    concrete_cpu_bootstrap_lwe_ciphertext_u64, concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch,
+    concrete_cpu_fourier_bootstrap_key_size_u64,
+};
+use concrete_cpu::c_api::fft::{
+    concrete_cpu_construct_concrete_fft, concrete_cpu_destroy_concrete_fft, Fft,
+    CONCRETE_FFT_ALIGN, CONCRETE_FFT_SIZE,
+};
+use concrete_cpu::c_api::keyswitch::{
+    concrete_cpu_keyswitch_key_size_u64, concrete_cpu_keyswitch_lwe_ciphertext_u64,
+};
+use concrete_cpu::c_api::linear_op::concrete_cpu_add_lwe_ciphertext_u64;
+use concrete_cpu::c_api::types::ScratchStatus;
+use concrete_fft::c64;
+use std::alloc::{alloc, dealloc, Layout};
+use std::fmt::Write;
+use std::hint::black_box;
+use std::time::{Duration, Instant};
+
+const LEVELLED_LWE_DIMENSIONS: [usize; 3] = [512, 1024, 2048];
+
+// The largest keyswitch keys do not fit in the caches, exposing the memory-bound regime
+const KEYSWITCH_INPUT_LWE_DIMENSIONS: [usize; 3] = [1024, 2048, 4096];
+const KEYSWITCH_OUTPUT_LWE_DIMENSIONS: [usize; 2] = [512, 1024];
+const KEYSWITCH_LEVELS: [usize; 3] = [1, 3, 6];
+
+// The bootstrap cost is linear in its input lwe dimension, a small one keeps the grid fast
+const BOOTSTRAP_INPUT_LWE_DIMENSION: usize = 128;
+// Bounds of the ratio of the bootstrap timings for twice the input lwe dimension, checked before
+// the grid is measured
+const BOOTSTRAP_LINEARITY_RATIO: (f64, f64) = (1.6, 2.4);
+// (glwe dimension, log2 of the polynomial size)
+const BOOTSTRAP_GLWE_PARAMETERS: [(usize, usize); 7] =
+    [(1, 9), (1, 10), (1, 11), (1, 12), (1, 13), (2, 10), (2, 11)];
+const BOOTSTRAP_LEVELS: [usize; 3] = [1, 2, 4];
+
+// The timings do not depend on the decomposition base, as long as the decomposition fits in 64
+// bits
+const DECOMPOSITION_BASE_LOG: usize = 4;
+
+const SAMPLE_COUNT: usize = 5;
+const SAMPLE_DURATION: Duration = Duration::from_millis(20);
+
+/// Returns the duration in nanoseconds of one call to `f`, as the fastest of several samples
+/// lasting at least `SAMPLE_DURATION`.
+fn measure_ns(mut f: impl FnMut()) -> f64 {
+    // warm up, and find the number of iterations of a sample
+    let mut iterations = 1_u32;
+    loop {
+        let start = Instant::now();
+        for _ in 0..iterations {
+            f();
+        }
+        if start.elapsed() >= SAMPLE_DURATION {
+            break;
+        }
+        iterations *= 2;
+    }
+    (0..SAMPLE_COUNT)
+        .map(|_| {
+            let start = Instant::now();
+            for _ in 0..iterations {
+                f();
+            }
+            start.elapsed().as_nanos() as f64 / iterations as f64
+        })
+        .fold(f64::INFINITY, f64::min)
+}
+
+/// Returns `len` pseudo-random values, as drawn in the tests of concrete-cpu.
+fn random_vec(len: usize) -> Vec<u64> {
+    let mut state = 0x853c_49e6_748f_ea9b_u64;
+    (0..len)
+        .map(|_| {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            state
+        })
+        .collect()
+}
+
+fn levelled_ns(lwe_dimension: usize) -> f64 {
+    let mut ct_out = vec![0_u64; lwe_dimension + 1];
+    let ct_in0 = vec![0_u64; lwe_dimension + 1];
+    let ct_in1 = vec![0_u64; lwe_dimension + 1];
+    measure_ns(|| unsafe {
+        concrete_cpu_add_lwe_ciphertext_u64(
+            black_box(ct_out.as_mut_ptr()),
+            ct_in0.as_ptr(),
+            ct_in1.as_ptr(),
+            lwe_dimension,
+        );
+    })
+}
+
+fn keyswitch_ns(input_lwe_dimension: usize, output_lwe_dimension: usize, level: usize) -> f64 {
+    let keyswitch_key = vec![
+        0_u64;
+        unsafe {
+            concrete_cpu_keyswitch_key_size_u64(level, input_lwe_dimension, output_lwe_dimension)
+        }
+    ];
+    let ct_in = random_vec(input_lwe_dimension + 1);
+    let mut ct_out = vec![0_u64; output_lwe_dimension + 1];
+    measure_ns(|| unsafe {
+        concrete_cpu_keyswitch_lwe_ciphertext_u64(
+            black_box(ct_out.as_mut_ptr()),
+            ct_in.as_ptr(),
+            keyswitch_key.as_ptr(),
+            level,
+            DECOMPOSITION_BASE_LOG,
+            input_lwe_dimension,
+            output_lwe_dimension,
+        );
+    })
+}
+
+fn bootstrap_ns(
+    input_lwe_dimension: usize,
+    glwe_dimension: usize,
+    log2_polynomial_size: usize,
+    level: usize,
+) -> f64 {
+    let polynomial_size = 1 << log2_polynomial_size;
+    let output_lwe_dimension = glwe_dimension * polynomial_size;
+    unsafe {
+        let fft_layout = Layout::from_size_align(CONCRETE_FFT_SIZE, CONCRETE_FFT_ALIGN).unwrap();
+        let fft = alloc(fft_layout) as *mut Fft;
+        concrete_cpu_construct_concrete_fft(fft, polynomial_size);
+
+        // The timings do not depend on the content of the key
+        let fourier_bsk = vec![
+            c64::default();
+            concrete_cpu_fourier_bootstrap_key_size_u64(
+                level,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+            )
+        ];
+
+        let mut stack_size = 0;
+        let mut stack_align = 0;
+        assert!(matches!(
+            concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+                &mut stack_size,
+                &mut stack_align,
+                glwe_dimension,
+                polynomial_size,
+                fft,
+            ),
+            ScratchStatus::Valid
+        ));
+        let stack_layout = Layout::from_size_align(stack_size, stack_align).unwrap();
+        let stack = alloc(stack_layout);
+
+        // A zero mask element skips its cmux, the mask elements are random values in
+        // [2^62, 2^63), which are never switched to zero
+        let ct_in: Vec<u64> = random_vec(input_lwe_dimension + 1)
+            .into_iter()
+            .map(|value| (value >> 2) | (1 << 62))
+            .collect();
+        let accumulator = vec![0_u64; (glwe_dimension + 1) * polynomial_size];
+        let mut ct_out = vec![0_u64; output_lwe_dimension + 1];
+        let ns = measure_ns(|| {
+            concrete_cpu_bootstrap_lwe_ciphertext_u64(
+                black_box(ct_out.as_mut_ptr()),
+                ct_in.as_ptr(),
+                accumulator.as_ptr(),
+                fourier_bsk.as_ptr(),
+                level,
+                DECOMPOSITION_BASE_LOG,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+                fft,
+                stack,
+                stack_size,
+            );
+        });
+
+        dealloc(stack, stack_layout);
+        concrete_cpu_destroy_concrete_fft(fft);
+        dealloc(fft as *mut u8, fft_layout);
+        ns
+    }
+}
+
+fn main() {
+    let path = std::env::args()
+        .nth(1)
+        .unwrap_or_else(|| "complexity_model.txt".to_owned());
+
+    let mut model = String::new();
+    writeln!(
+        model,
+        "# concrete-optimizer complexity model calibrated by concrete-cpu"
+    )
+    .unwrap();
+    writeln!(model, "# levelled <lwe_dimension> <ns>").unwrap();
+    writeln!(
+        model,
+        "# keyswitch <input_lwe_dimension> <output_lwe_dimension> <level> <ns>"
+    )
+    .unwrap();
+    writeln!(
+        model,
+        "# pbs <internal_lwe_dimension> <glwe_dimension> <log2_polynomial_size> <level> <ns>"
+    )
+    .unwrap();
+
+    for lwe_dimension in LEVELLED_LWE_DIMENSIONS {
+        let ns = levelled_ns(lwe_dimension);
+        eprintln!("levelled lwe_dimension={lwe_dimension}: {ns:.1}ns");
+        writeln!(model, "levelled {lwe_dimension} {ns:.1}").unwrap();
+    }
+
+    for input_lwe_dimension in KEYSWITCH_INPUT_LWE_DIMENSIONS {
+        for output_lwe_dimension in KEYSWITCH_OUTPUT_LWE_DIMENSIONS {
+            for level in KEYSWITCH_LEVELS {
+                let ns = keyswitch_ns(input_lwe_dimension, output_lwe_dimension, level);
+                eprintln!(
+                    "keyswitch {input_lwe_dimension}->{output_lwe_dimension} level={level}: {ns:.1}ns"
+                );
+                writeln!(
+                    model,
+                    "keyswitch {input_lwe_dimension} {output_lwe_dimension} {level} {ns:.1}"
+                )
+                .unwrap();
+            }
+        }
+    }
+
+    // The model scales the bootstrap timings linearly with the input lwe dimension
+    let (glwe_dimension, log2_polynomial_size) = BOOTSTRAP_GLWE_PARAMETERS[0];
+    let ratio = bootstrap_ns(
+        2 * BOOTSTRAP_INPUT_LWE_DIMENSION,
+        glwe_dimension,
+        log2_polynomial_size,
+        1,
+    ) / bootstrap_ns(
+        BOOTSTRAP_INPUT_LWE_DIMENSION,
+        glwe_dimension,
+        log2_polynomial_size,
+        1,
+    );
+    eprintln!("pbs time ratio for twice the input lwe dimension: {ratio:.2}");
+    let (min_ratio, max_ratio) = BOOTSTRAP_LINEARITY_RATIO;
+    assert!(
+        (min_ratio..=max_ratio).contains(&ratio),
+        "the pbs time is not linear in the input lwe dimension (ratio {ratio:.2} for twice the \
+         dimension), the host is too noisy to be calibrated"
+    );
+
+    for (glwe_dimension, log2_polynomial_size) in BOOTSTRAP_GLWE_PARAMETERS {
+        for level in BOOTSTRAP_LEVELS {
+            let ns = bootstrap_ns(
+                BOOTSTRAP_INPUT_LWE_DIMENSION,
+                glwe_dimension,
+                log2_polynomial_size,
+                level,
+            );
+            eprintln!(
+                "pbs glwe_dimension={glwe_dimension} log2_polynomial_size={log2_polynomial_size} \
+                 level={level}: {ns:.1}ns"
+            );
+            writeln!(
+                model,
+                "pbs {BOOTSTRAP_INPUT_LWE_DIMENSION} {glwe_dimension} {log2_polynomial_size} \
+                 {level} {ns:.1}"
+            )
+            .unwrap();
+        }
+    }
+
+    std::fs::write(&path, model).unwrap_or_else(|err| panic!("cannot write {path}: {err}"));
+    eprintln!("complexity model written to {path}");
+}
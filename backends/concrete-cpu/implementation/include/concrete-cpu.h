@@ -80,6 +80,59 @@ void concrete_cpu_add_plaintext_lwe_ciphertext_u64(uint64_t *ct_out,
                                                    uint64_t plaintext,
                                                    size_t lwe_dimension);
 
+void concrete_cpu_batched_bootstrap_lwe_ciphertext_u32_to_u64(uint64_t *ct_out,
+                                                              const uint32_t *ct_in,
+                                                              const uint64_t *accumulator,
+                                                              const c64 *fourier_bsk,
+                                                              size_t decomposition_level_count,
+                                                              size_t decomposition_base_log,
+                                                              size_t glwe_dimension,
+                                                              size_t polynomial_size,
+                                                              size_t input_lwe_dimension,
+                                                              size_t ciphertext_count,
+                                                              const struct Fft *fft,
+                                                              uint8_t *stack,
+                                                              size_t stack_size);
+
+void concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                       const uint64_t *ct_in,
+                                                       const uint64_t *accumulator,
+                                                       const c64 *fourier_bsk,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t glwe_dimension,
+                                                       size_t polynomial_size,
+                                                       size_t input_lwe_dimension,
+                                                       size_t ciphertext_count,
+                                                       const struct Fft *fft,
+                                                       uint8_t *stack,
+                                                       size_t stack_size);
+
+ScratchStatus concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch(size_t *stack_size,
+                                                                        size_t *stack_align,
+                                                                        size_t glwe_dimension,
+                                                                        size_t polynomial_size,
+                                                                        size_t ciphertext_count,
+                                                                        const struct Fft *fft);
+
+void concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                       const uint64_t *ct_in,
+                                                       const uint64_t *keyswitch_key,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t input_dimension,
+                                                       size_t output_dimension,
+                                                       size_t ciphertext_count);
+
+void concrete_cpu_batched_keyswitch_lwe_ciphertext_u64_to_u32(uint32_t *ct_out,
+                                                              const uint64_t *ct_in,
+                                                              const uint64_t *keyswitch_key,
+                                                              size_t decomposition_level_count,
+                                                              size_t decomposition_base_log,
+                                                              size_t input_dimension,
+                                                              size_t output_dimension,
+                                                              size_t ciphertext_count);
+
 void concrete_cpu_bootstrap_key_convert_u64_to_fourier(const uint64_t *standard_bsk,
                                                        c64 *fourier_bsk,
                                                        size_t decomposition_level_count,
@@ -100,6 +153,19 @@ size_t concrete_cpu_bootstrap_key_size_u64(size_t decomposition_level_count,
                                            size_t polynomial_size,
                                            size_t input_lwe_dimension);
 
+void concrete_cpu_bootstrap_lwe_ciphertext_u32_to_u64(uint64_t *ct_out,
+                                                      const uint32_t *ct_in,
+                                                      const uint64_t *accumulator,
+                                                      const c64 *fourier_bsk,
+                                                      size_t decomposition_level_count,
+                                                      size_t decomposition_base_log,
+                                                      size_t glwe_dimension,
+                                                      size_t polynomial_size,
+                                                      size_t input_lwe_dimension,
+                                                      const struct Fft *fft,
+                                                      uint8_t *stack,
+                                                      size_t stack_size);
+
 void concrete_cpu_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out,
                                                const uint64_t *ct_in,
                                                const uint64_t *accumulator,
@@ -221,6 +287,15 @@ void concrete_cpu_encrypt_ggsw_ciphertext_u64(const uint64_t *glwe_sk,
                                               double variance,
                                               struct EncCsprng *csprng);
 
+void concrete_cpu_encrypt_lwe_ciphertext_list_u64(const uint64_t *lwe_sk,
+                                                  uint64_t *lwe_out,
+                                                  const uint64_t *input,
+                                                  size_t count,
+                                                  size_t lwe_dimension,
+                                                  double variance,
+                                                  Parallelism parallelism,
+                                                  struct EncCsprng *csprng);
+
 void concrete_cpu_encrypt_lwe_ciphertext_u64(const uint64_t *lwe_sk,
                                              uint64_t *lwe_out,
                                              uint64_t input,
@@ -275,6 +350,12 @@ size_t concrete_cpu_fourier_bootstrap_key_size_u64(size_t decomposition_level_co
                                                    size_t polynomial_size,
                                                    size_t input_lwe_dimension);
 
+size_t concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(size_t decomposition_level_count,
+                                                            size_t glwe_dimension,
+                                                            size_t polynomial_size,
+                                                            size_t input_lwe_dimension,
+                                                            size_t grouping_factor);
+
 size_t concrete_cpu_ggsw_ciphertext_size_u64(size_t glwe_dimension,
                                              size_t polynomial_size,
                                              size_t decomposition_level_count);
@@ -317,6 +398,19 @@ void concrete_cpu_init_lwe_keyswitch_key_u64(uint64_t *lwe_ksk,
                                              double variance,
                                              struct EncCsprng *csprng);
 
+void concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(uint64_t *lwe_multi_bit_bsk,
+                                                       const uint64_t *input_lwe_sk,
+                                                       const uint64_t *output_glwe_sk,
+                                                       size_t input_lwe_dimension,
+                                                       size_t output_polynomial_size,
+                                                       size_t output_glwe_dimension,
+                                                       size_t decomposition_level_count,
+                                                       size_t decomposition_base_log,
+                                                       size_t grouping_factor,
+                                                       double variance,
+                                                       Parallelism parallelism,
+                                                       struct EncCsprng *csprng);
+
 void concrete_cpu_init_secret_key_u64(uint64_t *sk, size_t dimension, struct SecCsprng *csprng);
 
 void concrete_cpu_init_seeded_lwe_bootstrap_key_u64(uint64_t *seeded_lwe_bsk,
@@ -353,6 +447,14 @@ void concrete_cpu_keyswitch_lwe_ciphertext_u64(uint64_t *ct_out,
                                                size_t input_dimension,
                                                size_t output_dimension);
 
+void concrete_cpu_keyswitch_lwe_ciphertext_u64_to_u32(uint32_t *ct_out,
+                                                      const uint64_t *ct_in,
+                                                      const uint64_t *keyswitch_key,
+                                                      size_t decomposition_level_count,
+                                                      size_t decomposition_base_log,
+                                                      size_t input_dimension,
+                                                      size_t output_dimension);
+
 size_t concrete_cpu_lwe_ciphertext_size_u64(size_t lwe_dimension);
 
 size_t concrete_cpu_lwe_packing_keyswitch_key_size(size_t output_glwe_dimension,
@@ -362,11 +464,60 @@ size_t concrete_cpu_lwe_packing_keyswitch_key_size(size_t output_glwe_dimension,
 
 size_t concrete_cpu_lwe_secret_key_size_u64(size_t lwe_dimension);
 
+void concrete_cpu_many_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                    const uint64_t *ct_in,
+                                                    const uint64_t *accumulator,
+                                                    size_t lut_count,
+                                                    size_t lut_size,
+                                                    const c64 *fourier_bsk,
+                                                    size_t decomposition_level_count,
+                                                    size_t decomposition_base_log,
+                                                    size_t glwe_dimension,
+                                                    size_t polynomial_size,
+                                                    size_t input_lwe_dimension,
+                                                    const struct Fft *fft,
+                                                    uint8_t *stack,
+                                                    size_t stack_size);
+
+ScratchStatus concrete_cpu_many_bootstrap_lwe_ciphertext_u64_scratch(size_t *stack_size,
+                                                                     size_t *stack_align,
+                                                                     size_t glwe_dimension,
+                                                                     size_t polynomial_size,
+                                                                     const struct Fft *fft);
+
 void concrete_cpu_mul_cleartext_lwe_ciphertext_u64(uint64_t *ct_out,
                                                    const uint64_t *ct_in,
                                                    uint64_t cleartext,
                                                    size_t lwe_dimension);
 
+void concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(const uint64_t *standard_multi_bit_bsk,
+                                                                 c64 *fourier_multi_bit_bsk,
+                                                                 size_t decomposition_level_count,
+                                                                 size_t decomposition_base_log,
+                                                                 size_t glwe_dimension,
+                                                                 size_t polynomial_size,
+                                                                 size_t input_lwe_dimension,
+                                                                 size_t grouping_factor,
+                                                                 Parallelism parallelism);
+
+size_t concrete_cpu_multi_bit_bootstrap_key_size_u64(size_t decomposition_level_count,
+                                                     size_t glwe_dimension,
+                                                     size_t polynomial_size,
+                                                     size_t input_lwe_dimension,
+                                                     size_t grouping_factor);
+
+void concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(uint64_t *ct_out,
+                                                         const uint64_t *ct_in,
+                                                         const uint64_t *accumulator,
+                                                         const c64 *fourier_multi_bit_bsk,
+                                                         size_t decomposition_level_count,
+                                                         size_t decomposition_base_log,
+                                                         size_t glwe_dimension,
+                                                         size_t polynomial_size,
+                                                         size_t input_lwe_dimension,
+                                                         size_t grouping_factor,
+                                                         size_t thread_count);
+
 void concrete_cpu_negate_lwe_ciphertext_u64(uint64_t *ct_out,
                                             const uint64_t *ct_in,
                                             size_t lwe_dimension);
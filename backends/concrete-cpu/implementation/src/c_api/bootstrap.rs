@@ -1,11 +1,15 @@
 use concrete_csprng::generators::SoftwareRandomGenerator;
 use concrete_fft::c64;
+use tfhe::core_crypto::algorithms::polynomial_algorithms::{
+    polynomial_wrapping_monic_monomial_div_assign, polynomial_wrapping_monic_monomial_mul_assign,
+};
 use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
 use crate::c_api::types::{EncCsprng, Parallelism, ScratchStatus, Uint128};
+use aligned_vec::CACHELINE_ALIGN;
 use core::slice;
-use dyn_stack::PodStack;
+use dyn_stack::{PodStack, StackReq};
 
 use super::csprng::new_dyn_seeder;
 use super::secret_key::{
@@ -402,6 +406,683 @@ pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_u64(
     })
 }
 
+/// Number of accumulators blind rotated together by the batched bootstrap. The accumulators of a
+/// block have to stay in cache while each GGSW of the bootstrap key is applied to all of them.
+const BOOTSTRAP_BLOCK_SIZE: usize = 8;
+
+#[no_mangle]
+#[must_use]
+pub unsafe extern "C" fn concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch(
+    stack_size: *mut usize,
+    stack_align: *mut usize,
+    // bootstrap parameters
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    // batch size
+    ciphertext_count: usize,
+    // side resources
+    fft: *const Fft,
+) -> ScratchStatus {
+    nounwind(|| {
+        let glwe_size = GlweDimension(glwe_dimension).to_glwe_size();
+        let polynomial_size = PolynomialSize(polynomial_size);
+        let block_size = ciphertext_count.clamp(1, BOOTSTRAP_BLOCK_SIZE);
+        let accumulator_size = glwe_ciphertext_size(glwe_size, polynomial_size);
+
+        // the accumulators of a block, then the rotated copy of the accumulator being updated
+        if let Ok(scratch) =
+            StackReq::try_new_aligned::<u64>(block_size * accumulator_size, CACHELINE_ALIGN)
+                .and_then(|accumulators| {
+                    accumulators.try_and(StackReq::try_new_aligned::<u64>(
+                        accumulator_size,
+                        CACHELINE_ALIGN,
+                    )?)
+                })
+                .and_then(|buffers| {
+                    buffers.try_and(cmux_assign_mem_optimized_requirement::<u64>(
+                        glwe_size,
+                        polynomial_size,
+                        (*fft).as_view(),
+                    )?)
+                })
+        {
+            *stack_size = scratch.size_bytes();
+            *stack_align = scratch.align_bytes();
+            ScratchStatus::Valid
+        } else {
+            ScratchStatus::SizeOverflow
+        }
+    })
+}
+
+/// Bootstraps the `ciphertext_count` contiguous ciphertexts of `ct_in` with the same accumulator,
+/// and writes the results contiguously in `ct_out`.
+///
+/// The ciphertexts are blind rotated in lock-step by blocks: each GGSW of the bootstrap key is
+/// loaded once and used for the external products of all the accumulators of the block, instead
+/// of streaming the whole key once per ciphertext. The results are the same as the ones of
+/// `concrete_cpu_bootstrap_lwe_ciphertext_u64`.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // batch size
+    ciphertext_count: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        batched_bootstrap_lwe_ciphertext(
+            ct_out,
+            ct_in,
+            |x| x,
+            accumulator,
+            fourier_bsk,
+            decomposition_level_count,
+            decomposition_base_log,
+            glwe_dimension,
+            polynomial_size,
+            input_lwe_dimension,
+            ciphertext_count,
+            &*fft,
+            stack,
+            stack_size,
+        )
+    })
+}
+
+/// Bootstraps `ct_in`, a ciphertext stored on 32 bits, i.e. under the ciphertext modulus `2^32`,
+/// and writes the result in `ct_out` under the native modulus. The scratch requirements are the
+/// ones of `concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch` for a single ciphertext.
+///
+/// The input elements are lifted to the native modulus by a left shift, which is exact, such that
+/// the result is the one of the 64 bits bootstrap of the lifted ciphertext.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_bootstrap_lwe_ciphertext_u32_to_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u32,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        batched_bootstrap_lwe_ciphertext(
+            ct_out,
+            ct_in,
+            lift_u32_to_u64,
+            accumulator,
+            fourier_bsk,
+            decomposition_level_count,
+            decomposition_base_log,
+            glwe_dimension,
+            polynomial_size,
+            input_lwe_dimension,
+            1,
+            &*fft,
+            stack,
+            stack_size,
+        )
+    })
+}
+
+/// Same as `concrete_cpu_batched_bootstrap_lwe_ciphertext_u64`, for input ciphertexts stored on 32
+/// bits as in `concrete_cpu_bootstrap_lwe_ciphertext_u32_to_u64`. The elements are lifted on the
+/// fly, so the scratch requirements are the ones of the 64 bits batched bootstrap.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_batched_bootstrap_lwe_ciphertext_u32_to_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u32,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // batch size
+    ciphertext_count: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        batched_bootstrap_lwe_ciphertext(
+            ct_out,
+            ct_in,
+            lift_u32_to_u64,
+            accumulator,
+            fourier_bsk,
+            decomposition_level_count,
+            decomposition_base_log,
+            glwe_dimension,
+            polynomial_size,
+            input_lwe_dimension,
+            ciphertext_count,
+            &*fft,
+            stack,
+            stack_size,
+        )
+    })
+}
+
+/// Lifts an element from the ciphertext modulus `2^32` to the native one.
+fn lift_u32_to_u64(input: u32) -> u64 {
+    (input as u64) << 32
+}
+
+/// Core of the batched bootstraps, the elements of the input ciphertexts being brought to the
+/// native modulus by `to_native` as they are read.
+#[allow(clippy::too_many_arguments)]
+unsafe fn batched_bootstrap_lwe_ciphertext<Scalar: Copy>(
+    ct_out: *mut u64,
+    ct_in: *const Scalar,
+    to_native: impl Fn(Scalar) -> u64,
+    accumulator: *const u64,
+    fourier_bsk: *const c64,
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    ciphertext_count: usize,
+    fft: &Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    let output_lwe_dimension = glwe_dimension * polynomial_size;
+    let accumulator_size = concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size);
+    let block_size = ciphertext_count.clamp(1, BOOTSTRAP_BLOCK_SIZE);
+
+    let fourier = FourierLweBootstrapKey::from_container(
+        slice::from_raw_parts(
+            fourier_bsk,
+            concrete_cpu_fourier_bootstrap_key_size_u64(
+                decomposition_level_count,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+            ),
+        ),
+        LweDimension(input_lwe_dimension),
+        GlweDimension(glwe_dimension).to_glwe_size(),
+        PolynomialSize(polynomial_size),
+        DecompositionBaseLog(decomposition_base_log),
+        DecompositionLevelCount(decomposition_level_count),
+    );
+
+    let accumulator = slice::from_raw_parts(accumulator, accumulator_size);
+    let ct_in = slice::from_raw_parts(ct_in, ciphertext_count * (input_lwe_dimension + 1));
+    let ct_out = slice::from_raw_parts_mut(ct_out, ciphertext_count * (output_lwe_dimension + 1));
+
+    let mut stack = PodStack::new(slice::from_raw_parts_mut(stack as _, stack_size));
+
+    for (out_block, in_block) in ct_out
+        .chunks_mut(block_size * (output_lwe_dimension + 1))
+        .zip(ct_in.chunks(block_size * (input_lwe_dimension + 1)))
+    {
+        let (accumulators, stack) = stack
+            .rb_mut()
+            .make_aligned_raw::<u64>(block_size * accumulator_size, CACHELINE_ALIGN);
+
+        // rotate each accumulator by the body of its ciphertext
+        for (rotated, lwe_in) in accumulators
+            .chunks_exact_mut(accumulator_size)
+            .zip(in_block.chunks_exact(input_lwe_dimension + 1))
+        {
+            rotated.copy_from_slice(accumulator);
+            let degree =
+                pbs_modulus_switch(to_native(lwe_in[input_lwe_dimension]), polynomial_size);
+            for polynomial in rotated.chunks_exact_mut(polynomial_size) {
+                polynomial_wrapping_monic_monomial_div_assign(
+                    &mut Polynomial::from_container(polynomial),
+                    MonomialDegree(degree),
+                );
+            }
+        }
+
+        // advance all the accumulators of the block through the same cmux
+        let mut stack = stack;
+        for (i, ggsw) in fourier.as_view().into_ggsw_iter().enumerate() {
+            for (rotated, lwe_in) in accumulators
+                .chunks_exact_mut(accumulator_size)
+                .zip(in_block.chunks_exact(input_lwe_dimension + 1))
+            {
+                let mask_element = to_native(lwe_in[i]);
+                if mask_element == 0 {
+                    continue;
+                }
+
+                let (shifted, stack) = stack
+                    .rb_mut()
+                    .make_aligned_raw::<u64>(accumulator_size, CACHELINE_ALIGN);
+                shifted.copy_from_slice(rotated);
+                let degree = pbs_modulus_switch(mask_element, polynomial_size);
+                for polynomial in shifted.chunks_exact_mut(polynomial_size) {
+                    polynomial_wrapping_monic_monomial_mul_assign(
+                        &mut Polynomial::from_container(polynomial),
+                        MonomialDegree(degree),
+                    );
+                }
+
+                cmux_assign_mem_optimized(
+                    &mut GlweCiphertext::from_container(
+                        rotated,
+                        PolynomialSize(polynomial_size),
+                        CiphertextModulus::new_native(),
+                    ),
+                    &mut GlweCiphertext::from_container(
+                        shifted,
+                        PolynomialSize(polynomial_size),
+                        CiphertextModulus::new_native(),
+                    ),
+                    &ggsw,
+                    (*fft).as_view(),
+                    stack,
+                );
+            }
+        }
+
+        for (output, rotated) in out_block
+            .chunks_exact_mut(output_lwe_dimension + 1)
+            .zip(accumulators.chunks_exact(accumulator_size))
+        {
+            extract_lwe_sample_from_glwe_ciphertext(
+                &GlweCiphertext::from_container(
+                    rotated,
+                    PolynomialSize(polynomial_size),
+                    CiphertextModulus::new_native(),
+                ),
+                &mut LweCiphertext::from_container(output, CiphertextModulus::new_native()),
+                MonomialDegree(0),
+            );
+        }
+    }
+}
+
+/// Switches `input` from the native modulus to `2 * polynomial_size`, with the rounding of the
+/// modulus switch of the bootstrap.
+fn pbs_modulus_switch(input: u64, polynomial_size: usize) -> usize {
+    let log2_polynomial_size = polynomial_size.trailing_zeros();
+    let mut output = input >> (u64::BITS - log2_polynomial_size - 2);
+    output += output & 1;
+    (output >> 1) as usize
+}
+
+#[no_mangle]
+#[must_use]
+pub unsafe extern "C" fn concrete_cpu_many_bootstrap_lwe_ciphertext_u64_scratch(
+    stack_size: *mut usize,
+    stack_align: *mut usize,
+    // bootstrap parameters
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    // side resources
+    fft: *const Fft,
+) -> ScratchStatus {
+    nounwind(|| {
+        let glwe_size = GlweDimension(glwe_dimension).to_glwe_size();
+        let polynomial_size = PolynomialSize(polynomial_size);
+
+        // the accumulator is blind rotated in place, so it is copied on the stack first
+        if let Ok(scratch) = StackReq::try_new_aligned::<u64>(
+            glwe_ciphertext_size(glwe_size, polynomial_size),
+            CACHELINE_ALIGN,
+        )
+        .and_then(|accumulator| {
+            accumulator.try_and(blind_rotate_assign_mem_optimized_requirement::<u64>(
+                glwe_size,
+                polynomial_size,
+                (*fft).as_view(),
+            )?)
+        }) {
+            *stack_size = scratch.size_bytes();
+            *stack_align = scratch.align_bytes();
+            ScratchStatus::Valid
+        } else {
+            ScratchStatus::SizeOverflow
+        }
+    })
+}
+
+/// Bootstraps `ct_in` with an accumulator holding `lut_count` interleaved lookup tables, and
+/// writes the `lut_count` resulting ciphertexts contiguously in `ct_out`. `accumulator` is the
+/// polynomial of `polynomial_size` coefficients encoding the tables, which is trivially encrypted.
+///
+/// A single blind rotation is performed, the i-th output being the sample extracted at the
+/// coefficient `i * polynomial_size / (lut_count * lut_size)` of the rotated accumulator, where
+/// `lut_size` is the number of entries of each table.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_many_bootstrap_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    lut_count: usize,
+    lut_size: usize,
+    // bootstrap key
+    fourier_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    // side resources
+    fft: *const Fft,
+    stack: *mut u8,
+    stack_size: usize,
+) {
+    nounwind(|| {
+        let output_lwe_dimension = glwe_dimension * polynomial_size;
+        let glwe_size = GlweDimension(glwe_dimension).to_glwe_size();
+        let accumulator_size =
+            concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size);
+
+        assert!(lut_count > 0);
+        assert_eq!(polynomial_size % (lut_count * lut_size), 0);
+        let slot_size = polynomial_size / (lut_count * lut_size);
+
+        let fourier = FourierLweBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_bsk,
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            glwe_size,
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+
+        let lwe_in = LweCiphertext::from_container(
+            slice::from_raw_parts(ct_in, input_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let stack = PodStack::new(slice::from_raw_parts_mut(stack as _, stack_size));
+        let (rotated, stack) = stack.make_aligned_raw::<u64>(accumulator_size, CACHELINE_ALIGN);
+        // trivial encryption of the accumulator
+        let (mask, body) = rotated.split_at_mut(glwe_dimension * polynomial_size);
+        mask.fill(0);
+        body.copy_from_slice(slice::from_raw_parts(accumulator, polynomial_size));
+
+        let mut rotated = GlweCiphertext::from_container(
+            rotated,
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        blind_rotate_assign_mem_optimized(&lwe_in, &mut rotated, &fourier, (*fft).as_view(), stack);
+
+        let outputs = slice::from_raw_parts_mut(ct_out, lut_count * (output_lwe_dimension + 1));
+        for (i, output) in outputs
+            .chunks_exact_mut(output_lwe_dimension + 1)
+            .enumerate()
+        {
+            let mut lwe_out =
+                LweCiphertext::from_container(output, CiphertextModulus::new_native());
+            extract_lwe_sample_from_glwe_ciphertext(
+                &rotated,
+                &mut lwe_out,
+                MonomialDegree(i * slot_size),
+            );
+        }
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(
+    // bootstrap key
+    lwe_multi_bit_bsk: *mut u64,
+    // secret keys
+    input_lwe_sk: *const u64,
+    output_glwe_sk: *const u64,
+    // secret key dimensions
+    input_lwe_dimension: usize,
+    output_polynomial_size: usize,
+    output_glwe_dimension: usize,
+    // bootstrap key parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    grouping_factor: usize,
+    // noise parameters
+    variance: f64,
+    // parallelism
+    parallelism: Parallelism,
+    // csprng
+    csprng: *mut EncCsprng,
+) {
+    nounwind(|| {
+        let mut bsk = LweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts_mut(
+                lwe_multi_bit_bsk,
+                concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    output_glwe_dimension,
+                    output_polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            GlweDimension(output_glwe_dimension).to_glwe_size(),
+            PolynomialSize(output_polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+            CiphertextModulus::new_native(),
+        );
+
+        let lwe_sk = LweSecretKey::from_container(slice::from_raw_parts(
+            input_lwe_sk,
+            concrete_cpu_lwe_secret_key_size_u64(input_lwe_dimension),
+        ));
+        let glwe_sk = GlweSecretKey::from_container(
+            slice::from_raw_parts(
+                output_glwe_sk,
+                concrete_cpu_glwe_secret_key_size_u64(
+                    output_glwe_dimension,
+                    output_polynomial_size,
+                ),
+            ),
+            PolynomialSize(output_polynomial_size),
+        );
+
+        match parallelism {
+            Parallelism::No => generate_lwe_multi_bit_bootstrap_key(
+                &lwe_sk,
+                &glwe_sk,
+                &mut bsk,
+                Variance::from_variance(variance),
+                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            ),
+            Parallelism::Rayon => par_generate_lwe_multi_bit_bootstrap_key(
+                &lwe_sk,
+                &glwe_sk,
+                &mut bsk,
+                Variance::from_variance(variance),
+                &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>),
+            ),
+        }
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(
+    // bootstrap key
+    standard_multi_bit_bsk: *const u64,
+    fourier_multi_bit_bsk: *mut c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+    // parallelism
+    parallelism: Parallelism,
+) {
+    nounwind(|| {
+        let standard = LweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts(
+                standard_multi_bit_bsk,
+                concrete_cpu_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+            CiphertextModulus::new_native(),
+        );
+
+        let mut fourier = FourierLweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts_mut(
+                fourier_multi_bit_bsk,
+                concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+        );
+
+        match parallelism {
+            Parallelism::No => {
+                convert_standard_lwe_multi_bit_bootstrap_key_to_fourier(&standard, &mut fourier)
+            }
+            Parallelism::Rayon => {
+                par_convert_standard_lwe_multi_bit_bootstrap_key_to_fourier(&standard, &mut fourier)
+            }
+        }
+    })
+}
+
+/// Bootstraps `ct_in` with a multi-bit bootstrap key, i.e. a key blind rotating the accumulator
+/// by `grouping_factor` elements of the input mask at once.
+///
+/// The `2^grouping_factor - 1` external products of a group are independent, and are computed by
+/// `thread_count` threads, such that the latency of a single bootstrap decreases with the number
+/// of cores. The scratch memory is allocated by each thread.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // accumulator
+    accumulator: *const u64,
+    // bootstrap key
+    fourier_multi_bit_bsk: *const c64,
+    // bootstrap parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+    // parallelism
+    thread_count: usize,
+) {
+    nounwind(|| {
+        let output_lwe_dimension = glwe_dimension * polynomial_size;
+
+        let fourier = FourierLweMultiBitBootstrapKey::from_container(
+            slice::from_raw_parts(
+                fourier_multi_bit_bsk,
+                concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    grouping_factor,
+                ),
+            ),
+            LweDimension(input_lwe_dimension),
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+            LweBskGroupingFactor(grouping_factor),
+        );
+
+        let lwe_in = LweCiphertext::from_container(
+            slice::from_raw_parts(ct_in, input_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let mut lwe_out = LweCiphertext::from_container(
+            slice::from_raw_parts_mut(ct_out, output_lwe_dimension + 1),
+            CiphertextModulus::new_native(),
+        );
+
+        let accumulator = GlweCiphertext::from_container(
+            slice::from_raw_parts(
+                accumulator,
+                concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+            ),
+            PolynomialSize(polynomial_size),
+            CiphertextModulus::new_native(),
+        );
+
+        multi_bit_programmable_bootstrap_lwe_ciphertext(
+            &lwe_in,
+            &mut lwe_out,
+            &accumulator,
+            &fourier,
+            ThreadCount(thread_count.max(1)),
+        );
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_bootstrap_key_size_u64(
     decomposition_level_count: usize,
@@ -446,3 +1127,280 @@ pub unsafe extern "C" fn concrete_cpu_seeded_bootstrap_key_size_u64(
             DecompositionLevelCount(decomposition_level_count),
         )
 }
+
+/// Returns the number of GGSW ciphertexts of a multi-bit bootstrap key, i.e. one per non-zero
+/// combination of the bits of each group of `grouping_factor` secret key elements.
+fn multi_bit_ggsw_count(input_lwe_dimension: usize, grouping_factor: usize) -> usize {
+    assert!(grouping_factor > 0);
+    assert_eq!(input_lwe_dimension % grouping_factor, 0);
+    input_lwe_dimension / grouping_factor * ((1 << grouping_factor) - 1)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_multi_bit_bootstrap_key_size_u64(
+    decomposition_level_count: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+) -> usize {
+    multi_bit_ggsw_count(input_lwe_dimension, grouping_factor)
+        * ggsw_ciphertext_size(
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size),
+            DecompositionLevelCount(decomposition_level_count),
+        )
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_fourier_multi_bit_bootstrap_key_size_u64(
+    decomposition_level_count: usize,
+    glwe_dimension: usize,
+    polynomial_size: usize,
+    input_lwe_dimension: usize,
+    grouping_factor: usize,
+) -> usize {
+    multi_bit_ggsw_count(input_lwe_dimension, grouping_factor)
+        * fourier_ggsw_ciphertext_size(
+            GlweDimension(glwe_dimension).to_glwe_size(),
+            PolynomialSize(polynomial_size).to_fourier_polynomial_size(),
+            DecompositionLevelCount(decomposition_level_count),
+        )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::alloc::{alloc, dealloc, Layout};
+
+    #[test]
+    fn test_batched_bootstrap() {
+        let decomposition_level_count = 2;
+        let decomposition_base_log = 10;
+        let glwe_dimension = 1;
+        let polynomial_size = 256;
+        let input_lwe_dimension = 12;
+        let output_lwe_dimension = glwe_dimension * polynomial_size;
+        // not a multiple of the block size
+        let ciphertext_count = BOOTSTRAP_BLOCK_SIZE + 3;
+
+        let mut state = 0x853c_49e6_748f_ea9b_u64;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            state
+        };
+
+        let (fourier_bsk_size, accumulator_size) = unsafe {
+            (
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                ),
+                concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+            )
+        };
+        let fourier_bsk: Vec<c64> = (0..fourier_bsk_size)
+            .map(|_| c64::new((next() >> 54) as f64, (next() >> 54) as f64))
+            .collect();
+        let mut accumulator = vec![0_u64; accumulator_size];
+        for coefficient in &mut accumulator[output_lwe_dimension..] {
+            *coefficient = next();
+        }
+        let mut ct_in: Vec<u64> = (0..ciphertext_count * (input_lwe_dimension + 1))
+            .map(|_| next())
+            .collect();
+        // zero mask elements skip their cmux
+        ct_in[1] = 0;
+
+        let fft = Fft::new(PolynomialSize(polynomial_size));
+
+        let mut expected = vec![0_u64; ciphertext_count * (output_lwe_dimension + 1)];
+        let mut actual = vec![1_u64; ciphertext_count * (output_lwe_dimension + 1)];
+        unsafe {
+            let mut stack_size = 0;
+            let mut stack_align = 0;
+            assert!(matches!(
+                concrete_cpu_bootstrap_lwe_ciphertext_u64_scratch(
+                    &mut stack_size,
+                    &mut stack_align,
+                    glwe_dimension,
+                    polynomial_size,
+                    &fft,
+                ),
+                ScratchStatus::Valid
+            ));
+            let stack_layout = Layout::from_size_align(stack_size, stack_align).unwrap();
+            let stack = alloc(stack_layout);
+            for (out, input) in expected
+                .chunks_exact_mut(output_lwe_dimension + 1)
+                .zip(ct_in.chunks_exact(input_lwe_dimension + 1))
+            {
+                concrete_cpu_bootstrap_lwe_ciphertext_u64(
+                    out.as_mut_ptr(),
+                    input.as_ptr(),
+                    accumulator.as_ptr(),
+                    fourier_bsk.as_ptr(),
+                    decomposition_level_count,
+                    decomposition_base_log,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                    &fft,
+                    stack,
+                    stack_size,
+                );
+            }
+            dealloc(stack, stack_layout);
+
+            assert!(matches!(
+                concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch(
+                    &mut stack_size,
+                    &mut stack_align,
+                    glwe_dimension,
+                    polynomial_size,
+                    ciphertext_count,
+                    &fft,
+                ),
+                ScratchStatus::Valid
+            ));
+            let stack_layout = Layout::from_size_align(stack_size, stack_align).unwrap();
+            let stack = alloc(stack_layout);
+            concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+                actual.as_mut_ptr(),
+                ct_in.as_ptr(),
+                accumulator.as_ptr(),
+                fourier_bsk.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+                ciphertext_count,
+                &fft,
+                stack,
+                stack_size,
+            );
+            dealloc(stack, stack_layout);
+        }
+
+        assert_eq!(actual, expected);
+    }
+
+    #[test]
+    fn test_bootstrap_from_u32() {
+        let decomposition_level_count = 2;
+        let decomposition_base_log = 10;
+        let glwe_dimension = 1;
+        let polynomial_size = 256;
+        let input_lwe_dimension = 12;
+        let output_lwe_dimension = glwe_dimension * polynomial_size;
+        let ciphertext_count = BOOTSTRAP_BLOCK_SIZE + 1;
+
+        let mut state = 0x2545_f491_4f6c_dd1d_u64;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            state
+        };
+
+        let (fourier_bsk_size, accumulator_size) = unsafe {
+            (
+                concrete_cpu_fourier_bootstrap_key_size_u64(
+                    decomposition_level_count,
+                    glwe_dimension,
+                    polynomial_size,
+                    input_lwe_dimension,
+                ),
+                concrete_cpu_glwe_ciphertext_size_u64(glwe_dimension, polynomial_size),
+            )
+        };
+        let fourier_bsk: Vec<c64> = (0..fourier_bsk_size)
+            .map(|_| c64::new((next() >> 54) as f64, (next() >> 54) as f64))
+            .collect();
+        let mut accumulator = vec![0_u64; accumulator_size];
+        for coefficient in &mut accumulator[output_lwe_dimension..] {
+            *coefficient = next();
+        }
+        let ct_in: Vec<u32> = (0..ciphertext_count * (input_lwe_dimension + 1))
+            .map(|_| (next() >> 32) as u32)
+            .collect();
+        let lifted: Vec<u64> = ct_in.iter().map(|&x| lift_u32_to_u64(x)).collect();
+
+        let fft = Fft::new(PolynomialSize(polynomial_size));
+
+        let mut expected = vec![0_u64; ciphertext_count * (output_lwe_dimension + 1)];
+        let mut actual = vec![1_u64; ciphertext_count * (output_lwe_dimension + 1)];
+        let mut single = vec![1_u64; output_lwe_dimension + 1];
+        unsafe {
+            let mut stack_size = 0;
+            let mut stack_align = 0;
+            assert!(matches!(
+                concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch(
+                    &mut stack_size,
+                    &mut stack_align,
+                    glwe_dimension,
+                    polynomial_size,
+                    ciphertext_count,
+                    &fft,
+                ),
+                ScratchStatus::Valid
+            ));
+            let stack_layout = Layout::from_size_align(stack_size, stack_align).unwrap();
+            let stack = alloc(stack_layout);
+            concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+                expected.as_mut_ptr(),
+                lifted.as_ptr(),
+                accumulator.as_ptr(),
+                fourier_bsk.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+                ciphertext_count,
+                &fft,
+                stack,
+                stack_size,
+            );
+            concrete_cpu_batched_bootstrap_lwe_ciphertext_u32_to_u64(
+                actual.as_mut_ptr(),
+                ct_in.as_ptr(),
+                accumulator.as_ptr(),
+                fourier_bsk.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+                ciphertext_count,
+                &fft,
+                stack,
+                stack_size,
+            );
+            // a single ciphertext needs less scratch than a batch
+            concrete_cpu_bootstrap_lwe_ciphertext_u32_to_u64(
+                single.as_mut_ptr(),
+                ct_in.as_ptr(),
+                accumulator.as_ptr(),
+                fourier_bsk.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                glwe_dimension,
+                polynomial_size,
+                input_lwe_dimension,
+                &fft,
+                stack,
+                stack_size,
+            );
+            dealloc(stack, stack_layout);
+        }
+
+        assert_eq!(actual, expected);
+        assert_eq!(single, expected[..output_lwe_dimension + 1]);
+    }
+}
@@ -1,4 +1,5 @@
 use concrete_csprng::generators::SoftwareRandomGenerator;
+use tfhe::core_crypto::commons::math::decomposition::SignedDecomposer;
 use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
@@ -210,6 +211,212 @@ pub unsafe extern "C" fn concrete_cpu_keyswitch_lwe_ciphertext_u64(
     })
 }
 
+/// Number of ciphertexts decomposed together by the batched keyswitch. The
+/// outputs of a block have to stay in cache while the keyswitch key is streamed
+/// over them.
+const KEYSWITCH_BLOCK_SIZE: usize = 16;
+
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+    // ciphertexts
+    ct_out: *mut u64,
+    ct_in: *const u64,
+    // keyswitch key
+    keyswitch_key: *const u64,
+    // keyswitch parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    input_dimension: usize,
+    output_dimension: usize,
+    // batch size
+    ciphertext_count: usize,
+) {
+    nounwind(|| {
+        let input_size = input_dimension + 1;
+        let output_size = output_dimension + 1;
+
+        let ct_out = core::slice::from_raw_parts_mut(ct_out, ciphertext_count * output_size);
+        let ct_in = core::slice::from_raw_parts(ct_in, ciphertext_count * input_size);
+        let keyswitch_key = core::slice::from_raw_parts(
+            keyswitch_key,
+            concrete_cpu_keyswitch_key_size_u64(
+                decomposition_level_count,
+                input_dimension,
+                output_dimension,
+            ),
+        );
+
+        let decomposer = SignedDecomposer::<u64>::new(
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+        let mut decomposed = vec![0_u64; KEYSWITCH_BLOCK_SIZE * decomposition_level_count];
+
+        for (out_block, in_block) in ct_out
+            .chunks_mut(KEYSWITCH_BLOCK_SIZE * output_size)
+            .zip(ct_in.chunks(KEYSWITCH_BLOCK_SIZE * input_size))
+        {
+            keyswitch_block(
+                out_block,
+                in_block,
+                keyswitch_key,
+                &decomposer,
+                &mut decomposed,
+                decomposition_level_count,
+                input_size,
+                output_size,
+            );
+        }
+    })
+}
+
+/// Keyswitches `ct_in` and writes the result in `ct_out` stored on 32 bits, i.e. under the
+/// ciphertext modulus `2^32`. The keyswitch is computed under the native modulus, and each element
+/// of the result is then rounded to its 32 most significant bits.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_keyswitch_lwe_ciphertext_u64_to_u32(
+    // ciphertexts
+    ct_out: *mut u32,
+    ct_in: *const u64,
+    // keyswitch key
+    keyswitch_key: *const u64,
+    // keyswitch parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    input_dimension: usize,
+    output_dimension: usize,
+) {
+    concrete_cpu_batched_keyswitch_lwe_ciphertext_u64_to_u32(
+        ct_out,
+        ct_in,
+        keyswitch_key,
+        decomposition_level_count,
+        decomposition_base_log,
+        input_dimension,
+        output_dimension,
+        1,
+    )
+}
+
+/// Same as `concrete_cpu_batched_keyswitch_lwe_ciphertext_u64`, with the results stored on 32 bits
+/// as in `concrete_cpu_keyswitch_lwe_ciphertext_u64_to_u32`.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_batched_keyswitch_lwe_ciphertext_u64_to_u32(
+    // ciphertexts
+    ct_out: *mut u32,
+    ct_in: *const u64,
+    // keyswitch key
+    keyswitch_key: *const u64,
+    // keyswitch parameters
+    decomposition_level_count: usize,
+    decomposition_base_log: usize,
+    input_dimension: usize,
+    output_dimension: usize,
+    // batch size
+    ciphertext_count: usize,
+) {
+    nounwind(|| {
+        let input_size = input_dimension + 1;
+        let output_size = output_dimension + 1;
+
+        let ct_out = core::slice::from_raw_parts_mut(ct_out, ciphertext_count * output_size);
+        let ct_in = core::slice::from_raw_parts(ct_in, ciphertext_count * input_size);
+        let keyswitch_key = core::slice::from_raw_parts(
+            keyswitch_key,
+            concrete_cpu_keyswitch_key_size_u64(
+                decomposition_level_count,
+                input_dimension,
+                output_dimension,
+            ),
+        );
+
+        let decomposer = SignedDecomposer::<u64>::new(
+            DecompositionBaseLog(decomposition_base_log),
+            DecompositionLevelCount(decomposition_level_count),
+        );
+        let mut decomposed = vec![0_u64; KEYSWITCH_BLOCK_SIZE * decomposition_level_count];
+        // the native results of a block, before they are rounded
+        let mut native = vec![0_u64; KEYSWITCH_BLOCK_SIZE * output_size];
+
+        for (out_block, in_block) in ct_out
+            .chunks_mut(KEYSWITCH_BLOCK_SIZE * output_size)
+            .zip(ct_in.chunks(KEYSWITCH_BLOCK_SIZE * input_size))
+        {
+            let native = &mut native[..out_block.len()];
+            keyswitch_block(
+                native,
+                in_block,
+                keyswitch_key,
+                &decomposer,
+                &mut decomposed,
+                decomposition_level_count,
+                input_size,
+                output_size,
+            );
+            for (o, &x) in out_block.iter_mut().zip(native.iter()) {
+                *o = round_u64_to_u32(x);
+            }
+        }
+    })
+}
+
+/// Switches `input` from the native modulus to `2^32`, rounding to the nearest.
+fn round_u64_to_u32(input: u64) -> u32 {
+    (((input >> 31) + 1) >> 1) as u32
+}
+
+/// Keyswitches a block of ciphertexts, iterating over the keyswitch key in the
+/// outer loop such that each of its rows is loaded once for the whole block.
+/// The result is the same as the one of `keyswitch_lwe_ciphertext` on each
+/// ciphertext.
+#[allow(clippy::too_many_arguments)]
+fn keyswitch_block(
+    out_block: &mut [u64],
+    in_block: &[u64],
+    keyswitch_key: &[u64],
+    decomposer: &SignedDecomposer<u64>,
+    decomposed: &mut [u64],
+    decomposition_level_count: usize,
+    input_size: usize,
+    output_size: usize,
+) {
+    for (out, input) in out_block
+        .chunks_exact_mut(output_size)
+        .zip(in_block.chunks_exact(input_size))
+    {
+        out.fill(0);
+        out[output_size - 1] = input[input_size - 1];
+    }
+
+    for (i, keyswitch_key_block) in keyswitch_key
+        .chunks_exact(decomposition_level_count * output_size)
+        .enumerate()
+    {
+        // decompose the i-th mask element of every ciphertext of the block
+        for (digits, input) in decomposed
+            .chunks_exact_mut(decomposition_level_count)
+            .zip(in_block.chunks_exact(input_size))
+        {
+            for (digit, term) in digits.iter_mut().zip(decomposer.decompose(input[i])) {
+                *digit = term.value();
+            }
+        }
+
+        for (level, keyswitch_key_row) in keyswitch_key_block.chunks_exact(output_size).enumerate()
+        {
+            for (out, digits) in out_block
+                .chunks_exact_mut(output_size)
+                .zip(decomposed.chunks_exact(decomposition_level_count))
+            {
+                let digit = digits[level];
+                for (o, &k) in out.iter_mut().zip(keyswitch_key_row) {
+                    *o = o.wrapping_sub(k.wrapping_mul(digit));
+                }
+            }
+        }
+    }
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_keyswitch_key_size_u64(
     decomposition_level_count: usize,
@@ -233,3 +440,142 @@ pub unsafe extern "C" fn concrete_cpu_seeded_keyswitch_key_size_u64(
             decomposition_level_count,
         ))
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_batched_keyswitch() {
+        let decomposition_level_count = 3;
+        let decomposition_base_log = 4;
+        let input_dimension = 40;
+        let output_dimension = 17;
+        // not a multiple of the block size
+        let ciphertext_count = 2 * KEYSWITCH_BLOCK_SIZE + 3;
+
+        let mut state = 0x853c_49e6_748f_ea9b_u64;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            state
+        };
+
+        let keyswitch_key: Vec<u64> = (0..unsafe {
+            concrete_cpu_keyswitch_key_size_u64(
+                decomposition_level_count,
+                input_dimension,
+                output_dimension,
+            )
+        })
+            .map(|_| next())
+            .collect();
+        let ct_in: Vec<u64> = (0..ciphertext_count * (input_dimension + 1))
+            .map(|_| next())
+            .collect();
+
+        let mut expected = vec![0_u64; ciphertext_count * (output_dimension + 1)];
+        let mut actual = vec![1_u64; ciphertext_count * (output_dimension + 1)];
+        unsafe {
+            for (out, input) in expected
+                .chunks_exact_mut(output_dimension + 1)
+                .zip(ct_in.chunks_exact(input_dimension + 1))
+            {
+                concrete_cpu_keyswitch_lwe_ciphertext_u64(
+                    out.as_mut_ptr(),
+                    input.as_ptr(),
+                    keyswitch_key.as_ptr(),
+                    decomposition_level_count,
+                    decomposition_base_log,
+                    input_dimension,
+                    output_dimension,
+                );
+            }
+            concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+                actual.as_mut_ptr(),
+                ct_in.as_ptr(),
+                keyswitch_key.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                input_dimension,
+                output_dimension,
+                ciphertext_count,
+            );
+        }
+
+        assert_eq!(actual, expected);
+    }
+
+    #[test]
+    fn test_keyswitch_to_u32() {
+        let decomposition_level_count = 3;
+        let decomposition_base_log = 4;
+        let input_dimension = 40;
+        let output_dimension = 17;
+        let ciphertext_count = KEYSWITCH_BLOCK_SIZE + 5;
+
+        let mut state = 0x2545_f491_4f6c_dd1d_u64;
+        let mut next = || {
+            state = state
+                .wrapping_mul(6364136223846793005)
+                .wrapping_add(1442695040888963407);
+            state
+        };
+
+        let keyswitch_key: Vec<u64> = (0..unsafe {
+            concrete_cpu_keyswitch_key_size_u64(
+                decomposition_level_count,
+                input_dimension,
+                output_dimension,
+            )
+        })
+            .map(|_| next())
+            .collect();
+        let ct_in: Vec<u64> = (0..ciphertext_count * (input_dimension + 1))
+            .map(|_| next())
+            .collect();
+
+        let mut native = vec![0_u64; ciphertext_count * (output_dimension + 1)];
+        let mut actual = vec![1_u32; ciphertext_count * (output_dimension + 1)];
+        let mut single = vec![1_u32; output_dimension + 1];
+        unsafe {
+            concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+                native.as_mut_ptr(),
+                ct_in.as_ptr(),
+                keyswitch_key.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                input_dimension,
+                output_dimension,
+                ciphertext_count,
+            );
+            concrete_cpu_batched_keyswitch_lwe_ciphertext_u64_to_u32(
+                actual.as_mut_ptr(),
+                ct_in.as_ptr(),
+                keyswitch_key.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                input_dimension,
+                output_dimension,
+                ciphertext_count,
+            );
+            concrete_cpu_keyswitch_lwe_ciphertext_u64_to_u32(
+                single.as_mut_ptr(),
+                ct_in.as_ptr(),
+                keyswitch_key.as_ptr(),
+                decomposition_level_count,
+                decomposition_base_log,
+                input_dimension,
+                output_dimension,
+            );
+        }
+
+        let expected: Vec<u32> = native.iter().map(|&x| round_u64_to_u32(x)).collect();
+        assert_eq!(actual, expected);
+        assert_eq!(single, expected[..output_dimension + 1]);
+        assert_eq!(round_u64_to_u32((1 << 31) - 1), 0);
+        assert_eq!(round_u64_to_u32(1 << 31), 1);
+        assert_eq!(round_u64_to_u32(u64::MAX), 0);
+    }
+}
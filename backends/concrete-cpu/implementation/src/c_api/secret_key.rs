@@ -3,7 +3,7 @@ use tfhe::core_crypto::commons::math::random::{CompressionSeed, Seed};
 use tfhe::core_crypto::prelude::*;
 
 use super::csprng::new_dyn_seeder;
-use super::types::{EncCsprng, SecCsprng, Uint128};
+use super::types::{EncCsprng, Parallelism, SecCsprng, Uint128};
 use super::utils::nounwind;
 use core::slice;
 
@@ -59,6 +59,66 @@ pub unsafe extern "C" fn concrete_cpu_encrypt_lwe_ciphertext_u64(
     });
 }
 
+/// Encrypts `count` plaintexts into contiguous lwe ciphertexts. Each ciphertext is encrypted
+/// with its own stream forked from `csprng`, such that the result does not depend on the
+/// parallelism.
+#[no_mangle]
+pub unsafe extern "C" fn concrete_cpu_encrypt_lwe_ciphertext_list_u64(
+    // secret key
+    lwe_sk: *const u64,
+    // ciphertexts
+    lwe_out: *mut u64,
+    // plaintexts
+    input: *const u64,
+    // number of ciphertexts
+    count: usize,
+    // lwe dimension
+    lwe_dimension: usize,
+    // encryption parameters
+    variance: f64,
+    // parallelism
+    parallelism: Parallelism,
+    // csprng
+    csprng: *mut EncCsprng,
+) {
+    nounwind(|| {
+        if count == 0 {
+            return;
+        }
+        let lwe_sk = LweSecretKey::from_container(slice::from_raw_parts(
+            lwe_sk,
+            concrete_cpu_lwe_secret_key_size_u64(lwe_dimension),
+        ));
+        let mut lwe_out = LweCiphertextList::from_container(
+            slice::from_raw_parts_mut(
+                lwe_out,
+                count * concrete_cpu_lwe_ciphertext_size_u64(lwe_dimension),
+            ),
+            LweDimension(lwe_dimension).to_lwe_size(),
+            CiphertextModulus::new_native(),
+        );
+        let input = PlaintextList::from_container(slice::from_raw_parts(input, count));
+        let csprng = &mut *(csprng as *mut EncryptionRandomGenerator<SoftwareRandomGenerator>);
+
+        match parallelism {
+            Parallelism::No => encrypt_lwe_ciphertext_list(
+                &lwe_sk,
+                &mut lwe_out,
+                &input,
+                Variance::from_variance(variance),
+                csprng,
+            ),
+            Parallelism::Rayon => par_encrypt_lwe_ciphertext_list(
+                &lwe_sk,
+                &mut lwe_out,
+                &input,
+                Variance::from_variance(variance),
+                csprng,
+            ),
+        }
+    });
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn concrete_cpu_encrypt_seeded_lwe_ciphertext_u64(
     // secret key
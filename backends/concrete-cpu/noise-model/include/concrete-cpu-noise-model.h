@@ -23,6 +23,11 @@ double concrete_cpu_estimate_modulus_switching_noise_with_binary_key(uint64_t in
                                                                      uint64_t glwe_log2_polynomial_size,
                                                                      uint32_t ciphertext_modulus_log);
 
+double concrete_cpu_estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(uint64_t internal_ks_output_lwe_dimension,
+                                                                                         uint64_t glwe_log2_polynomial_size,
+                                                                                         uint32_t storage_modulus_log,
+                                                                                         uint32_t ciphertext_modulus_log);
+
 double concrete_cpu_variance_blind_rotate(uint64_t in_lwe_dimension,
                                           uint64_t out_glwe_dimension,
                                           uint64_t out_polynomial_size,
@@ -1,4 +1,7 @@
-use crate::gaussian_noise::noise::modulus_switching::estimate_modulus_switching_noise_with_binary_key;
+use crate::gaussian_noise::noise::modulus_switching::{
+    estimate_modulus_switching_noise_with_binary_key,
+    estimate_modulus_switching_noise_with_binary_key_and_storage_modulus,
+};
 
 #[no_mangle]
 pub extern "C" fn concrete_cpu_estimate_modulus_switching_noise_with_binary_key(
@@ -12,3 +15,18 @@ pub extern "C" fn concrete_cpu_estimate_modulus_switching_noise_with_binary_key(
         ciphertext_modulus_log,
     )
 }
+
+#[no_mangle]
+pub extern "C" fn concrete_cpu_estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+    internal_ks_output_lwe_dimension: u64,
+    glwe_log2_polynomial_size: u64,
+    storage_modulus_log: u32,
+    ciphertext_modulus_log: u32,
+) -> f64 {
+    estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+        internal_ks_output_lwe_dimension,
+        glwe_log2_polynomial_size,
+        storage_modulus_log,
+        ciphertext_modulus_log,
+    )
+}
@@ -5,11 +5,80 @@ pub fn estimate_modulus_switching_noise_with_binary_key(
     glwe_log2_polynomial_size: u64,
     ciphertext_modulus_log: u32,
 ) -> f64 {
-    let nb_msb = glwe_log2_polynomial_size + 1;
+    estimate_modulus_switching_noise_with_binary_key_to_modulus(
+        internal_ks_output_lwe_dimension,
+        glwe_log2_polynomial_size as u32 + 1,
+        ciphertext_modulus_log,
+    )
+}
 
-    let w = 2_f64.powi(nb_msb as i32);
-    let n = internal_ks_output_lwe_dimension as f64;
+/// Noise added by rounding a ciphertext encrypted under a binary key from a
+/// modulus of `2^ciphertext_modulus_log` to a modulus of `2^output_modulus_log`.
+pub fn estimate_modulus_switching_noise_with_binary_key_to_modulus(
+    lwe_dimension: u64,
+    output_modulus_log: u32,
+    ciphertext_modulus_log: u32,
+) -> f64 {
+    let w = 2_f64.powi(output_modulus_log as i32);
+    let n = lwe_dimension as f64;
 
     (1. / 12. + n / 24.) / square(w)
         + modular_variance_to_variance(-1. / 12. + n / 48., ciphertext_modulus_log)
 }
+
+/// Noise added between the keyswitch and the blind rotation when the keyswitch
+/// outputs are stored on a smaller modulus of `2^storage_modulus_log`: the
+/// outputs are first rounded to the storage modulus, then switched to `2N` by
+/// the bootstrap.
+pub fn estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+    internal_ks_output_lwe_dimension: u64,
+    glwe_log2_polynomial_size: u64,
+    storage_modulus_log: u32,
+    ciphertext_modulus_log: u32,
+) -> f64 {
+    if storage_modulus_log >= ciphertext_modulus_log {
+        return estimate_modulus_switching_noise_with_binary_key(
+            internal_ks_output_lwe_dimension,
+            glwe_log2_polynomial_size,
+            ciphertext_modulus_log,
+        );
+    }
+    estimate_modulus_switching_noise_with_binary_key_to_modulus(
+        internal_ks_output_lwe_dimension,
+        storage_modulus_log,
+        ciphertext_modulus_log,
+    ) + estimate_modulus_switching_noise_with_binary_key(
+        internal_ks_output_lwe_dimension,
+        glwe_log2_polynomial_size,
+        storage_modulus_log,
+    )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn storage_modulus_noise() {
+        let (n, log2_poly_size) = (800, 11);
+        let native = estimate_modulus_switching_noise_with_binary_key(n, log2_poly_size, 64);
+        assert_eq!(
+            native,
+            estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+                n,
+                log2_poly_size,
+                64,
+                64
+            )
+        );
+        let small = estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+            n,
+            log2_poly_size,
+            32,
+            64,
+        );
+        // the rounding to 2^32 is negligible compared to the one to 2N
+        assert!(native < small);
+        assert!(small < native * (1. + 1e-9));
+    }
+}
@@ -8,6 +8,7 @@
 
 #include "concrete-protocol.capnp.h"
 #include "concretelang/Common/Csprng.h"
+#include "concretelang/Common/Error.h"
 #include "concretelang/Common/Protocol.h"
 #include <memory>
 #include <stdlib.h>
@@ -75,15 +76,17 @@ class LweBootstrapKey {
 public:
   typedef Message<concreteprotocol::LweBootstrapKeyInfo> InfoType;
 
-  /// @brief Constructor of a bootstrap key that initialize according with the
-  /// given specification.
+  /// @brief Generates a bootstrap key according with the given
+  /// specification.
   /// @param info The info of the key to initialize.
   /// @param inputKey The input secret key of the bootstraping key.
   /// @param outputKey The output secret key of the bootstraping key.
   /// @param csprng An encryption csprng that used to encrypt the secret keys.
-  LweBootstrapKey(Message<concreteprotocol::LweBootstrapKeyInfo> info,
-                  const LweSecretKey &inputKey, const LweSecretKey &outputKey,
-                  concretelang::csprng::EncryptionCSPRNG &csprng);
+  /// @return The key, or an error if the specification is not supported.
+  static concretelang::error::Result<LweBootstrapKey>
+  generate(Message<concreteprotocol::LweBootstrapKeyInfo> info,
+           const LweSecretKey &inputKey, const LweSecretKey &outputKey,
+           concretelang::csprng::EncryptionCSPRNG &csprng);
   LweBootstrapKey(std::shared_ptr<std::vector<uint64_t>> buffer,
                   Message<concreteprotocol::LweBootstrapKeyInfo> info)
       : seededBuffer(std::make_shared<std::vector<uint64_t>>()), buffer(buffer),
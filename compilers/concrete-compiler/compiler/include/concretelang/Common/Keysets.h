@@ -52,9 +52,10 @@ struct Keyset {
   Keyset(){};
 
   /// Generates a fresh keyset from infos.
-  Keyset(const Message<concreteprotocol::KeysetInfo> &info,
-         concretelang::csprng::SecretCSPRNG &secretCsprng,
-         csprng::EncryptionCSPRNG &encryptionCsprng);
+  static Result<Keyset>
+  generate(const Message<concreteprotocol::KeysetInfo> &info,
+           concretelang::csprng::SecretCSPRNG &secretCsprng,
+           csprng::EncryptionCSPRNG &encryptionCsprng);
   Keyset(ServerKeyset server, ClientKeyset client)
       : server(server), client(client) {}
 
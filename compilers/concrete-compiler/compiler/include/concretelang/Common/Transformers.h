@@ -41,6 +41,11 @@ typedef std::function<Result<Value>(TransportValue)> ArgTransformer;
 /// TransportValue to be sent to the client.
 typedef std::function<Result<TransportValue>(Value)> ReturnTransformer;
 
+/// Returns the number of 64 bits words holding an lwe ciphertext of `lweSize`
+/// elements, once modulus switched to `2^modulusLog` and bit-packed by the
+/// modulus switch compression.
+size_t getModulusSwitchedLweSize(size_t lweSize, uint32_t modulusLog);
+
 /// A factory static class that generates transformers.
 class TransformerFactory {
 public:
@@ -10,8 +10,11 @@
 
 namespace mlir {
 namespace concretelang {
-/// Create a pass to convert `TFHE` dialect to `Concrete` dialect.
-std::unique_ptr<OperationPass<ModuleOp>> createConvertTFHEToConcretePass();
+/// Create a pass to convert `TFHE` dialect to `Concrete` dialect. With a
+/// `smallLweCiphertextModulusLog` of 32, the ciphertexts which only flow from
+/// keyswitches to bootstraps are stored on 32 bits.
+std::unique_ptr<OperationPass<ModuleOp>>
+createConvertTFHEToConcretePass(unsigned smallLweCiphertextModulusLog = 64);
 } // namespace concretelang
 } // namespace mlir
 
@@ -12,8 +12,11 @@
 namespace mlir {
 namespace concretelang {
 
+// Returns a memref of `rank` dynamic dimensions with an unknown offset, with
+// `i64` elements unless `elementType` is given
 mlir::Type getDynamicMemrefWithUnknownOffset(mlir::RewriterBase &rewriter,
-                                             size_t rank);
+                                             size_t rank,
+                                             mlir::Type elementType = nullptr);
 
 // Returns `memref.cast %0 : memref<...xAxT> to memref<...x?xT>`
 mlir::Value getCastedMemRef(mlir::RewriterBase &rewriter, mlir::Value value);
@@ -6,14 +6,24 @@
 #ifndef CONCRETELANG_DIALECT_CONCRETE_TRANSFORMS_PASSES_H_
 #define CONCRETELANG_DIALECT_CONCRETE_TRANSFORMS_PASSES_H_
 
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Pass/Pass.h"
 
+#include <functional>
+
 #define GEN_PASS_CLASSES
 #include "concretelang/Dialect/Concrete/Transforms/Passes.h.inc"
 
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<OperationPass<ModuleOp>> createAddRuntimeContext();
+
+/// Creates a pass removing redundant and dead programmable bootstraps and
+/// keyswitches. The callback is invoked once per function with the number of
+/// scalar programmable bootstraps eliminated by the pass.
+std::unique_ptr<OperationPass<func::FuncOp>> createBootstrapEliminationPass(
+    std::function<void(uint64_t)> eliminatedPBSCallback = nullptr);
 } // namespace concretelang
 } // namespace mlir
 
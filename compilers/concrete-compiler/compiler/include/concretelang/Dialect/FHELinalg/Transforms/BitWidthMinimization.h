@@ -0,0 +1,27 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_FHELINALG_BIT_WIDTH_MINIMIZATION_PASS_H
+#define CONCRETELANG_FHELINALG_BIT_WIDTH_MINIMIZATION_PASS_H
+
+#include <concretelang/Dialect/FHE/IR/FHEDialect.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Pass/Pass.h>
+
+#define GEN_PASS_CLASSES
+#include <concretelang/Dialect/FHELinalg/Transforms/BitWidthMinimization.h.inc>
+
+namespace mlir {
+namespace concretelang {
+/// Creates a pass shrinking the width of the encrypted integers of a
+/// function to the ranges of the values they hold.
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createBitWidthMinimizationPass();
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -0,0 +1,30 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_FHELINALG_LOOKUP_TABLE_COMPOSITION_PASS_H
+#define CONCRETELANG_FHELINALG_LOOKUP_TABLE_COMPOSITION_PASS_H
+
+#include <concretelang/Dialect/FHE/IR/FHEDialect.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h>
+#include <functional>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Pass/Pass.h>
+
+#define GEN_PASS_CLASSES
+#include <concretelang/Dialect/FHELinalg/Transforms/LookupTableComposition.h.inc>
+
+namespace mlir {
+namespace concretelang {
+/// Creates a pass composing, folding and removing table lookups with constant
+/// tables. The callback is invoked once per function with the number of
+/// scalar programmable bootstraps eliminated by the pass.
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createLookupTableCompositionPass(
+    std::function<void(uint64_t)> eliminatedPBSCallback = nullptr);
+} // namespace concretelang
+} // namespace mlir
+
+#endif
@@ -0,0 +1,28 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#ifndef CONCRETELANG_FHELINALG_WINOGRAD_CONV2D_PASS_H
+#define CONCRETELANG_FHELINALG_WINOGRAD_CONV2D_PASS_H
+
+#include <concretelang/Dialect/FHE/IR/FHEDialect.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgDialect.h>
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/Pass/Pass.h>
+
+#define GEN_PASS_CLASSES
+#include <concretelang/Dialect/FHELinalg/Transforms/WinogradConv2d.h.inc>
+
+namespace mlir {
+namespace concretelang {
+/// Creates a pass rewriting the 3x3 convolutions with clear weights of a
+/// function into their Winograd F(2x2, 3x3) form.
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createWinogradConv2dPass();
+} // namespace concretelang
+} // namespace mlir
+
+#endif
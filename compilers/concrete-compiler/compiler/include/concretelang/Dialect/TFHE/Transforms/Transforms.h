@@ -16,6 +16,8 @@
 namespace mlir {
 namespace concretelang {
 std::unique_ptr<mlir::OperationPass<>> createTFHEOptimizationPass();
+std::unique_ptr<mlir::OperationPass<>> createTFHEKeyswitchSharingPass();
+std::unique_ptr<mlir::OperationPass<>> createTFHEManyLutBootstrapPass();
 std::unique_ptr<mlir::OperationPass<>>
     createTFHECircuitSolutionParametrizationPass(
         concrete_optimizer::dag::CircuitSolution);
@@ -25,6 +25,7 @@ bool _dfr_is_jit();
 bool _dfr_is_root_node();
 bool _dfr_use_omp();
 bool _dfr_is_distributed();
+bool _dfr_is_worker_thread();
 
 typedef enum _dfr_task_arg_type {
   _DFR_TASK_ARG_BASE = 0,
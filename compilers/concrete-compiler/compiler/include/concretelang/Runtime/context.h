@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <complex>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <pthread.h>
 #include <vector>
@@ -38,6 +39,19 @@ typedef struct FFT {
   size_t polynomial_size;
 } FFT;
 
+/// Placement of the fourier bootstrap keys on the NUMA nodes of the host,
+/// selected by the `CONCRETE_KEY_PLACEMENT` environment variable (`default`,
+/// `replicate` or `interleave`).
+enum class KeyPlacement {
+  /// The keys are allocated on the node that converted them.
+  DEFAULT,
+  /// A copy of the keys is allocated on each node, and each thread reads the
+  /// copy of the node it runs on.
+  REPLICATE,
+  /// The pages of the keys are interleaved over all the nodes.
+  INTERLEAVE,
+};
+
 typedef struct RuntimeContext {
 
   RuntimeContext() = delete;
@@ -58,7 +72,8 @@ typedef struct RuntimeContext {
   }
 
   const std::complex<double> *fourier_bootstrap_key_buffer(size_t keyId) {
-    return fourier_bootstrap_keys[keyId]->data();
+    auto &replicas = fourier_bootstrap_keys[keyId];
+    return replicas[replicas.size() > 1 ? local_replica() : 0].get();
   }
 
   const uint64_t *fp_keyswitch_key_buffer(size_t keyId) {
@@ -67,13 +82,31 @@ typedef struct RuntimeContext {
 
   const struct Fft *fft(size_t keyId) { return ffts[keyId].fft; }
 
+  /// Returns the grouping factor of the bootstrap key `keyId`, i.e. 1 for a
+  /// classic bootstrap key and the number of mask elements blind rotated at
+  /// once for a multi-bit bootstrap key.
+  size_t grouping_factor(size_t keyId) { return grouping_factors[keyId]; }
+
   const ServerKeyset getKeys() const { return serverKeyset; }
 
+  /// Returns the placement of the fourier bootstrap keys.
+  KeyPlacement key_placement() const { return placement; }
+
 private:
+  /// Returns the replica of the fourier bootstrap keys local to the cpu the
+  /// calling thread runs on.
+  size_t local_replica() const;
+
   ServerKeyset serverKeyset;
-  std::vector<std::shared_ptr<std::vector<std::complex<double>>>>
+  /// The fourier bootstrap keys, with one replica per NUMA node for the
+  /// `REPLICATE` placement, or a single one otherwise.
+  std::vector<std::vector<std::shared_ptr<std::complex<double>>>>
       fourier_bootstrap_keys;
+  /// The replica of the fourier bootstrap keys read by each cpu.
+  std::vector<size_t> cpu_replicas;
+  KeyPlacement placement;
   std::vector<FFT> ffts;
+  std::vector<size_t> grouping_factors;
 
 #ifdef CONCRETELANG_CUDA_SUPPORT
 public:
@@ -15,6 +15,8 @@ using namespace hpx;
 typedef struct dfr_refcounted_future {
   hpx::shared_future<void *> *future;
   std::atomic<std::size_t> count;
+  // True if the future owns the memref buffer it holds, which is then
+  // shared by all the tasks referencing the future and freed with it.
   bool cloned_memref_p;
   dfr_refcounted_future(hpx::shared_future<void *> *f, size_t c, bool clone_p)
       : future(f), count(c), cloned_memref_p(clone_p) {}
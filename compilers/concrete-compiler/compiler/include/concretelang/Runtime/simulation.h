@@ -57,6 +57,18 @@ uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
                                uint32_t level, uint32_t base_log,
                                uint32_t glwe_dim);
 
+/// simulate a many-lut PBS, writing the evaluation of each of the lookup
+/// tables encoded in the accumulator in the 1D output memref
+void sim_many_bootstrap_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
+                                uint64_t out_offset, uint64_t out_size,
+                                uint64_t out_stride, uint64_t plaintext,
+                                uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+                                uint64_t tlu_offset, uint64_t tlu_size,
+                                uint64_t tlu_stride, uint32_t input_lwe_dim,
+                                uint32_t poly_size, uint32_t level,
+                                uint32_t base_log, uint32_t glwe_dim,
+                                uint32_t lut_size);
+
 /// simulate a WoP PBS
 void sim_wop_pbs_crt(
     // Output 1D memref
@@ -86,6 +98,13 @@ void sim_encode_expand_lut_for_boostrap(
     uint64_t out_stride, uint32_t poly_size, uint32_t output_bits,
     bool is_signed);
 
+void sim_encode_expand_many_luts_for_boostrap(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *in_allocated,
+    uint64_t *in_aligned, uint64_t in_offset, uint64_t in_size0,
+    uint64_t in_size1, uint64_t in_stride0, uint64_t in_stride1,
+    uint32_t poly_size, uint32_t output_bits, bool is_signed);
+
 void sim_encode_plaintext_with_crt(uint64_t *output_allocated,
                                    uint64_t *output_aligned,
                                    uint64_t output_offset, uint64_t output_size,
@@ -75,6 +75,31 @@ void stream_emulator_make_memref_batched_mapped_bootstrap_lwe_u64_process(
     uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
     uint32_t output_size, uint32_t bsk_index, void *context);
 
+void stream_emulator_make_memref_encode_expand_lut_for_bootstrap_process(
+    void *dfg, void *sin1, void *sout, uint32_t poly_size, uint32_t output_bits,
+    bool is_signed, uint32_t output_size);
+void stream_emulator_make_memref_encode_lut_for_crt_woppbs_process(
+    void *dfg, void *sin1, void *sout, uint64_t *crt_decomposition_allocated,
+    uint64_t *crt_decomposition_aligned, uint64_t crt_decomposition_offset,
+    uint64_t crt_decomposition_size, uint64_t crt_decomposition_stride,
+    uint64_t *crt_bits_allocated, uint64_t *crt_bits_aligned,
+    uint64_t crt_bits_offset, uint64_t crt_bits_size, uint64_t crt_bits_stride,
+    uint32_t modulus_product, bool is_signed, uint32_t output_size);
+void stream_emulator_make_memref_encode_plaintext_with_crt_process(
+    void *dfg, void *sin1, void *sout, uint64_t *mods_allocated,
+    uint64_t *mods_aligned, uint64_t mods_offset, uint64_t mods_size,
+    uint64_t mods_stride, uint64_t mods_product, uint32_t output_size);
+void stream_emulator_make_memref_wop_pbs_crt_lwe_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout,
+    uint64_t *crt_decomposition_allocated, uint64_t *crt_decomposition_aligned,
+    uint64_t crt_decomposition_offset, uint64_t crt_decomposition_size,
+    uint64_t crt_decomposition_stride, uint32_t lwe_small_size,
+    uint32_t cbs_level, uint32_t cbs_base_log, uint32_t ksk_level,
+    uint32_t ksk_base_log, uint32_t bsk_level, uint32_t bsk_base_log,
+    uint32_t fpksk_level, uint32_t fpksk_base_log, uint32_t poly_size,
+    uint32_t output_size, uint32_t ksk_index, uint32_t bsk_index,
+    uint32_t pksk_index, void *context);
+
 void *stream_emulator_make_uint64_stream(const char *name, stream_type stype);
 void stream_emulator_put_uint64(void *stream, uint64_t e);
 uint64_t stream_emulator_get_uint64(void *stream);
@@ -29,6 +29,15 @@ void memref_encode_expand_lut_for_bootstrap(
     uint64_t input_lut_size, uint64_t input_lut_stride, uint32_t poly_size,
     uint32_t out_MESSAGE_BITS, bool is_signed);
 
+void memref_encode_expand_many_luts_for_bootstrap(
+    uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
+    uint64_t output_lut_offset, uint64_t output_lut_size,
+    uint64_t output_lut_stride, uint64_t *input_luts_allocated,
+    uint64_t *input_luts_aligned, uint64_t input_luts_offset,
+    uint64_t input_luts_size0, uint64_t input_luts_size1,
+    uint64_t input_luts_stride0, uint64_t input_luts_stride1,
+    uint32_t poly_size, uint32_t out_MESSAGE_BITS, bool is_signed);
+
 void memref_encode_lut_for_crt_woppbs(
     uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
     uint64_t output_lut_offset, uint64_t output_lut_size0,
@@ -85,6 +94,14 @@ void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
                               uint32_t ksk_index,
                               mlir::concretelang::RuntimeContext *context);
 
+void memref_keyswitch_lwe_u64_to_u32(
+    uint32_t *out_allocated, uint32_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint32_t level, uint32_t base_log,
+    uint32_t input_lwe_dim, uint32_t output_lwe_dim, uint32_t ksk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_batched_add_lwe_ciphertexts_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -142,6 +159,15 @@ void memref_batched_keyswitch_lwe_u64(
     uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
     uint32_t ksk_index, mlir::concretelang::RuntimeContext *context);
 
+void memref_batched_keyswitch_lwe_u64_to_u32(
+    uint32_t *out_allocated, uint32_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
+    uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
+    uint32_t ksk_index, mlir::concretelang::RuntimeContext *context);
+
 void *memref_keyswitch_async_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
@@ -158,6 +184,27 @@ void memref_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+void memref_bootstrap_lwe_u32_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint32_t *ct0_allocated,
+    uint32_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
+void memref_many_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t input_lwe_dim,
+    uint32_t poly_size, uint32_t level, uint32_t base_log, uint32_t glwe_dim,
+    uint32_t lut_size, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_batched_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -169,6 +216,17 @@ void memref_batched_bootstrap_lwe_u64(
     uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+void memref_batched_bootstrap_lwe_u32_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint32_t *ct0_allocated, uint32_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_batched_mapped_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -181,6 +239,18 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context);
 
+void memref_batched_mapped_bootstrap_lwe_u32_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint32_t *ct0_allocated, uint32_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size0,
+    uint64_t tlu_size1, uint64_t tlu_stride0, uint64_t tlu_stride1,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context);
+
 void *memref_bootstrap_async_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
@@ -227,6 +297,39 @@ void memref_wop_pbs_crt_buffer(
     // runtime context that hold evluation keys
     mlir::concretelang::RuntimeContext *context);
 
+/// \brief Run the wop-pbs on a batch of CRT ciphertexts.
+///
+/// The bits of the blocks of all the ciphertexts are extracted in parallel,
+/// then the vertical packings of the ciphertexts are computed in parallel,
+/// each thread reusing its scratch buffers. The lookup tables are encoded
+/// once for the whole batch.
+void memref_batched_wop_pbs_crt_buffer(
+    // Output 3D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_size_2,
+    uint64_t out_stride_0, uint64_t out_stride_1, uint64_t out_stride_2,
+    // Input 3D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_size_2,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t in_stride_2,
+    // clear text lut
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_size, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key indices
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evluation keys
+    mlir::concretelang::RuntimeContext *context);
+
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
                           uint64_t src_offset, uint64_t src_size,
                           uint64_t src_stride, uint64_t *dst_allocated,
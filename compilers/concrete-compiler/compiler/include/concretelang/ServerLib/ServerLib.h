@@ -17,9 +17,17 @@
 #include <cassert>
 #include <dlfcn.h>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+namespace mlir {
+namespace concretelang {
+struct RuntimeContext;
+} // namespace concretelang
+} // namespace mlir
+
 using concretelang::keysets::ServerKeyset;
 using concretelang::transformers::ArgTransformer;
 using concretelang::transformers::ReturnTransformer;
@@ -50,6 +58,12 @@ public:
   Result<std::vector<TransportValue>> call(const ServerKeyset &serverKeyset,
                                            std::vector<TransportValue> &args);
 
+  /// Call the circuit with public arguments, reusing the evaluation keys
+  /// already prepared in `runtimeContext`.
+  Result<std::vector<TransportValue>>
+  call(mlir::concretelang::RuntimeContext &runtimeContext,
+       std::vector<TransportValue> &args);
+
   Result<std::vector<TransportValue>>
   simulate(std::vector<TransportValue> &args);
 
@@ -64,7 +78,7 @@ private:
                     std::shared_ptr<DynamicModule> dynamicModule,
                     bool useSimulation);
 
-  void invoke(const ServerKeyset &serverKeyset);
+  void invoke(mlir::concretelang::RuntimeContext &runtimeContext);
 
   Message<concreteprotocol::CircuitInfo> circuitInfo;
   bool useSimulation;
@@ -83,7 +97,9 @@ private:
 /// ServerProgram contains multiple
 class ServerProgram {
 public:
-  /// Loads a server program from a shared lib path essentially.
+  /// Loads a server program from a shared lib path essentially. The circuits
+  /// are loaded on their first use, from their own shared library next to the
+  /// shared library of the program if the program info says they have one.
   static Result<ServerProgram>
   load(const Message<concreteprotocol::ProgramInfo> &programInfo,
        const std::string &outputPath, bool useSimulation);
@@ -93,7 +109,17 @@ public:
 private:
   ServerProgram() = default;
 
-  std::vector<ServerCircuit> serverCircuits;
+  /// The circuits loaded so far, shared by the copies of the program.
+  struct LoadedCircuits {
+    std::mutex mutex;
+    std::shared_ptr<DynamicModule> programModule;
+    std::map<std::string, ServerCircuit> serverCircuits;
+  };
+
+  Message<concreteprotocol::ProgramInfo> programInfo;
+  std::string sharedLibPath;
+  bool useSimulation;
+  std::shared_ptr<LoadedCircuits> loadedCircuits;
 };
 
 } // namespace serverlib
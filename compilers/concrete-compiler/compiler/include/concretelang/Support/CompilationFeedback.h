@@ -81,6 +81,11 @@ struct CompilationFeedback {
   /// @brief memory usage per location
   std::map<std::string, int64_t> memoryUsagePerLoc;
 
+  /// @brief number of scalar PBS removed by compile-time rewriting of table
+  /// lookups (composition, folding and identity removal) and by the
+  /// elimination of redundant and dead bootstraps
+  uint64_t eliminatedPbsCount = 0;
+
   /// Fill the sizes from the program info.
   void fillFromProgramInfo(const Message<protocol::ProgramInfo> &params);
 
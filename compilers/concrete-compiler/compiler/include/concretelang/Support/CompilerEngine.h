@@ -68,10 +68,28 @@ struct CompilationOptions {
   bool loopParallelize;
   bool batchTFHEOps;
   int64_t maxBatchSize;
+  /// run the passes on the functions of the module in parallel
+  bool multithreadPasses;
+  /// outline the top-level loops of at least this many operations into
+  /// separate functions before the bufferized lowering, such that they are
+  /// processed in parallel, 0 disables the outlining
+  uint64_t loopOutliningThreshold;
   bool emitSDFGOps;
   bool unrollLoopsWithSDFGConvertibleOps;
   bool dataflowParallelize;
   bool optimizeTFHE;
+  /// compose, fold and remove table lookups with constant tables before the
+  /// FHE parameters are determined
+  bool composeLookupTables;
+  /// shrink the width of encrypted integers to the ranges of their values
+  /// before the FHE parameters are determined
+  bool minimizeBitWidths;
+  /// compute the encodings of the clear values extracted from constant
+  /// tensors, e.g. the weights of a matmul, at compile time
+  bool foldConstantEncodings;
+  /// rewrite the 3x3 convolutions with clear weights into their Winograd
+  /// form when the noise bounds allow it
+  bool winogradConv2d;
   /// simulate crypto operations
   bool simulate;
   /// use GPU during execution by generating GPU operations if possible
@@ -87,6 +105,10 @@ struct CompilationOptions {
   /// of bits used for the message, including the carry, while chunkWidth is
   /// only the number of bits used during encoding and decoding of a big integer
   bool chunkIntegers;
+  /// choose whether to decompose big integers into chunks by comparing the
+  /// complexity of the optimizer solutions with and without chunks, ignored
+  /// if chunkIntegers is set
+  bool chunkIntegersByCost;
   unsigned int chunkSize;
   unsigned int chunkWidth;
 
@@ -96,15 +118,29 @@ struct CompilationOptions {
 
   bool compressInputs;
 
+  /// modulus switch the output ciphertexts to the smallest modulus that
+  /// preserves their decryption, and bit-pack them
+  bool compressOutputs;
+
+  /// emit one object and one shared library per circuit next to the library
+  /// of the program, such that the server only loads the circuits it uses,
+  /// and the unchanged circuits of a program reuse their previous objects
+  bool emitCircuitLibraries;
+
   CompilationOptions()
       : v0FHEConstraints(std::nullopt), verifyDiagnostics(false),
         autoParallelize(false), loopParallelize(false), batchTFHEOps(false),
-        maxBatchSize(std::numeric_limits<int64_t>::max()), emitSDFGOps(false),
+        maxBatchSize(std::numeric_limits<int64_t>::max()),
+        multithreadPasses(false), loopOutliningThreshold(0), emitSDFGOps(false),
         unrollLoopsWithSDFGConvertibleOps(false), dataflowParallelize(false),
-        optimizeTFHE(true), simulate(false), emitGPUOps(false),
-        mainFuncName(std::nullopt), optimizerConfig(optimizer::DEFAULT_CONFIG),
-        chunkIntegers(false), chunkSize(4), chunkWidth(2),
-        encodings(std::nullopt), compressInputs(false){};
+        optimizeTFHE(true), composeLookupTables(true),
+        minimizeBitWidths(true), foldConstantEncodings(true),
+        winogradConv2d(false), simulate(false),
+        emitGPUOps(false), mainFuncName(std::nullopt),
+        optimizerConfig(optimizer::DEFAULT_CONFIG),
+        chunkIntegers(false), chunkIntegersByCost(false), chunkSize(4),
+        chunkWidth(2), encodings(std::nullopt), compressInputs(false),
+        compressOutputs(false), emitCircuitLibraries(false){};
 
   CompilationOptions(std::string funcname) : CompilationOptions() {
     mainFuncName = funcname;
@@ -152,6 +188,9 @@ public:
   class Library {
     std::string outputDirPath;
     std::vector<std::string> objectsPath;
+    /// Names and paths of the objects of the circuits emitted separately,
+    /// which are kept for later compilations
+    std::vector<std::pair<std::string, std::string>> circuitObjectsPath;
     /// Path to the runtime library. Will be linked to the output library if set
     std::string runtimeLibraryPath;
     bool cleanUp;
@@ -166,9 +205,11 @@ public:
             bool cleanUp = true)
         : outputDirPath(outputDirPath), runtimeLibraryPath(runtimeLibraryPath),
           cleanUp(cleanUp), programInfo() {}
-    /// Sets the compilation result used by the library
+    /// Sets the compilation result used by the library. If circuitObjects
+    /// is set, each circuit is emitted in its own object.
     llvm::Expected<std::string>
-    setCompilationResult(CompilationResult &compilation);
+    setCompilationResult(CompilationResult &compilation,
+                         bool circuitObjects = false);
     /// Emit the library artifacts with the previously added compilation result
     llvm::Error emitArtifacts(bool sharedLib, bool staticLib,
                               bool clientParameters, bool compilationFeedback);
@@ -186,6 +227,10 @@ public:
     /// Returns the path of the shared library
     static std::string getSharedLibraryPath(std::string outputDirPath);
 
+    /// Returns the path of the shared library of a single circuit
+    static std::string getCircuitSharedLibraryPath(std::string outputDirPath,
+                                                   std::string circuitName);
+
     /// Returns the path of the static library
     static std::string getStaticLibraryPath(std::string outputDirPath);
 
@@ -350,6 +395,12 @@ private:
   llvm::Expected<std::optional<optimizer::Description>>
   getConcreteOptimizerDescription(CompilationResult &res);
   llvm::Error determineFHEParameters(CompilationResult &res);
+  llvm::Error transformBeforeFHEParameters(CompilationResult &res,
+                                           bool chunkIntegers,
+                                           uint64_t &eliminatedPBS);
+  std::optional<bool> determineFHEParametersByCost(CompilationResult &res,
+                                                   mlir::ModuleOp module,
+                                                   uint64_t &eliminatedPBS);
 };
 
 } // namespace concretelang
@@ -7,12 +7,26 @@
 #define CONCRETELANG_SUPPORT_LLVMEMITFILE
 
 #include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
 
 namespace mlir {
 namespace concretelang {
 
 llvm::Error emitObject(llvm::Module &module, std::string objectPath);
 
+/// Returns a copy of `module` which only defines the circuit `circuitName`
+/// and the functions and globals it uses, or nullptr if the circuit is not
+/// defined in `module`.
+std::unique_ptr<llvm::Module>
+extractCircuitModule(const llvm::Module &module, llvm::StringRef circuitName);
+
+/// Emits the object of the circuit `circuitName` of `module` in
+/// `outputDirPath` and returns its path. The object is named after a hash of
+/// the circuit code, and an existing object with the same hash is reused.
+llvm::Expected<std::string> emitCircuitObject(const llvm::Module &module,
+                                              std::string circuitName,
+                                              std::string outputDirPath);
+
 llvm::Error callCmd(std::string cmd);
 
 llvm::Error emitLibrary(std::vector<std::string> objectsPath,
@@ -50,6 +50,19 @@ mlir::LogicalResult
 transformFHEBoolean(mlir::MLIRContext &context, mlir::ModuleOp &module,
                     std::function<bool(mlir::Pass *)> enablePass);
 
+mlir::LogicalResult
+composeLookupTables(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    uint64_t &eliminatedPBS);
+
+mlir::LogicalResult
+minimizeBitWidths(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                  std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+rewriteWinogradConv2d(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass);
+
 mlir::LogicalResult
 transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
                    std::function<bool(mlir::Pass *)> enablePass,
@@ -65,6 +78,10 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                 std::optional<V0FHEContext> &fheContext,
                 std::function<bool(mlir::Pass *)> enablePass);
 
+mlir::LogicalResult
+foldConstantEncodings(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass);
+
 mlir::LogicalResult batchTFHE(mlir::MLIRContext &context,
                               mlir::ModuleOp &module,
                               std::function<bool(mlir::Pass *)> enablePass,
@@ -81,7 +98,13 @@ extractTFHEStatistics(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerTFHEToConcrete(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass);
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    unsigned smallLweCiphertextModulusLog);
+
+mlir::LogicalResult
+eliminateConcreteBootstraps(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            uint64_t &eliminatedPBS);
 
 mlir::LogicalResult
 computeMemoryUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
@@ -97,6 +120,14 @@ mlir::LogicalResult optimizeTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::function<bool(mlir::Pass *)> enablePass);
 
+mlir::LogicalResult
+shareTFHEKeyswitches(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                     std::function<bool(mlir::Pass *)> enablePass);
+
+mlir::LogicalResult
+groupTFHEManyLutBootstraps(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                           std::function<bool(mlir::Pass *)> enablePass);
+
 mlir::LogicalResult simulateTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::function<bool(mlir::Pass *)> enablePass);
@@ -121,7 +152,8 @@ lowerStdToLLVMDialect(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
                                mlir::ModuleOp &module,
                                std::function<bool(mlir::Pass *)> enablePass,
-                               bool parallelizeLoops);
+                               bool parallelizeLoops,
+                               uint64_t loopOutliningThreshold = 0);
 
 mlir::LogicalResult lowerToCAPI(mlir::MLIRContext &context,
                                 mlir::ModuleOp &module,
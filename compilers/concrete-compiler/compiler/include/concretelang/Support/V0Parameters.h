@@ -6,6 +6,7 @@
 #ifndef CONCRETELANG_SUPPORT_V0Parameter_H_
 #define CONCRETELANG_SUPPORT_V0Parameter_H_
 
+#include <string>
 #include <variant>
 
 #include "llvm/ADT/Optional.h"
@@ -58,6 +59,10 @@ struct V0Parameter {
 
   std::optional<LargeIntegerParameter> largeInteger;
 
+  // Number of mask elements bootstrapped together by the multi-bit blind
+  // rotation, 1 for the classic blind rotation
+  size_t brGroupingFactor = 1;
+
   // TODO remove the shift when we have true polynomial size
   size_t getPolynomialSize() const { return 1 << logPolynomialSize; }
 
@@ -79,7 +84,19 @@ constexpr concrete_optimizer::Encoding DEFAULT_ENCODING =
     concrete_optimizer::Encoding::Auto;
 constexpr bool DEFAULT_CACHE_ON_DISK = true;
 constexpr uint32_t DEFAULT_CIPHERTEXT_MODULUS_LOG = 64;
+// Modulus log of the ciphertexts under the keyswitch output keys, 32 stores
+// them on 32 bits between the keyswitch and the bootstrap
+constexpr uint32_t DEFAULT_SMALL_LWE_CIPHERTEXT_MODULUS_LOG = 64;
 constexpr uint32_t DEFAULT_FFT_PRECISION = 53;
+// Maximal number of lookup tables evaluated by a single bootstrap, 1 disables
+// the many-lut bootstrap
+constexpr uint32_t DEFAULT_MAX_MANY_LUT_COUNT = 1;
+// Maximal grouping factor of the multi-bit bootstrap the optimizer can choose,
+// 1 disables the multi-bit bootstrap
+constexpr uint32_t DEFAULT_MAX_MULTI_BIT_GROUPING_FACTOR = 1;
+// Path of a host-calibrated complexity model written by the concrete-cpu
+// calibration tool, empty to rank parameters with the analytic model
+constexpr const char *DEFAULT_COMPLEXITY_MODEL_PATH = "";
 
 /// The strategy of the crypto optimization
 enum Strategy {
@@ -110,10 +127,14 @@ struct Config {
   concrete_optimizer::Encoding encoding;
   bool cache_on_disk;
   uint32_t ciphertext_modulus_log;
+  uint32_t small_lwe_ciphertext_modulus_log;
   uint32_t fft_precision;
+  uint32_t max_many_lut_count;
+  uint32_t max_multi_bit_grouping_factor;
+  std::string complexity_model_path;
 };
 
-constexpr Config DEFAULT_CONFIG = {
+const Config DEFAULT_CONFIG = {
     UNSPECIFIED_P_ERROR,
     UNSPECIFIED_GLOBAL_P_ERROR,
     DEFAULT_DISPLAY,
@@ -125,7 +146,11 @@ constexpr Config DEFAULT_CONFIG = {
     DEFAULT_ENCODING,
     DEFAULT_CACHE_ON_DISK,
     DEFAULT_CIPHERTEXT_MODULUS_LOG,
+    DEFAULT_SMALL_LWE_CIPHERTEXT_MODULUS_LOG,
     DEFAULT_FFT_PRECISION,
+    DEFAULT_MAX_MANY_LUT_COUNT,
+    DEFAULT_MAX_MULTI_BIT_GROUPING_FACTOR,
+    DEFAULT_COMPLEXITY_MODEL_PATH,
 };
 
 using Dag = rust::Box<concrete_optimizer::OperationDag>;
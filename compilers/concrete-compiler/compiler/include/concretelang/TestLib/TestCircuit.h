@@ -62,6 +62,12 @@ public:
     deleteFolder(d);
   };
 
+  /// Sets the options of the next compilations, which reuse the artifact
+  /// directory of the previous ones.
+  void setCompilationOptions(mlir::concretelang::CompilationOptions options) {
+    compiler.setCompilationOptions(options);
+  }
+
   Result<void> compile(std::string mlirProgram) {
     auto compilationResult = compiler.compile({mlirProgram}, artifactDirectory);
     if (!compilationResult) {
@@ -89,7 +95,8 @@ public:
       auto secretCsprng = csprng::SecretCSPRNG(secretSeed);
       Message<concreteprotocol::KeysetInfo> keysetInfo =
           lib.getProgramInfo().asReader().getKeyset();
-      keyset = Keyset(keysetInfo, secretCsprng, encryptionCsprng);
+      OUTCOME_TRY(keyset, Keyset::generate(keysetInfo, secretCsprng,
+                                           encryptionCsprng));
     }
     return outcome::success();
   }
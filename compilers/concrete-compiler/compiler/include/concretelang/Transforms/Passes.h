@@ -6,9 +6,11 @@
 #ifndef CONCRETELANG_TRANSFORMS_PASS_H
 #define CONCRETELANG_TRANSFORMS_PASS_H
 
+#include <mlir/Dialect/Arith/IR/Arith.h>
 #include <mlir/Dialect/Func/IR/FuncOps.h>
 #include <mlir/Dialect/MemRef/IR/MemRef.h>
 #include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
 #include <mlir/Pass/Pass.h>
 
 #define GEN_PASS_CLASSES
@@ -22,6 +24,10 @@ createCollapseParallelLoops();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createForLoopToParallel();
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 createBatchingPass(int64_t maxBatchSize = std::numeric_limits<int64_t>::max());
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createConstantDenseFoldingPass();
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createLoopOutliningPass(uint64_t minOperations = 0);
 } // namespace concretelang
 } // namespace mlir
 
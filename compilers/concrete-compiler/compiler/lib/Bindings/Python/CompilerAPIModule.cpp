@@ -93,8 +93,38 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
            })
       .def("set_compress_inputs", [](CompilationOptions &options,
                                      bool b) { options.compressInputs = b; })
+      .def("set_compress_outputs", [](CompilationOptions &options,
+                                      bool b) { options.compressOutputs = b; })
+      .def("set_emit_circuit_libraries",
+           [](CompilationOptions &options, bool b) {
+             options.emitCircuitLibraries = b;
+           })
       .def("set_optimize_concrete", [](CompilationOptions &options,
                                        bool b) { options.optimizeTFHE = b; })
+      .def("set_compose_lookup_tables",
+           [](CompilationOptions &options, bool b) {
+             options.composeLookupTables = b;
+           })
+      .def("set_minimize_bit_widths",
+           [](CompilationOptions &options, bool b) {
+             options.minimizeBitWidths = b;
+           })
+      .def("set_fold_constant_encodings",
+           [](CompilationOptions &options, bool b) {
+             options.foldConstantEncodings = b;
+           })
+      .def("set_winograd_conv2d",
+           [](CompilationOptions &options, bool b) {
+             options.winogradConv2d = b;
+           })
+      .def("set_multithread_passes",
+           [](CompilationOptions &options, bool b) {
+             options.multithreadPasses = b;
+           })
+      .def("set_loop_outlining_threshold",
+           [](CompilationOptions &options, uint64_t threshold) {
+             options.loopOutliningThreshold = threshold;
+           })
       .def("set_p_error",
            [](CompilationOptions &options, double p_error) {
              options.optimizerConfig.p_error = p_error;
@@ -115,6 +145,24 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
            [](CompilationOptions &options, int security_level) {
              options.optimizerConfig.security = security_level;
            })
+      .def("set_max_many_lut_count",
+           [](CompilationOptions &options, unsigned max_many_lut_count) {
+             options.optimizerConfig.max_many_lut_count = max_many_lut_count;
+           })
+      .def("set_max_multi_bit_grouping_factor",
+           [](CompilationOptions &options, unsigned grouping_factor) {
+             options.optimizerConfig.max_multi_bit_grouping_factor =
+                 grouping_factor;
+           })
+      .def("set_small_lwe_ciphertext_modulus_log",
+           [](CompilationOptions &options, unsigned modulus_log) {
+             options.optimizerConfig.small_lwe_ciphertext_modulus_log =
+                 modulus_log;
+           })
+      .def("set_complexity_model_path",
+           [](CompilationOptions &options, std::string path) {
+             options.optimizerConfig.complexity_model_path = path;
+           })
       .def("set_v0_parameter",
            [](CompilationOptions &options, size_t glweDimension,
               size_t logPolynomialSize, size_t nSmall, size_t brLevel,
@@ -209,7 +257,10 @@ void mlir::concretelang::python::populateCompilerAPISubmodule(
                     &mlir::concretelang::CompilationFeedback::statistics)
       .def_readonly(
           "memory_usage_per_location",
-          &mlir::concretelang::CompilationFeedback::memoryUsagePerLoc);
+          &mlir::concretelang::CompilationFeedback::memoryUsagePerLoc)
+      .def_readonly(
+          "eliminated_pbs_count",
+          &mlir::concretelang::CompilationFeedback::eliminatedPbsCount);
 
   pybind11::class_<mlir::concretelang::CompilationContext,
                    std::shared_ptr<mlir::concretelang::CompilationContext>>(
@@ -126,8 +126,10 @@ key_set(concretelang::clientlib::ClientParameters clientParameters,
   } else {
     concretelang::csprng::SecretCSPRNG secCsprng(secretSeed);
     concretelang::csprng::EncryptionCSPRNG encCsprng(encryptionSeed);
-    auto keyset = Keyset(clientParameters.programInfo.asReader().getKeyset(),
-                         secCsprng, encCsprng);
+    GET_OR_THROW_RESULT(
+        Keyset keyset,
+        Keyset::generate(clientParameters.programInfo.asReader().getKeyset(),
+                         secCsprng, encCsprng));
     concretelang::clientlib::KeySet output{keyset};
     return std::make_unique<concretelang::clientlib::KeySet>(std::move(output));
   }
@@ -69,6 +69,7 @@ class CompilationFeedback(WrapperCpp):
         )
         self.statistics = compilation_feedback.statistics
         self.memory_usage_per_location = compilation_feedback.memory_usage_per_location
+        self.eliminated_pbs_count = compilation_feedback.eliminated_pbs_count
 
         super().__init__(compilation_feedback)
 
@@ -100,6 +100,35 @@ class CompilationOptions(WrapperCpp):
             raise TypeError("can't set the option to a non-boolean value")
         self.cpp().set_compress_inputs(compress_inputs)
 
+    def set_compress_outputs(self, compress_outputs: bool):
+        """Set option for output compression.
+
+        Args:
+            compress_outputs (bool): whether to modulus switch and bit-pack the output ciphertexts
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(compress_outputs, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_compress_outputs(compress_outputs)
+
+    def set_emit_circuit_libraries(self, emit_circuit_libraries: bool):
+        """Set option for emitting one object and one shared library per circuit.
+
+        The server then only loads the circuits it uses, and recompiling a program
+        reuses the objects of its unchanged circuits.
+
+        Args:
+            emit_circuit_libraries (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(emit_circuit_libraries, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_emit_circuit_libraries(emit_circuit_libraries)
+
     def set_verify_diagnostics(self, verify_diagnostics: bool):
         """Set option for diagnostics verification.
 
@@ -139,6 +168,89 @@ class CompilationOptions(WrapperCpp):
             raise TypeError("can't set the option to a non-boolean value")
         self.cpp().set_optimize_concrete(optimize)
 
+    def set_compose_lookup_tables(self, compose: bool):
+        """Set flag to enable/disable composition of table lookups with constant tables.
+
+        Args:
+            compose (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(compose, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_compose_lookup_tables(compose)
+
+    def set_minimize_bit_widths(self, minimize: bool):
+        """Set flag to enable/disable shrinking of encrypted integers to the ranges of their values.
+
+        Args:
+            minimize (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(minimize, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_minimize_bit_widths(minimize)
+
+    def set_fold_constant_encodings(self, fold: bool):
+        """Set flag to enable/disable the encoding of clear constant tensors at compile time.
+
+        Args:
+            fold (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(fold, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_fold_constant_encodings(fold)
+
+    def set_winograd_conv2d(self, winograd: bool):
+        """Set flag to enable/disable the Winograd form of 3x3 convolutions with clear weights.
+
+        Args:
+            winograd (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(winograd, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_winograd_conv2d(winograd)
+
+    def set_multithread_passes(self, multithread: bool):
+        """Set flag to enable/disable running the passes on the functions in parallel.
+
+        Args:
+            multithread (bool): whether to turn it on or off
+
+        Raises:
+            TypeError: if the value to set is not boolean
+        """
+        if not isinstance(multithread, bool):
+            raise TypeError("can't set the option to a non-boolean value")
+        self.cpp().set_multithread_passes(multithread)
+
+    def set_loop_outlining_threshold(self, threshold: int):
+        """Set the minimal number of operations of the loops outlined into separate functions.
+
+        Outlined loops are lowered in parallel when the passes are multithreaded.
+
+        Args:
+            threshold (int): minimal number of operations, 0 disables the outlining
+
+        Raises:
+            TypeError: if the value to set is not int
+            ValueError: if the value to set is negative
+        """
+        if not isinstance(threshold, int):
+            raise TypeError("can't set loop_outlining_threshold to a non-int value")
+        if threshold < 0:
+            raise ValueError("loop_outlining_threshold must be non-negative")
+        self.cpp().set_loop_outlining_threshold(threshold)
+
     def set_funcname(self, funcname: str):
         """Set entrypoint function name.
 
@@ -228,6 +340,79 @@ class CompilationOptions(WrapperCpp):
             raise TypeError("can't set security_level to a non-int value")
         self.cpp().set_security_level(security_level)
 
+    def set_max_many_lut_count(self, max_many_lut_count: int):
+        """Set the maximal number of lookup tables evaluated by a single bootstrap.
+
+        Lookup tables applied on the same input can be evaluated by a single
+        bootstrap, at the cost of a lower noise budget for that input.
+
+        Args:
+            max_many_lut_count (int): a power of two, 1 disables the many-lut bootstrap
+
+        Raises:
+            TypeError: if the value to set is not int
+            ValueError: if the value to set is not a power of two
+        """
+        if not isinstance(max_many_lut_count, int):
+            raise TypeError("can't set max_many_lut_count to a non-int value")
+        if max_many_lut_count < 1 or (max_many_lut_count & (max_many_lut_count - 1)):
+            raise ValueError("max_many_lut_count must be a power of two")
+        self.cpp().set_max_many_lut_count(max_many_lut_count)
+
+    def set_max_multi_bit_grouping_factor(self, grouping_factor: int):
+        """Set the maximal grouping factor of the multi-bit bootstrap.
+
+        The optimizer keeps the classic bootstrap unless a multi-bit bootstrap
+        with a grouping factor up to this value has a lower complexity.
+
+        Args:
+            grouping_factor (int): between 1 and 4, 1 disables the multi-bit bootstrap
+
+        Raises:
+            TypeError: if the value to set is not int
+            ValueError: if the value to set is not in interval [1; 4]
+        """
+        if not isinstance(grouping_factor, int):
+            raise TypeError("can't set grouping_factor to a non-int value")
+        if not 1 <= grouping_factor <= 4:
+            raise ValueError("grouping_factor must be in interval [1; 4]")
+        self.cpp().set_max_multi_bit_grouping_factor(grouping_factor)
+
+    def set_small_lwe_ciphertext_modulus_log(self, modulus_log: int):
+        """Set the ciphertext modulus of the ciphertexts between a keyswitch and a bootstrap.
+
+        With 32, these ciphertexts are stored on 32 bits, which halves their
+        memory traffic. Only supported on CPU, with the dag-mono or V0 optimizer.
+
+        Args:
+            modulus_log (int): log2 of the ciphertext modulus, 32 or 64
+
+        Raises:
+            TypeError: if the value to set is not int
+            ValueError: if the value to set is neither 32 nor 64
+        """
+        if not isinstance(modulus_log, int):
+            raise TypeError("can't set modulus_log to a non-int value")
+        if modulus_log not in (32, 64):
+            raise ValueError("modulus_log must be 32 or 64")
+        self.cpp().set_small_lwe_ciphertext_modulus_log(modulus_log)
+
+    def set_complexity_model_path(self, path: str):
+        """Set the path of a host-calibrated complexity model for the optimizer.
+
+        The model is written by the `calibrate_complexity` example of concrete-cpu,
+        an empty path ranks the crypto parameters with the analytic model.
+
+        Args:
+            path (str): path of the calibrated complexity model
+
+        Raises:
+            TypeError: if the value to set is not str
+        """
+        if not isinstance(path, str):
+            raise TypeError("can't set path to a non-str value")
+        self.cpp().set_complexity_model_path(path)
+
     def set_v0_parameter(
         self,
         glwe_dim: int,
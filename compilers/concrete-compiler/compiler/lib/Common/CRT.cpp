@@ -77,6 +77,19 @@ uint64_t iCrt(std::vector<int64_t> moduli, std::vector<int64_t> remainders) {
   return result % product;
 }
 
+std::vector<uint64_t> iCrtCoefficients(std::vector<int64_t> moduli) {
+  uint64_t product = productOfModuli(moduli);
+  std::vector<uint64_t> coefficients(moduli.size());
+  for (size_t i = 0; i < moduli.size(); i++) {
+    uint64_t tmp = product / moduli[i];
+    coefficients[i] = (uint64_t)(((__uint128_t)modInverse(tmp % moduli[i],
+                                                          moduli[i]) *
+                                  tmp) %
+                                 product);
+  }
+  return coefficients;
+}
+
 uint64_t encode(int64_t plaintext, uint64_t modulus, uint64_t product) {
   // values are represented on the interval [0; product[ so we represent
   // plantext on this interval
@@ -16,6 +16,8 @@
 #include <stdlib.h>
 
 using concretelang::csprng::EncryptionCSPRNG;
+using concretelang::error::Result;
+using concretelang::error::StringError;
 using concretelang::csprng::SecretCSPRNG;
 using concretelang::protocol::Message;
 using concretelang::protocol::protoPayloadToSharedVector;
@@ -120,11 +122,13 @@ const std::vector<uint64_t> &LweSecretKey::getBuffer() const {
   return *this->buffer;
 }
 
-LweBootstrapKey::LweBootstrapKey(
+Result<LweBootstrapKey> LweBootstrapKey::generate(
     Message<concreteprotocol::LweBootstrapKeyInfo> info,
     const LweSecretKey &inputKey, const LweSecretKey &outputKey,
-    EncryptionCSPRNG &csprng)
-    : LweBootstrapKey(info) {
+    EncryptionCSPRNG &csprng) {
+  LweBootstrapKey key(info);
+  auto &buffer = key.buffer;
+  auto &seededBuffer = key.seededBuffer;
   assert(inputKey.info.asReader().getParams().getLweDimension() ==
          info.asReader().getParams().getInputLweDimension());
   assert(outputKey.info.asReader().getParams().getLweDimension() ==
@@ -136,6 +140,19 @@ LweBootstrapKey::LweBootstrapKey(
 
   switch (compression) {
   case concreteprotocol::Compression::NONE:
+    if (params.getGroupingFactor() > 1) {
+      buffer->resize(concrete_cpu_multi_bit_bootstrap_key_size_u64(
+          params.getLevelCount(), params.getGlweDimension(),
+          params.getPolynomialSize(), params.getInputLweDimension(),
+          params.getGroupingFactor()));
+      concrete_cpu_init_lwe_multi_bit_bootstrap_key_u64(
+          buffer->data(), inputKey.buffer->data(), outputKey.buffer->data(),
+          params.getInputLweDimension(), params.getPolynomialSize(),
+          params.getGlweDimension(), params.getLevelCount(),
+          params.getBaseLog(), params.getGroupingFactor(),
+          params.getVariance(), Parallelism::Rayon, csprng.ptr);
+      break;
+    }
     buffer->resize(concrete_cpu_bootstrap_key_size_u64(
         params.getLevelCount(), params.getGlweDimension(),
         params.getPolynomialSize(), params.getInputLweDimension()));
@@ -146,6 +163,9 @@ LweBootstrapKey::LweBootstrapKey(
         params.getVariance(), Parallelism::Rayon, csprng.ptr);
     break;
   case concreteprotocol::Compression::SEED:
+    if (params.getGroupingFactor() > 1)
+      return StringError(
+          "Unsupported seed compression for multi-bit bootstrap key");
     seededBuffer->resize(concrete_cpu_seeded_bootstrap_key_size_u64(
                              params.getLevelCount(), params.getGlweDimension(),
                              params.getPolynomialSize(),
@@ -162,9 +182,10 @@ LweBootstrapKey::LweBootstrapKey(
         Parallelism::Rayon);
     break;
   default:
-    assert(false && "Unsupported compression type for bootstrap key");
+    return StringError("Unsupported compression type for bootstrap key");
   }
-};
+  return key;
+}
 
 LweBootstrapKey LweBootstrapKey::fromProto(
     const Message<concreteprotocol::LweBootstrapKey> &proto) {
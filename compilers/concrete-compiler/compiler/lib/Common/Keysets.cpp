@@ -102,15 +102,23 @@ Message<concreteprotocol::ServerKeyset> ServerKeyset::toProto() const {
   return output;
 }
 
-Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
-               SecretCSPRNG &secretCsprng, EncryptionCSPRNG &encryptionCsprng) {
+Result<Keyset>
+Keyset::generate(const Message<concreteprotocol::KeysetInfo> &info,
+                 SecretCSPRNG &secretCsprng,
+                 EncryptionCSPRNG &encryptionCsprng) {
+  Keyset keyset;
+  auto &client = keyset.client;
+  auto &server = keyset.server;
   for (auto keyInfo : info.asReader().getLweSecretKeys()) {
     client.lweSecretKeys.push_back(LweSecretKey(keyInfo, secretCsprng));
   }
   for (auto keyInfo : info.asReader().getLweBootstrapKeys()) {
-    server.lweBootstrapKeys.push_back(LweBootstrapKey(
-        keyInfo, client.lweSecretKeys[keyInfo.getInputId()],
-        client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
+    OUTCOME_TRY(auto key,
+                LweBootstrapKey::generate(
+                    keyInfo, client.lweSecretKeys[keyInfo.getInputId()],
+                    client.lweSecretKeys[keyInfo.getOutputId()],
+                    encryptionCsprng));
+    server.lweBootstrapKeys.push_back(key);
   }
   for (auto keyInfo : info.asReader().getLweKeyswitchKeys()) {
     server.lweKeyswitchKeys.push_back(LweKeyswitchKey(
@@ -122,6 +130,7 @@ Keyset::Keyset(const Message<concreteprotocol::KeysetInfo> &info,
         keyInfo, client.lweSecretKeys[keyInfo.getInputId()],
         client.lweSecretKeys[keyInfo.getOutputId()], encryptionCsprng));
   }
+  return keyset;
 }
 
 Keyset Keyset::fromProto(const Message<concreteprotocol::Keyset> &proto) {
@@ -382,7 +391,8 @@ KeysetCache::getKeyset(const Message<concreteprotocol::KeysetInfo> &keysetInfo,
 
   auto encryptionCsprng = csprng::EncryptionCSPRNG(encryption_seed);
   auto secretCsprng = csprng::SecretCSPRNG(secret_seed);
-  Keyset keyset(keysetInfo, secretCsprng, encryptionCsprng);
+  OUTCOME_TRY(auto keyset,
+              Keyset::generate(keysetInfo, secretCsprng, encryptionCsprng));
 
   OUTCOME_TRYV(saveKeys(keyset, folderPath));
 
@@ -12,9 +12,13 @@
 #include "concretelang/Common/Keysets.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Runtime/simulation.h"
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdlib.h>
 #include <string>
+#include <thread>
+#include <vector>
 
 using concretelang::error::Result;
 using concretelang::keysets::ClientKeyset;
@@ -36,6 +40,35 @@ typedef std::function<Result<void>(const TransportValue &)>
 /// A private type for transformers working purely on values.
 typedef std::function<Value(Value)> Transformer;
 
+namespace {
+
+/// Minimal number of elements processed by a thread in the element-wise
+/// transformers, below which spawning a thread costs more than it saves.
+const size_t MIN_ELEMENTS_PER_THREAD = 1024;
+
+/// Calls `work(begin, end)` on the ranges of a partition of `[0, count)`,
+/// each range being processed by its own thread.
+void parallelForRanges(size_t count,
+                       const std::function<void(size_t, size_t)> &work) {
+  size_t threadCount = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      std::max<size_t>(1, count / MIN_ELEMENTS_PER_THREAD));
+  if (threadCount == 1) {
+    work(0, count);
+    return;
+  }
+  size_t rangeSize = (count + threadCount - 1) / threadCount;
+  std::vector<std::thread> threads;
+  for (size_t begin = 0; begin < count; begin += rangeSize) {
+    threads.emplace_back(work, begin, std::min(count, begin + rangeSize));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace
+
 Result<ValueVerifier> getIndexInputValueVerifier(
     const Message<concreteprotocol::GateInfo> &gateInfo) {
   if (!gateInfo.asReader().getTypeInfo().hasIndex()) {
@@ -423,13 +456,15 @@ Result<Transformer> getCrtModeIntegerEncodingTransformer(
     outputTensor.dimensions.push_back(size);
     outputTensor.values.resize(outputTensor.values.size() * size);
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      auto value = inputTensor.values[i];
-      for (size_t j = 0; j < (size_t)size; j++) {
-        outputTensor.values[i * size + j] =
-            concretelang::crt::encode(value, moduli[j], productOfModuli);
+    parallelForRanges(inputTensor.values.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        auto value = inputTensor.values[i];
+        for (size_t j = 0; j < (size_t)size; j++) {
+          outputTensor.values[i * size + j] =
+              concretelang::crt::encode(value, moduli[j], productOfModuli);
+        }
       }
-    }
+    });
 
     return Value{outputTensor};
   };
@@ -441,39 +476,37 @@ Result<Transformer> getCrtModeIntegerDecodingTransformer(
   for (auto modulus : info.asReader().getMode().getCrt().getModuli()) {
     moduli.push_back(modulus);
   }
-  std::vector<int64_t> remainders(
-      info.asReader().getMode().getCrt().getModuli().size());
   auto size = info.asReader().getMode().getCrt().getModuli().size();
   auto isSigned = info.asReader().getIsSigned();
+  auto productOfModuli = crt::productOfModuli(moduli);
+  // The inverse crt of the remainders is the sum of their products with
+  // these coefficients, modulo the product of moduli
+  auto coefficients = crt::iCrtCoefficients(moduli);
 
-  return [=](Value input) mutable {
+  return [=](Value input) {
     auto inputTensor = input.getTensor<uint64_t>().value();
     auto outputTensor = Tensor<uint64_t>(inputTensor);
     outputTensor.dimensions.pop_back();
     outputTensor.values.resize(outputTensor.values.size() / size);
 
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
-      for (size_t j = 0; j < (size_t)size; j++) {
-        remainders[j] =
-            crt::decode(inputTensor.values[i * size + j], moduli[j]);
-      }
-
-      // Compute the inverse crt
-      uint64_t output = crt::iCrt(moduli, remainders);
-
-      // Further decode signed integers
-      if (isSigned) {
-        uint64_t maxPos = 1;
-        for (auto prime : moduli) {
-          maxPos *= prime;
+    auto count = outputTensor.values.size();
+    parallelForRanges(count, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        __uint128_t sum = 0;
+        for (size_t j = 0; j < (size_t)size; j++) {
+          sum += (__uint128_t)crt::decode(inputTensor.values[i * size + j],
+                                          moduli[j]) *
+                 coefficients[j];
         }
-        maxPos /= 2;
-        if (output >= maxPos) {
-          output -= maxPos * 2;
+        uint64_t output = (uint64_t)(sum % productOfModuli);
+
+        // Further decode signed integers
+        if (isSigned && output >= productOfModuli / 2) {
+          output -= (productOfModuli / 2) * 2;
         }
+        outputTensor.values[i] = output;
       }
-      outputTensor.values[i] = output;
-    }
+    });
 
     Value output;
     if (isSigned) {
@@ -503,11 +536,12 @@ Result<Transformer> getEncryptionTransformer(
     outputTensor.dimensions.push_back(lweSize);
     outputTensor.values.resize(outputTensor.values.size() * lweSize);
 
-    for (size_t i = 0; i < inputTensor.values.size(); i++) {
-      concrete_cpu_encrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &outputTensor.values[i * lweSize],
-          inputTensor.values[i], lweDimension, variance, csprng->ptr);
-    }
+    // Each ciphertext (e.g. each block of a crt encoded integer) is
+    // encrypted with its own stream forked from the csprng
+    concrete_cpu_encrypt_lwe_ciphertext_list_u64(
+        key.getRawPtr(), outputTensor.values.data(), inputTensor.values.data(),
+        inputTensor.values.size(), lweDimension, variance, Parallelism::Rayon,
+        csprng->ptr);
 
     return Value{outputTensor};
   };
@@ -546,11 +580,14 @@ Result<Transformer> getDecryptionTransformer(
     outputTensor.dimensions.pop_back();
     outputTensor.values.resize(outputTensor.values.size() / lweSize);
 
-    for (size_t i = 0; i < outputTensor.values.size(); i++) {
-      concrete_cpu_decrypt_lwe_ciphertext_u64(
-          key.getRawPtr(), &inputTensor.values[i * lweSize], lweDimension,
-          &outputTensor.values[i]);
-    }
+    auto count = outputTensor.values.size();
+    parallelForRanges(count, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        concrete_cpu_decrypt_lwe_ciphertext_u64(
+            key.getRawPtr(), &inputTensor.values[i * lweSize], lweDimension,
+            &outputTensor.values[i]);
+      }
+    });
 
     return Value{outputTensor};
   };
@@ -568,6 +605,90 @@ Result<Transformer> getNoneDecompressionTransformer() {
   return [](auto input) { return input; };
 }
 
+size_t getModulusSwitchedLweSize(size_t lweSize, uint32_t modulusLog) {
+  return (lweSize * modulusLog + 63) / 64;
+}
+
+/// Returns a transformer switching the lwe ciphertexts of a value to the
+/// modulus `2^compressionModulusLog`, and packing the `compressionModulusLog`
+/// bits of their elements in 64 bits words. Each ciphertext starts on a new
+/// word.
+Result<Transformer> getModulusSwitchCompressionTransformer(
+    const Message<concreteprotocol::LweCiphertextTypeInfo> &info) {
+  auto modulusLog = info.asReader().getCompressionModulusLog();
+  if (modulusLog == 0 || modulusLog >= 64) {
+    return StringError("Invalid modulus of modulus switched lwe ciphertext");
+  }
+  auto lweSize = info.asReader().getEncryption().getLweDimension() + 1;
+  auto packedSize = getModulusSwitchedLweSize(lweSize, modulusLog);
+  uint64_t mask = (((uint64_t)1) << modulusLog) - 1;
+
+  return [=](Value input) {
+    auto inputTensor = input.getTensor<uint64_t>().value();
+    auto count = inputTensor.values.size() / lweSize;
+    auto outputTensor = Tensor<uint64_t>(
+        std::vector<uint64_t>(count * packedSize, 0), inputTensor.dimensions);
+    outputTensor.dimensions.back() = packedSize;
+
+    parallelForRanges(count, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        auto ciphertext = &inputTensor.values[i * lweSize];
+        auto packed = &outputTensor.values[i * packedSize];
+        for (size_t j = 0; j < lweSize; j++) {
+          // Rounds to the closest multiple of 2^(64 - modulusLog)
+          uint64_t element =
+              (((ciphertext[j] >> (63 - modulusLog)) + 1) >> 1) & mask;
+          size_t bit = j * modulusLog;
+          packed[bit / 64] |= element << (bit % 64);
+          if (bit % 64 + modulusLog > 64) {
+            packed[bit / 64 + 1] |= element >> (64 - bit % 64);
+          }
+        }
+      }
+    });
+
+    return Value{outputTensor};
+  };
+}
+
+/// Returns a transformer unpacking the lwe ciphertexts compressed by the
+/// transformer above, back to the native modulus.
+Result<Transformer> getModulusSwitchDecompressionTransformer(
+    const Message<concreteprotocol::LweCiphertextTypeInfo> &info) {
+  auto modulusLog = info.asReader().getCompressionModulusLog();
+  if (modulusLog == 0 || modulusLog >= 64) {
+    return StringError("Invalid modulus of modulus switched lwe ciphertext");
+  }
+  auto lweSize = info.asReader().getEncryption().getLweDimension() + 1;
+  auto packedSize = getModulusSwitchedLweSize(lweSize, modulusLog);
+  uint64_t mask = (((uint64_t)1) << modulusLog) - 1;
+
+  return [=](Value input) {
+    auto inputTensor = input.getTensor<uint64_t>().value();
+    auto count = inputTensor.values.size() / packedSize;
+    auto outputTensor = Tensor<uint64_t>(
+        std::vector<uint64_t>(count * lweSize), inputTensor.dimensions);
+    outputTensor.dimensions.back() = lweSize;
+
+    parallelForRanges(count, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        auto packed = &inputTensor.values[i * packedSize];
+        auto ciphertext = &outputTensor.values[i * lweSize];
+        for (size_t j = 0; j < lweSize; j++) {
+          size_t bit = j * modulusLog;
+          uint64_t element = packed[bit / 64] >> (bit % 64);
+          if (bit % 64 + modulusLog > 64) {
+            element |= packed[bit / 64 + 1] << (64 - bit % 64);
+          }
+          ciphertext[j] = (element & mask) << (64 - modulusLog);
+        }
+      }
+    });
+
+    return Value{outputTensor};
+  };
+}
+
 Result<Transformer> getBooleanDecodingTransformer() {
   return [=](Value input) {
     auto inputTensor = input.getTensor<uint64_t>().value();
@@ -844,13 +965,19 @@ Result<ReturnTransformer> TransformerFactory::getLweCiphertextReturnTransformer(
 
   /// Generating the compression transformer.
   Transformer compressionTransformer;
-  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() ==
-      concreteprotocol::Compression::NONE) {
+  auto compression =
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression();
+  if (compression == concreteprotocol::Compression::NONE) {
     OUTCOME_TRY(compressionTransformer, getNoneCompressionTransformer());
+  } else if (compression == concreteprotocol::Compression::MODULUS_SWITCH &&
+             !useSimulation) {
+    OUTCOME_TRY(compressionTransformer,
+                getModulusSwitchCompressionTransformer(
+                    gateInfo.asReader().getTypeInfo().getLweCiphertext()));
   } else {
     return StringError(
-        "Only none compression is currently supported for lwe ciphertext "
-        "currently.");
+        "Only none and modulus switch compressions are currently supported "
+        "for lwe ciphertext outputs.");
   }
 
   // Generating the verifier.
@@ -892,13 +1019,19 @@ Result<OutputTransformer> TransformerFactory::getLweCiphertextOutputTransformer(
 
   /// Generating the decompression transformer.
   Transformer decompressionTransformer;
-  if (gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression() ==
-      concreteprotocol::Compression::NONE) {
+  auto compression =
+      gateInfo.asReader().getTypeInfo().getLweCiphertext().getCompression();
+  if (compression == concreteprotocol::Compression::NONE) {
     OUTCOME_TRY(decompressionTransformer, getNoneDecompressionTransformer());
+  } else if (compression == concreteprotocol::Compression::MODULUS_SWITCH &&
+             !useSimulation) {
+    OUTCOME_TRY(decompressionTransformer,
+                getModulusSwitchDecompressionTransformer(
+                    gateInfo.asReader().getTypeInfo().getLweCiphertext()));
   } else {
     return StringError(
-        "Only none compression is currently supported for lwe ciphertext "
-        "currently.");
+        "Only none and modulus switch compressions are currently supported "
+        "for lwe ciphertext outputs.");
   }
 
   /// Generating the decryption transformer.
@@ -28,6 +28,7 @@ char memref_mul_cleartext_lwe_ciphertext_u64[] =
 char memref_negate_lwe_ciphertext_u64[] = "memref_negate_lwe_ciphertext_u64";
 char memref_keyswitch_lwe_u64[] = "memref_keyswitch_lwe_u64";
 char memref_bootstrap_lwe_u64[] = "memref_bootstrap_lwe_u64";
+char memref_many_bootstrap_lwe_u64[] = "memref_many_bootstrap_lwe_u64";
 char memref_batched_add_lwe_ciphertexts_u64[] =
     "memref_batched_add_lwe_ciphertexts_u64";
 char memref_batched_add_plaintext_lwe_ciphertext_u64[] =
@@ -44,6 +45,14 @@ char memref_batched_keyswitch_lwe_u64[] = "memref_batched_keyswitch_lwe_u64";
 char memref_batched_bootstrap_lwe_u64[] = "memref_batched_bootstrap_lwe_u64";
 char memref_batched_mapped_bootstrap_lwe_u64[] =
     "memref_batched_mapped_bootstrap_lwe_u64";
+char memref_keyswitch_lwe_u64_to_u32[] = "memref_keyswitch_lwe_u64_to_u32";
+char memref_bootstrap_lwe_u32_to_u64[] = "memref_bootstrap_lwe_u32_to_u64";
+char memref_batched_keyswitch_lwe_u64_to_u32[] =
+    "memref_batched_keyswitch_lwe_u64_to_u32";
+char memref_batched_bootstrap_lwe_u32_to_u64[] =
+    "memref_batched_bootstrap_lwe_u32_to_u64";
+char memref_batched_mapped_bootstrap_lwe_u32_to_u64[] =
+    "memref_batched_mapped_bootstrap_lwe_u32_to_u64";
 
 char memref_keyswitch_async_lwe_u64[] = "memref_keyswitch_async_lwe_u64";
 char memref_bootstrap_async_lwe_u64[] = "memref_bootstrap_async_lwe_u64";
@@ -60,10 +69,13 @@ char memref_expand_lut_in_trivial_glwe_ct_u64[] =
     "memref_expand_lut_in_trivial_glwe_ct_u64";
 
 char memref_wop_pbs_crt_buffer[] = "memref_wop_pbs_crt_buffer";
+char memref_batched_wop_pbs_crt_buffer[] = "memref_batched_wop_pbs_crt_buffer";
 
 char memref_encode_plaintext_with_crt[] = "memref_encode_plaintext_with_crt";
 char memref_encode_expand_lut_for_bootstrap[] =
     "memref_encode_expand_lut_for_bootstrap";
+char memref_encode_expand_many_luts_for_bootstrap[] =
+    "memref_encode_expand_many_luts_for_bootstrap";
 char memref_encode_lut_for_crt_woppbs[] = "memref_encode_lut_for_crt_woppbs";
 char memref_trace[] = "memref_trace";
 
@@ -74,6 +86,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 1);
   auto memref2DType =
       mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 2);
+  auto memref3DType =
+      mlir::concretelang::getDynamicMemrefWithUnknownOffset(rewriter, 3);
+  auto memref1DI32Type = mlir::concretelang::getDynamicMemrefWithUnknownOffset(
+      rewriter, 1, rewriter.getI32Type());
+  auto memref2DI32Type = mlir::concretelang::getDynamicMemrefWithUnknownOffset(
+      rewriter, 2, rewriter.getI32Type());
   auto futureType =
       mlir::concretelang::RT::FutureType::get(rewriter.getIndexType());
   auto contextType =
@@ -110,6 +128,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                         memref1DType, i32Type, i32Type, i32Type,
                                         i32Type, i32Type, i32Type, contextType},
                                        {});
+  } else if (funcName == memref_many_bootstrap_lwe_u64) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DType, memref1DType, memref1DType, i32Type, i32Type, i32Type,
+         i32Type, i32Type, i32Type, i32Type, contextType},
+        {});
   } else if (funcName == memref_keyswitch_async_lwe_u64) {
     // Todo Answer this question: Isn't it dead ?
     funcType = mlir::FunctionType::get(
@@ -162,6 +186,36 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                         memref2DType, i32Type, i32Type, i32Type,
                                         i32Type, i32Type, i32Type, contextType},
                                        {});
+  } else if (funcName == memref_keyswitch_lwe_u64_to_u32) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref1DI32Type, memref1DType, i32Type, i32Type, i32Type, i32Type,
+         i32Type, contextType},
+        {});
+  } else if (funcName == memref_bootstrap_lwe_u32_to_u64) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref1DType, memref1DI32Type,
+                                        memref1DType, i32Type, i32Type, i32Type,
+                                        i32Type, i32Type, i32Type, contextType},
+                                       {});
+  } else if (funcName == memref_batched_keyswitch_lwe_u64_to_u32) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref2DI32Type, memref2DType, i32Type, i32Type, i32Type, i32Type,
+         i32Type, contextType},
+        {});
+  } else if (funcName == memref_batched_bootstrap_lwe_u32_to_u64) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref2DType, memref2DI32Type,
+                                        memref1DType, i32Type, i32Type, i32Type,
+                                        i32Type, i32Type, i32Type, contextType},
+                                       {});
+  } else if (funcName == memref_batched_mapped_bootstrap_lwe_u32_to_u64) {
+    funcType = mlir::FunctionType::get(rewriter.getContext(),
+                                       {memref2DType, memref2DI32Type,
+                                        memref2DType, i32Type, i32Type, i32Type,
+                                        i32Type, i32Type, i32Type, contextType},
+                                       {});
   } else if (funcName == memref_await_future) {
     funcType = mlir::FunctionType::get(
         rewriter.getContext(),
@@ -176,11 +230,15 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
                                            memref1DType,
                                        },
                                        {});
-  } else if (funcName == memref_wop_pbs_crt_buffer) {
+  } else if (funcName == memref_wop_pbs_crt_buffer ||
+             funcName == memref_batched_wop_pbs_crt_buffer) {
+    auto ciphertextType = funcName == memref_wop_pbs_crt_buffer
+                              ? memref2DType
+                              : memref3DType;
     funcType = mlir::FunctionType::get(rewriter.getContext(),
                                        {
-                                           memref2DType,
-                                           memref2DType,
+                                           ciphertextType,
+                                           ciphertextType,
                                            memref2DType,
                                            memref1DType,
                                            rewriter.getI32Type(),
@@ -211,6 +269,12 @@ mlir::LogicalResult insertForwardDeclarationOfTheCAPI(
         {memref1DType, memref1DType, rewriter.getI32Type(),
          rewriter.getI32Type(), rewriter.getI1Type()},
         {});
+  } else if (funcName == memref_encode_expand_many_luts_for_bootstrap) {
+    funcType = mlir::FunctionType::get(
+        rewriter.getContext(),
+        {memref1DType, memref2DType, rewriter.getI32Type(),
+         rewriter.getI32Type(), rewriter.getI1Type()},
+        {});
   } else if (funcName == memref_encode_lut_for_crt_woppbs) {
     funcType = mlir::FunctionType::get(
         rewriter.getContext(),
@@ -283,6 +347,34 @@ private:
       addOperands;
 };
 
+/// Returns true if one of the buffers of `op` holds ciphertexts stored on 32
+/// bits.
+bool hasSmallLweBuffer(mlir::Operation *op) {
+  return llvm::any_of(op->getOperandTypes(), [](mlir::Type type) {
+    auto memrefTy = type.dyn_cast<mlir::MemRefType>();
+    return memrefTy != nullptr && memrefTy.getElementType().isInteger(32);
+  });
+}
+
+/// Rewrites the keyswitches and bootstraps on ciphertexts stored on 32 bits to
+/// a call to the `callee` variant of the runtime function, which converts them
+/// from or to 64 bits.
+template <typename ConcreteOp, char const *callee>
+struct ConcreteToCAPISmallLweCallPattern
+    : public ConcreteToCAPICallPattern<ConcreteOp, callee> {
+  using ConcreteToCAPICallPattern<ConcreteOp,
+                                  callee>::ConcreteToCAPICallPattern;
+
+  ::mlir::LogicalResult
+  matchAndRewrite(ConcreteOp bOp,
+                  ::mlir::PatternRewriter &rewriter) const override {
+    if (!hasSmallLweBuffer(bOp))
+      return mlir::failure();
+    return ConcreteToCAPICallPattern<ConcreteOp, callee>::matchAndRewrite(
+        bOp, rewriter);
+  }
+};
+
 template <typename KeySwitchOp>
 void keyswitchAddOperands(KeySwitchOp op,
                           mlir::SmallVector<mlir::Value> &operands,
@@ -332,8 +424,36 @@ void bootstrapAddOperands(BootstrapOp op,
   operands.push_back(getContextArgument(op));
 }
 
-void wopPBSAddOperands(Concrete::WopPBSCRTLweBufferOp op,
-                       mlir::SmallVector<mlir::Value> &operands,
+void manyBootstrapAddOperands(Concrete::ManyBootstrapLweBufferOp op,
+                              mlir::SmallVector<mlir::Value> &operands,
+                              mlir::RewriterBase &rewriter) {
+  // input_lwe_dim
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getInputLweDimAttr()));
+  // poly_size
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getPolySizeAttr()));
+  // level
+  operands.push_back(
+      rewriter.create<mlir::arith::ConstantOp>(op.getLoc(), op.getLevelAttr()));
+  // base_log
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getBaseLogAttr()));
+  // glwe_dim
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getGlweDimensionAttr()));
+  // lut_size
+  operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+      op.getLoc(), op.getLutSizeAttr()));
+  // bsk_index
+  operands.push_back(
+      rewriter.create<arith::ConstantOp>(op.getLoc(), op.getBskIndexAttr()));
+  // context
+  operands.push_back(getContextArgument(op));
+}
+
+template <typename WopPBSOp>
+void wopPBSAddOperands(WopPBSOp op, mlir::SmallVector<mlir::Value> &operands,
                        mlir::RewriterBase &rewriter) {
   mlir::Type crtType = mlir::RankedTensorType::get(
       {(int)op.getCrtDecompositionAttr().size()}, rewriter.getI64Type());
@@ -426,9 +546,10 @@ void encodePlaintextWithCrtAddOperands(
       op.getLoc(), op.getModsProdAttr()));
 }
 
+template <typename EncodeExpandOp>
 void encodeExpandLutForBootstrapAddOperands(
-    Concrete::EncodeExpandLutForBootstrapBufferOp op,
-    mlir::SmallVector<mlir::Value> &operands, mlir::RewriterBase &rewriter) {
+    EncodeExpandOp op, mlir::SmallVector<mlir::Value> &operands,
+    mlir::RewriterBase &rewriter) {
   // poly_size
   operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
       op.getLoc(), op.getPolySizeAttr()));
@@ -533,7 +654,15 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
     patterns.add<
         ConcreteToCAPICallPattern<Concrete::EncodeExpandLutForBootstrapBufferOp,
                                   memref_encode_expand_lut_for_bootstrap>>(
-        &getContext(), encodeExpandLutForBootstrapAddOperands);
+        &getContext(),
+        encodeExpandLutForBootstrapAddOperands<
+            Concrete::EncodeExpandLutForBootstrapBufferOp>);
+    patterns.add<ConcreteToCAPICallPattern<
+        Concrete::EncodeExpandManyLutsForBootstrapBufferOp,
+        memref_encode_expand_many_luts_for_bootstrap>>(
+        &getContext(),
+        encodeExpandLutForBootstrapAddOperands<
+            Concrete::EncodeExpandManyLutsForBootstrapBufferOp>);
     patterns
         .add<ConcreteToCAPICallPattern<Concrete::EncodeLutForCrtWopPBSBufferOp,
                                        memref_encode_lut_for_crt_woppbs>>(
@@ -602,11 +731,46 @@ struct ConcreteToCAPIPass : public ConcreteToCAPIBase<ConcreteToCAPIPass> {
                                     memref_batched_mapped_bootstrap_lwe_u64>>(
           &getContext(),
           bootstrapAddOperands<Concrete::BatchedMappedBootstrapLweBufferOp>);
+      patterns.add<ConcreteToCAPICallPattern<Concrete::ManyBootstrapLweBufferOp,
+                                             memref_many_bootstrap_lwe_u64>>(
+          &getContext(), manyBootstrapAddOperands);
+
+      // Ciphertexts stored on 32 bits, tried before the patterns above
+      patterns.add<
+          ConcreteToCAPISmallLweCallPattern<Concrete::KeySwitchLweBufferOp,
+                                            memref_keyswitch_lwe_u64_to_u32>>(
+          &getContext(), keyswitchAddOperands<Concrete::KeySwitchLweBufferOp>,
+          2);
+      patterns.add<
+          ConcreteToCAPISmallLweCallPattern<Concrete::BootstrapLweBufferOp,
+                                            memref_bootstrap_lwe_u32_to_u64>>(
+          &getContext(), bootstrapAddOperands<Concrete::BootstrapLweBufferOp>,
+          2);
+      patterns.add<ConcreteToCAPISmallLweCallPattern<
+          Concrete::BatchedKeySwitchLweBufferOp,
+          memref_batched_keyswitch_lwe_u64_to_u32>>(
+          &getContext(),
+          keyswitchAddOperands<Concrete::BatchedKeySwitchLweBufferOp>, 2);
+      patterns.add<ConcreteToCAPISmallLweCallPattern<
+          Concrete::BatchedBootstrapLweBufferOp,
+          memref_batched_bootstrap_lwe_u32_to_u64>>(
+          &getContext(),
+          bootstrapAddOperands<Concrete::BatchedBootstrapLweBufferOp>, 2);
+      patterns.add<ConcreteToCAPISmallLweCallPattern<
+          Concrete::BatchedMappedBootstrapLweBufferOp,
+          memref_batched_mapped_bootstrap_lwe_u32_to_u64>>(
+          &getContext(),
+          bootstrapAddOperands<Concrete::BatchedMappedBootstrapLweBufferOp>, 2);
     }
 
     patterns.add<ConcreteToCAPICallPattern<Concrete::WopPBSCRTLweBufferOp,
                                            memref_wop_pbs_crt_buffer>>(
-        &getContext(), wopPBSAddOperands);
+        &getContext(), wopPBSAddOperands<Concrete::WopPBSCRTLweBufferOp>);
+    patterns.add<
+        ConcreteToCAPICallPattern<Concrete::BatchedWopPBSCRTLweBufferOp,
+                                  memref_batched_wop_pbs_crt_buffer>>(
+        &getContext(),
+        wopPBSAddOperands<Concrete::BatchedWopPBSCRTLweBufferOp>);
 
     // Apply conversion
     if (mlir::applyPartialConversion(op, target, std::move(patterns))
@@ -586,7 +586,7 @@ struct ApplyLookupTableEintOpPattern
                                         TFHE::GLWESecretKey(), -1, -1, -1),
         TFHE::GLWEBootstrapKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
                                         TFHE::GLWESecretKey(), -1, -1, -1, -1,
-                                        -1),
+                                        -1, 1),
         TFHE::GLWEPackingKeyswitchKeyAttr::get(
             op.getContext(), TFHE::GLWESecretKey(), TFHE::GLWESecretKey(), -1,
             -1, -1, -1, -1, -1),
@@ -400,16 +400,21 @@ struct ApplyLookupTableEintOpPattern
     }
 
     // Insert bootstrap
+    auto manyLutCount = op->getAttr("TFHE.manyLut");
     auto bsOp = rewriter.replaceOpWithNewOp<TFHE::BootstrapGLWEOp>(
         op, getTypeConverter()->convertType(op.getType()), ksOp, newLut,
         TFHE::GLWEBootstrapKeyAttr::get(op.getContext(), TFHE::GLWESecretKey(),
                                         TFHE::GLWESecretKey(), -1, -1, -1, -1,
-                                        -1));
+                                        -1, 1));
     if (operatorIndexes != nullptr) {
       bsOp->setAttr("TFHE.OId",
                     rewriter.getI32IntegerAttr(
                         operatorIndexes[operatorIndexes.size() - 1]));
     }
+    // Forward the number of lookup tables that can share the bootstrap
+    if (manyLutCount != nullptr) {
+      bsOp->setAttr("TFHE.manyLut", manyLutCount);
+    }
     return mlir::success();
   };
 
@@ -523,7 +528,7 @@ std::vector<mlir::Value> extractBitWithClearedLowerBits(
   auto ksk = TFHE::GLWEKeyswitchKeyAttr::get(context, secretKey, secretKey, -1,
                                              -1, -1);
   auto bsk = TFHE::GLWEBootstrapKeyAttr::get(context, secretKey, secretKey, -1,
-                                             -1, -1, -1, -1);
+                                             -1, -1, -1, -1, 1);
 
   auto keyswitched = rewriter.create<TFHE::KeySwitchGLWEOp>(
       loc, cInputTy, shiftedRotatedInput, ksk);
@@ -65,6 +65,15 @@ char stream_emulator_make_memref_batched_bootstrap_lwe_u64_process[] =
 char stream_emulator_make_memref_batched_mapped_bootstrap_lwe_u64_process[] =
     "stream_emulator_make_memref_batched_mapped_bootstrap_lwe_u64_process";
 
+char stream_emulator_make_memref_encode_expand_lut_for_bootstrap_process[] =
+    "stream_emulator_make_memref_encode_expand_lut_for_bootstrap_process";
+char stream_emulator_make_memref_encode_lut_for_crt_woppbs_process[] =
+    "stream_emulator_make_memref_encode_lut_for_crt_woppbs_process";
+char stream_emulator_make_memref_encode_plaintext_with_crt_process[] =
+    "stream_emulator_make_memref_encode_plaintext_with_crt_process";
+char stream_emulator_make_memref_wop_pbs_crt_lwe_u64_process[] =
+    "stream_emulator_make_memref_wop_pbs_crt_lwe_u64_process";
+
 char stream_emulator_make_memref_stream[] =
     "stream_emulator_make_memref_stream";
 char stream_emulator_put_memref[] = "stream_emulator_put_memref";
@@ -122,6 +131,19 @@ void castDynamicTensorOps(mlir::Operation *op, mlir::OpBuilder &rewriter,
   }
 }
 
+// Returns the integers of the array attribute `name` of `op` as a dynamic
+// rank 1 tensor
+mlir::Value getArrayAttrTensor(mlir::Operation *op, mlir::OpBuilder &rewriter,
+                               llvm::StringRef name) {
+  std::vector<int64_t> values;
+  for (auto a : op->getAttrOfType<mlir::ArrayAttr>(name))
+    values.push_back(a.cast<mlir::IntegerAttr>().getValue().getZExtValue());
+  mlir::Value cst = rewriter.create<mlir::arith::ConstantOp>(
+      op->getLoc(), rewriter.getI64TensorAttr(values));
+  return rewriter.create<mlir::tensor::CastOp>(
+      op->getLoc(), getDynamicTensor(rewriter, 1), cst);
+}
+
 struct LowerSDFGInit
     : public mlir::OpRewritePattern<mlir::concretelang::SDFG::Init> {
   LowerSDFGInit(::mlir::MLIRContext *context, mlir::PatternBenefit benefit = 1)
@@ -279,6 +301,115 @@ struct LowerSDFGMakeProcess
       // context
       operands.push_back(getContextArgument(mpOp));
       break;
+    case SDFG::ProcessKind::encode_expand_lut_for_bootstrap:
+      funcName =
+          stream_emulator_make_memref_encode_expand_lut_for_bootstrap_process;
+      // poly_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>("polySize")));
+      // output_bits
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>("outputBits")));
+      // is_signed
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::BoolAttr>("isSigned")));
+      // output_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("output_size")));
+      break;
+    case SDFG::ProcessKind::encode_lut_for_crt_woppbs:
+      funcName = stream_emulator_make_memref_encode_lut_for_crt_woppbs_process;
+      // crt_decomposition
+      operands.push_back(
+          getArrayAttrTensor(mpOp, rewriter, "crtDecomposition"));
+      // crt_bits
+      operands.push_back(getArrayAttrTensor(mpOp, rewriter, "crtBits"));
+      // modulus_product
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("modulusProduct")));
+      // is_signed
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::BoolAttr>("isSigned")));
+      // output_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("output_size")));
+      break;
+    case SDFG::ProcessKind::encode_plaintext_with_crt:
+      funcName = stream_emulator_make_memref_encode_plaintext_with_crt_process;
+      // mods
+      operands.push_back(getArrayAttrTensor(mpOp, rewriter, "mods"));
+      // mods_product
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>("modsProd")));
+      // output_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("output_size")));
+      break;
+    case SDFG::ProcessKind::wop_pbs_crt:
+      funcName = stream_emulator_make_memref_wop_pbs_crt_lwe_u64_process;
+      // crt_decomposition
+      operands.push_back(
+          getArrayAttrTensor(mpOp, rewriter, "crtDecomposition"));
+      // lwe_small_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>(
+                             "packingKeySwitchInputLweDimension")));
+      // cbs_level
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("circuitBootstrapLevel")));
+      // cbs_base_log
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("circuitBootstrapBaseLog")));
+      // ksk_level
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("keyswitchLevel")));
+      // ksk_base_log
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("keyswitchBaseLog")));
+      // bsk_level
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("bootstrapLevel")));
+      // bsk_base_log
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("bootstrapBaseLog")));
+      // fpksk_level
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("packingKeySwitchLevel")));
+      // fpksk_base_log
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("packingKeySwitchBaseLog")));
+      // polynomial_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>(
+                             "packingKeySwitchoutputPolynomialSize")));
+      // output_size
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(),
+          mpOp->getAttrOfType<mlir::IntegerAttr>("output_size")));
+      // ksk_index
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>("kskIndex")));
+      // bsk_index
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>("bskIndex")));
+      // pksk_index
+      operands.push_back(rewriter.create<mlir::arith::ConstantOp>(
+          mpOp.getLoc(), mpOp->getAttrOfType<mlir::IntegerAttr>("pkskIndex")));
+      // context
+      operands.push_back(getContextArgument(mpOp));
+      break;
     case SDFG::ProcessKind::batched_add_eint:
       funcName =
           stream_emulator_make_memref_batched_add_lwe_ciphertexts_u64_process;
@@ -178,6 +178,74 @@ struct EncodeExpandLutForBootstrapOpPattern
   }
 };
 
+struct EncodeExpandManyLutsForBootstrapOpPattern
+    : public mlir::OpConversionPattern<
+          TFHE::EncodeExpandManyLutsForBootstrapOp> {
+
+  EncodeExpandManyLutsForBootstrapOpPattern(mlir::MLIRContext *context,
+                                            mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::EncodeExpandManyLutsForBootstrapOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::EncodeExpandManyLutsForBootstrapOp eeOp,
+                  TFHE::EncodeExpandManyLutsForBootstrapOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    const std::string funcName = "sim_encode_expand_many_luts_for_boostrap";
+
+    mlir::Value polySizeCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        eeOp.getLoc(), eeOp.getPolySize(), 32);
+    mlir::Value outputBitsCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        eeOp.getLoc(), eeOp.getOutputBits(), 32);
+    mlir::Value isSignedCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        eeOp.getLoc(), eeOp.getIsSigned(), 1);
+
+    mlir::Value outputBuffer =
+        rewriter.create<mlir::bufferization::AllocTensorOp>(
+            eeOp.getLoc(),
+            eeOp.getResult().getType().cast<mlir::RankedTensorType>(),
+            mlir::ValueRange{});
+
+    auto dynamicResultType = toDynamicTensorType(eeOp.getResult().getType());
+    auto dynamicLutsType =
+        toDynamicTensorType(eeOp.getInputLookupTables().getType());
+
+    mlir::Value castedOutputBuffer = rewriter.create<mlir::tensor::CastOp>(
+        eeOp.getLoc(), dynamicResultType, outputBuffer);
+
+    mlir::Value castedLUTs = rewriter.create<mlir::tensor::CastOp>(
+        eeOp.getLoc(), dynamicLutsType, adaptor.getInputLookupTables());
+
+    // sim_encode_expand_many_luts_for_boostrap(uint64_t *out_allocated,
+    // uint64_t *out_aligned, uint64_t out_offset, uint64_t out_size, uint64_t
+    // out_stride, uint64_t *in_allocated, uint64_t *in_aligned, uint64_t
+    // in_offset, uint64_t in_size0, uint64_t in_size1, uint64_t in_stride0,
+    // uint64_t in_stride1, uint32_t poly_size, uint32_t output_bits, bool
+    // is_signed)
+    if (insertForwardDeclaration(
+            eeOp, rewriter, funcName,
+            rewriter.getFunctionType(
+                {dynamicResultType, dynamicLutsType,
+                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
+                 rewriter.getIntegerType(1)},
+                {}))
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.create<mlir::func::CallOp>(
+        eeOp.getLoc(), funcName, mlir::TypeRange{},
+        mlir::ValueRange({castedOutputBuffer, castedLUTs, polySizeCst,
+                          outputBitsCst, isSignedCst}));
+
+    rewriter.replaceOp(eeOp, outputBuffer);
+
+    return mlir::success();
+  }
+};
+
 struct EncodeLutForCrtWopPBSOpPattern
     : public mlir::OpConversionPattern<TFHE::EncodeLutForCrtWopPBSOp> {
 
@@ -465,6 +533,99 @@ struct BootstrapGLWEOpPattern
   }
 };
 
+struct ManyBootstrapGLWEOpPattern
+    : public mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp> {
+
+  ManyBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                             mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyBootstrapGLWEOp bsOp,
+                  TFHE::ManyBootstrapGLWEOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+
+    const std::string funcName = "sim_many_bootstrap_lwe_u64";
+
+    TFHE::GLWECipherTextType inputType =
+        bsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
+
+    auto polySize = adaptor.getKey().getPolySize();
+    auto glweDimension = adaptor.getKey().getGlweDim();
+    auto levels = adaptor.getKey().getLevels();
+    auto baseLog = adaptor.getKey().getBaseLog();
+    auto inputLweDimension =
+        inputType.getKey().getNormalized().value().dimension;
+
+    auto polySizeCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), polySize, 32);
+    auto glweDimensionCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), glweDimension, 32);
+    auto levelsCst =
+        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), levels, 32);
+    auto baseLogCst =
+        rewriter.create<mlir::arith::ConstantIntOp>(bsOp.getLoc(), baseLog, 32);
+    auto inputLweDimensionCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), inputLweDimension, 32);
+    auto lutSizeCst = rewriter.create<mlir::arith::ConstantIntOp>(
+        bsOp.getLoc(), bsOp.getLutSize(), 32);
+
+    auto resultType = mlir::RankedTensorType::get(
+        {(int64_t)bsOp.getNumResults()}, rewriter.getIntegerType(64));
+    mlir::Value outputBuffer =
+        rewriter.create<mlir::bufferization::AllocTensorOp>(
+            bsOp.getLoc(), resultType, mlir::ValueRange{});
+
+    auto dynamicResultType = toDynamicTensorType(resultType);
+    auto dynamicLutType = toDynamicTensorType(bsOp.getLookupTable().getType());
+
+    mlir::Value castedOutputBuffer = rewriter.create<mlir::tensor::CastOp>(
+        bsOp.getLoc(), dynamicResultType, outputBuffer);
+    mlir::Value castedLUT = rewriter.create<mlir::tensor::CastOp>(
+        bsOp.getLoc(), dynamicLutType, adaptor.getLookupTable());
+
+    // void sim_many_bootstrap_lwe_u64(uint64_t *out_allocated, uint64_t
+    // *out_aligned, uint64_t out_offset, uint64_t out_size, uint64_t
+    // out_stride, uint64_t plaintext, uint64_t *tlu_allocated, uint64_t
+    // *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size, uint64_t
+    // tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    // uint32_t base_log, uint32_t glwe_dim, uint32_t lut_size)
+    if (insertForwardDeclaration(
+            bsOp, rewriter, funcName,
+            rewriter.getFunctionType(
+                {dynamicResultType, rewriter.getIntegerType(64),
+                 dynamicLutType, rewriter.getIntegerType(32),
+                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
+                 rewriter.getIntegerType(32), rewriter.getIntegerType(32),
+                 rewriter.getIntegerType(32)},
+                {}))
+            .failed()) {
+      return mlir::failure();
+    }
+
+    rewriter.create<mlir::func::CallOp>(
+        bsOp.getLoc(), funcName, mlir::TypeRange{},
+        mlir::ValueRange({castedOutputBuffer, adaptor.getCiphertext(),
+                          castedLUT, inputLweDimensionCst, polySizeCst,
+                          levelsCst, baseLogCst, glweDimensionCst,
+                          lutSizeCst}));
+
+    mlir::SmallVector<mlir::Value> results;
+    for (unsigned i = 0; i < bsOp.getNumResults(); i++) {
+      mlir::Value index =
+          rewriter.create<mlir::arith::ConstantIndexOp>(bsOp.getLoc(), i);
+      results.push_back(rewriter.create<mlir::tensor::ExtractOp>(
+          bsOp.getLoc(), outputBuffer, index));
+    }
+
+    rewriter.replaceOp(bsOp, results);
+
+    return mlir::success();
+  }
+};
+
 struct KeySwitchGLWEOpPattern
     : public mlir::OpConversionPattern<TFHE::KeySwitchGLWEOp> {
 
@@ -638,8 +799,9 @@ void SimulateTFHEPass::runOnOperation() {
   });
 
   patterns.insert<ZeroOpPattern, ZeroTensorOpPattern, KeySwitchGLWEOpPattern,
-                  BootstrapGLWEOpPattern, WopPBSGLWEOpPattern,
-                  EncodeExpandLutForBootstrapOpPattern,
+                  BootstrapGLWEOpPattern, ManyBootstrapGLWEOpPattern,
+                  WopPBSGLWEOpPattern, EncodeExpandLutForBootstrapOpPattern,
+                  EncodeExpandManyLutsForBootstrapOpPattern,
                   EncodeLutForCrtWopPBSOpPattern,
                   EncodePlaintextWithCrtOpPattern, NegOpPattern>(&getContext(),
                                                                  converter);
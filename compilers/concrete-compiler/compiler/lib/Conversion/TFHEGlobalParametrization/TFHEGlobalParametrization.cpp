@@ -161,7 +161,8 @@ struct BootstrapGLWEOpPattern
     auto bootstrapKey = TFHE::GLWEBootstrapKeyAttr::get(
         bsOp->getContext(), newInputKey, newOutputKey,
         cryptoParameters.getPolynomialSize(), cryptoParameters.glweDimension,
-        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1);
+        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1,
+        cryptoParameters.brGroupingFactor);
     auto newOp = rewriter.replaceOpWithNewOp<TFHE::BootstrapGLWEOp>(
         bsOp, newOutputTy, bsOp.getCiphertext(), bsOp.getLookupTable(),
         bootstrapKey);
@@ -202,7 +203,7 @@ struct WopPBSGLWEOpPattern : public mlir::OpRewritePattern<TFHE::WopPBSGLWEOp> {
     auto bootstrapKey = TFHE::GLWEBootstrapKeyAttr::get(
         wopPBSOp->getContext(), intraKey, interKey,
         cryptoParameters.getPolynomialSize(), cryptoParameters.glweDimension,
-        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1);
+        cryptoParameters.brLevel, cryptoParameters.brLogBase, -1, 1);
     auto packingKeyswitchKey = TFHE::GLWEPackingKeyswitchKeyAttr::get(
         wopPBSOp->getContext(), interKey, interKey,
         cryptoParameters.largeInteger->wopPBS.packingKeySwitch
@@ -51,7 +51,7 @@ public:
         bsk.getContext(), convertSecretKey(bsk.getInputKey()),
         convertSecretKey(bsk.getOutputKey()), bsk.getPolySize(),
         bsk.getGlweDim(), bsk.getLevels(), bsk.getBaseLog(),
-        circuitKeys.getBootstrapKeyIndex(bsk).value());
+        circuitKeys.getBootstrapKeyIndex(bsk).value(), bsk.getGroupingFactor());
   }
 
   TFHE::GLWEKeyswitchKeyAttr
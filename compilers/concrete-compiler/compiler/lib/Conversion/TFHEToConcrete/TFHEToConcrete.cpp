@@ -4,6 +4,7 @@
 // for license information.
 
 #include <iostream>
+#include <llvm/ADT/DenseSet.h>
 #include <mlir/Dialect/Bufferization/IR/Bufferization.h>
 
 #include "mlir/Pass/Pass.h"
@@ -32,20 +33,91 @@ namespace Tracing = mlir::concretelang::Tracing;
 
 namespace {
 struct TFHEToConcretePass : public TFHEToConcreteBase<TFHEToConcretePass> {
+  TFHEToConcretePass(unsigned smallLweCiphertextModulusLog)
+      : smallLweCiphertextModulusLog(smallLweCiphertextModulusLog) {}
+
   void runOnOperation() final;
+
+private:
+  unsigned smallLweCiphertextModulusLog;
 };
 } // namespace
 
 using mlir::concretelang::TFHE::GLWECipherTextType;
 
+/// Returns the normalized key of the ciphertexts held by `type`, if it is a
+/// ciphertext, a tensor of ciphertexts or a runtime value of those.
+static std::optional<mlir::concretelang::TFHE::GLWESecretKeyNormalized>
+getCiphertextKey(mlir::Type type) {
+  if (auto tensor = type.dyn_cast<mlir::RankedTensorType>())
+    type = tensor.getElementType();
+  if (auto future = type.dyn_cast<mlir::concretelang::RT::FutureType>())
+    return getCiphertextKey(future.getElementType());
+  if (auto pointer = type.dyn_cast<mlir::concretelang::RT::PointerType>())
+    return getCiphertextKey(pointer.getElementType());
+  auto glwe = type.dyn_cast<GLWECipherTextType>();
+  if (glwe == nullptr || !glwe.getKey().isNormalized())
+    return std::nullopt;
+  return glwe.getKey().getNormalized();
+}
+
+/// Returns the indices of the keyswitch output keys whose ciphertexts can be
+/// stored on 32 bits. The ciphertexts of such a key must only flow from
+/// keyswitches to bootstraps through tensor and loop operations, as the
+/// levelled operations, the function boundaries and the runtime work on 64
+/// bits ciphertexts.
+static llvm::DenseSet<uint64_t> getSmallLweKeys(mlir::ModuleOp module) {
+  llvm::DenseSet<uint64_t> candidates;
+  llvm::DenseSet<uint64_t> rejected;
+  auto reject = [&](mlir::TypeRange types) {
+    for (mlir::Type type : types)
+      if (auto key = getCiphertextKey(type))
+        rejected.insert(key->index);
+  };
+
+  module.walk([&](mlir::Operation *op) {
+    if (llvm::isa<TFHE::KeySwitchGLWEOp, TFHE::BatchedKeySwitchGLWEOp>(op)) {
+      candidates.insert(getCiphertextKey(op->getResult(0).getType())->index);
+      reject(op->getOperandTypes());
+      return;
+    }
+    if (llvm::isa<TFHE::BootstrapGLWEOp, TFHE::BatchedBootstrapGLWEOp,
+                  TFHE::BatchedMappedBootstrapGLWEOp>(op)) {
+      reject(op->getResultTypes());
+      return;
+    }
+    if (llvm::isa<TFHE::ZeroGLWEOp, TFHE::ZeroTensorGLWEOp,
+                  mlir::tensor::ExtractOp, mlir::tensor::ExtractSliceOp,
+                  mlir::tensor::InsertOp, mlir::tensor::InsertSliceOp,
+                  mlir::tensor::FromElementsOp, mlir::tensor::ExpandShapeOp,
+                  mlir::tensor::CollapseShapeOp, mlir::tensor::GenerateOp,
+                  mlir::tensor::YieldOp, mlir::bufferization::AllocTensorOp,
+                  mlir::scf::ForOp, mlir::scf::YieldOp>(op))
+      return;
+
+    reject(op->getOperandTypes());
+    reject(op->getResultTypes());
+    for (mlir::Region &region : op->getRegions())
+      for (mlir::Block &block : region)
+        reject(block.getArgumentTypes());
+  });
+
+  for (uint64_t key : rejected)
+    candidates.erase(key);
+  return candidates;
+}
+
 /// TFHEToConcreteTypeConverter is a TypeConverter that transform
 /// `TFHE.glwe<sk(id){dimension,1}>` to `tensor<dimension+1, i64>>`
 /// `tensor<...xTFHE.glwe<sk(id){dimension,1}>>` to
 /// `tensor<...xdimension+1, i64>>`
+/// The ciphertexts of the `smallLweKeys` are stored on 32 bits, i.e. with an
+/// `i32` element type.
 class TFHEToConcreteTypeConverter : public mlir::TypeConverter {
 
 public:
-  TFHEToConcreteTypeConverter() {
+  TFHEToConcreteTypeConverter(llvm::DenseSet<uint64_t> smallLweKeys = {})
+      : smallLweKeys(std::move(smallLweKeys)) {
     addConversion([](mlir::Type type) { return type; });
     addConversion([&](GLWECipherTextType type) {
       assert(type.getKey().isNormalized() && "keys should be normalized");
@@ -53,8 +125,7 @@ public:
              "converter doesn't support polynomialSize > 1");
       llvm::SmallVector<int64_t, 2> shape;
       shape.push_back(type.getKey().getNormalized().value().dimension + 1);
-      return mlir::RankedTensorType::get(
-          shape, mlir::IntegerType::get(type.getContext(), 64));
+      return mlir::RankedTensorType::get(shape, getElementType(type));
     });
     addConversion([&](mlir::RankedTensorType type) {
       auto glwe = type.getElementType().dyn_cast_or_null<GLWECipherTextType>();
@@ -66,8 +137,8 @@ public:
       newShape.append(type.getShape().begin(), type.getShape().end());
       assert(glwe.getKey().isNormalized());
       newShape.push_back(glwe.getKey().getNormalized().value().dimension + 1);
-      mlir::Type r = mlir::RankedTensorType::get(
-          newShape, mlir::IntegerType::get(type.getContext(), 64));
+      mlir::Type r =
+          mlir::RankedTensorType::get(newShape, getElementType(glwe));
       return r;
     });
     addConversion([&](mlir::concretelang::RT::FutureType type) {
@@ -81,6 +152,16 @@ public:
                                 .getElementType()));
     });
   }
+
+private:
+  mlir::Type getElementType(GLWECipherTextType type) {
+    unsigned width =
+        smallLweKeys.contains(type.getKey().getNormalized().value().index) ? 32
+                                                                           : 64;
+    return mlir::IntegerType::get(type.getContext(), width);
+  }
+
+  llvm::DenseSet<uint64_t> smallLweKeys;
 };
 
 namespace {
@@ -143,17 +224,77 @@ struct BootstrapGLWEOpPattern
   }
 };
 
-struct WopPBSGLWEOpPattern
-    : public mlir::OpConversionPattern<TFHE::WopPBSGLWEOp> {
+struct ManyBootstrapGLWEOpPattern
+    : public mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp> {
+
+  ManyBootstrapGLWEOpPattern(mlir::MLIRContext *context,
+                             mlir::TypeConverter &typeConverter)
+      : mlir::OpConversionPattern<TFHE::ManyBootstrapGLWEOp>(
+            typeConverter, context,
+            mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
+
+  ::mlir::LogicalResult
+  matchAndRewrite(TFHE::ManyBootstrapGLWEOp bsOp,
+                  TFHE::ManyBootstrapGLWEOp::Adaptor adaptor,
+                  mlir::ConversionPatternRewriter &rewriter) const override {
+    TFHE::GLWECipherTextType inputType =
+        bsOp.getCiphertext().getType().cast<TFHE::GLWECipherTextType>();
+
+    auto polySize = adaptor.getKey().getPolySize();
+    auto glweDimension = adaptor.getKey().getGlweDim();
+    auto levels = adaptor.getKey().getLevels();
+    auto baseLog = adaptor.getKey().getBaseLog();
+    auto inputLweDimension =
+        inputType.getKey().getNormalized().value().dimension;
+    auto bskIndex = bsOp.getKeyAttr().getIndex();
+
+    // All the results have the same type, the bootstrap produces them as
+    // the rows of a single tensor
+    auto resultType = this->getTypeConverter()
+                          ->convertType(bsOp.getResult(0).getType())
+                          .cast<mlir::RankedTensorType>();
+    auto lutCount = (int64_t)bsOp.getNumResults();
+    auto batchType = mlir::RankedTensorType::get(
+        {lutCount, resultType.getDimSize(0)}, resultType.getElementType());
+
+    auto manyBsOp = rewriter.create<Concrete::ManyBootstrapLweTensorOp>(
+        bsOp.getLoc(), batchType, adaptor.getCiphertext(),
+        adaptor.getLookupTable(), inputLweDimension, polySize, levels, baseLog,
+        glweDimension, bsOp.getLutSize(), bskIndex);
+
+    mlir::SmallVector<mlir::Value> results;
+    for (int64_t i = 0; i < lutCount; i++) {
+      mlir::SmallVector<mlir::OpFoldResult> offsets{rewriter.getIndexAttr(i),
+                                                    rewriter.getIndexAttr(0)};
+      mlir::SmallVector<mlir::OpFoldResult> sizes{
+          rewriter.getIndexAttr(1),
+          rewriter.getIndexAttr(resultType.getDimSize(0))};
+      mlir::SmallVector<mlir::OpFoldResult> strides{rewriter.getIndexAttr(1),
+                                                    rewriter.getIndexAttr(1)};
+      results.push_back(rewriter.create<mlir::tensor::ExtractSliceOp>(
+          bsOp.getLoc(), resultType, manyBsOp.getResult(), offsets, sizes,
+          strides));
+    }
+
+    rewriter.replaceOp(bsOp, results);
+
+    return mlir::success();
+  }
+};
+
+/// Rewrites a scalar or batched `TFHE` wop-pbs to the corresponding
+/// `Concrete` operation.
+template <typename WopPBSOp, typename ConcreteWopPBSOp>
+struct WopPBSGLWEOpPattern : public mlir::OpConversionPattern<WopPBSOp> {
 
   WopPBSGLWEOpPattern(mlir::MLIRContext *context,
                       mlir::TypeConverter &typeConverter)
-      : mlir::OpConversionPattern<TFHE::WopPBSGLWEOp>(
+      : mlir::OpConversionPattern<WopPBSOp>(
             typeConverter, context,
             mlir::concretelang::DEFAULT_PATTERN_BENEFIT) {}
 
   ::mlir::LogicalResult
-  matchAndRewrite(TFHE::WopPBSGLWEOp op, TFHE::WopPBSGLWEOp::Adaptor adaptor,
+  matchAndRewrite(WopPBSOp op, typename WopPBSOp::Adaptor adaptor,
                   mlir::ConversionPatternRewriter &rewriter) const override {
 
     auto bsBaseLog = adaptor.getBsk().getBaseLog();
@@ -172,7 +313,7 @@ struct WopPBSGLWEOpPattern
     auto bskIndex = op.getBskAttr().getIndex();
     auto pkskIndex = op.getPkskAttr().getIndex();
 
-    rewriter.replaceOpWithNewOp<Concrete::WopPBSCRTLweTensorOp>(
+    rewriter.replaceOpWithNewOp<ConcreteWopPBSOp>(
         op, this->getTypeConverter()->convertType(resultType),
         adaptor.getCiphertexts(), adaptor.getLookupTable(), bsLevels, bsBaseLog,
         ksLevels, ksBaseLog, pksInnerLweDim, pksOutputPolySize, pksLevels,
@@ -369,12 +510,15 @@ struct ZeroOpPattern : public mlir::OpConversionPattern<ZeroOp> {
                   mlir::ConversionPatternRewriter &rewriter) const override {
     auto newResultTy = this->getTypeConverter()->convertType(zeroOp.getType());
 
+    auto elementType =
+        newResultTy.template cast<mlir::RankedTensorType>().getElementType();
+
     auto generateBody = [&](mlir::OpBuilder &nestedBuilder,
                             mlir::Location nestedLoc,
                             mlir::ValueRange blockArgs) {
       // %c0 = 0 : i64
       auto cstOp = nestedBuilder.create<mlir::arith::ConstantOp>(
-          nestedLoc, nestedBuilder.getI64IntegerAttr(0));
+          nestedLoc, nestedBuilder.getIntegerAttr(elementType, 0));
       // tensor.yield %z : !FHE.eint<p>
       nestedBuilder.create<mlir::tensor::YieldOp>(nestedLoc, cstOp.getResult());
     };
@@ -759,7 +903,10 @@ void TFHEToConcretePass::runOnOperation() {
   auto op = this->getOperation();
 
   mlir::ConversionTarget target(getContext());
-  TFHEToConcreteTypeConverter converter;
+  llvm::DenseSet<uint64_t> smallLweKeys;
+  if (smallLweCiphertextModulusLog == 32)
+    smallLweKeys = getSmallLweKeys(op);
+  TFHEToConcreteTypeConverter converter(std::move(smallLweKeys));
 
   // Mark ops from the target dialect as legal operations
   target.addLegalDialect<mlir::concretelang::Concrete::ConcreteDialect>();
@@ -817,6 +964,10 @@ void TFHEToConcretePass::runOnOperation() {
           mlir::concretelang::TFHE::EncodeExpandLutForBootstrapOp,
           mlir::concretelang::Concrete::EncodeExpandLutForBootstrapTensorOp,
           true>,
+      mlir::concretelang::GenericOneToOneOpConversionPattern<
+          mlir::concretelang::TFHE::EncodeExpandManyLutsForBootstrapOp,
+          mlir::concretelang::Concrete::EncodeExpandManyLutsForBootstrapTensorOp,
+          true>,
       mlir::concretelang::GenericOneToOneOpConversionPattern<
           mlir::concretelang::TFHE::EncodeLutForCrtWopPBSOp,
           mlir::concretelang::Concrete::EncodeLutForCrtWopPBSTensorOp, true>,
@@ -849,9 +1000,13 @@ void TFHEToConcretePass::runOnOperation() {
   patterns.insert<ZeroOpPattern<mlir::concretelang::TFHE::ZeroGLWEOp>,
                   ZeroOpPattern<mlir::concretelang::TFHE::ZeroTensorGLWEOp>,
                   SubIntGLWEOpPattern, BootstrapGLWEOpPattern,
-                  BatchedBootstrapGLWEOpPattern,
+                  ManyBootstrapGLWEOpPattern, BatchedBootstrapGLWEOpPattern,
                   BatchedMappedBootstrapGLWEOpPattern, KeySwitchGLWEOpPattern,
-                  BatchedKeySwitchGLWEOpPattern, WopPBSGLWEOpPattern>(
+                  BatchedKeySwitchGLWEOpPattern,
+                  WopPBSGLWEOpPattern<TFHE::WopPBSGLWEOp,
+                                      Concrete::WopPBSCRTLweTensorOp>,
+                  WopPBSGLWEOpPattern<TFHE::BatchedWopPBSGLWEOp,
+                                      Concrete::BatchedWopPBSCRTLweTensorOp>>(
       &getContext(), converter);
 
   // Add patterns to rewrite tensor operators that works on tensors of TFHE GLWE
@@ -927,8 +1082,9 @@ void TFHEToConcretePass::runOnOperation() {
 
 namespace mlir {
 namespace concretelang {
-std::unique_ptr<OperationPass<ModuleOp>> createConvertTFHEToConcretePass() {
-  return std::make_unique<TFHEToConcretePass>();
+std::unique_ptr<OperationPass<ModuleOp>>
+createConvertTFHEToConcretePass(unsigned smallLweCiphertextModulusLog) {
+  return std::make_unique<TFHEToConcretePass>(smallLweCiphertextModulusLog);
 }
 } // namespace concretelang
 } // namespace mlir
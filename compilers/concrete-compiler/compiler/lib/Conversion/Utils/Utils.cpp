@@ -11,7 +11,10 @@ namespace mlir {
 namespace concretelang {
 
 mlir::Type getDynamicMemrefWithUnknownOffset(mlir::RewriterBase &rewriter,
-                                             size_t rank) {
+                                             size_t rank,
+                                             mlir::Type elementType) {
+  if (elementType == nullptr)
+    elementType = rewriter.getI64Type();
   std::vector<int64_t> shape(rank, mlir::ShapedType::kDynamic);
   mlir::AffineExpr expr = rewriter.getAffineSymbolExpr(0);
   for (size_t i = 0; i < rank; i++) {
@@ -19,7 +22,7 @@ mlir::Type getDynamicMemrefWithUnknownOffset(mlir::RewriterBase &rewriter,
            (rewriter.getAffineDimExpr(i) * rewriter.getAffineSymbolExpr(i + 1));
   }
   return mlir::MemRefType::get(
-      shape, rewriter.getI64Type(),
+      shape, elementType,
       mlir::AffineMap::get(rank, rank + 1, expr, rewriter.getContext()));
 }
 
@@ -30,7 +33,8 @@ mlir::Value getCastedMemRef(mlir::RewriterBase &rewriter, mlir::Value value) {
   if (auto memrefTy = valueType.dyn_cast_or_null<mlir::MemRefType>()) {
     return rewriter.create<mlir::memref::CastOp>(
         value.getLoc(),
-        getDynamicMemrefWithUnknownOffset(rewriter, memrefTy.getShape().size()),
+        getDynamicMemrefWithUnknownOffset(rewriter, memrefTy.getShape().size(),
+                                          memrefTy.getElementType()),
         value);
   } else {
     return value;
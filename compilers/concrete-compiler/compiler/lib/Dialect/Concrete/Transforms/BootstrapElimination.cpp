@@ -0,0 +1,287 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Dominance.h>
+#include <mlir/IR/IRMapping.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+#include "concretelang/Dialect/Concrete/IR/ConcreteDialect.h"
+#include "concretelang/Dialect/Concrete/IR/ConcreteOps.h"
+#include "concretelang/Dialect/Concrete/Transforms/Passes.h"
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+bool isBootstrap(mlir::Operation *op) {
+  return llvm::isa<Concrete::BootstrapLweTensorOp,
+                   Concrete::BatchedBootstrapLweTensorOp,
+                   Concrete::BatchedMappedBootstrapLweTensorOp,
+                   Concrete::ManyBootstrapLweTensorOp>(op);
+}
+
+bool isKeyswitch(mlir::Operation *op) {
+  return llvm::isa<Concrete::KeySwitchLweTensorOp,
+                   Concrete::BatchedKeySwitchLweTensorOp>(op);
+}
+
+/// Returns the number of scalar programmable bootstraps computed by `op`.
+uint64_t getPBSCount(mlir::Operation *op) {
+  if (llvm::isa<Concrete::BootstrapLweTensorOp,
+                Concrete::ManyBootstrapLweTensorOp>(op))
+    return 1;
+  if (llvm::isa<Concrete::BatchedBootstrapLweTensorOp,
+                Concrete::BatchedMappedBootstrapLweTensorOp>(op))
+    return op->getResult(0).getType().cast<mlir::RankedTensorType>().getDimSize(
+        0);
+  return 0;
+}
+
+llvm::hash_code hashOperation(mlir::Operation *op) {
+  return llvm::hash_combine(
+      op->getName(), op->getAttrDictionary(),
+      llvm::hash_combine_range(op->operand_begin(), op->operand_end()),
+      llvm::hash_combine_range(op->result_type_begin(),
+                               op->result_type_end()));
+}
+
+bool isEquivalent(mlir::Operation *lhs, mlir::Operation *rhs) {
+  return lhs->getName() == rhs->getName() &&
+         lhs->getOperands() == rhs->getOperands() &&
+         lhs->getResultTypes() == rhs->getResultTypes() &&
+         lhs->getAttrDictionary() == rhs->getAttrDictionary();
+}
+
+/// Collects the bootstraps and keyswitches of `root` together with the
+/// side-effect free operations their operands are computed from (e.g. the
+/// constant lookup tables and their encoding, or the extraction of an
+/// element). The operations are returned in pre-order, such that the
+/// producers of an operation appear before the operation itself.
+llvm::SmallVector<mlir::Operation *>
+collectNumberableOps(mlir::Operation *root) {
+  llvm::DenseSet<mlir::Operation *> numberable;
+  llvm::SmallVector<mlir::Operation *> worklist;
+
+  root->walk([&](mlir::Operation *op) {
+    if ((isBootstrap(op) || isKeyswitch(op)) && numberable.insert(op).second)
+      worklist.push_back(op);
+  });
+
+  while (!worklist.empty()) {
+    mlir::Operation *op = worklist.pop_back_val();
+    for (mlir::Value operand : op->getOperands()) {
+      mlir::Operation *producer = operand.getDefiningOp();
+      if (producer == nullptr || producer->getNumRegions() != 0 ||
+          !mlir::isMemoryEffectFree(producer))
+        continue;
+      if (numberable.insert(producer).second)
+        worklist.push_back(producer);
+    }
+  }
+
+  llvm::SmallVector<mlir::Operation *> ordered;
+  root->walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *op) {
+    if (numberable.contains(op))
+      ordered.push_back(op);
+  });
+  return ordered;
+}
+
+/// Replaces the operations computing the same value as a dominating
+/// equivalent operation by the latter. Returns the number of programmable
+/// bootstraps eliminated.
+uint64_t eliminateCommonBootstraps(mlir::Operation *root) {
+  uint64_t eliminated = 0;
+  mlir::DominanceInfo domInfo(root);
+  std::unordered_map<size_t, llvm::SmallVector<mlir::Operation *>> known;
+
+  for (mlir::Operation *op : collectNumberableOps(root)) {
+    auto &candidates = known[static_cast<size_t>(hashOperation(op))];
+    auto equivalent =
+        llvm::find_if(candidates, [&](mlir::Operation *candidate) {
+          return isEquivalent(candidate, op) &&
+                 domInfo.properlyDominates(candidate, op);
+        });
+    if (equivalent == candidates.end()) {
+      candidates.push_back(op);
+      continue;
+    }
+    eliminated += getPBSCount(op);
+    op->replaceAllUsesWith(*equivalent);
+    op->erase();
+  }
+  return eliminated;
+}
+
+/// Returns the range `[lo, hi)` of the batch rows of `op` read by its users
+/// if all of them are static slices, or `std::nullopt` otherwise.
+std::optional<std::pair<int64_t, int64_t>>
+getUsedBatchRange(mlir::Operation *op) {
+  int64_t lo = std::numeric_limits<int64_t>::max();
+  int64_t hi = std::numeric_limits<int64_t>::min();
+  for (mlir::Operation *user : op->getUsers()) {
+    auto slice = llvm::dyn_cast<mlir::tensor::ExtractSliceOp>(user);
+    if (slice == nullptr || slice.getSource() != op->getResult(0) ||
+        mlir::ShapedType::isDynamic(slice.getStaticOffsets()[0]) ||
+        mlir::ShapedType::isDynamic(slice.getStaticSizes()[0]) ||
+        mlir::ShapedType::isDynamic(slice.getStaticStrides()[0]))
+      return std::nullopt;
+    int64_t offset = slice.getStaticOffsets()[0];
+    int64_t size = slice.getStaticSizes()[0];
+    int64_t stride = slice.getStaticStrides()[0];
+    lo = std::min(lo, offset);
+    hi = std::max(hi, offset + (size - 1) * stride + 1);
+  }
+  if (lo >= hi)
+    return std::nullopt;
+  return std::make_pair(lo, hi);
+}
+
+/// Extracts the rows `[lo, hi)` of the rank-2 tensor `value`.
+mlir::Value sliceRows(mlir::OpBuilder &builder, mlir::Location loc,
+                      mlir::Value value, int64_t lo, int64_t hi) {
+  auto type = value.getType().cast<mlir::RankedTensorType>();
+  llvm::SmallVector<mlir::OpFoldResult> offsets{builder.getIndexAttr(lo),
+                                                builder.getIndexAttr(0)};
+  llvm::SmallVector<mlir::OpFoldResult> sizes{
+      builder.getIndexAttr(hi - lo), builder.getIndexAttr(type.getDimSize(1))};
+  llvm::SmallVector<mlir::OpFoldResult> strides{builder.getIndexAttr(1),
+                                                builder.getIndexAttr(1)};
+  return builder.create<mlir::tensor::ExtractSliceOp>(loc, value, offsets,
+                                                      sizes, strides);
+}
+
+/// Restricts the batched operation `op` to the rows of its result that are
+/// used. Returns the number of programmable bootstraps eliminated.
+uint64_t narrowBatch(mlir::Operation *op) {
+  auto range = getUsedBatchRange(op);
+  if (!range)
+    return 0;
+  auto [lo, hi] = *range;
+  auto resultType = op->getResult(0).getType().cast<mlir::RankedTensorType>();
+  int64_t batchSize = resultType.getDimSize(0);
+  if (hi - lo >= batchSize)
+    return 0;
+
+  mlir::OpBuilder builder(op);
+  mlir::IRMapping mapping;
+  mapping.map(op->getOperand(0),
+              sliceRows(builder, op->getLoc(), op->getOperand(0), lo, hi));
+  // Mapped bootstraps have one lookup table per batch row
+  if (llvm::isa<Concrete::BatchedMappedBootstrapLweTensorOp>(op))
+    mapping.map(op->getOperand(1),
+                sliceRows(builder, op->getLoc(), op->getOperand(1), lo, hi));
+  mlir::Operation *narrowed = builder.clone(*op, mapping);
+  narrowed->getResult(0).setType(mlir::RankedTensorType::get(
+      {hi - lo, resultType.getDimSize(1)}, resultType.getElementType()));
+
+  for (mlir::Operation *user : llvm::make_early_inc_range(op->getUsers())) {
+    auto slice = llvm::cast<mlir::tensor::ExtractSliceOp>(user);
+    mlir::Value newSlice = narrowed->getResult(0);
+    // Slices of the whole narrowed batch are replaced by the batch itself
+    bool isWholeBatch =
+        slice.getType() == newSlice.getType() &&
+        slice.getStaticOffsets()[0] == lo &&
+        llvm::all_of(slice.getStaticOffsets().drop_front(),
+                     [](int64_t offset) { return offset == 0; }) &&
+        llvm::all_of(slice.getStaticStrides(),
+                     [](int64_t stride) { return stride == 1; });
+    if (!isWholeBatch) {
+      llvm::SmallVector<mlir::OpFoldResult> offsets = slice.getMixedOffsets();
+      offsets[0] = builder.getIndexAttr(slice.getStaticOffsets()[0] - lo);
+      builder.setInsertionPoint(slice);
+      newSlice = builder.create<mlir::tensor::ExtractSliceOp>(
+          slice.getLoc(), slice.getType(), newSlice, offsets,
+          slice.getMixedSizes(), slice.getMixedStrides());
+    }
+    slice.replaceAllUsesWith(newSlice);
+    slice->erase();
+  }
+
+  uint64_t eliminated = getPBSCount(op) - getPBSCount(narrowed);
+  op->erase();
+  return eliminated;
+}
+
+/// Removes the bootstraps and keyswitches whose results are not used, as
+/// well as the side-effect free operations computing their operands that
+/// become unused. Returns the number of programmable bootstraps eliminated.
+uint64_t eliminateDeadBootstraps(mlir::Operation *root) {
+  uint64_t eliminated = 0;
+  // Users appear after their producers, visit them first
+  for (mlir::Operation *op : llvm::reverse(collectNumberableOps(root))) {
+    if (!op->use_empty())
+      continue;
+    eliminated += getPBSCount(op);
+    op->erase();
+  }
+  return eliminated;
+}
+
+/// Pass that removes the redundant programmable bootstraps and keyswitches
+/// of the Concrete dialect, as left by the lowering of tensor operations or
+/// of chunked integers:
+///
+///  - operations computing the same value as a dominating operation, i.e.
+///    with the same inputs, lookup tables and parameters, are replaced by
+///    the dominating one,
+///  - batched operations whose results are only partially extracted are
+///    restricted to the range of used rows,
+///  - operations whose results are not used are removed.
+class BootstrapEliminationPass
+    : public BootstrapEliminationBase<BootstrapEliminationPass> {
+public:
+  BootstrapEliminationPass(std::function<void(uint64_t)> eliminatedPBSCallback)
+      : eliminatedPBSCallback(eliminatedPBSCallback) {}
+
+  void runOnOperation() override {
+    mlir::Operation *root = getOperation();
+    uint64_t eliminated = eliminateCommonBootstraps(root);
+
+    llvm::SmallVector<mlir::Operation *> batched;
+    root->walk([&](mlir::Operation *op) {
+      if (llvm::isa<Concrete::BatchedBootstrapLweTensorOp,
+                    Concrete::BatchedMappedBootstrapLweTensorOp,
+                    Concrete::BatchedKeySwitchLweTensorOp>(op))
+        batched.push_back(op);
+    });
+    // Narrow the consumers first, such that their producers only see the
+    // narrowed slices
+    for (mlir::Operation *op : llvm::reverse(batched))
+      eliminated += narrowBatch(op);
+
+    eliminated += eliminateDeadBootstraps(root);
+
+    if (eliminatedPBSCallback)
+      eliminatedPBSCallback(eliminated);
+  }
+
+private:
+  std::function<void(uint64_t)> eliminatedPBSCallback;
+};
+
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createBootstrapEliminationPass(
+    std::function<void(uint64_t)> eliminatedPBSCallback) {
+  return std::make_unique<BootstrapEliminationPass>(eliminatedPBSCallback);
+}
+
+} // namespace concretelang
+} // namespace mlir
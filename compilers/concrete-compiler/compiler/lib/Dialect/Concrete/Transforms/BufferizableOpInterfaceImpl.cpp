@@ -123,6 +123,10 @@ void mlir::concretelang::Concrete::
     // bootstrap_lwe_tensor => bootstrap_lwe_buffer
     Concrete::BootstrapLweTensorOp::attachInterface<TensorToMemrefOp<
         Concrete::BootstrapLweTensorOp, Concrete::BootstrapLweBufferOp>>(*ctx);
+    // many_bootstrap_lwe_tensor => many_bootstrap_lwe_buffer
+    Concrete::ManyBootstrapLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::ManyBootstrapLweTensorOp,
+                         Concrete::ManyBootstrapLweBufferOp>>(*ctx);
 
     // batched_add_lwe_tensor => batched_add_lwe_buffer
     Concrete::BatchedAddLweTensorOp::attachInterface<TensorToMemrefOp<
@@ -167,6 +171,10 @@ void mlir::concretelang::Concrete::
     // wop_pbs_crt_lwe_tensor => wop_pbs_crt_lwe_buffer
     Concrete::WopPBSCRTLweTensorOp::attachInterface<TensorToMemrefOp<
         Concrete::WopPBSCRTLweTensorOp, Concrete::WopPBSCRTLweBufferOp>>(*ctx);
+    // batched_wop_pbs_crt_lwe_tensor => batched_wop_pbs_crt_lwe_buffer
+    Concrete::BatchedWopPBSCRTLweTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::BatchedWopPBSCRTLweTensorOp,
+                         Concrete::BatchedWopPBSCRTLweBufferOp>>(*ctx);
     // encode_plaintext_with_crt_tensor => encode_plaintext_with_crt_buffer
     Concrete::EncodePlaintextWithCrtTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::EncodePlaintextWithCrtTensorOp,
@@ -176,6 +184,12 @@ void mlir::concretelang::Concrete::
     Concrete::EncodeExpandLutForBootstrapTensorOp::attachInterface<
         TensorToMemrefOp<Concrete::EncodeExpandLutForBootstrapTensorOp,
                          Concrete::EncodeExpandLutForBootstrapBufferOp>>(*ctx);
+    // encode_expand_many_luts_for_bootstrap_tensor =>
+    // encode_expand_many_luts_for_bootstrap_buffer
+    Concrete::EncodeExpandManyLutsForBootstrapTensorOp::attachInterface<
+        TensorToMemrefOp<Concrete::EncodeExpandManyLutsForBootstrapTensorOp,
+                         Concrete::EncodeExpandManyLutsForBootstrapBufferOp>>(
+        *ctx);
     // encode_lut_for_crt_woppbs_tensor =>
     // encode_lut_for_crt_woppbs_buffer
     Concrete::EncodeLutForCrtWopPBSTensorOp::attachInterface<
@@ -6,6 +6,8 @@
 #include <chrono>
 #include <cmath>
 #include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -14,9 +16,11 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Pass/PassManager.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Pass.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "concrete-optimizer.hpp"
@@ -216,15 +220,69 @@ struct FunctionToDag {
       encrypted_input = addIndex;
       operatorIndexes.push_back(addIndex.index);
     }
+    mlir::Builder builder(op.getContext());
+    // Lookup tables on the same input can be evaluated by a single bootstrap,
+    // each lookup table having a slot of the accumulator. This requires the
+    // noise of the input to fit in a slot, i.e. to be as low as for a lookup
+    // table on log2(#lookup tables) more bits.
+    if (auto manyLutCount = getManyLutCount(op); manyLutCount > 1) {
+      encrypted_input = dag->add_unsafe_cast_op(
+          encrypted_input, inputType.getWidth() + llvm::Log2_64(manyLutCount));
+      op.setAttr("TFHE.manyLut", builder.getI32IntegerAttr(manyLutCount));
+    }
     auto lutIndex =
         dag->add_lut(encrypted_input, slice(unknowFunction), precision);
     operatorIndexes.push_back(lutIndex.index);
-    mlir::Builder builder(op.getContext());
     if (setOptimizerID)
       op.setAttr("TFHE.OId", builder.getDenseI32ArrayAttr(operatorIndexes));
     index[val] = lutIndex;
   }
 
+  // Returns the number of lookup tables that can be evaluated with `op` by a
+  // single bootstrap. It mirrors the grouping of the many-lut bootstrap
+  // rewrite: the lookup tables with a constant table of the same shape and
+  // the same result type, applied on the same input in the same block, are
+  // grouped in block order by power of two groups bounded by the
+  // configuration. The many-lut bootstrap is disabled when the optimizer can
+  // choose a multi-bit bootstrap key.
+  uint64_t getManyLutCount(mlir::Operation &op) {
+    auto lut = llvm::dyn_cast<FHE::ApplyLookupTableEintOp>(op);
+    if (lut == nullptr || config.max_many_lut_count <= 1 ||
+        config.max_multi_bit_grouping_factor > 1 ||
+        config.use_gpu_constraints || !hasConstantTable(lut)) {
+      return 1;
+    }
+    llvm::SmallVector<mlir::Operation *> group;
+    for (mlir::Operation *user : lut.getA().getUsers()) {
+      auto other = llvm::dyn_cast<FHE::ApplyLookupTableEintOp>(user);
+      if (other != nullptr && other->getBlock() == op.getBlock() &&
+          other.getType() == lut.getType() &&
+          other.getLut().getType() == lut.getLut().getType() &&
+          hasConstantTable(other) && !llvm::is_contained(group, user)) {
+        group.push_back(user);
+      }
+    }
+    llvm::sort(group, [](mlir::Operation *a, mlir::Operation *b) {
+      return a->isBeforeInBlock(b);
+    });
+    uint64_t rank = llvm::find(group, &op) - group.begin();
+    uint64_t remaining = group.size();
+    uint64_t first = 0;
+    while (remaining > 1) {
+      uint64_t lutCount = llvm::PowerOf2Floor(
+          std::min<uint64_t>(remaining, config.max_many_lut_count));
+      if (rank < first + lutCount)
+        return lutCount;
+      first += lutCount;
+      remaining -= lutCount;
+    }
+    return 1;
+  }
+
+  static bool hasConstantTable(FHE::ApplyLookupTableEintOp lut) {
+    return mlir::matchPattern(lut.getLut(), mlir::m_Constant());
+  }
+
   concrete_optimizer::dag::OperatorIndex addRound(optimizer::Dag &dag,
                                                   mlir::Value &val,
                                                   Inputs &encrypted_inputs,
@@ -953,6 +1011,9 @@ struct FunctionToDag {
 struct DagPass : ConcreteOptimizerBase<DagPass> {
   optimizer::Config config;
   optimizer::FunctionsDag &dags;
+  // Guards `dags`, shared with the clones of the pass running on different
+  // functions in parallel
+  std::shared_ptr<std::mutex> dagsMutex;
 
   void runOnOperation() override {
     mlir::func::FuncOp func = getOperation();
@@ -960,6 +1021,7 @@ struct DagPass : ConcreteOptimizerBase<DagPass> {
     DEBUG("ConcreteOptimizer Dag: " << name);
     auto dag = FunctionToDag(func, config).build();
     if (dag) {
+      std::lock_guard<std::mutex> guard(*dagsMutex);
       dags.insert(
           optimizer::FunctionsDag::value_type(name, std::move(dag.value())));
     } else {
@@ -969,7 +1031,8 @@ struct DagPass : ConcreteOptimizerBase<DagPass> {
 
   DagPass() = delete;
   DagPass(optimizer::Config config, optimizer::FunctionsDag &dags)
-      : config(config), dags(dags) {}
+      : config(config), dags(dags),
+        dagsMutex(std::make_shared<std::mutex>()) {}
 };
 
 // Create an instance of the ConcreteOptimizerPass pass.
@@ -0,0 +1,834 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Matchers.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/BitWidthMinimization.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+const int64_t MIN_VALUE = std::numeric_limits<int64_t>::min();
+const int64_t MAX_VALUE = std::numeric_limits<int64_t>::max();
+
+/// Saturating arithmetic on 64 bits integers. The saturated values are out of
+/// the range of any encrypted integer, such that the values computed with
+/// them are never shrunk.
+int64_t addSat(int64_t a, int64_t b) {
+  int64_t result;
+  if (llvm::AddOverflow(a, b, result))
+    return b > 0 ? MAX_VALUE : MIN_VALUE;
+  return result;
+}
+
+int64_t subSat(int64_t a, int64_t b) {
+  int64_t result;
+  if (llvm::SubOverflow(a, b, result))
+    return b < 0 ? MAX_VALUE : MIN_VALUE;
+  return result;
+}
+
+int64_t mulSat(int64_t a, int64_t b) {
+  int64_t result;
+  if (llvm::MulOverflow(a, b, result))
+    return (a < 0) != (b < 0) ? MIN_VALUE : MAX_VALUE;
+  return result;
+}
+
+/// Inclusive range `[lo, hi]` of the values of an integer.
+struct Range {
+  int64_t lo;
+  int64_t hi;
+
+  static Range of(int64_t value) { return Range{value, value}; }
+
+  Range operator+(const Range &other) const {
+    return Range{addSat(lo, other.lo), addSat(hi, other.hi)};
+  }
+
+  Range operator-(const Range &other) const {
+    return Range{subSat(lo, other.hi), subSat(hi, other.lo)};
+  }
+
+  Range operator*(const Range &other) const {
+    int64_t products[] = {mulSat(lo, other.lo), mulSat(lo, other.hi),
+                          mulSat(hi, other.lo), mulSat(hi, other.hi)};
+    return Range{*std::min_element(std::begin(products), std::end(products)),
+                 *std::max_element(std::begin(products), std::end(products))};
+  }
+
+  Range join(const Range &other) const {
+    return Range{std::min(lo, other.lo), std::max(hi, other.hi)};
+  }
+};
+
+FHE::FheIntegerInterface getEncryptedElementType(mlir::Type type) {
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    return tensorTy.getElementType().dyn_cast<FHE::FheIntegerInterface>();
+
+  return type.dyn_cast<FHE::FheIntegerInterface>();
+}
+
+bool isEncrypted(mlir::Value value) {
+  return getEncryptedElementType(value.getType()) != nullptr;
+}
+
+mlir::IntegerType getClearElementType(mlir::Type type) {
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    return tensorTy.getElementType().dyn_cast<mlir::IntegerType>();
+
+  return type.dyn_cast<mlir::IntegerType>();
+}
+
+bool isClear(mlir::Value value) {
+  return getClearElementType(value.getType()) != nullptr;
+}
+
+int64_t getNumElements(mlir::Type type) {
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    return tensorTy.getNumElements();
+
+  return 1;
+}
+
+/// Returns the range of all the values of an encrypted integer of type
+/// `type`.
+Range getFullRange(FHE::FheIntegerInterface type) {
+  int64_t width = type.getWidth();
+  if (type.isSigned())
+    return Range{-((int64_t)1 << (width - 1)), ((int64_t)1 << (width - 1)) - 1};
+
+  return Range{0, ((int64_t)1 << width) - 1};
+}
+
+/// Returns the smallest width of an encrypted integer holding all the values
+/// of `range`.
+uint64_t getRequiredWidth(Range range, bool isSigned) {
+  if (!isSigned) {
+    if (range.lo < 0)
+      return 64;
+    return range.hi == 0 ? 1 : llvm::Log2_64((uint64_t)range.hi) + 1;
+  }
+
+  uint64_t width = 1;
+  while (width < 64 && (range.lo < -((int64_t)1 << (width - 1)) ||
+                        range.hi >= ((int64_t)1 << (width - 1))))
+    width++;
+  return width;
+}
+
+/// Returns the index of the table entry selected by an encrypted integer of
+/// `width` bits holding `value`, i.e. the bit pattern of `value`.
+size_t toTableIndex(int64_t value, uint64_t width) {
+  return (uint64_t)value & (((uint64_t)1 << width) - 1);
+}
+
+/// Returns the value held by an encrypted integer of `width` bits that selects
+/// the table entry at `index`.
+int64_t fromTableIndex(size_t index, uint64_t width, bool isSigned) {
+  if (isSigned && index >= ((size_t)1 << (width - 1)))
+    return (int64_t)index - ((int64_t)1 << width);
+
+  return (int64_t)index;
+}
+
+/// Returns the values of a constant clear integer or tensor of clear
+/// integers, sign-extended to 64 bits as done when they are lowered.
+std::optional<llvm::SmallVector<int64_t>>
+getConstantClearValues(mlir::Value value) {
+  mlir::Attribute attr;
+  if (!mlir::matchPattern(value, mlir::m_Constant(&attr)))
+    return std::nullopt;
+
+  llvm::SmallVector<int64_t> values;
+  if (auto intAttr = attr.dyn_cast<mlir::IntegerAttr>()) {
+    if (intAttr.getValue().getBitWidth() > 64)
+      return std::nullopt;
+    values.push_back(intAttr.getValue().getSExtValue());
+    return values;
+  }
+
+  auto denseAttr = attr.dyn_cast<mlir::DenseIntElementsAttr>();
+  if (denseAttr == nullptr ||
+      denseAttr.getElementType().getIntOrFloatBitWidth() > 64)
+    return std::nullopt;
+  for (llvm::APInt val : denseAttr.getValues<llvm::APInt>())
+    values.push_back(val.getSExtValue());
+  return values;
+}
+
+/// Returns the range of a constant clear integer or tensor of clear integers.
+std::optional<Range> getConstantClearRange(mlir::Value value) {
+  auto values = getConstantClearValues(value);
+  if (!values.has_value())
+    return std::nullopt;
+  if (values->empty())
+    return Range::of(0);
+
+  auto [min, max] = std::minmax_element(values->begin(), values->end());
+  return Range{*min, *max};
+}
+
+/// Returns the range of the sums of the products of inputs in `input` with
+/// `weights`, where the weight at the flat index `i` contributes to the sum
+/// `groupOf(i)` and `biases` (if any) holds the clear value added to each
+/// sum. Terms may be missing from a sum (e.g. zero padding of convolutions),
+/// each term thus contributes with a range including zero.
+Range getWeightedSumsRange(Range input, llvm::ArrayRef<int64_t> weights,
+                           int64_t numGroups,
+                           llvm::function_ref<int64_t(int64_t)> groupOf,
+                           llvm::ArrayRef<int64_t> biases = {}) {
+  llvm::SmallVector<Range> sums(numGroups, Range::of(0));
+  for (size_t i = 0; i < weights.size(); i++) {
+    Range &sum = sums[groupOf(i)];
+    sum = sum + (input * Range::of(weights[i])).join(Range::of(0));
+  }
+
+  std::optional<Range> result;
+  for (int64_t group = 0; group < numGroups; group++) {
+    Range sum = sums[group];
+    if (!biases.empty())
+      sum = sum + Range::of(biases[group]);
+    result = result.has_value() ? result->join(sum) : sum;
+  }
+  return result.value_or(Range::of(0));
+}
+
+bool isLookup(mlir::Operation *op) {
+  return llvm::isa<FHE::ApplyLookupTableEintOp,
+                   FHELinalg::ApplyLookupTableEintOp,
+                   FHELinalg::ApplyMultiLookupTableEintOp,
+                   FHELinalg::ApplyMappedLookupTableEintOp>(op);
+}
+
+/// Leveled operations and tensor operations, whose encrypted operands and
+/// results must have the same width, and whose semantics do not depend on
+/// this width.
+bool isSameWidthOp(mlir::Operation *op) {
+  return llvm::isa<
+      FHE::ZeroEintOp, FHE::ZeroTensorOp, FHE::AddEintIntOp, FHE::AddEintOp,
+      FHE::SubIntEintOp, FHE::SubEintIntOp, FHE::SubEintOp, FHE::NegEintOp,
+      FHE::MulEintIntOp, FHE::MulEintOp, FHE::MaxEintOp,
+      FHELinalg::AddEintIntOp, FHELinalg::AddEintOp, FHELinalg::SubIntEintOp,
+      FHELinalg::SubEintIntOp, FHELinalg::SubEintOp, FHELinalg::NegEintOp,
+      FHELinalg::MulEintIntOp, FHELinalg::MulEintOp, FHELinalg::Dot,
+      FHELinalg::DotEint, FHELinalg::MatMulEintIntOp,
+      FHELinalg::MatMulIntEintOp, FHELinalg::MatMulEintEintOp,
+      FHELinalg::SumOp, FHELinalg::ConcatOp, FHELinalg::Conv2dOp,
+      FHELinalg::Maxpool2dOp, FHELinalg::TransposeOp,
+      FHELinalg::FromElementOp, mlir::tensor::ExtractOp,
+      mlir::tensor::InsertOp, mlir::tensor::FromElementsOp,
+      mlir::tensor::ExtractSliceOp, mlir::tensor::InsertSliceOp,
+      mlir::tensor::ExpandShapeOp, mlir::tensor::CollapseShapeOp>(op);
+}
+
+/// Analysis of the ranges of the encrypted integers of a function, and of the
+/// classes of encrypted integers that must share the same width.
+class WidthAnalysis {
+public:
+  void run(mlir::func::FuncOp func) {
+    func.walk<mlir::WalkOrder::PreOrder>(
+        [&](mlir::Operation *op) { visit(op); });
+
+    // Function arguments are encoded by the client and block arguments are
+    // not rewritten, keep their width
+    func.walk([&](mlir::Block *block) {
+      for (mlir::BlockArgument arg : block->getArguments()) {
+        if (isEncrypted(arg))
+          pin(arg);
+      }
+    });
+  }
+
+  /// Returns the new width of the classes of encrypted integers that can be
+  /// shrunk, indexed by the representative of the class.
+  llvm::DenseMap<mlir::Value, uint64_t> getNewWidths() {
+    llvm::DenseSet<mlir::Value> pinnedClasses;
+    for (mlir::Value value : pinned)
+      pinnedClasses.insert(find(value));
+
+    llvm::DenseMap<mlir::Value, uint64_t> requiredWidths;
+    llvm::DenseMap<mlir::Value, uint64_t> currentWidths;
+    llvm::DenseSet<mlir::Value> mixedWidthClasses;
+    for (mlir::Value value : values) {
+      mlir::Value root = find(value);
+      auto type = getEncryptedElementType(value.getType());
+      uint64_t &required = requiredWidths[root];
+      required = std::max(required,
+                          getRequiredWidth(getRange(value), type.isSigned()));
+      auto [it, inserted] = currentWidths.insert({root, type.getWidth()});
+      if (!inserted && it->second != type.getWidth())
+        mixedWidthClasses.insert(root);
+    }
+    for (const Constraint &constraint : constraints) {
+      uint64_t &required = requiredWidths[find(constraint.value)];
+      required = std::max(
+          required, getRequiredWidth(constraint.range, constraint.isSigned));
+    }
+
+    llvm::DenseMap<mlir::Value, uint64_t> newWidths;
+    for (auto [root, required] : requiredWidths) {
+      if (pinnedClasses.contains(root) || mixedWidthClasses.contains(root) ||
+          required >= currentWidths[root])
+        continue;
+      newWidths[root] = required;
+    }
+    return newWidths;
+  }
+
+  mlir::Value find(mlir::Value value) {
+    mlir::Value root = value;
+    while (true) {
+      auto it = parents.find(root);
+      if (it == parents.end() || it->second == root)
+        break;
+      root = it->second;
+    }
+    while (value != root) {
+      mlir::Value next = parents.lookup(value);
+      parents[value] = root;
+      value = next;
+    }
+    return root;
+  }
+
+  /// Encrypted integers whose width is kept or shrunk, in the order they are
+  /// defined.
+  llvm::SmallVector<mlir::Value> values;
+  /// Table lookups with constant tables.
+  llvm::SmallVector<mlir::Operation *> lookups;
+  /// Operations with encrypted integers of the same width and constant clear
+  /// operands.
+  llvm::SmallVector<mlir::Operation *> clearOperandOps;
+
+private:
+  /// Additional range of an intermediate value computed from the encrypted
+  /// integers of a class when the operation is lowered, e.g. `x + y` and
+  /// `x - y` for the multiplication of encrypted integers.
+  struct Constraint {
+    mlir::Value value;
+    Range range;
+    bool isSigned;
+  };
+
+  void addValue(mlir::Value value) {
+    if (parents.insert({value, value}).second)
+      values.push_back(value);
+  }
+
+  void merge(mlir::Value a, mlir::Value b) {
+    mlir::Value rootA = find(a);
+    mlir::Value rootB = find(b);
+    if (rootA != rootB)
+      parents[rootA] = rootB;
+  }
+
+  void pin(mlir::Value value) {
+    addValue(value);
+    pinned.push_back(value);
+  }
+
+  Range getRange(mlir::Value value) {
+    auto it = ranges.find(value);
+    if (it != ranges.end())
+      return it->second;
+    return getFullRange(getEncryptedElementType(value.getType()));
+  }
+
+  void setRange(mlir::Value value, Range range) {
+    // A range exceeding the values of the type means that the value may
+    // overflow, keep its width
+    Range fullRange = getFullRange(getEncryptedElementType(value.getType()));
+    ranges[value] = range.lo < fullRange.lo || range.hi > fullRange.hi
+                        ? fullRange
+                        : range;
+  }
+
+  void visit(mlir::Operation *op) {
+    llvm::SmallVector<mlir::Value> encrypted;
+    for (mlir::Value operand : op->getOperands()) {
+      if (isEncrypted(operand))
+        encrypted.push_back(operand);
+    }
+    for (mlir::Value result : op->getResults()) {
+      if (isEncrypted(result))
+        encrypted.push_back(result);
+    }
+    if (encrypted.empty())
+      return;
+    for (mlir::Value value : encrypted)
+      addValue(value);
+
+    if (isLookup(op)) {
+      visitLookup(op);
+      return;
+    }
+
+    if (llvm::isa<FHE::RoundEintOp, FHELinalg::RoundOp>(op)) {
+      // The rounding depends on the input width, keep it
+      pin(op->getOperand(0));
+      Range input = getRange(op->getOperand(0));
+      uint64_t shift =
+          getEncryptedElementType(op->getOperand(0).getType()).getWidth() -
+          getEncryptedElementType(op->getResult(0).getType()).getWidth();
+      int64_t half = shift == 0 ? 0 : (int64_t)1 << (shift - 1);
+      setRange(op->getResult(0), Range{addSat(input.lo, half) >> shift,
+                                       addSat(input.hi, half) >> shift});
+      return;
+    }
+
+    if (llvm::isa<FHE::ReinterpretPrecisionEintOp,
+                  FHELinalg::ReinterpretPrecisionEintOp>(op)) {
+      // The reinterpretation shifts the value by the difference of widths,
+      // keep both of them
+      pin(op->getOperand(0));
+      pin(op->getResult(0));
+      Range input = getRange(op->getOperand(0));
+      int64_t inputWidth =
+          getEncryptedElementType(op->getOperand(0).getType()).getWidth();
+      int64_t outputWidth =
+          getEncryptedElementType(op->getResult(0).getType()).getWidth();
+      if (outputWidth >= inputWidth) {
+        Range scale = Range::of((int64_t)1 << (outputWidth - inputWidth));
+        setRange(op->getResult(0), input * scale);
+      } else {
+        // The discarded bits may round the value up
+        int64_t shift = inputWidth - outputWidth;
+        setRange(op->getResult(0),
+                 Range{input.lo >> shift,
+                       addSat(input.hi, ((int64_t)1 << shift) - 1) >> shift});
+      }
+      return;
+    }
+
+    if (!isSameWidthOp(op)) {
+      for (mlir::Value value : encrypted)
+        pin(value);
+      return;
+    }
+
+    for (mlir::Value value : encrypted)
+      merge(encrypted.front(), value);
+
+    bool hasClearOperand = false;
+    for (mlir::Value operand : op->getOperands()) {
+      if (!isClear(operand))
+        continue;
+      hasClearOperand = true;
+      // Only constants can be truncated to the new width
+      if (!getConstantClearValues(operand).has_value())
+        pin(encrypted.front());
+    }
+    if (hasClearOperand)
+      clearOperandOps.push_back(op);
+
+    addConstraints(op);
+    for (mlir::Value result : op->getResults()) {
+      if (!isEncrypted(result))
+        continue;
+      if (auto range = getSameWidthOpRange(op))
+        setRange(result, *range);
+    }
+  }
+
+  void visitLookup(mlir::Operation *op) {
+    mlir::Value input = op->getOperand(0);
+    mlir::Value result = op->getResult(0);
+
+    mlir::DenseIntElementsAttr tables;
+    if (!mlir::matchPattern(op->getOperand(1), mlir::m_Constant(&tables)) ||
+        tables.getElementType().getIntOrFloatBitWidth() > 64) {
+      // The tables cannot be truncated, keep the input width
+      pin(input);
+      return;
+    }
+    lookups.push_back(op);
+
+    auto inputType = getEncryptedElementType(input.getType());
+    bool isSigned = getEncryptedElementType(result.getType()).isSigned();
+    uint64_t width = inputType.getWidth();
+    int64_t lutSize = (int64_t)1 << width;
+    Range inputRange = getRange(input);
+    bool allEntries = subSat(inputRange.hi, inputRange.lo) >= lutSize - 1;
+
+    std::vector<int64_t> entries;
+    entries.reserve(tables.getNumElements());
+    for (llvm::APInt val : tables.getValues<llvm::APInt>()) {
+      entries.push_back(isSigned ? val.getSExtValue()
+                                 : (int64_t)val.getZExtValue());
+    }
+
+    std::optional<Range> range;
+    auto addEntry = [&](int64_t entry) {
+      range = range.has_value() ? range->join(Range::of(entry))
+                                : Range::of(entry);
+    };
+    for (size_t offset = 0; offset < entries.size(); offset += lutSize) {
+      if (allEntries) {
+        for (int64_t index = 0; index < lutSize; index++)
+          addEntry(entries[offset + index]);
+        continue;
+      }
+      // Only the entries selected by the range of the input are reachable
+      for (int64_t value = inputRange.lo; value <= inputRange.hi; value++)
+        addEntry(entries[offset + toTableIndex(value, width)]);
+    }
+    if (range.has_value())
+      setRange(result, *range);
+  }
+
+  void addConstraints(mlir::Operation *op) {
+    auto addConstraint = [&](Range range, bool isSigned) {
+      constraints.push_back(Constraint{op->getResult(0), range, isSigned});
+    };
+    bool isSigned =
+        getEncryptedElementType(op->getResult(0).getType()).isSigned();
+
+    // The multiplications of encrypted integers are lowered to table lookups
+    // on `x + y` and on the signed `x - y`
+    if (llvm::isa<FHE::MulEintOp, FHELinalg::MulEintOp, FHELinalg::DotEint,
+                  FHELinalg::MatMulEintEintOp>(op)) {
+      Range lhs = getRange(op->getOperand(0));
+      Range rhs = getRange(op->getOperand(1));
+      addConstraint(lhs + rhs, isSigned);
+      addConstraint(lhs - rhs, true);
+      return;
+    }
+
+    // The maximums are lowered to a table lookup on the signed `x - y`
+    if (llvm::isa<FHE::MaxEintOp>(op)) {
+      addConstraint(getRange(op->getOperand(0)) - getRange(op->getOperand(1)),
+                    true);
+      return;
+    }
+    if (llvm::isa<FHELinalg::Maxpool2dOp>(op)) {
+      Range input = getRange(op->getOperand(0));
+      addConstraint(input - input, true);
+    }
+  }
+
+  /// Returns the range of the encrypted result of an operation of
+  /// `isSameWidthOp`, or `std::nullopt` if it cannot be determined.
+  std::optional<Range> getSameWidthOpRange(mlir::Operation *op) {
+    auto operand = [&](unsigned index) {
+      return getRange(op->getOperand(index));
+    };
+    auto clear = [&](unsigned index) {
+      return getConstantClearRange(op->getOperand(index));
+    };
+    auto shapeOf = [&](unsigned index) {
+      return op->getOperand(index)
+          .getType()
+          .cast<mlir::RankedTensorType>()
+          .getShape();
+    };
+
+    if (llvm::isa<FHE::ZeroEintOp, FHE::ZeroTensorOp>(op))
+      return Range::of(0);
+
+    if (llvm::isa<FHE::AddEintOp, FHELinalg::AddEintOp>(op))
+      return operand(0) + operand(1);
+
+    if (llvm::isa<FHE::SubEintOp, FHELinalg::SubEintOp>(op))
+      return operand(0) - operand(1);
+
+    if (llvm::isa<FHE::NegEintOp, FHELinalg::NegEintOp>(op))
+      return Range::of(0) - operand(0);
+
+    if (llvm::isa<FHE::MulEintOp, FHELinalg::MulEintOp>(op))
+      return operand(0) * operand(1);
+
+    if (llvm::isa<FHE::MaxEintOp>(op)) {
+      Range x = operand(0), y = operand(1);
+      return Range{std::max(x.lo, y.lo), std::max(x.hi, y.hi)};
+    }
+
+    if (llvm::isa<FHE::AddEintIntOp, FHELinalg::AddEintIntOp>(op)) {
+      if (auto cst = clear(1))
+        return operand(0) + *cst;
+      return std::nullopt;
+    }
+
+    if (llvm::isa<FHE::SubEintIntOp, FHELinalg::SubEintIntOp>(op)) {
+      if (auto cst = clear(1))
+        return operand(0) - *cst;
+      return std::nullopt;
+    }
+
+    if (llvm::isa<FHE::SubIntEintOp, FHELinalg::SubIntEintOp>(op)) {
+      if (auto cst = clear(0))
+        return *cst - operand(1);
+      return std::nullopt;
+    }
+
+    if (llvm::isa<FHE::MulEintIntOp, FHELinalg::MulEintIntOp>(op)) {
+      if (auto cst = clear(1))
+        return operand(0) * *cst;
+      return std::nullopt;
+    }
+
+    if (llvm::isa<FHELinalg::Dot>(op)) {
+      auto weights = getConstantClearValues(op->getOperand(1));
+      if (!weights.has_value())
+        return std::nullopt;
+      return getWeightedSumsRange(operand(0), *weights, 1,
+                                  [](int64_t) { return 0; });
+    }
+
+    if (llvm::isa<FHELinalg::MatMulEintIntOp>(op)) {
+      auto weights = getConstantClearValues(op->getOperand(1));
+      if (!weights.has_value() || weights->empty())
+        return std::nullopt;
+      // Each result sums a column of the weights
+      auto shape = shapeOf(1);
+      int64_t k = shape.size() == 1 ? shape[0] : shape[shape.size() - 2];
+      int64_t n = shape.size() == 1 ? 1 : shape.back();
+      return getWeightedSumsRange(
+          operand(0), *weights, weights->size() / k,
+          [&](int64_t i) { return (i / (k * n)) * n + i % n; });
+    }
+
+    if (llvm::isa<FHELinalg::MatMulIntEintOp>(op)) {
+      auto weights = getConstantClearValues(op->getOperand(0));
+      if (!weights.has_value() || weights->empty())
+        return std::nullopt;
+      // Each result sums a row of the weights
+      int64_t k = shapeOf(0).back();
+      return getWeightedSumsRange(operand(1), *weights, weights->size() / k,
+                                  [&](int64_t i) { return i / k; });
+    }
+
+    if (llvm::isa<FHELinalg::Conv2dOp>(op)) {
+      auto weights = getConstantClearValues(op->getOperand(1));
+      if (!weights.has_value() || weights->empty())
+        return std::nullopt;
+      std::optional<llvm::SmallVector<int64_t>> biases;
+      if (op->getNumOperands() > 2) {
+        biases = getConstantClearValues(op->getOperand(2));
+        if (!biases.has_value())
+          return std::nullopt;
+      }
+      // Each output channel sums the weights of a filter
+      int64_t filters = shapeOf(1)[0];
+      int64_t filterSize = weights->size() / filters;
+      return getWeightedSumsRange(
+          operand(0), *weights, filters,
+          [&](int64_t i) { return i / filterSize; },
+          biases.value_or(llvm::SmallVector<int64_t>{}));
+    }
+
+    if (llvm::isa<FHELinalg::DotEint>(op)) {
+      Range terms = Range::of(getNumElements(op->getOperand(0).getType()));
+      return operand(0) * operand(1) * terms;
+    }
+
+    if (llvm::isa<FHELinalg::MatMulEintEintOp>(op)) {
+      Range terms = Range::of(shapeOf(0).back());
+      return operand(0) * operand(1) * terms;
+    }
+
+    if (llvm::isa<FHELinalg::SumOp>(op)) {
+      int64_t inputSize = getNumElements(op->getOperand(0).getType());
+      int64_t outputSize = getNumElements(op->getResult(0).getType());
+      int64_t terms = outputSize == 0 ? 0 : inputSize / outputSize;
+      return operand(0) * Range::of(terms);
+    }
+
+    if (llvm::isa<FHELinalg::ConcatOp, mlir::tensor::FromElementsOp,
+                  mlir::tensor::InsertOp, mlir::tensor::InsertSliceOp>(op)) {
+      std::optional<Range> range;
+      for (mlir::Value value : op->getOperands()) {
+        if (!isEncrypted(value))
+          continue;
+        range = range.has_value() ? range->join(getRange(value))
+                                  : getRange(value);
+      }
+      return range;
+    }
+
+    // Operations forwarding the values of their encrypted operand
+    return operand(0);
+  }
+
+  llvm::DenseMap<mlir::Value, mlir::Value> parents;
+  llvm::SmallVector<mlir::Value> pinned;
+  llvm::DenseMap<mlir::Value, Range> ranges;
+  llvm::SmallVector<Constraint> constraints;
+};
+
+mlir::Type withElementType(mlir::Type type, mlir::Type elementType) {
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    return tensorTy.clone(elementType);
+
+  return elementType;
+}
+
+/// Truncates the tables of `lookup`, whose input is shrunk from `width` to
+/// `newWidth` bits, to the entries selected by the new input.
+void truncateTables(mlir::Operation *lookup, uint64_t width,
+                    uint64_t newWidth) {
+  mlir::DenseIntElementsAttr tables;
+  mlir::matchPattern(lookup->getOperand(1), mlir::m_Constant(&tables));
+  bool isSigned =
+      getEncryptedElementType(lookup->getOperand(0).getType()).isSigned();
+
+  auto entries = llvm::to_vector(tables.getValues<llvm::APInt>());
+  size_t lutSize = (size_t)1 << width;
+  size_t newLutSize = (size_t)1 << newWidth;
+  std::vector<llvm::APInt> newEntries;
+  newEntries.reserve(entries.size() / lutSize * newLutSize);
+  for (size_t offset = 0; offset < entries.size(); offset += lutSize) {
+    for (size_t index = 0; index < newLutSize; index++) {
+      int64_t value = fromTableIndex(index, newWidth, isSigned);
+      newEntries.push_back(entries[offset + toTableIndex(value, width)]);
+    }
+  }
+
+  auto tablesType = tables.getType().cast<mlir::RankedTensorType>();
+  llvm::SmallVector<int64_t> shape(tablesType.getShape());
+  shape.back() = newLutSize;
+  mlir::OpBuilder builder(lookup);
+  mlir::Value newTables = builder.create<mlir::arith::ConstantOp>(
+      lookup->getLoc(),
+      mlir::DenseIntElementsAttr::get(
+          mlir::RankedTensorType::get(shape, tablesType.getElementType()),
+          newEntries));
+  lookup->setOperand(1, newTables);
+}
+
+/// Truncates the constant clear operands of `op`, whose encrypted integers
+/// are shrunk to `newWidth` bits. The truncation keeps the values modulo the
+/// message space of the new width.
+void truncateClearOperands(mlir::Operation *op, uint64_t newWidth) {
+  // The scalar operations need clear operands of exactly one more bit than
+  // the encrypted ones, the tensor operations of at most one more bit
+  bool exactWidth = llvm::isa<FHE::FHEDialect>(op->getDialect());
+  mlir::OpBuilder builder(op);
+  for (mlir::OpOperand &operand : op->getOpOperands()) {
+    if (!isClear(operand.get()))
+      continue;
+    uint64_t width = getClearElementType(operand.get().getType()).getWidth();
+    uint64_t newClearWidth =
+        exactWidth ? newWidth + 1 : std::min<uint64_t>(width, newWidth + 1);
+    if (newClearWidth == width)
+      continue;
+
+    mlir::Attribute attr;
+    mlir::matchPattern(operand.get(), mlir::m_Constant(&attr));
+    mlir::IntegerType newIntType = builder.getIntegerType(newClearWidth);
+    mlir::TypedAttr newAttr;
+    if (auto intAttr = attr.dyn_cast<mlir::IntegerAttr>()) {
+      newAttr = builder.getIntegerAttr(
+          newIntType, intAttr.getValue().trunc(newClearWidth));
+    } else {
+      newAttr = attr.cast<mlir::DenseIntElementsAttr>().mapValues(
+          newIntType,
+          [&](const llvm::APInt &val) { return val.trunc(newClearWidth); });
+    }
+    operand.set(
+        builder.create<mlir::arith::ConstantOp>(op->getLoc(), newAttr));
+  }
+}
+
+struct BitWidthMinimizationPass
+    : public BitWidthMinimizationBase<BitWidthMinimizationPass> {
+  void runOnOperation() override {
+    mlir::func::FuncOp func = getOperation();
+
+    WidthAnalysis analysis;
+    analysis.run(func);
+    llvm::DenseMap<mlir::Value, uint64_t> newWidths = analysis.getNewWidths();
+    if (newWidths.empty())
+      return;
+
+    auto getNewWidth = [&](mlir::Value value) -> std::optional<uint64_t> {
+      auto it = newWidths.find(analysis.find(value));
+      if (it == newWidths.end())
+        return std::nullopt;
+      return it->second;
+    };
+
+    // Collect the constants that may become unused before rewriting their
+    // users
+    llvm::SetVector<mlir::Operation *> constants;
+    auto collectConstant = [&](mlir::Value value) {
+      if (auto cstOp = value.getDefiningOp<mlir::arith::ConstantOp>())
+        constants.insert(cstOp);
+    };
+
+    // Rewrite the tables and the clear operands while the encrypted integers
+    // still have their original width
+    for (mlir::Operation *lookup : analysis.lookups) {
+      mlir::Value input = lookup->getOperand(0);
+      if (auto newWidth = getNewWidth(input)) {
+        collectConstant(lookup->getOperand(1));
+        truncateTables(lookup,
+                       getEncryptedElementType(input.getType()).getWidth(),
+                       *newWidth);
+      }
+    }
+
+    for (mlir::Operation *op : analysis.clearOperandOps) {
+      mlir::Value encrypted = *llvm::find_if(op->getResults(), isEncrypted);
+      if (auto newWidth = getNewWidth(encrypted)) {
+        for (mlir::Value operand : op->getOperands()) {
+          if (isClear(operand))
+            collectConstant(operand);
+        }
+        truncateClearOperands(op, *newWidth);
+      }
+    }
+
+    for (mlir::Value value : analysis.values) {
+      auto newWidth = getNewWidth(value);
+      if (!newWidth.has_value())
+        continue;
+      auto type = getEncryptedElementType(value.getType());
+      mlir::Type newElementType =
+          type.isSigned()
+              ? (mlir::Type)FHE::EncryptedSignedIntegerType::get(&getContext(),
+                                                                 *newWidth)
+              : (mlir::Type)FHE::EncryptedUnsignedIntegerType::get(
+                    &getContext(), *newWidth);
+      value.setType(withElementType(value.getType(), newElementType));
+    }
+
+    for (mlir::Operation *cstOp : constants) {
+      if (cstOp->use_empty())
+        cstOp->erase();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createBitWidthMinimizationPass() {
+  return std::make_unique<BitWidthMinimizationPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,458 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/IR/PatternMatch.h>
+#include <mlir/Transforms/GreedyPatternRewriteDriver.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/LookupTableComposition.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Constant tables of a table lookup operation. The table applied to the
+/// element at the flat index `i` is `tables[map[i]]`. For scalar lookups and
+/// for `FHELinalg.apply_lookup_table`, `map` is empty and the single table
+/// is applied to all elements.
+struct ConstantLookup {
+  std::vector<std::vector<int64_t>> tables;
+  std::vector<int64_t> map;
+
+  const std::vector<int64_t> &tableOf(size_t element) const {
+    return map.empty() ? tables[0] : tables[map[element]];
+  }
+};
+
+FHE::FheIntegerInterface getEncryptedElementType(mlir::Type type) {
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    return tensorTy.getElementType().cast<FHE::FheIntegerInterface>();
+
+  return type.cast<FHE::FheIntegerInterface>();
+}
+
+int64_t getNumElements(mlir::Type type) {
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    return tensorTy.getNumElements();
+
+  return 1;
+}
+
+bool isLookup(mlir::Operation *op) {
+  return llvm::isa_and_nonnull<FHE::ApplyLookupTableEintOp,
+                               FHELinalg::ApplyLookupTableEintOp,
+                               FHELinalg::ApplyMappedLookupTableEintOp>(op);
+}
+
+/// Returns the values of a constant integer tensor, extended to 64 bits.
+/// Values are sign-extended if `isSigned` is set and zero-extended otherwise,
+/// following the extension done when luts are lowered.
+std::optional<std::vector<int64_t>> getConstantValues(mlir::Value value,
+                                                      bool isSigned) {
+  auto cstOp =
+      llvm::dyn_cast_or_null<mlir::arith::ConstantOp>(value.getDefiningOp());
+  if (cstOp == nullptr)
+    return std::nullopt;
+
+  auto denseVals = cstOp.getValueAttr().dyn_cast<mlir::DenseIntElementsAttr>();
+  if (denseVals == nullptr)
+    return std::nullopt;
+
+  std::vector<int64_t> values;
+  values.reserve(denseVals.getNumElements());
+  for (llvm::APInt val : denseVals.getValues<llvm::APInt>()) {
+    values.push_back(isSigned ? val.getSExtValue()
+                              : (int64_t)val.getZExtValue());
+  }
+  return values;
+}
+
+/// Extracts the constant tables of a lookup operation, returns `std::nullopt`
+/// if the tables or the map are not compile-time constants.
+std::optional<ConstantLookup> getConstantLookup(mlir::Operation *op) {
+  bool isSigned =
+      getEncryptedElementType(op->getResult(0).getType()).isSigned();
+  ConstantLookup lookup;
+
+  if (llvm::isa<FHE::ApplyLookupTableEintOp, FHELinalg::ApplyLookupTableEintOp>(
+          op)) {
+    auto table = getConstantValues(op->getOperand(1), isSigned);
+    if (!table.has_value())
+      return std::nullopt;
+
+    lookup.tables.push_back(std::move(*table));
+    return lookup;
+  }
+
+  if (auto mappedOp =
+          llvm::dyn_cast<FHELinalg::ApplyMappedLookupTableEintOp>(op)) {
+    auto luts = getConstantValues(mappedOp.getLuts(), isSigned);
+    auto map = getConstantValues(mappedOp.getMap(), false);
+    if (!luts.has_value() || !map.has_value())
+      return std::nullopt;
+
+    size_t lutSize = (size_t)1
+                     << getEncryptedElementType(mappedOp.getT().getType())
+                            .getWidth();
+    for (size_t offset = 0; offset < luts->size(); offset += lutSize) {
+      lookup.tables.emplace_back(luts->begin() + offset,
+                                 luts->begin() + offset + lutSize);
+    }
+    for (int64_t tableIndex : *map) {
+      if (tableIndex < 0 || (size_t)tableIndex >= lookup.tables.size())
+        return std::nullopt;
+    }
+    lookup.map = std::move(*map);
+    return lookup;
+  }
+
+  return std::nullopt;
+}
+
+/// Checks whether `value` can be represented by an encrypted integer of type
+/// `type` without overflowing into the padding bit.
+bool fitsInEncryptedType(int64_t value, FHE::FheIntegerInterface type) {
+  int64_t width = type.getWidth();
+  if (type.isSigned()) {
+    return value >= -((int64_t)1 << (width - 1)) &&
+           value < ((int64_t)1 << (width - 1));
+  }
+  return value >= 0 && value < ((int64_t)1 << width);
+}
+
+/// Returns the index of the table entry selected by an encrypted integer of
+/// type `type` holding `value`, i.e. the bit pattern of `value`.
+size_t toTableIndex(int64_t value, FHE::FheIntegerInterface type) {
+  return (uint64_t)value & (((uint64_t)1 << type.getWidth()) - 1);
+}
+
+/// Returns the value held by an encrypted integer of type `type` that selects
+/// the table entry at `index`.
+int64_t fromTableIndex(size_t index, FHE::FheIntegerInterface type) {
+  int64_t width = type.getWidth();
+  if (type.isSigned() && index >= ((size_t)1 << (width - 1)))
+    return (int64_t)index - ((int64_t)1 << width);
+
+  return (int64_t)index;
+}
+
+/// Composes `outer` after `inner`, where the result of `inner` is an
+/// encrypted integer of type `intermediateType`. Returns `std::nullopt` if a
+/// value of an inner table does not fit in the intermediate precision, in
+/// which case the two lookups cannot be composed.
+std::optional<ConstantLookup>
+composeLookups(const ConstantLookup &inner, const ConstantLookup &outer,
+               FHE::FheIntegerInterface intermediateType,
+               int64_t numElements) {
+  for (auto &table : inner.tables) {
+    for (int64_t value : table) {
+      if (!fitsInEncryptedType(value, intermediateType))
+        return std::nullopt;
+    }
+  }
+
+  auto compose = [&](const std::vector<int64_t> &innerTable,
+                     const std::vector<int64_t> &outerTable) {
+    std::vector<int64_t> table;
+    table.reserve(innerTable.size());
+    for (int64_t value : innerTable)
+      table.push_back(outerTable[toTableIndex(value, intermediateType)]);
+    return table;
+  };
+
+  ConstantLookup composed;
+  if (inner.map.empty() && outer.map.empty()) {
+    composed.tables.push_back(compose(inner.tables[0], outer.tables[0]));
+    return composed;
+  }
+
+  // At least one of the lookups is mapped: create one table per distinct
+  // pair of (inner, outer) tables used by the elements.
+  std::map<std::pair<size_t, size_t>, size_t> pairToTable;
+  composed.map.reserve(numElements);
+  for (int64_t element = 0; element < numElements; element++) {
+    size_t innerIndex = inner.map.empty() ? 0 : inner.map[element];
+    size_t outerIndex = outer.map.empty() ? 0 : outer.map[element];
+    auto it = pairToTable.find({innerIndex, outerIndex});
+    if (it == pairToTable.end()) {
+      it = pairToTable
+               .insert({{innerIndex, outerIndex}, composed.tables.size()})
+               .first;
+      composed.tables.push_back(
+          compose(inner.tables[innerIndex], outer.tables[outerIndex]));
+    }
+    composed.map.push_back(it->second);
+  }
+  return composed;
+}
+
+/// Creates the lookup operation applying `lookup` to `input`.
+mlir::Value createLookup(mlir::PatternRewriter &rewriter, mlir::Location loc,
+                         mlir::Type resultType, mlir::Value input,
+                         const ConstantLookup &lookup) {
+  mlir::Type i64Ty = rewriter.getIntegerType(64);
+  auto createTableConstant = [&](llvm::ArrayRef<int64_t> shape,
+                                 llvm::ArrayRef<int64_t> values) {
+    return rewriter
+        .create<mlir::arith::ConstantOp>(
+            loc, mlir::DenseIntElementsAttr::get(
+                     mlir::RankedTensorType::get(shape, i64Ty), values))
+        .getResult();
+  };
+
+  bool singleTable = lookup.map.empty() || lookup.tables.size() == 1;
+  int64_t lutSize = lookup.tables[0].size();
+
+  if (!resultType.isa<mlir::RankedTensorType>()) {
+    mlir::Value lut = createTableConstant({lutSize}, lookup.tables[0]);
+    return rewriter.create<FHE::ApplyLookupTableEintOp>(loc, resultType, input,
+                                                        lut);
+  }
+
+  if (singleTable) {
+    mlir::Value lut = createTableConstant({lutSize}, lookup.tables[0]);
+    return rewriter.create<FHELinalg::ApplyLookupTableEintOp>(loc, resultType,
+                                                              input, lut);
+  }
+
+  std::vector<int64_t> flatLuts;
+  flatLuts.reserve(lookup.tables.size() * lutSize);
+  for (auto &table : lookup.tables)
+    flatLuts.insert(flatLuts.end(), table.begin(), table.end());
+
+  mlir::Value luts = createTableConstant(
+      {(int64_t)lookup.tables.size(), lutSize}, flatLuts);
+
+  llvm::SmallVector<llvm::APInt> mapValues;
+  mapValues.reserve(lookup.map.size());
+  for (int64_t tableIndex : lookup.map)
+    mapValues.push_back(llvm::APInt(64, tableIndex));
+
+  mlir::Value map = rewriter.create<mlir::arith::ConstantOp>(
+      loc, mlir::DenseIntElementsAttr::get(
+               mlir::RankedTensorType::get(
+                   resultType.cast<mlir::RankedTensorType>().getShape(),
+                   rewriter.getIndexType()),
+               mapValues));
+
+  return rewriter.create<FHELinalg::ApplyMappedLookupTableEintOp>(
+      loc, resultType, input, luts, map);
+}
+
+/// Rewrites `tlu(tlu(x, T1), T2)` to `tlu(x, T2∘T1)` if the inner lookup has
+/// a single use and its results fit in the intermediate precision.
+template <typename LookupOp>
+struct ComposeLookupsPattern : public mlir::OpRewritePattern<LookupOp> {
+  ComposeLookupsPattern(mlir::MLIRContext *context, uint64_t &eliminated)
+      : mlir::OpRewritePattern<LookupOp>(context), eliminated(eliminated) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(LookupOp op, mlir::PatternRewriter &rewriter) const override {
+    mlir::Operation *innerOp = op->getOperand(0).getDefiningOp();
+    if (!isLookup(innerOp) || !innerOp->hasOneUse())
+      return mlir::failure();
+
+    auto outer = getConstantLookup(op);
+    auto inner = getConstantLookup(innerOp);
+    if (!outer.has_value() || !inner.has_value())
+      return mlir::failure();
+
+    mlir::Type intermediateType = innerOp->getResult(0).getType();
+    int64_t numElements = getNumElements(intermediateType);
+    auto composed =
+        composeLookups(*inner, *outer,
+                       getEncryptedElementType(intermediateType), numElements);
+    if (!composed.has_value())
+      return mlir::failure();
+
+    mlir::Value result =
+        createLookup(rewriter, op.getLoc(), op.getResult().getType(),
+                     innerOp->getOperand(0), *composed);
+    rewriter.replaceOp(op, result);
+    rewriter.eraseOp(innerOp);
+
+    eliminated += numElements;
+    return mlir::success();
+  }
+
+private:
+  uint64_t &eliminated;
+};
+
+/// Removes table lookups whose tables map every value to itself.
+template <typename LookupOp>
+struct RemoveIdentityLookupPattern : public mlir::OpRewritePattern<LookupOp> {
+  RemoveIdentityLookupPattern(mlir::MLIRContext *context, uint64_t &eliminated)
+      : mlir::OpRewritePattern<LookupOp>(context), eliminated(eliminated) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(LookupOp op, mlir::PatternRewriter &rewriter) const override {
+    mlir::Value input = op->getOperand(0);
+    if (input.getType() != op.getResult().getType())
+      return mlir::failure();
+
+    auto lookup = getConstantLookup(op);
+    if (!lookup.has_value())
+      return mlir::failure();
+
+    std::set<size_t> usedTables;
+    if (lookup->map.empty())
+      usedTables.insert(0);
+    else
+      usedTables.insert(lookup->map.begin(), lookup->map.end());
+
+    auto type = getEncryptedElementType(input.getType());
+    for (size_t tableIndex : usedTables) {
+      auto &table = lookup->tables[tableIndex];
+      for (size_t index = 0; index < table.size(); index++) {
+        if (table[index] != fromTableIndex(index, type))
+          return mlir::failure();
+      }
+    }
+
+    rewriter.replaceOp(op, input);
+
+    eliminated += getNumElements(input.getType());
+    return mlir::success();
+  }
+
+private:
+  uint64_t &eliminated;
+};
+
+/// Folds table lookups applied to encrypted zeros into encrypted constants,
+/// i.e. an `FHE.zero` / `FHE.zero_tensor` followed by an addition of the
+/// clear values selected by the zero index.
+template <typename LookupOp>
+struct FoldZeroLookupPattern : public mlir::OpRewritePattern<LookupOp> {
+  FoldZeroLookupPattern(mlir::MLIRContext *context, uint64_t &eliminated)
+      : mlir::OpRewritePattern<LookupOp>(context), eliminated(eliminated) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(LookupOp op, mlir::PatternRewriter &rewriter) const override {
+    mlir::Operation *inputOp = op->getOperand(0).getDefiningOp();
+    if (!llvm::isa_and_nonnull<FHE::ZeroEintOp, FHE::ZeroTensorOp>(inputOp))
+      return mlir::failure();
+
+    auto lookup = getConstantLookup(op);
+    if (!lookup.has_value())
+      return mlir::failure();
+
+    mlir::Type resultType = op.getResult().getType();
+    auto resultElementType = getEncryptedElementType(resultType);
+    int64_t numElements = getNumElements(resultType);
+
+    std::vector<int64_t> values;
+    values.reserve(numElements);
+    bool allZeros = true;
+    for (int64_t element = 0; element < numElements; element++) {
+      int64_t value = lookup->tableOf(element)[0];
+      if (!fitsInEncryptedType(value, resultElementType))
+        return mlir::failure();
+      allZeros &= value == 0;
+      values.push_back(value);
+    }
+
+    mlir::Location loc = op.getLoc();
+    mlir::Type cleartextType =
+        rewriter.getIntegerType(resultElementType.getWidth() + 1);
+
+    if (auto tensorTy = resultType.dyn_cast<mlir::RankedTensorType>()) {
+      mlir::Value zero = rewriter.create<FHE::ZeroTensorOp>(loc, resultType);
+      if (allZeros) {
+        rewriter.replaceOp(op, zero);
+      } else {
+        llvm::SmallVector<llvm::APInt> cleartexts;
+        for (int64_t value : values) {
+          cleartexts.push_back(
+              llvm::APInt(cleartextType.getIntOrFloatBitWidth(), value, true));
+        }
+        mlir::Value cst = rewriter.create<mlir::arith::ConstantOp>(
+            loc, mlir::DenseIntElementsAttr::get(
+                     mlir::RankedTensorType::get(tensorTy.getShape(),
+                                                 cleartextType),
+                     cleartexts));
+        rewriter.replaceOpWithNewOp<FHELinalg::AddEintIntOp>(op, resultType,
+                                                             zero, cst);
+      }
+    } else {
+      mlir::Value zero = rewriter.create<FHE::ZeroEintOp>(loc, resultType);
+      if (allZeros) {
+        rewriter.replaceOp(op, zero);
+      } else {
+        mlir::Value cst = rewriter.create<mlir::arith::ConstantOp>(
+            loc, rewriter.getIntegerAttr(cleartextType, values[0]));
+        rewriter.replaceOpWithNewOp<FHE::AddEintIntOp>(op, resultType, zero,
+                                                       cst);
+      }
+    }
+
+    eliminated += numElements;
+    return mlir::success();
+  }
+
+private:
+  uint64_t &eliminated;
+};
+
+template <typename LookupOp>
+void addLookupPatterns(mlir::RewritePatternSet &patterns,
+                       uint64_t &eliminated) {
+  patterns.add<ComposeLookupsPattern<LookupOp>,
+               RemoveIdentityLookupPattern<LookupOp>,
+               FoldZeroLookupPattern<LookupOp>>(patterns.getContext(),
+                                                eliminated);
+}
+
+struct LookupTableCompositionPass
+    : public LookupTableCompositionBase<LookupTableCompositionPass> {
+  LookupTableCompositionPass(
+      std::function<void(uint64_t)> eliminatedPBSCallback)
+      : eliminatedPBSCallback(eliminatedPBSCallback) {}
+
+  void runOnOperation() override {
+    mlir::func::FuncOp func = getOperation();
+    uint64_t eliminated = 0;
+
+    mlir::RewritePatternSet patterns(&getContext());
+    addLookupPatterns<FHE::ApplyLookupTableEintOp>(patterns, eliminated);
+    addLookupPatterns<FHELinalg::ApplyLookupTableEintOp>(patterns, eliminated);
+    addLookupPatterns<FHELinalg::ApplyMappedLookupTableEintOp>(patterns,
+                                                               eliminated);
+
+    if (mlir::applyPatternsAndFoldGreedily(func, std::move(patterns))
+            .failed()) {
+      this->signalPassFailure();
+      return;
+    }
+
+    if (eliminatedPBSCallback)
+      eliminatedPBSCallback(eliminated);
+  }
+
+private:
+  std::function<void(uint64_t)> eliminatedPBSCallback;
+};
+
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createLookupTableCompositionPass(
+    std::function<void(uint64_t)> eliminatedPBSCallback) {
+  return std::make_unique<LookupTableCompositionPass>(eliminatedPBSCallback);
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,431 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/Tensor/IR/Tensor.h>
+#include <mlir/IR/Builders.h>
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <concretelang/Dialect/FHE/IR/FHEOps.h>
+#include <concretelang/Dialect/FHE/IR/FHETypes.h>
+#include <concretelang/Dialect/FHELinalg/IR/FHELinalgOps.h>
+#include <concretelang/Dialect/FHELinalg/Transforms/WinogradConv2d.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Transforms of Winograd F(2x2, 3x3): an output tile of 2x2 elements is
+/// `AT * ((G * g * GT) . (BT * d * B)) * A`, where `d` is the 4x4 input tile
+/// and `g` the 3x3 kernel. `G` has entries of 1/2 and is stored scaled by 2.
+const int64_t BT[4][4] = {
+    {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+const int64_t G2[4][3] = {{2, 0, 0}, {1, 1, 1}, {1, -1, 1}, {0, 0, 2}};
+const int64_t AT[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+
+/// Returns the constant weights of `conv`, if any.
+std::optional<mlir::DenseIntElementsAttr>
+getConstantWeights(FHELinalg::Conv2dOp conv) {
+  auto cstOp = conv.getWeight().getDefiningOp<mlir::arith::ConstantOp>();
+  if (cstOp == nullptr)
+    return std::nullopt;
+  auto weights = cstOp.getValue().dyn_cast<mlir::DenseIntElementsAttr>();
+  if (weights == nullptr)
+    return std::nullopt;
+  return weights;
+}
+
+std::vector<int64_t> getSignedValues(mlir::DenseIntElementsAttr attr) {
+  std::vector<int64_t> values;
+  for (llvm::APInt value : attr.getValues<llvm::APInt>())
+    values.push_back(value.getSExtValue());
+  return values;
+}
+
+/// Returns whether `conv` is a convolution with a 3x3 kernel, unit strides
+/// and dilations, no padding, a single group and an even output size.
+bool hasWinogradShape(FHELinalg::Conv2dOp conv) {
+  auto weightTy = conv.getWeight().getType().cast<mlir::RankedTensorType>();
+  auto resultTy = conv.getResult().getType().cast<mlir::RankedTensorType>();
+  return weightTy.getDimSize(2) == 3 && weightTy.getDimSize(3) == 3 &&
+         resultTy.getDimSize(2) % 2 == 0 && resultTy.getDimSize(3) % 2 == 0 &&
+         FHELinalg::getGroupFromConv2d(conv) == 1 &&
+         llvm::all_of(FHELinalg::getPaddingFromConv2d(conv),
+                      [](int64_t p) { return p == 0; }) &&
+         llvm::all_of(FHELinalg::getStridesFromConv2d(conv),
+                      [](int64_t s) { return s == 1; }) &&
+         llvm::all_of(FHELinalg::getDilationsFromConv2d(conv),
+                      [](int64_t d) { return d == 1; });
+}
+
+/// Transformed weights `G * g * GT` of the kernels of a convolution, stored
+/// as `u[(i * 4 + j) * F * C + f * C + c]`.
+struct TransformedWeights {
+  int64_t F, C;
+  std::vector<int64_t> u;
+
+  int64_t at(int64_t i, int64_t j, int64_t f, int64_t c) const {
+    return u[((i * 4 + j) * F + f) * C + c];
+  }
+};
+
+/// Computes the transformed weights of `weights`, truncated to `width` bits
+/// which does not change their value modulo the message space. Returns
+/// `std::nullopt` if one of the transformed kernels is not integral, as the
+/// encrypted side cannot be divided.
+std::optional<TransformedWeights>
+transformWeights(mlir::DenseIntElementsAttr weights, unsigned width) {
+  auto shape = weights.getType().getShape();
+  TransformedWeights result{shape[0], shape[1], {}};
+  result.u.resize(16 * result.F * result.C);
+  std::vector<int64_t> g = getSignedValues(weights);
+
+  for (int64_t f = 0; f < result.F; f++) {
+    for (int64_t c = 0; c < result.C; c++) {
+      const int64_t *kernel = &g[(f * result.C + c) * 9];
+      for (int64_t i = 0; i < 4; i++) {
+        for (int64_t j = 0; j < 4; j++) {
+          int64_t scaled = 0;
+          for (int64_t k = 0; k < 3; k++)
+            for (int64_t l = 0; l < 3; l++)
+              scaled += G2[i][k] * kernel[k * 3 + l] * G2[j][l];
+          if (scaled % 4 != 0)
+            return std::nullopt;
+          result.u[((i * 4 + j) * result.F + f) * result.C + c] =
+              llvm::SignExtend64(scaled / 4, width);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/// Returns the squared MANP of `value` computed by the MANP analysis, or
+/// `std::nullopt` if it has not been run.
+std::optional<double> getSqMANP(mlir::Value value) {
+  mlir::Operation *op = value.getDefiningOp();
+  if (op == nullptr)
+    return 1.0;
+  auto attr = op->getAttrOfType<mlir::IntegerAttr>("SMANP");
+  if (attr == nullptr)
+    return std::nullopt;
+  return attr.getValue().roundToDouble(false);
+}
+
+void setSqMANP(mlir::Operation *op, double sqMANP) {
+  auto type =
+      mlir::IntegerType::get(op->getContext(), 64, mlir::IntegerType::Unsigned);
+  op->setAttr("SMANP",
+              mlir::IntegerAttr::get(type, (uint64_t)std::ceil(sqMANP)));
+}
+
+bool isLookup(mlir::Operation *op) {
+  return llvm::isa<FHE::ApplyLookupTableEintOp,
+                   FHELinalg::ApplyLookupTableEintOp,
+                   FHELinalg::ApplyMultiLookupTableEintOp,
+                   FHELinalg::ApplyMappedLookupTableEintOp>(op);
+}
+
+/// Returns the operations whose noise is proportional to the noise of the
+/// result of `op`, i.e. `op` and its transitive users up to the table
+/// lookups, which reset the noise.
+llvm::SetVector<mlir::Operation *> getNoiseDependentOps(mlir::Operation *op) {
+  llvm::SetVector<mlir::Operation *> ops;
+  llvm::SmallVector<mlir::Operation *> worklist{op};
+  ops.insert(op);
+  while (!worklist.empty()) {
+    mlir::Operation *current = worklist.pop_back_val();
+    for (mlir::Operation *user : current->getUsers()) {
+      if (!isLookup(user) && ops.insert(user))
+        worklist.push_back(user);
+    }
+  }
+  return ops;
+}
+
+/// Squared MANP of the direct convolution of an input of squared MANP
+/// `inputSqMANP` with `weights`, as computed by the MANP analysis.
+double getDirectSqMANP(double inputSqMANP,
+                       mlir::DenseIntElementsAttr weights) {
+  auto shape = weights.getType().getShape();
+  int64_t kernelSize = shape[1] * shape[2] * shape[3];
+  std::vector<int64_t> values = getSignedValues(weights);
+  double result = 0;
+  for (int64_t f = 0; f < shape[0]; f++) {
+    double norm = inputSqMANP;
+    for (int64_t k = 0; k < kernelSize; k++) {
+      double w = values[f * kernelSize + k];
+      norm += inputSqMANP * w * w;
+    }
+    result = std::max(result, norm);
+  }
+  return result;
+}
+
+/// Squared MANP of the Winograd convolution of an input of squared MANP
+/// `inputSqMANP`, as computed by the MANP analysis on the rewritten
+/// operations.
+double getWinogradSqMANP(double inputSqMANP, const TransformedWeights &u) {
+  // Each element of a transformed input tile is the sum of 4 inputs
+  double tileSqMANP = 4 * inputSqMANP;
+  double result = 0;
+  for (int64_t f = 0; f < u.F; f++) {
+    double products[4][4];
+    for (int64_t i = 0; i < 4; i++) {
+      for (int64_t j = 0; j < 4; j++) {
+        products[i][j] = tileSqMANP;
+        for (int64_t c = 0; c < u.C; c++) {
+          double w = u.at(i, j, f, c);
+          products[i][j] += tileSqMANP * w * w;
+        }
+      }
+    }
+    for (int64_t r = 0; r < 2; r++) {
+      for (int64_t s = 0; s < 2; s++) {
+        double norm = 0;
+        for (int64_t i = 0; i < 4; i++)
+          for (int64_t j = 0; j < 4; j++)
+            if (AT[r][i] != 0 && AT[s][j] != 0)
+              norm += products[i][j];
+        result = std::max(result, norm);
+      }
+    }
+  }
+  return result;
+}
+
+/// Returns the linear combination of `values` with coefficients in
+/// {-1, 0, 1}, starting with a positive term such that no negation is
+/// needed.
+mlir::Value combine(mlir::OpBuilder &builder, mlir::Location loc,
+                    llvm::ArrayRef<int64_t> coefs,
+                    llvm::ArrayRef<mlir::Value> values) {
+  size_t first = llvm::find(coefs, 1) - coefs.begin();
+  mlir::Value acc = values[first];
+  for (size_t k = 0; k < coefs.size(); k++) {
+    if (k == first || coefs[k] == 0)
+      continue;
+    if (coefs[k] == 1)
+      acc = builder.create<FHELinalg::AddEintOp>(loc, acc.getType(), acc,
+                                                 values[k]);
+    else
+      acc = builder.create<FHELinalg::SubEintOp>(loc, acc.getType(), acc,
+                                                 values[k]);
+  }
+  return acc;
+}
+
+/// Extracts the elements `offset + stride * k` of the dimension `dim` of the
+/// 4-dimensional tensor `value`, for `k` in `[0, size)`.
+mlir::Value extractStrided(mlir::OpBuilder &builder, mlir::Location loc,
+                           mlir::Value value, int64_t dim, int64_t offset,
+                           int64_t size, int64_t stride) {
+  auto type = value.getType().cast<mlir::RankedTensorType>();
+  llvm::SmallVector<int64_t> shape(type.getShape());
+  llvm::SmallVector<mlir::OpFoldResult> offsets(4, builder.getIndexAttr(0));
+  llvm::SmallVector<mlir::OpFoldResult> sizes;
+  llvm::SmallVector<mlir::OpFoldResult> strides(4, builder.getIndexAttr(1));
+  shape[dim] = size;
+  offsets[dim] = builder.getIndexAttr(offset);
+  strides[dim] = builder.getIndexAttr(stride);
+  for (int64_t s : shape)
+    sizes.push_back(builder.getIndexAttr(s));
+  auto resultType = mlir::RankedTensorType::get(shape, type.getElementType());
+  return builder.create<mlir::tensor::ExtractSliceOp>(
+      loc, resultType, value, offsets, sizes, strides);
+}
+
+/// Replaces `conv` by its Winograd F(2x2, 3x3) form:
+///
+///  - the input is split in the 16 strided tensors of the elements at the
+///    position (k, l) of each input tile, which are combined by additions
+///    and subtractions into the transformed input tiles `BT * d * B`,
+///  - the products with the transformed weights, summed over the input
+///    channels, are 1x1 convolutions,
+///  - the output tiles are combined by additions and subtractions and
+///    interleaved into the result.
+mlir::Operation *rewriteConv(FHELinalg::Conv2dOp conv,
+                             const TransformedWeights &u) {
+  mlir::OpBuilder builder(conv);
+  mlir::Location loc = conv.getLoc();
+  mlir::Value input = conv.getInput();
+  auto inputTy = input.getType().cast<mlir::RankedTensorType>();
+  auto resultTy = conv.getResult().getType().cast<mlir::RankedTensorType>();
+  auto weightTy = conv.getWeight().getType().cast<mlir::RankedTensorType>();
+  int64_t N = inputTy.getDimSize(0);
+  int64_t tilesH = resultTy.getDimSize(2) / 2;
+  int64_t tilesW = resultTy.getDimSize(3) / 2;
+
+  // Transformed input tiles
+  mlir::Value rows[4], tiles[4][4];
+  for (int64_t k = 0; k < 4; k++)
+    rows[k] = extractStrided(builder, loc, input, 2, k, tilesH, 2);
+  for (int64_t i = 0; i < 4; i++) {
+    mlir::Value row = combine(builder, loc, BT[i], rows);
+    mlir::Value columns[4];
+    for (int64_t l = 0; l < 4; l++)
+      columns[l] = extractStrided(builder, loc, row, 3, l, tilesW, 2);
+    for (int64_t j = 0; j < 4; j++)
+      tiles[i][j] = combine(builder, loc, BT[j], columns);
+  }
+
+  // Products with the transformed weights, the bias is added to the product
+  // used by all the output tiles
+  auto productTy = mlir::RankedTensorType::get({N, u.F, tilesH, tilesW},
+                                               resultTy.getElementType());
+  auto uTy = mlir::RankedTensorType::get({u.F, u.C, 1, 1},
+                                         weightTy.getElementType());
+  mlir::Value products[4][4];
+  for (int64_t i = 0; i < 4; i++) {
+    for (int64_t j = 0; j < 4; j++) {
+      llvm::SmallVector<llvm::APInt> values;
+      for (int64_t f = 0; f < u.F; f++)
+        for (int64_t c = 0; c < u.C; c++)
+          values.push_back(
+              llvm::APInt(uTy.getElementTypeBitWidth(), u.at(i, j, f, c),
+                          /*isSigned=*/true));
+      mlir::Value weights = builder.create<mlir::arith::ConstantOp>(
+          loc, mlir::DenseIntElementsAttr::get(uTy, values));
+      mlir::Value bias = (i == 1 && j == 1) ? conv.getBias() : mlir::Value();
+      products[i][j] = builder.create<FHELinalg::Conv2dOp>(
+          loc, productTy, tiles[i][j], weights, bias,
+          mlir::DenseIntElementsAttr(), mlir::DenseIntElementsAttr(),
+          mlir::DenseIntElementsAttr(), mlir::IntegerAttr());
+    }
+  }
+
+  // Output tiles, interleaved into the result
+  mlir::Value result =
+      builder.create<FHE::ZeroTensorOp>(loc, resultTy).getResult();
+  for (int64_t r = 0; r < 2; r++) {
+    mlir::Value partial[4];
+    for (int64_t j = 0; j < 4; j++) {
+      mlir::Value column[4] = {products[0][j], products[1][j], products[2][j],
+                               products[3][j]};
+      partial[j] = combine(builder, loc, AT[r], column);
+    }
+    for (int64_t s = 0; s < 2; s++) {
+      mlir::Value tile = combine(builder, loc, AT[s], partial);
+      llvm::SmallVector<mlir::OpFoldResult> offsets{
+          builder.getIndexAttr(0), builder.getIndexAttr(0),
+          builder.getIndexAttr(r), builder.getIndexAttr(s)};
+      llvm::SmallVector<mlir::OpFoldResult> sizes{
+          builder.getIndexAttr(N), builder.getIndexAttr(u.F),
+          builder.getIndexAttr(tilesH), builder.getIndexAttr(tilesW)};
+      llvm::SmallVector<mlir::OpFoldResult> strides{
+          builder.getIndexAttr(1), builder.getIndexAttr(1),
+          builder.getIndexAttr(2), builder.getIndexAttr(2)};
+      result = builder.create<mlir::tensor::InsertSliceOp>(
+          loc, tile, result, offsets, sizes, strides);
+    }
+  }
+
+  conv.getResult().replaceAllUsesWith(result);
+  return result.getDefiningOp();
+}
+
+/// Returns the squared MANP of the result of `op` scaled by `4^width`, where
+/// `width` is the width of its encrypted integers, or `std::nullopt` if `op`
+/// is not annotated. An encrypted integer of `width` bits with a MANP of `m`
+/// needs as much room for its noise as one of `width + log2(m)` bits with a
+/// MANP of 1, so the parameters are bound by the largest scaled noise of the
+/// function, and an operation may grow its noise up to that bound.
+std::optional<double> getScaledSqMANP(mlir::Operation *op) {
+  auto attr = op->getAttrOfType<mlir::IntegerAttr>("SMANP");
+  if (attr == nullptr || op->getNumResults() != 1)
+    return std::nullopt;
+  mlir::Type type = op->getResult(0).getType();
+  if (auto tensorTy = type.dyn_cast<mlir::RankedTensorType>())
+    type = tensorTy.getElementType();
+  auto eintTy = type.dyn_cast<FHE::FheIntegerInterface>();
+  if (eintTy == nullptr)
+    return std::nullopt;
+  return std::ldexp(attr.getValue().roundToDouble(false),
+                    2 * eintTy.getWidth());
+}
+
+/// Pass that rewrites the convolutions with constant 3x3 kernels into their
+/// Winograd F(2x2, 3x3) form, if their transformed kernels are integral and
+/// if the noise bound of the rewritten form, as computed from the
+/// annotations of the MANP analysis and scaled by the width of the
+/// convolution, does not raise the largest scaled bound of the function.
+class WinogradConv2dPass : public WinogradConv2dBase<WinogradConv2dPass> {
+public:
+  void runOnOperation() override {
+    mlir::func::FuncOp func = getOperation();
+
+    std::optional<double> budget;
+    func.walk([&](mlir::Operation *op) {
+      if (auto scaled = getScaledSqMANP(op))
+        budget = std::max(budget.value_or(0.0), *scaled);
+    });
+    if (!budget)
+      return;
+
+    llvm::SmallVector<FHELinalg::Conv2dOp> convs;
+    func.walk([&](FHELinalg::Conv2dOp conv) { convs.push_back(conv); });
+
+    for (FHELinalg::Conv2dOp conv : convs) {
+      auto weights = getConstantWeights(conv);
+      auto inputSqMANP = getSqMANP(conv.getInput());
+      if (!weights || !inputSqMANP || !hasWinogradShape(conv))
+        continue;
+      auto u = transformWeights(
+          *weights, weights->getType().getElementTypeBitWidth());
+      if (!u)
+        continue;
+
+      double direct = getDirectSqMANP(*inputSqMANP, *weights);
+      double winograd = getWinogradSqMANP(*inputSqMANP, *u);
+      double growth = winograd / direct;
+
+      // The noise of the convolution and of its users grows in the same
+      // proportion, none of them may exceed the bound of the parameters
+      llvm::SetVector<mlir::Operation *> dependents =
+          getNoiseDependentOps(conv);
+      bool fits = llvm::all_of(dependents, [&](mlir::Operation *op) {
+        auto scaled = getScaledSqMANP(op);
+        return !scaled || *scaled * growth <= *budget;
+      });
+      if (!fits)
+        continue;
+
+      // Keep the annotations of the users as bounds for the next
+      // convolutions
+      dependents.remove(conv);
+      for (mlir::Operation *op : dependents) {
+        if (auto attr = op->getAttrOfType<mlir::IntegerAttr>("SMANP"))
+          setSqMANP(op, attr.getValue().roundToDouble(false) * growth);
+      }
+      setSqMANP(rewriteConv(conv, *u), winograd);
+
+      mlir::Operation *weightsOp = conv.getWeight().getDefiningOp();
+      conv.erase();
+      if (weightsOp->use_empty())
+        weightsOp->erase();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<mlir::func::FuncOp>>
+createWinogradConv2dPass() {
+  return std::make_unique<WinogradConv2dPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -40,6 +40,7 @@
 #include <mlir/IR/BuiltinOps.h>
 #include <mlir/IR/IRMapping.h>
 #include <mlir/IR/SymbolTable.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
 #include <mlir/Interfaces/ViewLikeInterface.h>
 #include <mlir/Pass/PassManager.h>
 #include <mlir/Support/LLVM.h>
@@ -56,6 +57,34 @@ namespace concretelang {
 
 namespace {
 
+/// Returns the identifier of the optimizer node computing `val`, or a null
+/// attribute if the producer of `val` was not annotated by the optimizer
+/// analysis.
+static IntegerAttr getOptimizerID(Value val) {
+  if (auto arg = val.dyn_cast<BlockArgument>()) {
+    auto func = dyn_cast<func::FuncOp>(arg.getOwner()->getParentOp());
+    if (func == nullptr || !arg.getOwner()->isEntryBlock())
+      return nullptr;
+    return func.getArgAttrOfType<IntegerAttr>(arg.getArgNumber(), "TFHE.OId");
+  }
+  Operation *producer = val.getDefiningOp();
+  // The value computed by a task is the one yielded by its body
+  if (auto task = dyn_cast<RT::DataflowTaskOp>(producer)) {
+    Operation *yield = task.getBody().back().getTerminator();
+    unsigned resultNumber = val.cast<OpResult>().getResultNumber();
+    return getOptimizerID(yield->getOperand(resultNumber));
+  }
+  if (auto id = producer->getAttrOfType<IntegerAttr>("TFHE.OId"))
+    return id;
+  // Operations mapped to several optimizer nodes list the node computing
+  // their result last
+  auto ids = producer->getAttrOfType<DenseI32ArrayAttr>("TFHE.OId");
+  if (ids == nullptr || ids.empty())
+    return nullptr;
+  return IntegerAttr::get(IntegerType::get(val.getContext(), 32),
+                          ids.asArrayRef().back());
+}
+
 static func::FuncOp outlineWorkFunction(RT::DataflowTaskOp DFTOp,
                                         StringRef workFunctionName) {
   Location loc = DFTOp.getLoc();
@@ -76,6 +105,17 @@ static func::FuncOp outlineWorkFunction(RT::DataflowTaskOp DFTOp,
   FunctionType type = FunctionType::get(DFTOp.getContext(), operandTypes, {});
   auto outlinedFunc = builder.create<func::FuncOp>(loc, workFunctionName, type);
   outlinedFunc->setAttr("_dfr_work_function_attribute", builder.getUnitAttr());
+
+  // Forward the optimizer identifiers of the values flowing through the
+  // task boundary, such that the work function arguments can be
+  // parametrized with the keys of the multi-parameter solution.
+  for (auto result : llvm::enumerate(DFTOp.getResults()))
+    if (auto optimizerID = getOptimizerID(result.value()))
+      outlinedFunc.setArgAttr(result.index(), "TFHE.OId", optimizerID);
+  for (auto operand : llvm::enumerate(DFTOp.getOperands()))
+    if (auto optimizerID = getOptimizerID(operand.value()))
+      outlinedFunc.setArgAttr(DFTOp.getNumResults() + operand.index(),
+                              "TFHE.OId", optimizerID);
   Region &outlinedFuncBody = outlinedFunc.getBody();
   Block *outlinedEntryBlock = new Block;
   SmallVector<Location> locations(type.getInputs().size(), loc);
@@ -246,6 +286,8 @@ static void lowerDataflowTaskOp(RT::DataflowTaskOp DFTOp,
     Type futType = RT::PointerType::get(RT::FutureType::get(result.getType()));
     auto brpp = builder.create<RT::BuildReturnPtrPlaceholderOp>(DFTOp.getLoc(),
                                                                 futType);
+    if (auto optimizerID = getOptimizerID(result))
+      brpp->setAttr("TFHE.OId", optimizerID);
     map.map(result, brpp->getResult(0));
     catOperands.push_back(brpp->getResult(0));
   }
@@ -487,6 +529,89 @@ std::unique_ptr<mlir::Pass> createStartStopPass(bool debug) {
 }
 
 namespace {
+static void getAliasedUses(Value val, DenseSet<OpOperand *> &aliasedUses) {
+  for (auto &use : val.getUses()) {
+    aliasedUses.insert(&use);
+    if (dyn_cast<ViewLikeOpInterface>(use.getOwner()))
+      getAliasedUses(use.getOwner()->getResult(0), aliasedUses);
+  }
+}
+
+/// Returns true if the operation owning `use` may write to the buffer
+/// accessed through `use`. Concrete buffer operations write their first
+/// operand and only read the others, operations without memory effect
+/// information are conservatively considered as writing.
+static bool mayWriteTo(OpOperand &use) {
+  Operation *owner = use.getOwner();
+  if (isa<ViewLikeOpInterface>(owner))
+    return false;
+  if (isa_and_nonnull<Concrete::ConcreteDialect>(owner->getDialect()))
+    return use.getOperandNumber() == 0;
+  auto iface = dyn_cast<MemoryEffectOpInterface>(owner);
+  if (!iface)
+    return true;
+  SmallVector<MemoryEffects::EffectInstance, 4> effects;
+  iface.getEffects(effects);
+  return llvm::any_of(effects, [&](MemoryEffects::EffectInstance &effect) {
+    return isa<MemoryEffects::Write>(effect.getEffect()) &&
+           (!effect.getValue() || effect.getValue() == use.get());
+  });
+}
+
+/// Returns true if the buffer wrapped by `mrf` can be handed over to the
+/// future without a copy. This requires the buffer to be a heap allocation
+/// with an identity layout that is no longer accessed after the creation of
+/// the future (the runtime takes ownership and frees it once the last
+/// reference to the future is released), and that none of the tasks
+/// consuming the future writes to it in place.
+static bool canShareBuffer(RT::MakeReadyFutureOp mrf) {
+  auto alloc = mrf.getOperand(0).getDefiningOp<memref::AllocOp>();
+  if (!alloc || alloc->getBlock() != mrf->getBlock() ||
+      !alloc.getType().getLayout().isIdentity())
+    return false;
+
+  // All other accesses to the buffer must happen before the future is
+  // created and must not let the buffer escape.
+  DenseSet<OpOperand *> aliasedUses;
+  getAliasedUses(alloc.getResult(), aliasedUses);
+  for (OpOperand *use : aliasedUses) {
+    Operation *owner = use->getOwner();
+    if (owner == mrf.getOperation() || isa<memref::DeallocOp>(owner))
+      continue;
+    if (isa_and_nonnull<RT::RTDialect>(owner->getDialect()))
+      return false;
+    Operation *ancestor = mrf->getBlock()->findAncestorOpInBlock(*owner);
+    if (!ancestor || !ancestor->isBeforeInBlock(mrf))
+      return false;
+    if (!isa<ViewLikeOpInterface, MemoryEffectOpInterface>(owner) &&
+        !isa_and_nonnull<Concrete::ConcreteDialect>(owner->getDialect()))
+      return false;
+  }
+
+  // The work functions consuming the future must only read the buffer.
+  for (OpOperand &futureUse : mrf.getOutput().getUses()) {
+    auto catOp = dyn_cast<RT::CreateAsyncTaskOp>(futureUse.getOwner());
+    if (!catOp || futureUse.getOperandNumber() < 3)
+      return false;
+    SymbolRefAttr sym =
+        catOp->getAttr("workfn").dyn_cast_or_null<SymbolRefAttr>();
+    func::FuncOp workfn = dyn_cast_or_null<func::FuncOp>(
+        SymbolTable::lookupNearestSymbolFrom(catOp, sym));
+    if (!workfn || workfn.isExternal())
+      return false;
+    BlockArgument arg = workfn.getArgument(futureUse.getOperandNumber() - 3);
+    for (Operation *user : arg.getUsers()) {
+      if (!isa<RT::DerefWorkFunctionArgumentPtrPlaceholderOp>(user))
+        return false;
+      DenseSet<OpOperand *> argUses;
+      getAliasedUses(user->getResult(0), argUses);
+      if (llvm::any_of(argUses,
+                       [](OpOperand *use) { return mayWriteTo(*use); }))
+        return false;
+    }
+  }
+  return true;
+}
 
 // For documentation see Autopar.td
 struct FinalizeTaskCreationPass
@@ -496,6 +621,15 @@ struct FinalizeTaskCreationPass
     auto module = getOperation();
     std::vector<Operation *> ops;
 
+    // Determine which futures can share the buffer of their producer
+    // before the task creation operands are extended.
+    DenseSet<Operation *> sharedBuffers;
+    module.walk([&](RT::MakeReadyFutureOp op) {
+      if (op.getOperand(0).getType().isa<mlir::MemRefType>() &&
+          canShareBuffer(op))
+        sharedBuffers.insert(op);
+    });
+
     module.walk([&](RT::CreateAsyncTaskOp catOp) {
       OpBuilder builder(catOp);
       SmallVector<Value, 4> operands;
@@ -538,15 +672,19 @@ struct FinalizeTaskCreationPass
 
     // If we are building a future on a MemRef, we need to flatten it.
 
-    // TODO: the performance of shared memory can be improved by
-    // allowing view-like access instead of cloning, but memory
-    // deallocation needs to be synchronized appropriately
+    // Buffers that can be shared are handed over to the runtime as
+    // is: the future owns the buffer, which is freed when the last
+    // task referencing it completes. Other buffers are copied.
     module.walk([&](RT::MakeReadyFutureOp op) {
       OpBuilder builder(op);
 
       Value val = op.getOperand(0);
       Value clone = op.getOperand(1);
-      if (val.getType().isa<mlir::MemRefType>()) {
+      if (sharedBuffers.contains(op)) {
+        clone = builder.create<arith::ConstantOp>(op.getLoc(),
+                                                  builder.getI64IntegerAttr(1));
+        op->setOperand(1, clone);
+      } else if (val.getType().isa<mlir::MemRefType>()) {
         MemRefType mrType_base = val.getType().dyn_cast<mlir::MemRefType>();
         MemRefType mrType = mrType_base;
         if (!mrType_base.getLayout().isIdentity()) {
@@ -581,14 +719,6 @@ std::unique_ptr<mlir::Pass> createFinalizeTaskCreationPass(bool debug) {
 }
 
 namespace {
-static void getAliasedUses(Value val, DenseSet<OpOperand *> &aliasedUses) {
-  for (auto &use : val.getUses()) {
-    aliasedUses.insert(&use);
-    if (dyn_cast<ViewLikeOpInterface>(use.getOwner()))
-      getAliasedUses(use.getOwner()->getResult(0), aliasedUses);
-  }
-}
-
 // For documentation see Autopar.td
 struct FixupBufferDeallocationPass
     : public FixupBufferDeallocationBase<FixupBufferDeallocationPass> {
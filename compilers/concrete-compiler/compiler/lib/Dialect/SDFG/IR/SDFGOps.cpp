@@ -100,6 +100,14 @@ mlir::LogicalResult MakeProcess::verify() {
     return checkStreams(2, 1);
   case ProcessKind::batched_mapped_bootstrap:
     return checkStreams(2, 1);
+  case ProcessKind::encode_expand_lut_for_bootstrap:
+    return checkStreams(1, 1);
+  case ProcessKind::encode_lut_for_crt_woppbs:
+    return checkStreams(1, 1);
+  case ProcessKind::encode_plaintext_with_crt:
+    return checkStreams(1, 1);
+  case ProcessKind::wop_pbs_crt:
+    return checkStreams(2, 1);
   }
 
   return mlir::failure();
@@ -30,6 +30,11 @@ char batched_neg_eint[] = "batched_neg_eint";
 char batched_keyswitch[] = "batched_keyswitch";
 char batched_bootstrap[] = "batched_bootstrap";
 char batched_mapped_bootstrap[] = "batched_mapped_bootstrap";
+
+char encode_expand_lut_for_bootstrap[] = "encode_expand_lut_for_bootstrap";
+char encode_lut_for_crt_woppbs[] = "encode_lut_for_crt_woppbs";
+char encode_plaintext_with_crt[] = "encode_plaintext_with_crt";
+char wop_pbs_crt[] = "wop_pbs_crt";
 } // namespace
 
 template <typename Op, char const *processName, bool copyAttributes = false>
@@ -134,6 +139,23 @@ void registerSDFGConvertibleOpInterfaceExternalModels(
         attachInterface<ReplaceWithProcessSDFGConversionInterface<
             mlir::concretelang::Concrete::BatchedMappedBootstrapLweTensorOp,
             batched_mapped_bootstrap, true>>(*ctx);
+
+    mlir::concretelang::Concrete::EncodeExpandLutForBootstrapTensorOp::
+        attachInterface<ReplaceWithProcessSDFGConversionInterface<
+            mlir::concretelang::Concrete::EncodeExpandLutForBootstrapTensorOp,
+            encode_expand_lut_for_bootstrap, true>>(*ctx);
+    mlir::concretelang::Concrete::EncodeLutForCrtWopPBSTensorOp::
+        attachInterface<ReplaceWithProcessSDFGConversionInterface<
+            mlir::concretelang::Concrete::EncodeLutForCrtWopPBSTensorOp,
+            encode_lut_for_crt_woppbs, true>>(*ctx);
+    mlir::concretelang::Concrete::EncodePlaintextWithCrtTensorOp::
+        attachInterface<ReplaceWithProcessSDFGConversionInterface<
+            mlir::concretelang::Concrete::EncodePlaintextWithCrtTensorOp,
+            encode_plaintext_with_crt, true>>(*ctx);
+    mlir::concretelang::Concrete::WopPBSCRTLweTensorOp::attachInterface<
+        ReplaceWithProcessSDFGConversionInterface<
+            mlir::concretelang::Concrete::WopPBSCRTLweTensorOp, wop_pbs_crt,
+            true>>(*ctx);
   });
 }
 } // namespace SDFG
@@ -72,6 +72,7 @@ struct ExtractTFHEStatisticsPass
     DISPATCH_ENTER(TFHE::AddGLWEIntOp)
     DISPATCH_ENTER(TFHE::BootstrapGLWEOp)
     DISPATCH_ENTER(TFHE::KeySwitchGLWEOp)
+    DISPATCH_ENTER(TFHE::ManyBootstrapGLWEOp)
     DISPATCH_ENTER(TFHE::MulGLWEIntOp)
     DISPATCH_ENTER(TFHE::NegGLWEOp)
     DISPATCH_ENTER(TFHE::SubGLWEIntOp)
@@ -189,6 +190,34 @@ struct ExtractTFHEStatisticsPass
     return std::nullopt;
   }
 
+  // ########################
+  // TFHE.many_bootstrap_glwe
+  // ########################
+
+  static std::optional<StringError> on_enter(TFHE::ManyBootstrapGLWEOp &op,
+                                             ExtractTFHEStatisticsPass &pass) {
+    auto bsk = op.getKey();
+
+    // All the lookup tables are evaluated by a single PBS
+    auto location = locationString(op.getLoc());
+    auto operation = PrimitiveOperation::PBS;
+    auto keys = std::vector<std::pair<KeyType, size_t>>();
+    auto count = pass.iterations;
+
+    std::pair<KeyType, size_t> key =
+        std::make_pair(KeyType::BOOTSTRAP, (size_t)bsk.getIndex());
+    keys.push_back(key);
+
+    pass.feedback.statistics.push_back(concretelang::Statistic{
+        location,
+        operation,
+        keys,
+        count,
+    });
+
+    return std::nullopt;
+  }
+
   // ###################
   // TFHE.keyswitch_glwe
   // ###################
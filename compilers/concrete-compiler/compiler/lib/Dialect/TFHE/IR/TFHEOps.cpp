@@ -4,6 +4,7 @@
 // for license information.
 
 #include "mlir/IR/Region.h"
+#include "llvm/Support/MathExtras.h"
 
 #include "concretelang/Dialect/TFHE/IR/TFHEAttrs.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEDialect.h"
@@ -115,6 +116,27 @@ mlir::LogicalResult MulGLWEIntOp::verify() {
       *this);
 }
 
+mlir::LogicalResult ManyBootstrapGLWEOp::verify() {
+  if (!llvm::isPowerOf2_64(getResults().size())) {
+    emitOpError() << "should have a power of two number of results";
+    return mlir::failure();
+  }
+
+  if (llvm::any_of(getResults().getTypes(), [&](mlir::Type type) {
+        return type != getResults().front().getType();
+      })) {
+    emitOpError() << "should have results of the same type";
+    return mlir::failure();
+  }
+
+  if (!llvm::isPowerOf2_64(getLutSize())) {
+    emitOpError() << "should have a power of two lookup table size";
+    return mlir::failure();
+  }
+
+  return mlir::success();
+}
+
 } // namespace TFHE
 } // namespace concretelang
 } // namespace mlir
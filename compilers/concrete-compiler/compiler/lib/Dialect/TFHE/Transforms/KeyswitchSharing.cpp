@@ -0,0 +1,157 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/IR/Dominance.h>
+#include <mlir/Interfaces/LoopLikeInterface.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <unordered_map>
+
+#include <concretelang/Dialect/TFHE/IR/TFHEOps.h>
+#include <concretelang/Dialect/TFHE/Transforms/Transforms.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+bool isKeyswitch(mlir::Operation *op) {
+  return llvm::isa<TFHE::KeySwitchGLWEOp, TFHE::BatchedKeySwitchGLWEOp>(op);
+}
+
+/// Returns the attributes of `op` that are relevant to decide if two
+/// operations compute the same value, i.e. all attributes but the
+/// optimizer identifier.
+mlir::DictionaryAttr getSemanticAttributes(mlir::Operation *op) {
+  mlir::NamedAttrList attrs(op->getAttrDictionary());
+  attrs.erase("TFHE.OId");
+  return attrs.getDictionary(op->getContext());
+}
+
+llvm::hash_code hashOperation(mlir::Operation *op) {
+  return llvm::hash_combine(
+      op->getName(), getSemanticAttributes(op),
+      llvm::hash_combine_range(op->operand_begin(), op->operand_end()),
+      llvm::hash_combine_range(op->result_type_begin(),
+                               op->result_type_end()));
+}
+
+bool isEquivalent(mlir::Operation *lhs, mlir::Operation *rhs) {
+  return lhs->getName() == rhs->getName() &&
+         lhs->getOperands() == rhs->getOperands() &&
+         lhs->getResultTypes() == rhs->getResultTypes() &&
+         getSemanticAttributes(lhs) == getSemanticAttributes(rhs);
+}
+
+/// Collects the keyswitches of `root` together with the side-effect free
+/// operations their inputs are computed from (e.g. the extraction of an
+/// element, the collapse of a tensor or the offset added to signed inputs
+/// before a lookup). The operations are returned in pre-order, such that
+/// the producers of an operation appear before the operation itself.
+llvm::SmallVector<mlir::Operation *>
+collectShareableOps(mlir::Operation *root) {
+  llvm::DenseSet<mlir::Operation *> shareable;
+  llvm::SmallVector<mlir::Operation *> worklist;
+
+  root->walk([&](mlir::Operation *op) {
+    if (isKeyswitch(op) && shareable.insert(op).second)
+      worklist.push_back(op);
+  });
+
+  while (!worklist.empty()) {
+    mlir::Operation *op = worklist.pop_back_val();
+    for (mlir::Value operand : op->getOperands()) {
+      mlir::Operation *producer = operand.getDefiningOp();
+      if (producer == nullptr || producer->getNumRegions() != 0 ||
+          !mlir::isMemoryEffectFree(producer))
+        continue;
+      if (shareable.insert(producer).second)
+        worklist.push_back(producer);
+    }
+  }
+
+  llvm::SmallVector<mlir::Operation *> ordered;
+  root->walk<mlir::WalkOrder::PreOrder>([&](mlir::Operation *op) {
+    if (shareable.contains(op))
+      ordered.push_back(op);
+  });
+  return ordered;
+}
+
+/// Moves `op` out of all the loops it is invariant to, first hoisting the
+/// shareable operations of the same loop it depends on.
+void hoistLoopInvariant(mlir::Operation *op,
+                        const llvm::DenseSet<mlir::Operation *> &shareable) {
+  while (auto loop = op->getParentOfType<mlir::LoopLikeOpInterface>()) {
+    if (op->getParentOp() != loop.getOperation())
+      return;
+    for (mlir::Value operand : op->getOperands()) {
+      if (loop.isDefinedOutsideOfLoop(operand))
+        continue;
+      mlir::Operation *producer = operand.getDefiningOp();
+      if (producer != nullptr && shareable.contains(producer))
+        hoistLoopInvariant(producer, shareable);
+    }
+    if (!llvm::all_of(op->getOperands(), [&](mlir::Value operand) {
+          return loop.isDefinedOutsideOfLoop(operand);
+        }))
+      return;
+    loop.moveOutOfLoop(op);
+  }
+}
+
+/// Pass that shares the keyswitches applied on the same ciphertext with
+/// the same keyswitch key, e.g. for several lookups on the same input. The
+/// pass first hoists the loop-invariant keyswitches out of loops and then
+/// replaces each keyswitch by an equivalent dominating one when it exists.
+class TFHEKeyswitchSharingPass
+    : public TFHEKeyswitchSharingBase<TFHEKeyswitchSharingPass> {
+public:
+  void runOnOperation() override {
+    mlir::Operation *root = getOperation();
+
+    auto ops = collectShareableOps(root);
+    llvm::DenseSet<mlir::Operation *> shareable(ops.begin(), ops.end());
+
+    for (mlir::Operation *op : ops) {
+      if (isKeyswitch(op))
+        hoistLoopInvariant(op, shareable);
+    }
+
+    // Hoisting may have changed the order of the operations
+    ops = collectShareableOps(root);
+
+    mlir::DominanceInfo domInfo(root);
+    std::unordered_map<size_t, llvm::SmallVector<mlir::Operation *>> known;
+
+    for (mlir::Operation *op : ops) {
+      auto &candidates = known[static_cast<size_t>(hashOperation(op))];
+      auto equivalent =
+          llvm::find_if(candidates, [&](mlir::Operation *candidate) {
+            return isEquivalent(candidate, op) &&
+                   domInfo.properlyDominates(candidate, op);
+          });
+      if (equivalent == candidates.end()) {
+        candidates.push_back(op);
+        continue;
+      }
+      op->replaceAllUsesWith(*equivalent);
+      op->erase();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<>> createTFHEKeyswitchSharingPass() {
+  return std::make_unique<TFHEKeyswitchSharingPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -0,0 +1,178 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <mlir/Dialect/Arith/IR/Arith.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/Matchers.h>
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/MathExtras.h>
+
+#include <concretelang/Dialect/TFHE/IR/TFHEOps.h>
+#include <concretelang/Dialect/TFHE/Transforms/Transforms.h>
+
+namespace mlir {
+namespace concretelang {
+
+namespace {
+
+/// Name of the attribute set by the optimizer on the lookup tables that can
+/// be evaluated by a many-lut bootstrap, holding the maximal number of lookup
+/// tables per bootstrap the noise of the input was budgeted for.
+const llvm::StringLiteral MANY_LUT_ATTR_NAME = "TFHE.manyLut";
+
+/// A bootstrap that can be part of a many-lut bootstrap, i.e. a bootstrap
+/// with a constant lookup table encoded by
+/// `TFHE.encode_expand_lut_for_bootstrap`.
+struct Candidate {
+  TFHE::BootstrapGLWEOp bootstrap;
+  TFHE::EncodeExpandLutForBootstrapOp encode;
+  mlir::DenseIntElementsAttr lut;
+  int64_t maxLutCount;
+};
+
+std::optional<Candidate> asCandidate(TFHE::BootstrapGLWEOp bootstrap) {
+  auto maxLutCount =
+      bootstrap->getAttrOfType<mlir::IntegerAttr>(MANY_LUT_ATTR_NAME);
+  if (maxLutCount == nullptr || maxLutCount.getInt() < 2)
+    return std::nullopt;
+  auto encode = bootstrap.getLookupTable()
+                    .getDefiningOp<TFHE::EncodeExpandLutForBootstrapOp>();
+  if (encode == nullptr)
+    return std::nullopt;
+  mlir::DenseIntElementsAttr lut;
+  if (!mlir::matchPattern(encode.getInputLookupTable(),
+                          mlir::m_Constant(&lut)))
+    return std::nullopt;
+  return Candidate{bootstrap, encode, lut, maxLutCount.getInt()};
+}
+
+/// Bootstraps that can be grouped share their input ciphertext, their
+/// bootstrap key and the encoding of their lookup tables.
+using GroupKey = std::tuple<mlir::Value, mlir::Attribute, int64_t, int64_t,
+                            int64_t, int64_t>;
+
+GroupKey getGroupKey(const Candidate &candidate) {
+  return GroupKey{candidate.bootstrap.getCiphertext(),
+                  candidate.bootstrap.getKeyAttr(),
+                  candidate.encode.getPolySize(),
+                  candidate.encode.getOutputBits(),
+                  candidate.encode.getIsSigned(),
+                  candidate.lut.getNumElements()};
+}
+
+/// Returns the largest number of lookup tables, lower or equal to
+/// `maxLutCount`, that fits in an accumulator of `polySize` coefficients
+/// for lookup tables of `lutSize` entries, or 1 if there is none.
+int64_t fittingLutCount(int64_t maxLutCount, int64_t polySize,
+                        int64_t lutSize) {
+  int64_t lutCount = llvm::PowerOf2Floor(maxLutCount);
+  // Each lookup table needs a slot of at least two coefficients per entry,
+  // to be centered over its value
+  while (lutCount > 1 && polySize / lutSize < 2 * lutCount)
+    lutCount /= 2;
+  return lutCount;
+}
+
+/// Replaces the bootstraps of `group` by a single many-lut bootstrap.
+void replaceByManyLutBootstrap(llvm::ArrayRef<Candidate> group) {
+  const Candidate &first = group.front();
+  mlir::OpBuilder builder(first.bootstrap);
+
+  llvm::SmallVector<mlir::Location> locations;
+  std::vector<llvm::APInt> values;
+  for (const Candidate &candidate : group) {
+    locations.push_back(candidate.bootstrap.getLoc());
+    for (llvm::APInt value : candidate.lut.getValues<llvm::APInt>())
+      values.push_back(value.sextOrTrunc(64));
+  }
+  auto loc = builder.getFusedLoc(locations);
+
+  int64_t lutCount = group.size();
+  int64_t lutSize = first.lut.getNumElements();
+  auto lutsType =
+      mlir::RankedTensorType::get({lutCount, lutSize}, builder.getI64Type());
+  mlir::Value luts = builder.create<mlir::arith::ConstantOp>(
+      loc, mlir::DenseIntElementsAttr::get(lutsType, values));
+
+  mlir::Value accumulator =
+      builder.create<TFHE::EncodeExpandManyLutsForBootstrapOp>(
+          loc, first.encode.getType(), luts, first.encode.getPolySizeAttr(),
+          first.encode.getOutputBitsAttr(), first.encode.getIsSignedAttr());
+
+  llvm::SmallVector<mlir::Type> resultTypes(lutCount,
+                                            first.bootstrap.getType());
+  auto manyBootstrap = builder.create<TFHE::ManyBootstrapGLWEOp>(
+      loc, resultTypes, first.bootstrap.getCiphertext(), accumulator,
+      builder.getI32IntegerAttr(lutSize), first.bootstrap.getKeyAttr());
+
+  for (size_t i = 0; i < group.size(); i++) {
+    mlir::Operation *bootstrap = group[i].bootstrap;
+    mlir::Operation *encode = group[i].encode;
+    bootstrap->replaceAllUsesWith(
+        mlir::ValueRange{manyBootstrap.getResult(i)});
+    bootstrap->erase();
+    if (encode->use_empty())
+      encode->erase();
+  }
+}
+
+/// Pass that evaluates several lookup tables on the same ciphertext with a
+/// single bootstrap. The lookup tables are interleaved in the accumulator,
+/// such that the i-th lookup table is extracted from the i-th coefficient
+/// slot of the rotated accumulator. Only the bootstraps annotated by the
+/// optimizer are grouped, as the input noise must have been budgeted for the
+/// slot of a single lookup table.
+class TFHEManyLutBootstrapPass
+    : public TFHEManyLutBootstrapBase<TFHEManyLutBootstrapPass> {
+public:
+  void runOnOperation() override {
+    mlir::Operation *root = getOperation();
+
+    llvm::SmallVector<mlir::Block *> blocks;
+    root->walk([&](mlir::Block *block) { blocks.push_back(block); });
+
+    for (mlir::Block *block : blocks) {
+      llvm::MapVector<GroupKey, llvm::SmallVector<Candidate>> groups;
+      for (auto bootstrap : block->getOps<TFHE::BootstrapGLWEOp>()) {
+        if (auto candidate = asCandidate(bootstrap))
+          groups[getGroupKey(*candidate)].push_back(*candidate);
+      }
+
+      for (auto &[key, candidates] : groups) {
+        int64_t polySize = std::get<2>(key);
+        int64_t lutSize = std::get<5>(key);
+        llvm::ArrayRef<Candidate> remaining(candidates);
+        while (remaining.size() > 1) {
+          // The optimizer budgeted the candidates in block order, by groups
+          // of the size annotated on the first candidate of each group
+          int64_t maxLutCount = std::min<int64_t>(
+              remaining.front().maxLutCount, remaining.size());
+          for (const Candidate &candidate : remaining.take_front(maxLutCount))
+            maxLutCount = std::min(maxLutCount, candidate.maxLutCount);
+          int64_t lutCount = fittingLutCount(maxLutCount, polySize, lutSize);
+          if (lutCount < 2)
+            break;
+          replaceByManyLutBootstrap(remaining.take_front(lutCount));
+          remaining = remaining.drop_front(lutCount);
+        }
+      }
+    }
+
+    root->walk([&](TFHE::BootstrapGLWEOp bootstrap) {
+      bootstrap->removeAttr(MANY_LUT_ATTR_NAME);
+    });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::OperationPass<>> createTFHEManyLutBootstrapPass() {
+  return std::make_unique<TFHEManyLutBootstrapPass>();
+}
+
+} // namespace concretelang
+} // namespace mlir
@@ -6,9 +6,12 @@
 #include "llvm/Support/Debug.h"
 
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
+#include "concretelang/Dialect/RT/IR/RTOps.h"
 #include "concretelang/Dialect/TFHE/IR/TFHEOps.h"
 #include "concretelang/Dialect/TFHE/Transforms/Transforms.h"
 #include "concretelang/Support/Constants.h"
@@ -29,6 +32,7 @@ namespace {
   }
 
 namespace TFHE = mlir::concretelang::TFHE;
+namespace RT = mlir::concretelang::RT;
 
 /// Optimization pass that should choose more efficient ways of performing
 /// crypto operations.
@@ -46,13 +50,18 @@ public:
       DEBUG("apply solution: \n" << solution.dump().c_str());
       DEBUG("process func: " << func);
       // Process function arguments, change type of arguments according of the
-      // optimizer identifier stored in the "TFHE.OId" attribute.
+      // optimizer identifier stored in the "TFHE.OId" attribute. The
+      // arguments of the work function of a dataflow task are the values
+      // flowing through the task boundary.
+      bool isWorkFunction = func->hasAttr("_dfr_work_function_attribute");
       for (size_t i = 0; i < func.getNumArguments(); i++) {
         auto arg = func.getArgument(i);
         auto attr = func.getArgAttrOfType<mlir::IntegerAttr>(i, "TFHE.OId");
         if (attr != nullptr) {
           DEBUG("process arg = " << arg)
-          arg.setType(getParametrizedType(arg.getType(), attr));
+          arg.setType(isWorkFunction
+                          ? getTaskBoundaryParametrizedType(arg.getType(), attr)
+                          : getParametrizedType(arg.getType(), attr));
         } else {
           DEBUG("skip arg " << arg)
         }
@@ -79,6 +88,15 @@ public:
       VERBOSE("\n### BEFORE Remove optimizer identifiers \n" << func);
       removeOptimizerIdentifiers(func);
     });
+    // The work functions of the dataflow tasks are referenced by constants
+    // which must follow their parametrized signature
+    op->walk([&](mlir::func::ConstantOp constant) {
+      auto callee =
+          mlir::SymbolTable::lookupNearestSymbolFrom<mlir::func::FuncOp>(
+              constant, constant.getValueAttr());
+      if (callee != nullptr)
+        constant.getResult().setType(callee.getFunctionType());
+    });
   }
 
   static mlir::Type getParametrizedType(mlir::Type originalType,
@@ -94,6 +112,14 @@ public:
       assert(oldGlwe != nullptr);
       assert(oldGlwe.getKey().isNone());
       return mlir::RankedTensorType::get(oldTensor.getShape(), newGlwe);
+    } else if (auto oldFuture = originalType.dyn_cast<RT::FutureType>();
+               oldFuture != nullptr) {
+      return RT::FutureType::get(
+          getParametrizedType(oldFuture.getElementType(), newGlwe));
+    } else if (auto oldPointer = originalType.dyn_cast<RT::PointerType>();
+               oldPointer != nullptr) {
+      return RT::PointerType::get(
+          getParametrizedType(oldPointer.getElementType(), newGlwe));
     }
     assert(false);
   }
@@ -106,6 +132,14 @@ public:
     return getParametrizedType(originalType, newGlwe);
   }
 
+  mlir::Type getTaskBoundaryParametrizedType(mlir::Type originalType,
+                                             mlir::IntegerAttr optimizerAttrID) {
+    auto context = originalType.getContext();
+    auto newGlwe =
+        getTaskBoundaryLWECipherTextType(context, optimizerAttrID.getInt());
+    return getParametrizedType(originalType, newGlwe);
+  }
+
   static TFHE::GLWECipherTextType getGlweTypeFromType(mlir::Type type) {
     if (auto glwe = type.dyn_cast<TFHE::GLWECipherTextType>();
         glwe != nullptr) {
@@ -117,6 +151,12 @@ public:
         return nullptr;
       }
       return glwe;
+    } else if (auto future = type.dyn_cast<RT::FutureType>();
+               future != nullptr) {
+      return getGlweTypeFromType(future.getElementType());
+    } else if (auto pointer = type.dyn_cast<RT::PointerType>();
+               pointer != nullptr) {
+      return getGlweTypeFromType(pointer.getElementType());
     }
     return nullptr;
   }
@@ -148,9 +188,14 @@ public:
       }
       DEBUG("process operation: " << *op);
       auto optimizerID = attrOptimizerID.getInt();
-      // Change the output type of the operation
+      // Change the output type of the operation, the placeholder of a
+      // dataflow task result holds the value flowing out of the task
+      bool isTaskBoundary = mlir::isa<RT::BuildReturnPtrPlaceholderOp>(op);
       for (auto result : op->getResults()) {
-        result.setType(getParametrizedType(result.getType(), attrOptimizerID));
+        result.setType(isTaskBoundary ? getTaskBoundaryParametrizedType(
+                                            result.getType(), attrOptimizerID)
+                                      : getParametrizedType(result.getType(),
+                                                            attrOptimizerID));
       }
       // Set the keyswitch_key attribute
       // TODO: Change ambiguous attribute name
@@ -245,7 +290,8 @@ public:
       auto newAttrBootstrapKey = TFHE::GLWEBootstrapKeyAttr::get(
           context, attrBootstrapKey.getInputKey(), newOutputKey,
           attrBootstrapKey.getPolySize(), attrBootstrapKey.getGlweDim(),
-          attrBootstrapKey.getLevels(), attrBootstrapKey.getBaseLog(), -1);
+          attrBootstrapKey.getLevels(), attrBootstrapKey.getBaseLog(), -1,
+          attrBootstrapKey.getGroupingFactor());
       op.setKeyAttr(newAttrBootstrapKey);
     });
   }
@@ -253,6 +299,10 @@ public:
   static void
   fixupNonParametrizedOp(mlir::Operation *op,
                          TFHE::GLWECipherTextType parametrizedGlweType) {
+    // The operands of a dataflow task creation are unrelated values, which
+    // are parametrized from their own producers
+    if (mlir::isa<RT::CreateAsyncTaskOp>(op))
+      return;
     DEBUG("  START Fixup {" << *op)
     for (auto result : op->getResults()) {
       if (isNoneGlweType(result.getType())) {
@@ -521,7 +571,7 @@ public:
         context, toLWESecretKey(key.input_key), toGLWESecretKey(key.output_key),
         key.output_key.polynomial_size, key.output_key.glwe_dimension,
         key.br_decomposition_parameter.level,
-        key.br_decomposition_parameter.log2_base, -1);
+        key.br_decomposition_parameter.log2_base, -1, 1);
   }
 
   const TFHE::GLWECipherTextType
@@ -530,6 +580,25 @@ public:
     return TFHE::GLWECipherTextType::get(context, outputKey);
   }
 
+  /// Returns the type of the ciphertexts computed by the instruction
+  /// `optimizerID` once they flow to another dataflow task. All the uses of
+  /// a bootstrap with an extra conversion key are converted, see
+  /// `applyInstructionKeys`.
+  const TFHE::GLWECipherTextType
+  getTaskBoundaryLWECipherTextType(mlir::MLIRContext *context,
+                                   size_t optimizerID) {
+    auto instKeys = getInstructionKey(optimizerID);
+    if (instKeys.tlu_bootstrap_key == concrete_optimizer::NO_KEY_ID() ||
+        instKeys.extra_conversion_keys.size() == 0) {
+      return getOutputLWECipherTextType(context, optimizerID);
+    }
+    auto convKSK =
+        solution.circuit_keys
+            .conversion_keyswitch_keys[instKeys.extra_conversion_keys[0]];
+    return TFHE::GLWECipherTextType::get(context,
+                                         toLWESecretKey(convKSK.output_key));
+  }
+
 private:
   concrete_optimizer::dag::CircuitSolution solution;
 };
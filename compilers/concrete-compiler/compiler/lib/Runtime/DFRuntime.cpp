@@ -61,11 +61,14 @@ void _dfr_deallocate_future(void *in) {
   auto drf = static_cast<dfr_refcounted_future_p>(in);
   size_t prev_count = drf->count.fetch_sub(1);
   if (prev_count == 1) {
-    // If this was a memref for which a clone was needed, deallocate first.
-    if (drf->cloned_memref_p)
-      free(
-          (void *)(static_cast<StridedMemRefType<char, 1> *>(drf->future->get())
-                       ->data));
+    // If the future owns the buffer of a memref (either a clone or a
+    // buffer handed over by its producer), deallocate it first.  The
+    // allocated pointer is only null for buffers received from a remote
+    // node, which are allocated at the aligned pointer.
+    if (drf->cloned_memref_p) {
+      auto mref = static_cast<StridedMemRefType<char, 1> *>(drf->future->get());
+      free((void *)(mref->basePtr ? mref->basePtr : mref->data));
+    }
     free(drf->future->get());
     delete (drf->future);
     delete drf;
@@ -179,6 +182,9 @@ bool _dfr_is_jit() { return is_jit_p; }
 bool _dfr_is_root_node() { return is_root_node_p; }
 bool _dfr_use_omp() { return use_omp_p; }
 bool _dfr_is_distributed() { return num_nodes > 1; }
+bool _dfr_is_worker_thread() {
+  return hpx::get_worker_thread_num() != std::size_t(-1);
+}
 } // namespace dfr
 } // namespace concretelang
 } // namespace mlir
@@ -492,6 +498,7 @@ bool _dfr_is_jit() { return is_jit_p; }
 bool _dfr_is_root_node() { return true; }
 bool _dfr_use_omp() { return use_omp_p; }
 bool _dfr_is_distributed() { return num_nodes > 1; }
+bool _dfr_is_worker_thread() { return false; }
 
 } // namespace dfr
 } // namespace concretelang
@@ -321,6 +321,22 @@ struct Process {
   Param glwe_dim;
   Param sk_index;
   Param output_size;
+  // Additional parameters of the wop-pbs
+  Param ks_level;
+  Param ks_base_log;
+  Param pksk_level;
+  Param pksk_base_log;
+  Param cbs_level;
+  Param cbs_base_log;
+  Param ksk_index;
+  Param bsk_index;
+  Param pksk_index;
+  // Parameters of the lookup table and plaintext encodings
+  Param precision;
+  Param is_signed;
+  uint64_t crt_product;
+  std::vector<uint64_t> crt_decomposition;
+  std::vector<uint64_t> crt_bits;
   Context ctx;
   void (*fun)(Process *, int32_t, uint64_t *);
   char name[80];
@@ -1139,6 +1155,105 @@ void memref_negate_lwe_ciphertext_u64_process(Process *p, int32_t loc,
       sched(idep0, (cudaStream_t *)p->dfg->get_gpu_stream(loc), loc));
 }
 
+// The encodings of lookup tables and plaintexts and the wop-pbs are only
+// implemented on the host: their inputs are brought back to the host, where
+// their results are produced, whatever the location they are scheduled on.
+void memref_encode_expand_lut_for_bootstrap_process(Process *p, int32_t loc,
+                                                    uint64_t *out_ptr) {
+  Dependence *idep = p->input_streams[0]->get(host_location);
+  MemRef2 &lut = idep->host_data;
+  MemRef2 out = {0, 0, 0, {1, p->output_size.val}, {p->output_size.val, 1}};
+  out.allocated = out.aligned =
+      (uint64_t *)((out_ptr != nullptr) ? out_ptr
+                                         : malloc(memref_get_data_size(out)));
+  memref_encode_expand_lut_for_bootstrap(
+      out.allocated, out.aligned, out.offset, out.sizes[1], out.strides[1],
+      lut.allocated, lut.aligned, lut.offset, lut.sizes[1], lut.strides[1],
+      p->poly_size.val, p->precision.val, p->is_signed.val);
+  p->output_streams[0]->put(
+      new Dependence(host_location, out, nullptr, true, true, idep->chunk_id));
+}
+
+void memref_encode_lut_for_crt_woppbs_process(Process *p, int32_t loc,
+                                              uint64_t *out_ptr) {
+  Dependence *idep = p->input_streams[0]->get(host_location);
+  MemRef2 &lut = idep->host_data;
+  MemRef2 out = {0,
+                 0,
+                 0,
+                 {p->crt_decomposition.size(), p->output_size.val},
+                 {p->output_size.val, 1}};
+  out.allocated = out.aligned =
+      (uint64_t *)((out_ptr != nullptr) ? out_ptr
+                                         : malloc(memref_get_data_size(out)));
+  memref_encode_lut_for_crt_woppbs(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], lut.allocated, lut.aligned, lut.offset,
+      lut.sizes[1], lut.strides[1], p->crt_decomposition.data(),
+      p->crt_decomposition.data(), 0, p->crt_decomposition.size(), 1,
+      p->crt_bits.data(), p->crt_bits.data(), 0, p->crt_bits.size(), 1,
+      p->crt_product, p->is_signed.val);
+  p->output_streams[0]->put(
+      new Dependence(host_location, out, nullptr, true, true, idep->chunk_id));
+}
+
+void memref_encode_plaintext_with_crt_process(Process *p, int32_t loc,
+                                              uint64_t *out_ptr) {
+  Dependence *idep = p->input_streams[0]->get(host_location);
+  uint64_t plaintext = idep->host_data.aligned[idep->host_data.offset];
+  MemRef2 out = {0, 0, 0, {1, p->output_size.val}, {p->output_size.val, 1}};
+  out.allocated = out.aligned =
+      (uint64_t *)((out_ptr != nullptr) ? out_ptr
+                                         : malloc(memref_get_data_size(out)));
+  memref_encode_plaintext_with_crt(
+      out.allocated, out.aligned, out.offset, out.sizes[1], out.strides[1],
+      plaintext, p->crt_decomposition.data(), p->crt_decomposition.data(), 0,
+      p->crt_decomposition.size(), 1, p->crt_product);
+  p->output_streams[0]->put(
+      new Dependence(host_location, out, nullptr, true, true, idep->chunk_id));
+}
+
+void memref_wop_pbs_crt_lwe_u64_process(Process *p, int32_t loc,
+                                        uint64_t *out_ptr) {
+  Dependence *idep0 = p->input_streams[0]->get(host_location);
+  Dependence *idep1 = p->input_streams[1]->get(host_location);
+  MemRef2 &ct0 = idep0->host_data;
+  MemRef2 &luts = idep1->host_data;
+  MemRef2 out = {0,
+                 0,
+                 0,
+                 {ct0.sizes[0], p->output_size.val},
+                 {p->output_size.val, 1}};
+  out.allocated = out.aligned =
+      (uint64_t *)((out_ptr != nullptr) ? out_ptr
+                                         : malloc(memref_get_data_size(out)));
+  memref_wop_pbs_crt_buffer(
+      out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+      out.strides[0], out.strides[1], ct0.allocated, ct0.aligned, ct0.offset,
+      ct0.sizes[0], ct0.sizes[1], ct0.strides[0], ct0.strides[1],
+      luts.allocated, luts.aligned, luts.offset, luts.sizes[0], luts.sizes[1],
+      luts.strides[0], luts.strides[1], p->crt_decomposition.data(),
+      p->crt_decomposition.data(), 0, p->crt_decomposition.size(), 1,
+      p->input_lwe_dim.val, p->cbs_level.val, p->cbs_base_log.val,
+      p->ks_level.val, p->ks_base_log.val, p->level.val, p->base_log.val,
+      p->pksk_level.val, p->pksk_base_log.val, p->poly_size.val,
+      p->ksk_index.val, p->bsk_index.val, p->pksk_index.val, p->ctx.val);
+  p->output_streams[0]->put(
+      new Dependence(host_location, out, nullptr, true, true, idep0->chunk_id));
+}
+
+// Copies the elements of a rank 1 memref passed as a process parameter, as
+// it does not outlive the creation of the process
+static inline std::vector<uint64_t> copy_memref_param(uint64_t *aligned,
+                                                      uint64_t offset,
+                                                      uint64_t size,
+                                                      uint64_t stride) {
+  std::vector<uint64_t> values(size);
+  for (size_t i = 0; i < size; i++)
+    values[i] = aligned[offset + i * stride];
+  return values;
+}
+
 } // namespace
 } // namespace gpu_dfg
 } // namespace concretelang
@@ -1329,6 +1444,95 @@ void stream_emulator_make_memref_batched_mapped_bootstrap_lwe_u64_process(
   ((Stream *)sout)->ct_stream = true;
 }
 
+void stream_emulator_make_memref_encode_expand_lut_for_bootstrap_process(
+    void *dfg, void *sin1, void *sout, uint32_t poly_size, uint32_t output_bits,
+    bool is_signed, uint32_t output_size) {
+  // The lookup table is needed as a whole by each chunk of a batch
+  ((Stream *)sin1)->const_stream = true;
+  Process *p = make_process_1_1(
+      dfg, sin1, sout, memref_encode_expand_lut_for_bootstrap_process);
+  p->poly_size.val = poly_size;
+  p->precision.val = output_bits;
+  p->is_signed.val = is_signed;
+  p->output_size.val = output_size;
+  static int count = 0;
+  sprintf(p->name, "encode_expand_lut_for_bootstrap_%d", count++);
+}
+
+void stream_emulator_make_memref_encode_lut_for_crt_woppbs_process(
+    void *dfg, void *sin1, void *sout, uint64_t *crt_decomposition_allocated,
+    uint64_t *crt_decomposition_aligned, uint64_t crt_decomposition_offset,
+    uint64_t crt_decomposition_size, uint64_t crt_decomposition_stride,
+    uint64_t *crt_bits_allocated, uint64_t *crt_bits_aligned,
+    uint64_t crt_bits_offset, uint64_t crt_bits_size, uint64_t crt_bits_stride,
+    uint32_t modulus_product, bool is_signed, uint32_t output_size) {
+  ((Stream *)sin1)->const_stream = true;
+  Process *p = make_process_1_1(dfg, sin1, sout,
+                                memref_encode_lut_for_crt_woppbs_process);
+  p->crt_decomposition =
+      copy_memref_param(crt_decomposition_aligned, crt_decomposition_offset,
+                        crt_decomposition_size, crt_decomposition_stride);
+  p->crt_bits = copy_memref_param(crt_bits_aligned, crt_bits_offset,
+                                  crt_bits_size, crt_bits_stride);
+  p->crt_product = modulus_product;
+  p->is_signed.val = is_signed;
+  p->output_size.val = output_size;
+  static int count = 0;
+  sprintf(p->name, "encode_lut_for_crt_woppbs_%d", count++);
+}
+
+void stream_emulator_make_memref_encode_plaintext_with_crt_process(
+    void *dfg, void *sin1, void *sout, uint64_t *mods_allocated,
+    uint64_t *mods_aligned, uint64_t mods_offset, uint64_t mods_size,
+    uint64_t mods_stride, uint64_t mods_product, uint32_t output_size) {
+  Process *p = make_process_1_1(dfg, sin1, sout,
+                                memref_encode_plaintext_with_crt_process);
+  p->crt_decomposition =
+      copy_memref_param(mods_aligned, mods_offset, mods_size, mods_stride);
+  p->crt_product = mods_product;
+  p->output_size.val = output_size;
+  static int count = 0;
+  sprintf(p->name, "encode_plaintext_with_crt_%d", count++);
+}
+
+void stream_emulator_make_memref_wop_pbs_crt_lwe_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout,
+    uint64_t *crt_decomposition_allocated, uint64_t *crt_decomposition_aligned,
+    uint64_t crt_decomposition_offset, uint64_t crt_decomposition_size,
+    uint64_t crt_decomposition_stride, uint32_t lwe_small_size,
+    uint32_t cbs_level, uint32_t cbs_base_log, uint32_t ksk_level,
+    uint32_t ksk_base_log, uint32_t bsk_level, uint32_t bsk_base_log,
+    uint32_t fpksk_level, uint32_t fpksk_base_log, uint32_t poly_size,
+    uint32_t output_size, uint32_t ksk_index, uint32_t bsk_index,
+    uint32_t pksk_index, void *context) {
+  // The blocks of a CRT ciphertext and the lookup tables must not be split
+  // across chunks
+  ((Stream *)sin1)->const_stream = true;
+  ((Stream *)sin2)->const_stream = true;
+  Process *p = make_process_2_1(dfg, sin1, sin2, sout,
+                                memref_wop_pbs_crt_lwe_u64_process);
+  p->crt_decomposition =
+      copy_memref_param(crt_decomposition_aligned, crt_decomposition_offset,
+                        crt_decomposition_size, crt_decomposition_stride);
+  p->input_lwe_dim.val = lwe_small_size;
+  p->cbs_level.val = cbs_level;
+  p->cbs_base_log.val = cbs_base_log;
+  p->ks_level.val = ksk_level;
+  p->ks_base_log.val = ksk_base_log;
+  p->level.val = bsk_level;
+  p->base_log.val = bsk_base_log;
+  p->pksk_level.val = fpksk_level;
+  p->pksk_base_log.val = fpksk_base_log;
+  p->poly_size.val = poly_size;
+  p->output_size.val = output_size;
+  p->ksk_index.val = ksk_index;
+  p->bsk_index.val = bsk_index;
+  p->pksk_index.val = pksk_index;
+  p->ctx.val = (RuntimeContext *)context;
+  static int count = 0;
+  sprintf(p->name, "wop_pbs_crt_%d", count++);
+}
+
 void *stream_emulator_make_uint64_stream(const char *name, stream_type stype) {
   return (void *)new Stream(stype);
 }
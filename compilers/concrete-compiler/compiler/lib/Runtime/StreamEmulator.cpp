@@ -38,9 +38,11 @@ private:
 union Stream {
   StreamBase<uint64_t> *uint64_stream;
   StreamBase<MemRefDescriptor<1>> *memref_stream;
+  StreamBase<MemRefDescriptor<2>> *memref_batch_stream;
 
   Stream(StreamBase<uint64_t> *s) : uint64_stream(s) {}
   Stream(StreamBase<MemRefDescriptor<1>> *s) : memref_stream(s) {}
+  Stream(StreamBase<MemRefDescriptor<2>> *s) : memref_batch_stream(s) {}
 };
 
 struct Void {};
@@ -67,6 +69,19 @@ struct Process {
   Param output_size;
   Param ksk_index;
   Param bsk_index;
+  // Additional parameters of the wop-pbs
+  Param ks_level;
+  Param ks_base_log;
+  Param pksk_level;
+  Param pksk_base_log;
+  Param cbs_level;
+  Param cbs_base_log;
+  Param pksk_index;
+  // Parameters of the lookup table and plaintext encodings
+  Param is_signed;
+  uint64_t crt_product;
+  std::vector<uint64_t> crt_decomposition;
+  std::vector<uint64_t> crt_bits;
   Context ctx;
   void (*fun)(Process *);
 };
@@ -192,6 +207,104 @@ void memref_negate_lwe_ciphertext_u64_process(Process *p) {
   delete p;
 }
 
+void memref_encode_expand_lut_for_bootstrap_process(Process *p) {
+  while (!p->terminate_p) {
+    MemRefDescriptor<1> lut = (p->input_streams[0]).memref_stream->get();
+    MemRefDescriptor<1> out;
+    out.sizes[0] = p->output_size.val;
+    out.strides[0] = 1;
+    out.offset = 0;
+    out.allocated = out.aligned =
+        (uint64_t *)malloc(out.sizes[0] * sizeof(uint64_t));
+    memref_encode_expand_lut_for_bootstrap(
+        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+        lut.allocated, lut.aligned, lut.offset, lut.sizes[0], lut.strides[0],
+        p->poly_size.val, p->precision.val, p->is_signed.val);
+    (p->output_streams[0]).memref_stream->put(out);
+  }
+  delete p;
+}
+
+void memref_encode_lut_for_crt_woppbs_process(Process *p) {
+  while (!p->terminate_p) {
+    MemRefDescriptor<1> lut = (p->input_streams[0]).memref_stream->get();
+    MemRefDescriptor<2> out;
+    out.sizes[0] = p->crt_decomposition.size();
+    out.sizes[1] = p->output_size.val;
+    out.strides[0] = out.sizes[1];
+    out.strides[1] = 1;
+    out.offset = 0;
+    out.allocated = out.aligned =
+        (uint64_t *)malloc(out.sizes[0] * out.sizes[1] * sizeof(uint64_t));
+    memref_encode_lut_for_crt_woppbs(
+        out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+        out.strides[0], out.strides[1], lut.allocated, lut.aligned, lut.offset,
+        lut.sizes[0], lut.strides[0], p->crt_decomposition.data(),
+        p->crt_decomposition.data(), 0, p->crt_decomposition.size(), 1,
+        p->crt_bits.data(), p->crt_bits.data(), 0, p->crt_bits.size(), 1,
+        p->crt_product, p->is_signed.val);
+    (p->output_streams[0]).memref_batch_stream->put(out);
+  }
+  delete p;
+}
+
+void memref_encode_plaintext_with_crt_process(Process *p) {
+  while (!p->terminate_p) {
+    uint64_t plaintext = (p->input_streams[0]).uint64_stream->get();
+    MemRefDescriptor<1> out;
+    out.sizes[0] = p->output_size.val;
+    out.strides[0] = 1;
+    out.offset = 0;
+    out.allocated = out.aligned =
+        (uint64_t *)malloc(out.sizes[0] * sizeof(uint64_t));
+    memref_encode_plaintext_with_crt(
+        out.allocated, out.aligned, out.offset, out.sizes[0], out.strides[0],
+        plaintext, p->crt_decomposition.data(), p->crt_decomposition.data(), 0,
+        p->crt_decomposition.size(), 1, p->crt_product);
+    (p->output_streams[0]).memref_stream->put(out);
+  }
+  delete p;
+}
+
+void memref_wop_pbs_crt_lwe_u64_process(Process *p) {
+  while (!p->terminate_p) {
+    MemRefDescriptor<2> ct0 = (p->input_streams[0]).memref_batch_stream->get();
+    MemRefDescriptor<2> luts = (p->input_streams[1]).memref_batch_stream->get();
+    MemRefDescriptor<2> out;
+    out.sizes[0] = ct0.sizes[0];
+    out.sizes[1] = p->output_size.val;
+    out.strides[0] = out.sizes[1];
+    out.strides[1] = 1;
+    out.offset = 0;
+    out.allocated = out.aligned =
+        (uint64_t *)malloc(out.sizes[0] * out.sizes[1] * sizeof(uint64_t));
+    memref_wop_pbs_crt_buffer(
+        out.allocated, out.aligned, out.offset, out.sizes[0], out.sizes[1],
+        out.strides[0], out.strides[1], ct0.allocated, ct0.aligned,
+        ct0.offset, ct0.sizes[0], ct0.sizes[1], ct0.strides[0],
+        ct0.strides[1], luts.allocated, luts.aligned, luts.offset,
+        luts.sizes[0], luts.sizes[1], luts.strides[0], luts.strides[1],
+        p->crt_decomposition.data(), p->crt_decomposition.data(), 0,
+        p->crt_decomposition.size(), 1, p->input_lwe_dim.val,
+        p->cbs_level.val, p->cbs_base_log.val, p->ks_level.val,
+        p->ks_base_log.val, p->level.val, p->base_log.val, p->pksk_level.val,
+        p->pksk_base_log.val, p->poly_size.val, p->ksk_index.val,
+        p->bsk_index.val, p->pksk_index.val, p->ctx.val);
+    (p->output_streams[0]).memref_batch_stream->put(out);
+  }
+  delete p;
+}
+
+// Copies the elements of a rank 1 memref passed as a process parameter, as
+// it does not outlive the creation of the process
+std::vector<uint64_t> copy_memref_param(uint64_t *aligned, uint64_t offset,
+                                        uint64_t size, uint64_t stride) {
+  std::vector<uint64_t> values(size);
+  for (size_t i = 0; i < size; i++)
+    values[i] = aligned[offset + i * stride];
+  return values;
+}
+
 } // namespace
 } // namespace stream_emulator
 } // namespace concretelang
@@ -326,6 +439,122 @@ void stream_emulator_make_memref_bootstrap_lwe_u64_process(
       ->dfg_processes.push_back(p);
 }
 
+void stream_emulator_make_memref_encode_expand_lut_for_bootstrap_process(
+    void *dfg, void *sin1, void *sout, uint32_t poly_size, uint32_t output_bits,
+    bool is_signed, uint32_t output_size) {
+  mlir::concretelang::stream_emulator::Process *p =
+      new mlir::concretelang::stream_emulator::Process;
+  p->input_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
+          sin1);
+  p->output_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
+          sout);
+  p->poly_size.val = poly_size;
+  p->precision.val = output_bits;
+  p->is_signed.val = is_signed;
+  p->output_size.val = output_size;
+  p->fun = mlir::concretelang::stream_emulator::
+      memref_encode_expand_lut_for_bootstrap_process;
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
+      ->dfg_processes.push_back(p);
+}
+
+void stream_emulator_make_memref_encode_lut_for_crt_woppbs_process(
+    void *dfg, void *sin1, void *sout, uint64_t *crt_decomposition_allocated,
+    uint64_t *crt_decomposition_aligned, uint64_t crt_decomposition_offset,
+    uint64_t crt_decomposition_size, uint64_t crt_decomposition_stride,
+    uint64_t *crt_bits_allocated, uint64_t *crt_bits_aligned,
+    uint64_t crt_bits_offset, uint64_t crt_bits_size, uint64_t crt_bits_stride,
+    uint32_t modulus_product, bool is_signed, uint32_t output_size) {
+  mlir::concretelang::stream_emulator::Process *p =
+      new mlir::concretelang::stream_emulator::Process;
+  p->input_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
+          sin1);
+  p->output_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<2>> *)
+          sout);
+  p->crt_decomposition = mlir::concretelang::stream_emulator::copy_memref_param(
+      crt_decomposition_aligned, crt_decomposition_offset,
+      crt_decomposition_size, crt_decomposition_stride);
+  p->crt_bits = mlir::concretelang::stream_emulator::copy_memref_param(
+      crt_bits_aligned, crt_bits_offset, crt_bits_size, crt_bits_stride);
+  p->crt_product = modulus_product;
+  p->is_signed.val = is_signed;
+  p->output_size.val = output_size;
+  p->fun = mlir::concretelang::stream_emulator::
+      memref_encode_lut_for_crt_woppbs_process;
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
+      ->dfg_processes.push_back(p);
+}
+
+void stream_emulator_make_memref_encode_plaintext_with_crt_process(
+    void *dfg, void *sin1, void *sout, uint64_t *mods_allocated,
+    uint64_t *mods_aligned, uint64_t mods_offset, uint64_t mods_size,
+    uint64_t mods_stride, uint64_t mods_product, uint32_t output_size) {
+  mlir::concretelang::stream_emulator::Process *p =
+      new mlir::concretelang::stream_emulator::Process;
+  p->input_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<uint64_t> *)sin1);
+  p->output_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<1>> *)
+          sout);
+  p->crt_decomposition = mlir::concretelang::stream_emulator::copy_memref_param(
+      mods_aligned, mods_offset, mods_size, mods_stride);
+  p->crt_product = mods_product;
+  p->output_size.val = output_size;
+  p->fun = mlir::concretelang::stream_emulator::
+      memref_encode_plaintext_with_crt_process;
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
+      ->dfg_processes.push_back(p);
+}
+
+void stream_emulator_make_memref_wop_pbs_crt_lwe_u64_process(
+    void *dfg, void *sin1, void *sin2, void *sout,
+    uint64_t *crt_decomposition_allocated, uint64_t *crt_decomposition_aligned,
+    uint64_t crt_decomposition_offset, uint64_t crt_decomposition_size,
+    uint64_t crt_decomposition_stride, uint32_t lwe_small_size,
+    uint32_t cbs_level, uint32_t cbs_base_log, uint32_t ksk_level,
+    uint32_t ksk_base_log, uint32_t bsk_level, uint32_t bsk_base_log,
+    uint32_t fpksk_level, uint32_t fpksk_base_log, uint32_t poly_size,
+    uint32_t output_size, uint32_t ksk_index, uint32_t bsk_index,
+    uint32_t pksk_index, void *context) {
+  mlir::concretelang::stream_emulator::Process *p =
+      new mlir::concretelang::stream_emulator::Process;
+  p->input_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<2>> *)
+          sin1);
+  p->input_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<2>> *)
+          sin2);
+  p->output_streams.push_back(
+      (mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<2>> *)
+          sout);
+  p->crt_decomposition = mlir::concretelang::stream_emulator::copy_memref_param(
+      crt_decomposition_aligned, crt_decomposition_offset,
+      crt_decomposition_size, crt_decomposition_stride);
+  p->input_lwe_dim.val = lwe_small_size;
+  p->cbs_level.val = cbs_level;
+  p->cbs_base_log.val = cbs_base_log;
+  p->ks_level.val = ksk_level;
+  p->ks_base_log.val = ksk_base_log;
+  p->level.val = bsk_level;
+  p->base_log.val = bsk_base_log;
+  p->pksk_level.val = fpksk_level;
+  p->pksk_base_log.val = fpksk_base_log;
+  p->poly_size.val = poly_size;
+  p->output_size.val = output_size;
+  p->ksk_index.val = ksk_index;
+  p->bsk_index.val = bsk_index;
+  p->pksk_index.val = pksk_index;
+  p->ctx.val = (mlir::concretelang::RuntimeContext *)context;
+  p->fun =
+      mlir::concretelang::stream_emulator::memref_wop_pbs_crt_lwe_u64_process;
+  ((mlir::concretelang::stream_emulator::DFGraph *)dfg)
+      ->dfg_processes.push_back(p);
+}
+
 void *stream_emulator_make_uint64_stream(const char *name, stream_type stype) {
   return (void *)new mlir::concretelang::stream_emulator::StreamBase<uint64_t>;
 }
@@ -363,20 +592,32 @@ void stream_emulator_get_memref(void *stream, uint64_t *out_allocated,
 
 void *stream_emulator_make_memref_batch_stream(const char *name,
                                                stream_type stype) {
-  assert(0 && "Batched operations not implemented in the StreamEmulator.");
+  return (void *)new mlir::concretelang::stream_emulator::StreamBase<
+      MemRefDescriptor<2>>;
 }
 void stream_emulator_put_memref_batch(void *stream, uint64_t *allocated,
                                       uint64_t *aligned, uint64_t offset,
                                       uint64_t size0, uint64_t size1,
                                       uint64_t stride0, uint64_t stride1) {
-  assert(0 && "Batched operations not implemented in the StreamEmulator.");
+  ((mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<2>> *)
+       stream)
+      ->put({allocated, aligned, offset, {size0, size1}, {stride0, stride1}});
 }
 void stream_emulator_get_memref_batch(void *stream, uint64_t *out_allocated,
                                       uint64_t *out_aligned,
                                       uint64_t out_offset, uint64_t out_size0,
                                       uint64_t out_size1, uint64_t out_stride0,
                                       uint64_t out_stride1) {
-  assert(0 && "Batched operations not implemented in the StreamEmulator.");
+  MemRefDescriptor<2> mref =
+      ((mlir::concretelang::stream_emulator::StreamBase<MemRefDescriptor<2>> *)
+           stream)
+          ->get();
+  for (size_t i = 0; i < out_size0; i++)
+    memref_copy_one_rank(mref.allocated, mref.aligned,
+                         mref.offset + i * mref.strides[0], mref.sizes[1],
+                         mref.strides[1], out_allocated, out_aligned,
+                         out_offset + i * out_stride0, out_size1, out_stride1);
+  free(mref.allocated);
 }
 
 void *stream_emulator_init() {
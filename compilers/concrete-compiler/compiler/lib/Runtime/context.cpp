@@ -6,12 +6,163 @@
 #include "concretelang/Runtime/context.h"
 #include "concretelang/Common/Error.h"
 #include "concretelang/Common/Keysets.h"
+#include <algorithm>
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+#include <hwloc.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
 
 namespace mlir {
 namespace concretelang {
 
+namespace {
+
+/// Size of the huge pages backing the placed fourier bootstrap keys.
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+KeyPlacement getKeyPlacement() {
+  char *env = getenv("CONCRETE_KEY_PLACEMENT");
+  if (env == nullptr || strcmp(env, "default") == 0)
+    return KeyPlacement::DEFAULT;
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+  if (strcmp(env, "replicate") == 0)
+    return KeyPlacement::REPLICATE;
+  if (strcmp(env, "interleave") == 0)
+    return KeyPlacement::INTERLEAVE;
+  fprintf(stderr,
+          "Runtime: unknown key placement `%s`, using the default one\n", env);
+#else
+  fprintf(stderr, "Runtime: key placement `%s` is not supported by this "
+                  "build, using the default one\n",
+          env);
+#endif
+  return KeyPlacement::DEFAULT;
+}
+
+/// Allocates the fourier bootstrap keys on the NUMA nodes according to their
+/// placement.
+class FourierKeyAllocator {
+public:
+  FourierKeyAllocator(KeyPlacement placement) : placement(placement) {
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+    if (placement == KeyPlacement::DEFAULT)
+      return;
+    hwloc_topology_init(&topology);
+    hwloc_topology_load(topology);
+    node_count = std::max(
+        1, hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_NUMANODE));
+#endif
+  }
+
+  FourierKeyAllocator(FourierKeyAllocator &other) = delete;
+
+  ~FourierKeyAllocator() {
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+    if (topology != nullptr)
+      hwloc_topology_destroy(topology);
+#endif
+  }
+
+  /// Returns the number of replicas of each key.
+  size_t replica_count() const {
+    return placement == KeyPlacement::REPLICATE ? node_count : 1;
+  }
+
+  /// Returns the replica read by each cpu, indexed by the os index of the cpu.
+  std::vector<size_t> cpu_replicas() const {
+    std::vector<size_t> replicas;
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+    if (replica_count() == 1)
+      return replicas;
+    for (size_t replica = 0; replica < replica_count(); replica++) {
+      auto node = hwloc_get_obj_by_type(topology, HWLOC_OBJ_NUMANODE, replica);
+      unsigned cpu;
+      hwloc_bitmap_foreach_begin(cpu, node->cpuset) {
+        if (cpu >= replicas.size())
+          replicas.resize(cpu + 1, 0);
+        replicas[cpu] = replica;
+      }
+      hwloc_bitmap_foreach_end();
+    }
+#endif
+    return replicas;
+  }
+
+  /// Allocates the replica `replica` of a fourier bootstrap key of `size`
+  /// elements. The key falls back to the default placement when the placed
+  /// allocation fails, and the process is aborted when memory is exhausted.
+  std::shared_ptr<std::complex<double>> allocate(size_t size, size_t replica) {
+    size_t bytes = size * sizeof(std::complex<double>);
+    void *buffer = nullptr;
+    if (placement != KeyPlacement::DEFAULT) {
+      buffer = allocatePlaced(bytes, replica);
+      if (buffer == nullptr)
+        fprintf(stderr,
+                "Runtime: cannot allocate %zu bytes of huge pages for a "
+                "fourier bootstrap key, using the default placement\n",
+                bytes);
+    }
+    if (buffer == nullptr)
+      buffer = malloc(bytes);
+    if (buffer == nullptr) {
+      fprintf(stderr,
+              "Runtime: cannot allocate %zu bytes for a fourier bootstrap "
+              "key\n",
+              bytes);
+      abort();
+    }
+    return std::shared_ptr<std::complex<double>>((std::complex<double> *)buffer,
+                                                 free);
+  }
+
+private:
+  /// Allocates `bytes` bytes backed by huge pages and bound to the NUMA nodes
+  /// of the replica `replica`, or returns null on failure.
+  void *allocatePlaced(size_t bytes, size_t replica) {
+    // Keys are large and read by every bootstrap, back them by huge pages to
+    // spare TLB misses
+    bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void *buffer = aligned_alloc(HUGE_PAGE_SIZE, bytes);
+    if (buffer == nullptr)
+      return nullptr;
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+#ifdef MADV_HUGEPAGE
+    // Only a hint, transparent huge pages may be disabled on the host
+    madvise(buffer, bytes, MADV_HUGEPAGE);
+#endif
+    // Bind the pages before they are first touched by the conversion
+    if (placement == KeyPlacement::REPLICATE) {
+      auto node = hwloc_get_obj_by_type(topology, HWLOC_OBJ_NUMANODE, replica);
+      if (node != nullptr)
+        hwloc_set_area_membind(topology, buffer, bytes, node->nodeset,
+                               HWLOC_MEMBIND_BIND,
+                               HWLOC_MEMBIND_BYNODESET |
+                                   HWLOC_MEMBIND_MIGRATE);
+    } else {
+      hwloc_set_area_membind(
+          topology, buffer, bytes, hwloc_topology_get_topology_nodeset(topology),
+          HWLOC_MEMBIND_INTERLEAVE,
+          HWLOC_MEMBIND_BYNODESET | HWLOC_MEMBIND_MIGRATE);
+    }
+#endif
+    return buffer;
+  }
+
+  KeyPlacement placement;
+  size_t node_count = 1;
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+  hwloc_topology_t topology = nullptr;
+#endif
+};
+
+} // namespace
+
 FFT::FFT(size_t polynomial_size)
     : fft(nullptr), polynomial_size(polynomial_size) {
   fft = (struct Fft *)aligned_alloc(CONCRETE_FFT_ALIGN, CONCRETE_FFT_SIZE);
@@ -30,8 +181,10 @@ FFT::~FFT() {
 }
 
 RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
-    : serverKeyset(serverKeyset) {
+    : serverKeyset(serverKeyset), placement(getKeyPlacement()) {
   {
+    FourierKeyAllocator allocator(placement);
+    cpu_replicas = allocator.cpu_replicas();
 
     // Initialize for each bootstrap key the fourier one
     for (size_t i = 0; i < serverKeyset.lweBootstrapKeys.size(); i++) {
@@ -44,10 +197,43 @@ RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
       size_t glwe_dimension = info.getParams().getGlweDimension();
       size_t polynomial_size = info.getParams().getPolynomialSize();
       size_t input_lwe_dimension = info.getParams().getInputLweDimension();
+      size_t grouping_factor = info.getParams().getGroupingFactor();
 
       // Create the FFT
       FFT fft(polynomial_size);
 
+      // Allocate the fourier_bootstrap_key
+      auto &bsk_buffer = bsk.getBuffer();
+      size_t fourier_size = bsk_buffer.size() / 2;
+      auto fourier_data = allocator.allocate(fourier_size, 0);
+      auto bsk_data = bsk_buffer.data();
+
+      // Copy the converted key to the other replicas
+      auto replicate = [&]() {
+        std::vector<std::shared_ptr<std::complex<double>>> replicas{
+            fourier_data};
+        for (size_t r = 1; r < allocator.replica_count(); r++) {
+          auto replica = allocator.allocate(fourier_size, r);
+          std::copy(fourier_data.get(), fourier_data.get() + fourier_size,
+                    replica.get());
+          replicas.push_back(replica);
+        }
+        return replicas;
+      };
+
+      if (grouping_factor > 1) {
+        // Convert the multi-bit bootstrap_key to the fourier domain
+        concrete_cpu_multi_bit_bootstrap_key_convert_u64_to_fourier(
+            bsk_data, fourier_data.get(), decomposition_level_count,
+            decomposition_base_log, glwe_dimension, polynomial_size,
+            input_lwe_dimension, grouping_factor, Parallelism::Rayon);
+
+        fourier_bootstrap_keys.push_back(replicate());
+        grouping_factors.push_back(grouping_factor);
+        ffts.push_back(std::move(fft));
+        continue;
+      }
+
       // Allocate scratch for key conversion
       size_t scratch_size;
       size_t scratch_align;
@@ -55,20 +241,15 @@ RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
           &scratch_size, &scratch_align, fft.fft);
       auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
 
-      // Allocate the fourier_bootstrap_key
-      auto &bsk_buffer = bsk.getBuffer();
-      auto fourier_data = std::make_shared<std::vector<std::complex<double>>>();
-      fourier_data->resize(bsk_buffer.size() / 2);
-      auto bsk_data = bsk_buffer.data();
-
       // Convert bootstrap_key to the fourier domain
       concrete_cpu_bootstrap_key_convert_u64_to_fourier(
-          bsk_data, fourier_data->data(), decomposition_level_count,
+          bsk_data, fourier_data.get(), decomposition_level_count,
           decomposition_base_log, glwe_dimension, polynomial_size,
           input_lwe_dimension, fft.fft, scratch, scratch_size);
 
       // Store the fourier_bootstrap_key in the context
-      fourier_bootstrap_keys.push_back(fourier_data);
+      fourier_bootstrap_keys.push_back(replicate());
+      grouping_factors.push_back(1);
       ffts.push_back(std::move(fft));
       free(scratch);
     }
@@ -85,5 +266,14 @@ RuntimeContext::RuntimeContext(ServerKeyset serverKeyset)
   }
 }
 
+size_t RuntimeContext::local_replica() const {
+#ifdef CONCRETELANG_NUMA_KEY_PLACEMENT
+  int cpu = sched_getcpu();
+  if (cpu >= 0 && (size_t)cpu < cpu_replicas.size())
+    return cpu_replicas[cpu];
+#endif
+  return 0;
+}
+
 } // namespace concretelang
 } // namespace mlir
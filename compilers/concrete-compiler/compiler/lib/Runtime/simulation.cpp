@@ -54,15 +54,9 @@ uint64_t sim_keyswitch_lwe_u64(uint64_t plaintext, uint32_t level,
   return plaintext + ks_noise;
 }
 
-uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
-                               uint64_t *tlu_aligned, uint64_t tlu_offset,
-                               uint64_t tlu_size, uint64_t tlu_stride,
-                               uint32_t input_lwe_dim, uint32_t poly_size,
-                               uint32_t level, uint32_t base_log,
-                               uint32_t glwe_dim) {
-  auto tlu = tlu_aligned + tlu_offset;
-
-  // modulus switching
+// Simulates the modulus switching of `plaintext` to `2 * poly_size`
+uint64_t sim_modulus_switch(uint64_t plaintext, uint32_t input_lwe_dim,
+                            uint32_t poly_size) {
   double variance_ms =
       concrete_cpu_estimate_modulus_switching_noise_with_binary_key(
           input_lwe_dim, log2(poly_size), 64);
@@ -78,23 +72,75 @@ uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
   mod_switched >>= 1;
   mod_switched += noise;
   mod_switched %= 2 * poly_size;
+  return mod_switched;
+}
 
-  uint64_t out;
-  // blind rotate & sample extract:
-  // instead of doing a plynomial multiplication, then extracting the first
-  // coeff, we directly extract the appropriate coeff from the tlu.
-  if (mod_switched < poly_size)
-    out = tlu[mod_switched];
+// Returns the coefficient `index` of the negacyclic rotation of `tlu`
+uint64_t sim_negacyclic_coefficient(uint64_t *tlu, uint64_t index,
+                                    uint32_t poly_size) {
+  index %= 2 * poly_size;
+  if (index < poly_size)
+    return tlu[index];
   else
-    out = -tlu[mod_switched % poly_size];
+    return -tlu[index % poly_size];
+}
 
+double sim_blind_rotate_variance(uint32_t input_lwe_dim, uint32_t poly_size,
+                                 uint32_t level, uint32_t base_log,
+                                 uint32_t glwe_dim) {
   double variance_bsk = security_curve()->getVariance(glwe_dim, poly_size, 64);
-  double variance = concrete_cpu_variance_blind_rotate(
+  return concrete_cpu_variance_blind_rotate(
       input_lwe_dim, glwe_dim, poly_size, base_log, level, 64,
       mlir::concretelang::optimizer::DEFAULT_FFT_PRECISION, variance_bsk);
+}
+
+uint64_t sim_bootstrap_lwe_u64(uint64_t plaintext, uint64_t *tlu_allocated,
+                               uint64_t *tlu_aligned, uint64_t tlu_offset,
+                               uint64_t tlu_size, uint64_t tlu_stride,
+                               uint32_t input_lwe_dim, uint32_t poly_size,
+                               uint32_t level, uint32_t base_log,
+                               uint32_t glwe_dim) {
+  auto tlu = tlu_aligned + tlu_offset;
+
+  uint64_t mod_switched =
+      sim_modulus_switch(plaintext, input_lwe_dim, poly_size);
+
+  // blind rotate & sample extract:
+  // instead of doing a plynomial multiplication, then extracting the first
+  // coeff, we directly extract the appropriate coeff from the tlu.
+  uint64_t out = sim_negacyclic_coefficient(tlu, mod_switched, poly_size);
+
+  double variance = sim_blind_rotate_variance(input_lwe_dim, poly_size, level,
+                                              base_log, glwe_dim);
   return out + gaussian_noise(0, variance);
 }
 
+void sim_many_bootstrap_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
+                                uint64_t out_offset, uint64_t out_size,
+                                uint64_t out_stride, uint64_t plaintext,
+                                uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+                                uint64_t tlu_offset, uint64_t tlu_size,
+                                uint64_t tlu_stride, uint32_t input_lwe_dim,
+                                uint32_t poly_size, uint32_t level,
+                                uint32_t base_log, uint32_t glwe_dim,
+                                uint32_t lut_size) {
+  auto tlu = tlu_aligned + tlu_offset;
+  uint64_t slot_size = poly_size / (out_size * lut_size);
+
+  // A single modulus switch is shared by all the extracted samples
+  uint64_t mod_switched =
+      sim_modulus_switch(plaintext, input_lwe_dim, poly_size);
+
+  double variance = sim_blind_rotate_variance(input_lwe_dim, poly_size, level,
+                                              base_log, glwe_dim);
+  for (uint64_t i = 0; i < out_size; i++) {
+    uint64_t out = sim_negacyclic_coefficient(
+        tlu, mod_switched + i * slot_size, poly_size);
+    out_aligned[out_offset + i * out_stride] =
+        out + gaussian_noise(0, variance);
+  }
+}
+
 void sim_wop_pbs_crt(
     // Output 1D memref
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
@@ -193,6 +239,18 @@ void sim_encode_expand_lut_for_boostrap(
       output_bits, is_signed);
 }
 
+void sim_encode_expand_many_luts_for_boostrap(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *in_allocated,
+    uint64_t *in_aligned, uint64_t in_offset, uint64_t in_size0,
+    uint64_t in_size1, uint64_t in_stride0, uint64_t in_stride1,
+    uint32_t poly_size, uint32_t output_bits, bool is_signed) {
+  return memref_encode_expand_many_luts_for_bootstrap(
+      out_allocated, out_aligned, out_offset, out_size, out_stride,
+      in_allocated, in_aligned, in_offset, in_size0, in_size1, in_stride0,
+      in_stride1, poly_size, output_bits, is_signed);
+}
+
 void sim_encode_plaintext_with_crt(uint64_t *output_allocated,
                                    uint64_t *output_aligned,
                                    uint64_t output_offset, uint64_t output_size,
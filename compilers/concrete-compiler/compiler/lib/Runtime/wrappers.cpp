@@ -6,6 +6,8 @@
 #include "concretelang/Runtime/wrappers.h"
 #include "concrete-cpu.h"
 #include "concretelang/Common/Error.h"
+#include "concretelang/Runtime/DFRuntime.hpp"
+#include <algorithm>
 #include <assert.h>
 #include <bitset>
 #include <cmath>
@@ -14,8 +16,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "concretelang/Common/CRT.h"
 #include "concretelang/Runtime/wrappers.h"
 
@@ -418,6 +425,68 @@ void memref_encode_expand_lut_for_bootstrap(
   return;
 }
 
+void memref_encode_expand_many_luts_for_bootstrap(
+    uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
+    uint64_t output_lut_offset, uint64_t output_lut_size,
+    uint64_t output_lut_stride, uint64_t *input_luts_allocated,
+    uint64_t *input_luts_aligned, uint64_t input_luts_offset,
+    uint64_t input_luts_size0, uint64_t input_luts_size1,
+    uint64_t input_luts_stride0, uint64_t input_luts_stride1,
+    uint32_t poly_size, uint32_t out_MESSAGE_BITS, bool is_signed) {
+
+  assert(input_luts_stride1 == 1 && "Runtime: stride not equal to 1, check "
+                                    "memref_encode_expand_many_luts_bootstrap");
+
+  assert(output_lut_stride == 1 && "Runtime: stride not equal to 1, check "
+                                   "memref_encode_expand_many_luts_bootstrap");
+
+  size_t lut_count = input_luts_size0;
+  size_t lut_size = input_luts_size1;
+  size_t mega_case_size = output_lut_size / lut_size;
+  // Each mega case is split in one slot per lut, the i-th lut being read at
+  // the coefficient `i * slot_size` of the rotated accumulator.
+  size_t slot_size = mega_case_size / lut_count;
+
+  assert((slot_size % 2) == 0);
+
+  std::function<size_t(size_t)> indexMap;
+  if (is_signed) {
+    size_t halfInputSize = lut_size / 2;
+    indexMap = [=](size_t idx) {
+      if (idx < halfInputSize) {
+        return idx + halfInputSize;
+      } else {
+        return idx - halfInputSize;
+      }
+    };
+  } else {
+    indexMap = [=](size_t idx) { return idx; };
+  }
+
+  // Each value is centered over its slot. The values that fall before the
+  // beginning of the output lut are wrapped at its end (but negated).
+  for (size_t lut_idx = 0; lut_idx < lut_size; ++lut_idx) {
+    for (size_t lut_num = 0; lut_num < lut_count; ++lut_num) {
+      uint64_t lut_value =
+          input_luts_aligned[input_luts_offset + lut_num * input_luts_stride0 +
+                             indexMap(lut_idx)]
+          << (64 - out_MESSAGE_BITS - 1);
+      int64_t center = lut_idx * mega_case_size + lut_num * slot_size;
+      for (int64_t idx = center - (int64_t)slot_size / 2;
+           idx < center + (int64_t)slot_size / 2; ++idx) {
+        if (idx < 0) {
+          output_lut_aligned[output_lut_offset + output_lut_size + idx] =
+              -lut_value;
+        } else {
+          output_lut_aligned[output_lut_offset + idx] = lut_value;
+        }
+      }
+    }
+  }
+
+  return;
+}
+
 void memref_encode_lut_for_crt_woppbs(
     // Output encoded/expanded lut
     uint64_t *output_lut_allocated, uint64_t *output_lut_aligned,
@@ -615,6 +684,24 @@ void memref_keyswitch_lwe_u64(uint64_t *out_allocated, uint64_t *out_aligned,
       output_dimension);
 }
 
+void memref_keyswitch_lwe_u64_to_u32(
+    uint32_t *out_allocated, uint32_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint64_t *ct0_allocated,
+    uint64_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint32_t decomposition_level_count,
+    uint32_t decomposition_base_log, uint32_t input_dimension,
+    uint32_t output_dimension, uint32_t ksk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(out_stride == 1 && ct0_stride == 1);
+  // Get keyswitch key
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  // The result is rounded to the 32 bits ciphertext modulus of the small key
+  concrete_cpu_keyswitch_lwe_ciphertext_u64_to_u32(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, keyswitch_key,
+      decomposition_level_count, decomposition_base_log, input_dimension,
+      output_dimension);
+}
+
 void memref_batched_add_lwe_ciphertexts_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
@@ -719,13 +806,48 @@ void memref_batched_keyswitch_lwe_u64(
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
     uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
     uint32_t ksk_index, mlir::concretelang::RuntimeContext *context) {
-  for (size_t i = 0; i < ct0_size0; i++) {
-    memref_keyswitch_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated + i * ct0_size1,
-        ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1, ct0_stride1, level,
-        base_log, input_lwe_dim, output_lwe_dim, ksk_index, context);
-  }
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  assert(out_stride0 == out_size1 && ct0_stride0 == ct0_size1);
+  // Get keyswitch key
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  // The whole batch is switched at once, such that the keyswitch key is
+  // streamed once per block of ciphertexts instead of once per ciphertext
+  concrete_cpu_batched_keyswitch_lwe_ciphertext_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, keyswitch_key, level,
+      base_log, input_lwe_dim, output_lwe_dim, ct0_size0);
+}
+
+void memref_batched_keyswitch_lwe_u64_to_u32(
+    uint32_t *out_allocated, uint32_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint32_t level,
+    uint32_t base_log, uint32_t input_lwe_dim, uint32_t output_lwe_dim,
+    uint32_t ksk_index, mlir::concretelang::RuntimeContext *context) {
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  assert(out_stride0 == out_size1 && ct0_stride0 == ct0_size1);
+  // Get keyswitch key
+  const uint64_t *keyswitch_key = context->keyswitch_key_buffer(ksk_index);
+  concrete_cpu_batched_keyswitch_lwe_ciphertext_u64_to_u32(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, keyswitch_key, level,
+      base_log, input_lwe_dim, output_lwe_dim, ct0_size0);
+}
+
+/// Returns the number of threads computing a multi-bit bootstrap, bounded by
+/// those of the OpenMP runtime. The bootstraps called from a parallel loop or
+/// a dataflow task run on a single thread, as the cores are already busy.
+static size_t multi_bit_thread_count() {
+  if (mlir::concretelang::dfr::_dfr_is_worker_thread())
+    return 1;
+  size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+#ifdef _OPENMP
+  if (omp_in_parallel())
+    return 1;
+  thread_count =
+      std::min<size_t>(thread_count, std::max(1, omp_get_max_threads()));
+#endif
+  return thread_count;
 }
 
 void memref_bootstrap_lwe_u64(
@@ -754,6 +876,20 @@ void memref_bootstrap_lwe_u64(
   // Get fourrier bootstrap key
   const auto &fft = context->fft(bsk_index);
   auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+
+  // Multi-bit bootstrap, the groups of the key are blind rotated by several
+  // threads
+  if (auto grouping_factor = context->grouping_factor(bsk_index);
+      grouping_factor > 1) {
+    concrete_cpu_multi_bit_bootstrap_lwe_ciphertext_u64(
+        out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
+        bootstrap_key, decomposition_level_count, decomposition_base_log,
+        glwe_dimension, polynomial_size, input_lwe_dimension, grouping_factor,
+        multi_bit_thread_count());
+    free(glwe_ct);
+    return;
+  }
+
   // Get stack parameter
   size_t scratch_size;
   size_t scratch_align;
@@ -773,10 +909,182 @@ void memref_bootstrap_lwe_u64(
   free(scratch);
 }
 
-void memref_batched_bootstrap_lwe_u64(
+void memref_bootstrap_lwe_u32_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size, uint64_t out_stride, uint32_t *ct0_allocated,
+    uint32_t *ct0_aligned, uint64_t ct0_offset, uint64_t ct0_size,
+    uint64_t ct0_stride, uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+    uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+    uint32_t input_lwe_dimension, uint32_t polynomial_size,
+    uint32_t decomposition_level_count, uint32_t decomposition_base_log,
+    uint32_t glwe_dimension, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  assert(ct0_stride == 1);
+
+  // The multi-bit bootstrap has no 32 bits variant, the input is lifted to
+  // the native modulus instead
+  if (context->grouping_factor(bsk_index) > 1) {
+    uint64_t *lifted = (uint64_t *)malloc(ct0_size * sizeof(uint64_t));
+    for (size_t i = 0; i < ct0_size; i++) {
+      lifted[i] = (uint64_t)ct0_aligned[ct0_offset + i] << 32;
+    }
+    memref_bootstrap_lwe_u64(out_allocated, out_aligned, out_offset, out_size,
+                             out_stride, lifted, lifted, 0, ct0_size, 1,
+                             tlu_allocated, tlu_aligned, tlu_offset, tlu_size,
+                             tlu_stride, input_lwe_dimension, polynomial_size,
+                             decomposition_level_count,
+                             decomposition_base_log, glwe_dimension,
+                             bsk_index, context);
+    free(lifted);
+    return;
+  }
+
+  uint64_t glwe_ct_size = polynomial_size * (glwe_dimension + 1);
+  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
+  auto tlu = tlu_aligned + tlu_offset;
+
+  // Glwe trivial encryption
+  for (size_t i = 0; i < polynomial_size * glwe_dimension; i++) {
+    glwe_ct[i] = 0;
+  }
+  for (size_t i = 0; i < polynomial_size; i++) {
+    glwe_ct[polynomial_size * glwe_dimension + i] = tlu[i];
+  }
+
+  // Get fourrier bootstrap key
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+
+  // Get stack parameter
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratch_size, &scratch_align, glwe_dimension, polynomial_size, 1, fft);
+  // Allocate scratch
+  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+  // Bootstrap
+  concrete_cpu_bootstrap_lwe_ciphertext_u32_to_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset, glwe_ct,
+      bootstrap_key, decomposition_level_count, decomposition_base_log,
+      glwe_dimension, polynomial_size, input_lwe_dimension, fft, scratch,
+      scratch_size);
+
+  free(glwe_ct);
+  free(scratch);
+}
+
+void memref_many_bootstrap_lwe_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
     uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+    uint64_t *tlu_allocated, uint64_t *tlu_aligned, uint64_t tlu_offset,
+    uint64_t tlu_size, uint64_t tlu_stride, uint32_t input_lwe_dimension,
+    uint32_t polynomial_size, uint32_t decomposition_level_count,
+    uint32_t decomposition_base_log, uint32_t glwe_dimension,
+    uint32_t lut_size, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+
+  assert(out_stride1 == 1 && out_stride0 == out_size1 &&
+         "Runtime: output is not contiguous, check "
+         "memref_many_bootstrap_lwe_u64");
+  assert(context->grouping_factor(bsk_index) == 1 &&
+         "Runtime: many-lut bootstrap of a multi-bit bootstrap key, check "
+         "memref_many_bootstrap_lwe_u64");
+
+  // Get fourrier bootstrap key
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  // Get stack parameter
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_many_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratch_size, &scratch_align, glwe_dimension, polynomial_size, fft);
+  // Allocate scratch
+  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+  // Bootstrap once, extracting one ciphertext per lut of the accumulator
+  concrete_cpu_many_bootstrap_lwe_ciphertext_u64(
+      out_aligned + out_offset, ct0_aligned + ct0_offset,
+      tlu_aligned + tlu_offset, out_size0, lut_size, bootstrap_key,
+      decomposition_level_count, decomposition_base_log, glwe_dimension,
+      polynomial_size, input_lwe_dimension, fft, scratch, scratch_size);
+
+  free(scratch);
+}
+
+namespace {
+
+/// Bootstraps a single ciphertext of the native modulus.
+void bootstrap_lwe(uint64_t *out_allocated, uint64_t *out_aligned,
+                   uint64_t out_offset, uint64_t out_size, uint64_t out_stride,
+                   uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+                   uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+                   uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+                   uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+                   uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+                   uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+                   mlir::concretelang::RuntimeContext *context) {
+  memref_bootstrap_lwe_u64(out_allocated, out_aligned, out_offset, out_size,
+                           out_stride, ct0_allocated, ct0_aligned, ct0_offset,
+                           ct0_size, ct0_stride, tlu_allocated, tlu_aligned,
+                           tlu_offset, tlu_size, tlu_stride, input_lwe_dim,
+                           poly_size, level, base_log, glwe_dim, bsk_index,
+                           context);
+}
+
+/// Bootstraps a single ciphertext of a 32 bits modulus.
+void bootstrap_lwe(uint64_t *out_allocated, uint64_t *out_aligned,
+                   uint64_t out_offset, uint64_t out_size, uint64_t out_stride,
+                   uint32_t *ct0_allocated, uint32_t *ct0_aligned,
+                   uint64_t ct0_offset, uint64_t ct0_size, uint64_t ct0_stride,
+                   uint64_t *tlu_allocated, uint64_t *tlu_aligned,
+                   uint64_t tlu_offset, uint64_t tlu_size, uint64_t tlu_stride,
+                   uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+                   uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+                   mlir::concretelang::RuntimeContext *context) {
+  memref_bootstrap_lwe_u32_to_u64(
+      out_allocated, out_aligned, out_offset, out_size, out_stride,
+      ct0_allocated, ct0_aligned, ct0_offset, ct0_size, ct0_stride,
+      tlu_allocated, tlu_aligned, tlu_offset, tlu_size, tlu_stride,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index, context);
+}
+
+/// Bootstraps a batch of ciphertexts of the native modulus, the ciphertexts
+/// being blind rotated in lock-step such that each GGSW of the key is loaded
+/// once per block.
+void batched_bootstrap_lwe(uint64_t *ct_out, const uint64_t *ct_in,
+                           const uint64_t *accumulator, const c64 *fourier_bsk,
+                           size_t level, size_t base_log, size_t glwe_dim,
+                           size_t poly_size, size_t input_lwe_dim,
+                           size_t ct_count, const Fft *fft, uint8_t *stack,
+                           size_t stack_size) {
+  concrete_cpu_batched_bootstrap_lwe_ciphertext_u64(
+      ct_out, ct_in, accumulator, fourier_bsk, level, base_log, glwe_dim,
+      poly_size, input_lwe_dim, ct_count, fft, stack, stack_size);
+}
+
+/// Bootstraps a batch of ciphertexts of a 32 bits modulus, which are lifted
+/// to the native modulus as they are read.
+void batched_bootstrap_lwe(uint64_t *ct_out, const uint32_t *ct_in,
+                           const uint64_t *accumulator, const c64 *fourier_bsk,
+                           size_t level, size_t base_log, size_t glwe_dim,
+                           size_t poly_size, size_t input_lwe_dim,
+                           size_t ct_count, const Fft *fft, uint8_t *stack,
+                           size_t stack_size) {
+  concrete_cpu_batched_bootstrap_lwe_ciphertext_u32_to_u64(
+      ct_out, ct_in, accumulator, fourier_bsk, level, base_log, glwe_dim,
+      poly_size, input_lwe_dim, ct_count, fft, stack, stack_size);
+}
+
+/// Bootstraps the batch of input ciphertexts of scalar type `InputT` with the
+/// same lookup table, to ciphertexts of the native modulus.
+template <typename InputT>
+void batched_bootstrap_lwe_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, InputT *ct0_allocated, InputT *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
     uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
@@ -784,20 +1092,63 @@ void memref_batched_bootstrap_lwe_u64(
     uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
     mlir::concretelang::RuntimeContext *context) {
 
-  for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated, tlu_aligned,
-        tlu_offset, tlu_size, tlu_stride, input_lwe_dim, poly_size, level,
-        base_log, glwe_dim, bsk_index, context);
+  // Multi-bit bootstraps are parallelized within each bootstrap
+  if (context->grouping_factor(bsk_index) > 1) {
+    for (size_t i = 0; i < out_size0; i++) {
+      bootstrap_lwe(out_allocated + i * out_size1, out_aligned + i * out_size1,
+                    out_offset, out_size1, out_stride1, ct0_allocated,
+                    ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1,
+                    ct0_stride1, tlu_allocated, tlu_aligned, tlu_offset,
+                    tlu_size, tlu_stride, input_lwe_dim, poly_size, level,
+                    base_log, glwe_dim, bsk_index, context);
+    }
+    return;
   }
+
+  assert(out_stride1 == 1 && ct0_stride1 == 1);
+  assert(out_stride0 == out_size1 && ct0_stride0 == ct0_size1);
+
+  uint64_t glwe_ct_size = poly_size * (glwe_dim + 1);
+  uint64_t *glwe_ct = (uint64_t *)malloc(glwe_ct_size * sizeof(uint64_t));
+  auto tlu = tlu_aligned + tlu_offset;
+
+  // Glwe trivial encryption
+  for (size_t i = 0; i < poly_size * glwe_dim; i++) {
+    glwe_ct[i] = 0;
+  }
+  for (size_t i = 0; i < poly_size; i++) {
+    glwe_ct[poly_size * glwe_dim + i] = tlu[i];
+  }
+
+  // Get fourrier bootstrap key
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+
+  // Get stack parameter
+  size_t scratch_size;
+  size_t scratch_align;
+  concrete_cpu_batched_bootstrap_lwe_ciphertext_u64_scratch(
+      &scratch_size, &scratch_align, glwe_dim, poly_size, out_size0, fft);
+  // Allocate scratch
+  auto scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+  // Bootstrap the whole batch
+  batched_bootstrap_lwe(out_aligned + out_offset, ct0_aligned + ct0_offset,
+                        glwe_ct, bootstrap_key, level, base_log, glwe_dim,
+                        poly_size, input_lwe_dim, out_size0, fft, scratch,
+                        scratch_size);
+
+  free(glwe_ct);
+  free(scratch);
 }
 
-void memref_batched_mapped_bootstrap_lwe_u64(
+/// Bootstraps each input ciphertext of scalar type `InputT` with its own
+/// lookup table, to ciphertexts of the native modulus.
+template <typename InputT>
+void batched_mapped_bootstrap_lwe_to_u64(
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
     uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
-    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t out_stride1, InputT *ct0_allocated, InputT *ct0_aligned,
     uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
     uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
     uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size0,
@@ -807,20 +1158,248 @@ void memref_batched_mapped_bootstrap_lwe_u64(
     mlir::concretelang::RuntimeContext *context) {
   assert(out_size0 == tlu_size0 && "Number of LUTs does not match batch size");
   for (size_t i = 0; i < out_size0; i++) {
-    memref_bootstrap_lwe_u64(
-        out_allocated + i * out_size1, out_aligned + i * out_size1, out_offset,
-        out_size1, out_stride1, ct0_allocated, ct0_aligned + i * ct0_size1,
-        ct0_offset, ct0_size1, ct0_stride1, tlu_allocated,
-        tlu_aligned + i * tlu_size1, tlu_offset, tlu_size1, tlu_stride1,
-        input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index,
-        context);
+    bootstrap_lwe(out_allocated + i * out_size1, out_aligned + i * out_size1,
+                  out_offset, out_size1, out_stride1, ct0_allocated,
+                  ct0_aligned + i * ct0_size1, ct0_offset, ct0_size1,
+                  ct0_stride1, tlu_allocated, tlu_aligned + i * tlu_size1,
+                  tlu_offset, tlu_size1, tlu_stride1, input_lwe_dim, poly_size,
+                  level, base_log, glwe_dim, bsk_index, context);
   }
 }
 
+} // namespace
+
+void memref_batched_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  batched_bootstrap_lwe_to_u64(
+      out_allocated, out_aligned, out_offset, out_size0, out_size1,
+      out_stride0, out_stride1, ct0_allocated, ct0_aligned, ct0_offset,
+      ct0_size0, ct0_size1, ct0_stride0, ct0_stride1, tlu_allocated,
+      tlu_aligned, tlu_offset, tlu_size, tlu_stride, input_lwe_dim, poly_size,
+      level, base_log, glwe_dim, bsk_index, context);
+}
+
+void memref_batched_mapped_bootstrap_lwe_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint64_t *ct0_allocated, uint64_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size0,
+    uint64_t tlu_size1, uint64_t tlu_stride0, uint64_t tlu_stride1,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  batched_mapped_bootstrap_lwe_to_u64(
+      out_allocated, out_aligned, out_offset, out_size0, out_size1,
+      out_stride0, out_stride1, ct0_allocated, ct0_aligned, ct0_offset,
+      ct0_size0, ct0_size1, ct0_stride0, ct0_stride1, tlu_allocated,
+      tlu_aligned, tlu_offset, tlu_size0, tlu_size1, tlu_stride0, tlu_stride1,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index, context);
+}
+
+void memref_batched_bootstrap_lwe_u32_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint32_t *ct0_allocated, uint32_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size,
+    uint64_t tlu_stride, uint32_t input_lwe_dim, uint32_t poly_size,
+    uint32_t level, uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  batched_bootstrap_lwe_to_u64(
+      out_allocated, out_aligned, out_offset, out_size0, out_size1,
+      out_stride0, out_stride1, ct0_allocated, ct0_aligned, ct0_offset,
+      ct0_size0, ct0_size1, ct0_stride0, ct0_stride1, tlu_allocated,
+      tlu_aligned, tlu_offset, tlu_size, tlu_stride, input_lwe_dim, poly_size,
+      level, base_log, glwe_dim, bsk_index, context);
+}
+
+void memref_batched_mapped_bootstrap_lwe_u32_to_u64(
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size0, uint64_t out_size1, uint64_t out_stride0,
+    uint64_t out_stride1, uint32_t *ct0_allocated, uint32_t *ct0_aligned,
+    uint64_t ct0_offset, uint64_t ct0_size0, uint64_t ct0_size1,
+    uint64_t ct0_stride0, uint64_t ct0_stride1, uint64_t *tlu_allocated,
+    uint64_t *tlu_aligned, uint64_t tlu_offset, uint64_t tlu_size0,
+    uint64_t tlu_size1, uint64_t tlu_stride0, uint64_t tlu_stride1,
+    uint32_t input_lwe_dim, uint32_t poly_size, uint32_t level,
+    uint32_t base_log, uint32_t glwe_dim, uint32_t bsk_index,
+    mlir::concretelang::RuntimeContext *context) {
+  batched_mapped_bootstrap_lwe_to_u64(
+      out_allocated, out_aligned, out_offset, out_size0, out_size1,
+      out_stride0, out_stride1, ct0_allocated, ct0_aligned, ct0_offset,
+      ct0_size0, ct0_size1, ct0_stride0, ct0_stride1, tlu_allocated,
+      tlu_aligned, tlu_offset, tlu_size0, tlu_size1, tlu_stride0, tlu_stride1,
+      input_lwe_dim, poly_size, level, base_log, glwe_dim, bsk_index, context);
+}
+
 uint64_t encode_crt(int64_t plaintext, uint64_t modulus, uint64_t product) {
   return concretelang::crt::encode(plaintext, modulus, product);
 }
 
+namespace {
+
+/// Calls `work(begin, end)` on the ranges of a partition of `[0, count)`,
+/// each range being processed by an OpenMP thread when `parallel` is set.
+/// Buffers allocated by `work` are thus shared by all the items of a range.
+/// The threads are those of the OpenMP runtime, which is bounded by
+/// `OMP_NUM_THREADS` and accounted for by the dataflow runtime, and the calls
+/// from a parallel loop stay sequential as nested parallelism is disabled.
+void parallel_for_ranges(size_t count, bool parallel,
+                         const std::function<void(size_t, size_t)> &work) {
+  size_t thread_count = 1;
+#ifdef _OPENMP
+  if (parallel && !omp_in_parallel())
+    thread_count = std::min<size_t>(std::max(1, omp_get_max_threads()), count);
+#endif
+  if (thread_count <= 1) {
+    work(0, count);
+    return;
+  }
+  size_t range_size = (count + thread_count - 1) / thread_count;
+  size_t range_count = (count + range_size - 1) / range_size;
+#pragma omp parallel for num_threads(thread_count) schedule(static, 1)
+  for (size_t range = 0; range < range_count; range++) {
+    work(range * range_size, std::min(count, (range + 1) * range_size));
+  }
+}
+
+/// Evaluates the wop-pbs on `ct_count` ciphertexts, each made of
+/// `crt_decomp_size` contiguous LWE blocks of `lwe_big_size` elements, with the
+/// same encoded lookup tables `luts`. The bits of all the blocks of all the
+/// ciphertexts are extracted in parallel, then the vertical packing of each
+/// ciphertext is computed in parallel, each thread reusing its own scratch.
+void wop_pbs_crt(uint64_t *out, const uint64_t *in, const uint64_t *luts,
+                 size_t lut_count, size_t lut_size, size_t ct_count,
+                 const uint64_t *crt_decomp, size_t crt_decomp_size,
+                 uint64_t lwe_big_size, uint32_t lwe_small_dim,
+                 uint32_t cbs_level_count, uint32_t cbs_base_log,
+                 uint32_t ksk_level_count, uint32_t ksk_base_log,
+                 uint32_t bsk_level_count, uint32_t bsk_base_log,
+                 uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+                 uint32_t polynomial_size, uint32_t ksk_index,
+                 uint32_t bsk_index, uint32_t pksk_index,
+                 mlir::concretelang::RuntimeContext *context, bool parallel) {
+  uint64_t lwe_small_size = lwe_small_dim + 1;
+  uint64_t lwe_big_dim = lwe_big_size - 1;
+  assert(lwe_big_dim % polynomial_size == 0);
+  uint64_t glwe_dim = lwe_big_dim / polynomial_size;
+
+  // Compute the numbers of bits to extract for each block and the total one.
+  // The extracted bits should be in the following order:
+  //
+  // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
+  // is the size of the crt decomposition
+  std::vector<uint64_t> number_of_bits_per_block(crt_decomp_size);
+  std::vector<uint64_t> extract_bits_offset_per_block(crt_decomp_size);
+  uint64_t total_number_of_bits_per_block = 0;
+  for (int64_t i = crt_decomp_size - 1; i >= 0; i--) {
+    uint64_t modulus = crt_decomp[i];
+    uint64_t nb_bit_to_extract =
+        static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
+    number_of_bits_per_block[i] = nb_bit_to_extract;
+    extract_bits_offset_per_block[i] = total_number_of_bits_per_block;
+
+    total_number_of_bits_per_block += nb_bit_to_extract;
+  }
+
+  size_t ct_in_count = total_number_of_bits_per_block;
+  size_t ct_out_count = crt_decomp_size;
+
+  assert(lut_count == ct_out_count);
+  assert(lut_size == size_t(1) << ct_in_count);
+
+  // Create the buffer of ciphertexts for storing the extracted bits of each
+  // ciphertext
+  std::vector<uint64_t> extract_bits_output_buffer(ct_count * ct_in_count *
+                                                   lwe_small_size);
+
+  const auto &fft = context->fft(bsk_index);
+  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
+  auto keyswicth_key = context->keyswitch_key_buffer(ksk_index);
+  auto fp_keyswicth_key = context->fp_keyswitch_key_buffer(pksk_index);
+
+  // Extraction of each bit for each block of each ciphertext
+  parallel_for_ranges(
+      ct_count * crt_decomp_size, parallel, [&](size_t begin, size_t end) {
+        size_t scratch_size;
+        size_t scratch_align;
+        concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(
+            &scratch_size, &scratch_align, lwe_small_dim, lwe_big_dim,
+            glwe_dim, polynomial_size, fft);
+        auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+        // We make a private copy to apply a subtraction on the body
+        std::vector<uint64_t> in_block(lwe_big_size);
+
+        for (size_t block = begin; block < end; block++) {
+          size_t ct = block / crt_decomp_size;
+          size_t i = block % crt_decomp_size;
+          auto nb_bits_to_extract = number_of_bits_per_block[i];
+
+          size_t delta_log = 64 - nb_bits_to_extract;
+
+          std::copy(in + lwe_big_size * block,
+                    in + lwe_big_size * (block + 1), in_block.begin());
+
+          // trick ( ct - delta/2 + delta/2^4  )
+          uint64_t sub =
+              (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
+              (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
+          in_block[lwe_big_size - 1] -= sub;
+
+          concrete_cpu_extract_bit_lwe_ciphertext_u64(
+              &extract_bits_output_buffer[lwe_small_size *
+                                          (ct * ct_in_count +
+                                           extract_bits_offset_per_block[i])],
+              in_block.data(), bootstrap_key, keyswicth_key, lwe_small_dim,
+              nb_bits_to_extract, lwe_big_dim, nb_bits_to_extract, delta_log,
+              bsk_level_count, bsk_base_log, glwe_dim, polynomial_size,
+              lwe_small_dim, ksk_level_count, ksk_base_log, lwe_big_dim,
+              lwe_small_dim, fft, scratch, scratch_size);
+        }
+
+        free(scratch);
+      });
+
+  // Vertical packing of each ciphertext
+  parallel_for_ranges(ct_count, parallel, [&](size_t begin, size_t end) {
+    size_t scratch_size;
+    size_t scratch_align;
+    concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64_scratch(
+        &scratch_size, &scratch_align, ct_out_count, lwe_small_dim,
+        ct_in_count, lut_size, lut_count, glwe_dim, polynomial_size,
+        polynomial_size, cbs_level_count, fft);
+    auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
+
+    for (size_t ct = begin; ct < end; ct++) {
+      concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
+          out + ct * ct_out_count * lwe_big_size,
+          &extract_bits_output_buffer[ct * ct_in_count * lwe_small_size], luts,
+          bootstrap_key, fp_keyswicth_key, lwe_big_dim, ct_out_count,
+          lwe_small_dim, ct_in_count, lut_size, lut_count, bsk_level_count,
+          bsk_base_log, glwe_dim, polynomial_size, lwe_small_dim,
+          fpksk_level_count, fpksk_base_log, lwe_big_dim, glwe_dim,
+          polynomial_size, glwe_dim + 1, cbs_level_count, cbs_base_log, fft,
+          scratch, scratch_size);
+    }
+
+    free(scratch);
+  });
+}
+
+} // namespace
+
 void memref_wop_pbs_crt_buffer(
     // Output 2D memref
     uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
@@ -859,110 +1438,65 @@ void memref_wop_pbs_crt_buffer(
   // Check for the size S
   assert(out_size_1 == in_size_1);
 
-  uint64_t lwe_small_size = lwe_small_dim + 1;
-
-  assert(out_size_1 == in_size_1);
-  uint64_t lwe_big_size = in_size_1;
-  uint64_t lwe_big_dim = lwe_big_size - 1;
-  assert(lwe_big_dim % polynomial_size == 0);
-
-  assert(lwe_big_dim % polynomial_size == 0);
-  uint64_t glwe_dim = lwe_big_dim / polynomial_size;
-
-  // Compute the numbers of bits to extract for each block and the total one.
-  uint64_t total_number_of_bits_per_block = 0;
-  auto number_of_bits_per_block = new uint64_t[crt_decomp_size]();
-  for (uint64_t i = 0; i < crt_decomp_size; i++) {
-    uint64_t modulus = crt_decomp_aligned[i + crt_decomp_offset];
-    uint64_t nb_bit_to_extract =
-        static_cast<uint64_t>(ceil(log2(static_cast<double>(modulus))));
-    number_of_bits_per_block[i] = nb_bit_to_extract;
-
-    total_number_of_bits_per_block += nb_bit_to_extract;
-  }
-
-  // Create the buffer of ciphertexts for storing the total number of bits to
-  // extract.
-  // The extracted bit should be in the following order:
-  //
-  // [msb(m%crt[n-1])..lsb(m%crt[n-1])...msb(m%crt[0])..lsb(m%crt[0])] where n
-  // is the size of the crt decomposition
-  auto extract_bits_output_buffer =
-      new uint64_t[lwe_small_size * total_number_of_bits_per_block]{0};
-
-  // We make a private copy to apply a subtraction on the body
-  auto first_ciphertext = in_aligned + in_offset;
-  auto copy_size = crt_decomp_size * lwe_big_size;
-  std::vector<uint64_t> in_copy(first_ciphertext, first_ciphertext + copy_size);
-  // Extraction of each bit for each block
-
-  const auto &fft = context->fft(bsk_index);
-  auto bootstrap_key = context->fourier_bootstrap_key_buffer(bsk_index);
-  auto keyswicth_key = context->keyswitch_key_buffer(ksk_index);
-
-  for (int64_t i = crt_decomp_size - 1, extract_bits_output_offset = 0; i >= 0;
-       extract_bits_output_offset += number_of_bits_per_block[i--]) {
-    auto nb_bits_to_extract = number_of_bits_per_block[i];
-
-    size_t delta_log = 64 - nb_bits_to_extract;
-
-    auto in_block = &in_copy[lwe_big_size * i];
-
-    // trick ( ct - delta/2 + delta/2^4  )
-    uint64_t sub = (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 1)) -
-                   (uint64_t(1) << (uint64_t(64) - nb_bits_to_extract - 5));
-    in_block[lwe_big_size - 1] -= sub;
-
-    size_t scratch_size;
-    size_t scratch_align;
-    concrete_cpu_extract_bit_lwe_ciphertext_u64_scratch(
-        &scratch_size, &scratch_align, lwe_small_dim, lwe_big_dim, glwe_dim,
-        polynomial_size, fft);
-    // Allocate scratch
-    auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-    concrete_cpu_extract_bit_lwe_ciphertext_u64(
-        &extract_bits_output_buffer[lwe_small_size *
-                                    extract_bits_output_offset],
-        in_block, bootstrap_key, keyswicth_key, lwe_small_dim,
-        nb_bits_to_extract, lwe_big_dim, nb_bits_to_extract, delta_log,
-        bsk_level_count, bsk_base_log, glwe_dim, polynomial_size, lwe_small_dim,
-        ksk_level_count, ksk_base_log, lwe_big_dim, lwe_small_dim, fft, scratch,
-        scratch_size);
-
-    free(scratch);
-  }
-
-  size_t ct_in_count = total_number_of_bits_per_block;
-  size_t lut_size = 1 << ct_in_count;
-  size_t ct_out_count = out_size_0;
-  size_t lut_count = ct_out_count;
-
-  assert(lut_ct_size0 == lut_count);
-  assert(lut_ct_size1 == lut_size);
-
-  // Vertical packing
-  size_t scratch_size;
-  size_t scratch_align;
-  concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64_scratch(
-      &scratch_size, &scratch_align, ct_out_count, lwe_small_dim, ct_in_count,
-      lut_size, lut_count, glwe_dim, polynomial_size, polynomial_size,
-      cbs_level_count, fft);
-
-  auto *scratch = (uint8_t *)aligned_alloc(scratch_align, scratch_size);
-
-  auto fp_keyswicth_key = context->fp_keyswitch_key_buffer(pksk_index);
+  // A single wop-pbs may already run in parallel loops, so it is kept
+  // sequential
+  wop_pbs_crt(out_aligned + out_offset, in_aligned + in_offset,
+              lut_ct_aligned + lut_ct_offset, lut_ct_size0, lut_ct_size1, 1,
+              crt_decomp_aligned + crt_decomp_offset, crt_decomp_size,
+              in_size_1, lwe_small_dim, cbs_level_count, cbs_base_log,
+              ksk_level_count, ksk_base_log, bsk_level_count, bsk_base_log,
+              fpksk_level_count, fpksk_base_log, polynomial_size, ksk_index,
+              bsk_index, pksk_index, context, false);
+}
 
-  concrete_cpu_circuit_bootstrap_boolean_vertical_packing_lwe_ciphertext_u64(
-      out_aligned + out_offset, extract_bits_output_buffer,
-      lut_ct_aligned + lut_ct_offset, bootstrap_key, fp_keyswicth_key,
-      lwe_big_dim, ct_out_count, lwe_small_dim, ct_in_count, lut_size,
-      lut_count, bsk_level_count, bsk_base_log, glwe_dim, polynomial_size,
-      lwe_small_dim, fpksk_level_count, fpksk_base_log, lwe_big_dim, glwe_dim,
-      polynomial_size, glwe_dim + 1, cbs_level_count, cbs_base_log, fft,
-      scratch, scratch_size);
+void memref_batched_wop_pbs_crt_buffer(
+    // Output 3D memref
+    uint64_t *out_allocated, uint64_t *out_aligned, uint64_t out_offset,
+    uint64_t out_size_0, uint64_t out_size_1, uint64_t out_size_2,
+    uint64_t out_stride_0, uint64_t out_stride_1, uint64_t out_stride_2,
+    // Input 3D memref
+    uint64_t *in_allocated, uint64_t *in_aligned, uint64_t in_offset,
+    uint64_t in_size_0, uint64_t in_size_1, uint64_t in_size_2,
+    uint64_t in_stride_0, uint64_t in_stride_1, uint64_t in_stride_2,
+    // clear text lut 2D memref
+    uint64_t *lut_ct_allocated, uint64_t *lut_ct_aligned,
+    uint64_t lut_ct_offset, uint64_t lut_ct_size0, uint64_t lut_ct_size1,
+    uint64_t lut_ct_stride0, uint64_t lut_ct_stride1,
+    // CRT decomposition 1D memref
+    uint64_t *crt_decomp_allocated, uint64_t *crt_decomp_aligned,
+    uint64_t crt_decomp_offset, uint64_t crt_decomp_size,
+    uint64_t crt_decomp_stride,
+    // Additional crypto parameters
+    uint32_t lwe_small_dim, uint32_t cbs_level_count, uint32_t cbs_base_log,
+    uint32_t ksk_level_count, uint32_t ksk_base_log, uint32_t bsk_level_count,
+    uint32_t bsk_base_log, uint32_t fpksk_level_count, uint32_t fpksk_base_log,
+    uint32_t polynomial_size,
+    // Key Indices,
+    uint32_t ksk_index, uint32_t bsk_index, uint32_t pksk_index,
+    // runtime context that hold evluation keys
+    mlir::concretelang::RuntimeContext *context) {
 
-  free(scratch);
+  // The compiler should only generates contiguous 3D memref<NxBxS>, where N is
+  // the number of ciphertexts, B the number of ciphertext block and S the
+  // lweSize.
+  assert(out_stride_2 == 1 && out_stride_1 == out_size_2 &&
+         out_stride_0 == out_size_1 * out_size_2);
+  assert(in_stride_2 == 1 && in_stride_1 == in_size_2 &&
+         in_stride_0 == in_size_1 * in_size_2);
+  // Check for the size N
+  assert(out_size_0 == in_size_0);
+  // Check for the size B
+  assert(out_size_1 == in_size_1 && out_size_1 == crt_decomp_size);
+  // Check for the size S
+  assert(out_size_2 == in_size_2);
+
+  wop_pbs_crt(out_aligned + out_offset, in_aligned + in_offset,
+              lut_ct_aligned + lut_ct_offset, lut_ct_size0, lut_ct_size1,
+              in_size_0, crt_decomp_aligned + crt_decomp_offset,
+              crt_decomp_size, in_size_2, lwe_small_dim, cbs_level_count,
+              cbs_base_log, ksk_level_count, ksk_base_log, bsk_level_count,
+              bsk_base_log, fpksk_level_count, fpksk_base_log, polynomial_size,
+              ksk_index, bsk_index, pksk_index, context, true);
 }
 
 void memref_copy_one_rank(uint64_t *src_allocated, uint64_t *src_aligned,
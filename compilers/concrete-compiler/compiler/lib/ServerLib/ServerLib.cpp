@@ -19,6 +19,9 @@
 #include "concretelang/ServerLib/ServerLib.h"
 #include "concretelang/Support/CompilerEngine.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 
 using concretelang::keysets::ServerKeyset;
 using concretelang::transformers::ArgTransformer;
@@ -420,6 +423,15 @@ bool getGateIsSigned(const Message<concreteprotocol::GateInfo> &gateInfo) {
 Result<std::vector<TransportValue>>
 ServerCircuit::call(const ServerKeyset &serverKeyset,
                     std::vector<TransportValue> &args) {
+  // We create a runtime context from the keyset, which prepares the
+  // evaluation keys for this call only.
+  RuntimeContext runtimeContext = RuntimeContext(serverKeyset);
+  return call(runtimeContext, args);
+}
+
+Result<std::vector<TransportValue>>
+ServerCircuit::call(RuntimeContext &runtimeContext,
+                    std::vector<TransportValue> &args) {
   if (args.size() != argsBuffer.size()) {
     return StringError("Called circuit with wrong number of arguments");
   }
@@ -431,7 +443,7 @@ ServerCircuit::call(const ServerKeyset &serverKeyset,
 
   // The arguments has been pushed in the arg buffer, we are now ready to
   // invoke the circuit function.
-  invoke(serverKeyset);
+  invoke(runtimeContext);
 
   // We process the return values to turn them into transport values.
   std::vector<TransportValue> returns(returnsBuffer.size());
@@ -532,11 +544,9 @@ Result<ServerCircuit> ServerCircuit::fromDynamicModule(
   return output;
 }
 
-void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
+void ServerCircuit::invoke(RuntimeContext &runtimeContext) {
 
-  // We create a runtime context from the keyset, and place a pointer to it in
-  // the structure.
-  RuntimeContext runtimeContext = RuntimeContext(serverKeyset);
+  // We place a pointer to the runtime context in the structure.
   RuntimeContext *_runtimeContextPtr = &runtimeContext;
 
   auto _argRaws = std::vector<void *>(this->argRawSize);
@@ -596,29 +606,71 @@ void ServerCircuit::invoke(const ServerKeyset &serverKeyset) {
   }
 }
 
+/// Returns the path of the shared library of a single circuit, as emitted by
+/// the compiler next to the shared library of the program: `sharedlib.so`
+/// becomes `sharedlib.<circuitName>.so`.
+std::string getCircuitSharedLibPath(const std::string &sharedLibPath,
+                                    const std::string &circuitName) {
+  llvm::SmallString<0> path(sharedLibPath);
+  llvm::sys::path::replace_extension(
+      path, circuitName + llvm::sys::path::extension(sharedLibPath));
+  return path.str().str();
+}
+
 Result<ServerProgram>
 ServerProgram::load(const Message<concreteprotocol::ProgramInfo> &programInfo,
                     const std::string &sharedLibPath, bool useSimulation) {
-  ServerProgram output;
-  OUTCOME_TRY(auto dynamicModule, DynamicModule::open(sharedLibPath));
-  auto sharedDynamicModule = std::shared_ptr<DynamicModule>(dynamicModule);
-  std::vector<ServerCircuit> serverCircuits;
+  // The libraries are only opened on the first use of their circuits, but
+  // they must exist
   for (auto circuitInfo : programInfo.asReader().getCircuits()) {
-    OUTCOME_TRY(auto serverCircuit,
-                ServerCircuit::fromDynamicModule(
-                    circuitInfo, sharedDynamicModule, useSimulation));
-    serverCircuits.push_back(serverCircuit);
+    auto libPath = circuitInfo.getHasOwnLibrary()
+                       ? getCircuitSharedLibPath(sharedLibPath,
+                                                 circuitInfo.getName().cStr())
+                       : sharedLibPath;
+    if (!llvm::sys::fs::exists(libPath)) {
+      return StringError("Cannot open shared library ") << libPath;
+    }
   }
-  output.serverCircuits = serverCircuits;
+
+  ServerProgram output;
+  output.programInfo = programInfo;
+  output.sharedLibPath = sharedLibPath;
+  output.useSimulation = useSimulation;
+  output.loadedCircuits = std::make_shared<LoadedCircuits>();
   return output;
 }
 
 Result<ServerCircuit>
 ServerProgram::getServerCircuit(const std::string &circuitName) {
-  for (auto serverCircuit : serverCircuits) {
-    if (serverCircuit.getName() == circuitName) {
-      return serverCircuit;
+  std::lock_guard<std::mutex> guard(loadedCircuits->mutex);
+  auto loaded = loadedCircuits->serverCircuits.find(circuitName);
+  if (loaded != loadedCircuits->serverCircuits.end()) {
+    return loaded->second;
+  }
+
+  for (auto circuitInfo : programInfo.asReader().getCircuits()) {
+    if (std::string(circuitInfo.getName().cStr()) != circuitName) {
+      continue;
     }
+    // The circuits emitted in their own library are loaded from it, the
+    // others share the library of the program
+    std::shared_ptr<DynamicModule> dynamicModule;
+    if (circuitInfo.getHasOwnLibrary()) {
+      OUTCOME_TRY(dynamicModule,
+                  DynamicModule::open(
+                      getCircuitSharedLibPath(sharedLibPath, circuitName)));
+    } else {
+      if (!loadedCircuits->programModule) {
+        OUTCOME_TRY(loadedCircuits->programModule,
+                    DynamicModule::open(sharedLibPath));
+      }
+      dynamicModule = loadedCircuits->programModule;
+    }
+    OUTCOME_TRY(auto serverCircuit,
+                ServerCircuit::fromDynamicModule(circuitInfo, dynamicModule,
+                                                 useSimulation));
+    loadedCircuits->serverCircuits.emplace(circuitName, serverCircuit);
+    return serverCircuit;
   }
   return StringError("Tried to get unknown server circuit: `" + circuitName +
                      "`");
@@ -134,6 +134,7 @@ llvm::json::Value toJSON(const mlir::concretelang::CompilationFeedback &v) {
       {"totalInputsSize", v.totalInputsSize},
       {"totalOutputsSize", v.totalOutputsSize},
       {"crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs},
+      {"eliminatedPbsCount", v.eliminatedPbsCount},
   };
 
   auto memoryUsageObject = llvm::json::Object();
@@ -215,7 +216,8 @@ bool fromJSON(const llvm::json::Value j,
       O.map("totalKeyswitchKeysSize", v.totalKeyswitchKeysSize) &&
       O.map("totalInputsSize", v.totalInputsSize) &&
       O.map("totalOutputsSize", v.totalOutputsSize) &&
-      O.map("crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs);
+      O.map("crtDecompositionsOfOutputs", v.crtDecompositionsOfOutputs) &&
+      O.mapOptional("eliminatedPbsCount", v.eliminatedPbsCount);
 
   if (!is_success) {
     return false;
@@ -8,8 +8,8 @@
 #include "mlir/Dialect/Linalg/Transforms/BufferizableOpInterfaceImpl.h"
 #include "mlir/Dialect/SCF/Transforms/BufferizableOpInterfaceImpl.h"
 #include "mlir/Dialect/Tensor/Transforms/BufferizableOpInterfaceImpl.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/Debug.h"
-#include <err.h>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -25,6 +25,7 @@
 #include "mlir/Dialect/OpenMP/OpenMPDialect.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/ExecutionEngine/OptUtils.h"
+#include "mlir/IR/Diagnostics.h"
 #include "mlir/Parser/Parser.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
@@ -204,6 +205,14 @@ llvm::Error CompilerEngine::determineFHEParameters(CompilationResult &res) {
   }
   // compute parameters
   else {
+    // Make sure to use the gpu constraint of the optimizer if we use gpu
+    // backend.
+    compilerOptions.optimizerConfig.use_gpu_constraints =
+        compilerOptions.emitGPUOps;
+    // The lookup tables of a same input can only share a bootstrap once
+    // their keyswitches are shared by the TFHE optimization
+    if (!compilerOptions.optimizeTFHE)
+      compilerOptions.optimizerConfig.max_many_lut_count = 1;
     auto descr = getConcreteOptimizerDescription(res);
     if (auto err = descr.takeError()) {
       return err;
@@ -212,10 +221,6 @@ llvm::Error CompilerEngine::determineFHEParameters(CompilationResult &res) {
       return llvm::Error::success();
     }
     CompilationFeedback feedback;
-    // Make sure to use the gpu constraint of the optimizer if we use gpu
-    // backend.
-    compilerOptions.optimizerConfig.use_gpu_constraints =
-        compilerOptions.emitGPUOps;
     auto expectedSolution = getSolution(descr.get().value(), feedback,
                                         compilerOptions.optimizerConfig);
     if (auto err = expectedSolution.takeError()) {
@@ -229,6 +234,110 @@ llvm::Error CompilerEngine::determineFHEParameters(CompilationResult &res) {
   return llvm::Error::success();
 }
 
+/// Transforms the module of `res` as required before the FHE parameters are
+/// determined, with big integers decomposed into chunks or not, and counts
+/// the bootstraps eliminated by the composition of lookup tables in
+/// `eliminatedPBS`.
+llvm::Error
+CompilerEngine::transformBeforeFHEParameters(CompilationResult &res,
+                                             bool chunkIntegers,
+                                             uint64_t &eliminatedPBS) {
+  mlir::MLIRContext &mlirContext = *this->compilationContext->getMLIRContext();
+  CompilationOptions &options = this->compilerOptions;
+  mlir::ModuleOp module = res.mlirModuleRef->get();
+
+  if (chunkIntegers) {
+    if (mlir::concretelang::pipeline::transformFHEBigInt(
+            mlirContext, module, enablePass, options.chunkSize,
+            options.chunkWidth)
+            .failed()) {
+      return StreamStringError("Transforming FHE big integer ops failed");
+    }
+  }
+
+  // Remove the PBS of table lookups that can be computed at compile time,
+  // this must be done before the FHE parameters are determined
+  if (options.composeLookupTables &&
+      mlir::concretelang::pipeline::composeLookupTables(
+          mlirContext, module, enablePass, eliminatedPBS)
+          .failed()) {
+    return StreamStringError("Composing table lookups failed");
+  }
+
+  // Shrink the encrypted integers to the ranges of their values, this must
+  // also be done before the FHE parameters are determined
+  if (options.minimizeBitWidths &&
+      mlir::concretelang::pipeline::minimizeBitWidths(mlirContext, module,
+                                                      enablePass)
+          .failed()) {
+    return StreamStringError("Minimizing bit widths failed");
+  }
+
+  // Rewrite the convolutions into their Winograd form once the widths are
+  // known, such that the parameters account for the transformed weights
+  if (options.winogradConv2d &&
+      mlir::concretelang::pipeline::rewriteWinogradConv2d(mlirContext, module,
+                                                          enablePass)
+          .failed()) {
+    return StreamStringError("Rewriting convolutions to Winograd failed");
+  }
+
+  return llvm::Error::success();
+}
+
+/// Determines the FHE parameters of copies of `module` with big integers
+/// decomposed into chunks or not, and moves the cheapest one, with its
+/// parameters, to `res`. Returns whether big integers are chunked, or
+/// `std::nullopt` if no copy has a solution.
+std::optional<bool> CompilerEngine::determineFHEParametersByCost(
+    CompilationResult &res, mlir::ModuleOp module, uint64_t &eliminatedPBS) {
+  mlir::MLIRContext &mlirContext = *this->compilationContext->getMLIRContext();
+
+  // The failures of a candidate only discard it, silence their diagnostics
+  mlir::ScopedDiagnosticHandler silenceHandler(
+      &mlirContext, [](mlir::Diagnostic &) { return mlir::success(); });
+
+  // The solutions of the candidates are not displayed, only compared
+  bool display = this->compilerOptions.optimizerConfig.display;
+  this->compilerOptions.optimizerConfig.display = false;
+  auto restoreDisplay = llvm::make_scope_exit(
+      [&]() { this->compilerOptions.optimizerConfig.display = display; });
+
+  std::optional<CompilationResult> best;
+  bool bestChunkIntegers = false;
+  uint64_t bestEliminatedPBS = 0;
+  for (bool chunkIntegers : {false, true}) {
+    CompilationResult candidate(this->compilationContext);
+    candidate.mlirModuleRef = mlir::OwningOpRef<mlir::ModuleOp>(module.clone());
+    uint64_t candidateEliminatedPBS = 0;
+    if (auto err = transformBeforeFHEParameters(candidate, chunkIntegers,
+                                                candidateEliminatedPBS)) {
+      llvm::consumeError(std::move(err));
+      continue;
+    }
+    if (auto err = this->determineFHEParameters(candidate)) {
+      llvm::consumeError(std::move(err));
+      continue;
+    }
+    if (!candidate.fheContext.has_value() || !candidate.feedback.has_value())
+      continue;
+    if (best.has_value() &&
+        best->feedback->complexity <= candidate.feedback->complexity)
+      continue;
+    best = std::move(candidate);
+    bestChunkIntegers = chunkIntegers;
+    bestEliminatedPBS = candidateEliminatedPBS;
+  }
+
+  if (!best.has_value())
+    return std::nullopt;
+  res.mlirModuleRef = std::move(best->mlirModuleRef);
+  res.fheContext = std::move(best->fheContext);
+  res.feedback = std::move(best->feedback);
+  eliminatedPBS = bestEliminatedPBS;
+  return bestChunkIntegers;
+}
+
 using OptionalLib = std::optional<std::shared_ptr<CompilerEngine::Library>>;
 // Compile the sources managed by the source manager `sm` to the
 // target dialect `target`. If successful, the result can be retrieved
@@ -289,18 +398,12 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   // enable/disable usage of gpu functions during bufferization
   EMIT_GPU_OPS = options.emitGPUOps;
 
+  // the passes operating on functions are run on all functions of the module
+  // in parallel if multithreading is enabled
+  mlirContext.enableMultithreading(options.multithreadPasses);
+
   auto dataflowParallelize =
       options.autoParallelize || options.dataflowParallelize;
-  if (options.optimizerConfig.strategy == optimizer::Strategy::DAG_MULTI &&
-      dataflowParallelize == true) {
-    // FIXME: DF is not currently compatible with multi-parameters as
-    // the generation of dataflow tasks obfuscates the code before the
-    // analysis can be done. Until this is fixed we cannot allow both.
-    dataflowParallelize = false;
-    warnx("WARNING: dataflow parallelization is not compatible with the "
-          "optimizer strategy [dag-multi]. Continuing with dataflow "
-          "parallelization disabled.");
-  }
   auto loopParallelize = options.autoParallelize || options.loopParallelize;
 
   if (loopParallelize)
@@ -309,6 +412,29 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   if (dataflowParallelize)
     mlir::concretelang::dfr::_dfr_set_required(true);
 
+  // The 32 bits storage of the small LWE ciphertexts is only implemented by
+  // the CPU runtime, and only modeled by the mono-parameter optimizer
+  if (options.optimizerConfig.small_lwe_ciphertext_modulus_log != 64) {
+    if (options.optimizerConfig.small_lwe_ciphertext_modulus_log != 32)
+      return StreamStringError(
+          "The small LWE ciphertext modulus log must be 32 or 64");
+    if (options.optimizerConfig.strategy == optimizer::Strategy::DAG_MULTI)
+      return StreamStringError("32 bits small LWE ciphertexts are not "
+                               "supported by the dag-multi optimizer");
+    if (options.emitGPUOps || options.emitSDFGOps || options.simulate)
+      return StreamStringError("32 bits small LWE ciphertexts are only "
+                               "supported by the CPU runtime");
+  }
+
+  // The calibrated complexity model is loaded once per compilation, and kept
+  // by the optimizer for the optimizations of all the functions
+  if (!options.optimizerConfig.complexity_model_path.empty()) {
+    auto error = concrete_optimizer::utils::check_complexity_model(
+        options.optimizerConfig.complexity_model_path);
+    if (!error.empty())
+      return StreamStringError(std::string(error));
+  }
+
   mlir::OwningOpRef<mlir::ModuleOp> mlirModuleRef(moduleOp);
   res.mlirModuleRef = std::move(mlirModuleRef);
   mlir::ModuleOp module = res.mlirModuleRef->get();
@@ -335,18 +461,34 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return StreamStringError("Transforming FHE boolean ops failed");
   }
 
-  if (options.chunkIntegers) {
-    if (mlir::concretelang::pipeline::transformFHEBigInt(
-            mlirContext, module, enablePass, options.chunkSize,
-            options.chunkWidth)
-            .failed()) {
-      return StreamStringError("Transforming FHE big integer ops failed");
-    }
+  // Decompose the big integers into chunks if requested, or if the optimizer
+  // finds cheaper parameters for the chunked circuit than for the native or
+  // CRT encoding of the big integers, in which case the module of the
+  // cheapest candidate replaces the current one
+  bool chunkIntegers = options.chunkIntegers;
+  uint64_t eliminatedPBS = 0;
+  std::optional<bool> chunkIntegersByCost;
+  if (!chunkIntegers && options.chunkIntegersByCost &&
+      !options.v0Parameter.has_value()) {
+    chunkIntegersByCost =
+        this->determineFHEParametersByCost(res, module, eliminatedPBS);
   }
 
-  // FHE High level pass to determine FHE parameters
-  if (auto err = this->determineFHEParameters(res))
-    return std::move(err);
+  if (chunkIntegersByCost.has_value()) {
+    chunkIntegers = *chunkIntegersByCost;
+    module = res.mlirModuleRef->get();
+  } else {
+    if (auto err = this->transformBeforeFHEParameters(res, chunkIntegers,
+                                                      eliminatedPBS))
+      return std::move(err);
+
+    // FHE High level pass to determine FHE parameters
+    if (auto err = this->determineFHEParameters(res))
+      return std::move(err);
+  }
+
+  if (res.feedback)
+    res.feedback->eliminatedPbsCount += eliminatedPBS;
 
   // Now that FHE Parameters were computed, we can set the encoding mode of
   // integer ciphered inputs.
@@ -354,7 +496,7 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     std::optional<
         Message<concreteprotocol::IntegerCiphertextEncodingInfo::ChunkedMode>>
         maybeChunkInfo(std::nullopt);
-    if (options.chunkIntegers) {
+    if (chunkIntegers) {
       auto chunkedMode = Message<
           concreteprotocol::IntegerCiphertextEncodingInfo::ChunkedMode>();
       chunkedMode.asBuilder().setSize(options.chunkSize);
@@ -453,6 +595,23 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
     return StreamStringError("Normalizing TFHE keys failed");
   }
 
+  // Share the keyswitches of a same ciphertext
+  if (this->compilerOptions.optimizeTFHE &&
+      mlir::concretelang::pipeline::shareTFHEKeyswitches(mlirContext, module,
+                                                         this->enablePass)
+          .failed()) {
+    return StreamStringError("Sharing of TFHE keyswitches failed");
+  }
+
+  // Evaluate the lookup tables of a same ciphertext with a single bootstrap
+  if (this->compilerOptions.optimizerConfig.max_many_lut_count > 1 &&
+      !this->compilerOptions.emitGPUOps &&
+      mlir::concretelang::pipeline::groupTFHEManyLutBootstraps(
+          mlirContext, module, this->enablePass)
+          .failed()) {
+    return StreamStringError("Grouping of TFHE many-lut bootstraps failed");
+  }
+
   // Generate client parameters if requested
   if (this->generateProgramInfo) {
     if (!options.mainFuncName.has_value()) {
@@ -479,7 +638,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
       auto programInfoOrErr =
           mlir::concretelang::createProgramInfoFromTfheDialect(
               module, funcName, options.optimizerConfig.security,
-              options.encodings.value(), options.compressInputs);
+              options.encodings.value(), options.compressInputs,
+              options.compressOutputs && !options.simulate);
 
       if (!programInfoOrErr)
         return programInfoOrErr.takeError();
@@ -516,24 +676,55 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
   if (target == Target::SIMULATED_TFHE)
     return std::move(res);
 
+  // Compute the encodings of the clear values extracted from constant tensors
+  // at compile time
+  if (options.foldConstantEncodings &&
+      mlir::concretelang::pipeline::foldConstantEncodings(mlirContext, module,
+                                                          enablePass)
+          .failed()) {
+    return StreamStringError("Folding of constant encodings failed");
+  }
+
   if (options.batchTFHEOps) {
     if (mlir::concretelang::pipeline::batchTFHE(mlirContext, module, enablePass,
                                                 options.maxBatchSize)
             .failed()) {
       return StreamStringError("Batching of TFHE operations");
     }
+
+    // Batching may have introduced batched keyswitches of a same tensor
+    if (this->compilerOptions.optimizeTFHE &&
+        mlir::concretelang::pipeline::shareTFHEKeyswitches(mlirContext, module,
+                                                           this->enablePass)
+            .failed()) {
+      return StreamStringError("Sharing of TFHE keyswitches failed");
+    }
   }
 
   if (target == Target::BATCHED_TFHE)
     return std::move(res);
 
   // TFHE -> Concrete
-  if (mlir::concretelang::pipeline::lowerTFHEToConcrete(mlirContext, module,
-                                                        this->enablePass)
+  if (mlir::concretelang::pipeline::lowerTFHEToConcrete(
+          mlirContext, module, this->enablePass,
+          options.optimizerConfig.small_lwe_ciphertext_modulus_log)
           .failed()) {
     return StreamStringError("Lowering from TFHE to Concrete failed");
   }
 
+  // Remove the bootstraps left redundant by the lowering of tensor
+  // operations and of chunked integers
+  if (this->compilerOptions.optimizeTFHE) {
+    uint64_t eliminatedConcretePBS = 0;
+    if (mlir::concretelang::pipeline::eliminateConcreteBootstraps(
+            mlirContext, module, this->enablePass, eliminatedConcretePBS)
+            .failed()) {
+      return StreamStringError("Elimination of Concrete bootstraps failed");
+    }
+    if (res.feedback)
+      res.feedback->eliminatedPbsCount += eliminatedConcretePBS;
+  }
+
   if (target == Target::CONCRETE)
     return std::move(res);
 
@@ -570,7 +761,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
 
   // bufferize and related passes
   if (mlir::concretelang::pipeline::lowerToStd(mlirContext, module, enablePass,
-                                               loopParallelize)
+                                               loopParallelize,
+                                               options.loopOutliningThreshold)
           .failed()) {
     return StreamStringError("Failed to lower to std");
   }
@@ -628,7 +820,8 @@ CompilerEngine::compile(mlir::ModuleOp moduleOp, Target target,
       return StreamStringError(
           "Internal Error: Please provide a library parameter");
     }
-    auto objPath = lib.value()->setCompilationResult(res);
+    auto objPath = lib.value()->setCompilationResult(
+        res, options.emitCircuitLibraries);
     if (!objPath) {
       return StreamStringError(llvm::toString(objPath.takeError()));
     }
@@ -739,6 +932,16 @@ CompilerEngine::Library::getSharedLibraryPath(std::string outputDirPath) {
   return sharedLibraryPath.str().str();
 }
 
+/// Returns the path of the shared library of a single circuit
+std::string
+CompilerEngine::Library::getCircuitSharedLibraryPath(std::string outputDirPath,
+                                                     std::string circuitName) {
+  llvm::SmallString<0> sharedLibraryPath(outputDirPath);
+  llvm::sys::path::append(sharedLibraryPath,
+                          "sharedlib." + circuitName + DOT_SHARED_LIB_EXT);
+  return sharedLibraryPath.str().str();
+}
+
 /// Returns the path of the static library
 std::string
 CompilerEngine::Library::getStaticLibraryPath(std::string outputDirPath) {
@@ -830,19 +1033,36 @@ CompilerEngine::Library::emitCompilationFeedbackJSON() {
 }
 
 llvm::Expected<std::string>
-CompilerEngine::Library::setCompilationResult(CompilationResult &compilation) {
+CompilerEngine::Library::setCompilationResult(CompilationResult &compilation,
+                                              bool circuitObjects) {
   llvm::Module *module = compilation.llvmModule.get();
-  auto sourceName = module->getSourceFileName();
-  if (sourceName == "" || sourceName == "LLVMDialectModule") {
-    sourceName = this->outputDirPath + "/program.module-" +
-                 std::to_string(objectsPath.size()) + ".mlir";
-  }
-  auto objectPath = sourceName + OBJECT_EXT;
-  if (auto error = mlir::concretelang::emitObject(*module, objectPath)) {
-    return std::move(error);
+  std::string objectPath;
+  if (circuitObjects && compilation.programInfo) {
+    // Each circuit is emitted separately, reusing the objects of the circuits
+    // which did not change since the previous compilation
+    for (auto circuitInfo : compilation.programInfo->asReader().getCircuits()) {
+      std::string circuitName = circuitInfo.getName().cStr();
+      auto circuitObjectPath = mlir::concretelang::emitCircuitObject(
+          *module, circuitName, outputDirPath);
+      if (!circuitObjectPath) {
+        return circuitObjectPath.takeError();
+      }
+      objectPath = *circuitObjectPath;
+      circuitObjectsPath.push_back({circuitName, objectPath});
+    }
+  } else {
+    auto sourceName = module->getSourceFileName();
+    if (sourceName == "" || sourceName == "LLVMDialectModule") {
+      sourceName = this->outputDirPath + "/program.module-" +
+                   std::to_string(objectsPath.size()) + ".mlir";
+    }
+    objectPath = sourceName + OBJECT_EXT;
+    if (auto error = mlir::concretelang::emitObject(*module, objectPath)) {
+      return std::move(error);
+    }
+    addExtraObjectFilePath(objectPath);
   }
 
-  addExtraObjectFilePath(objectPath);
   if (compilation.programInfo) {
     programInfo = *compilation.programInfo;
   }
@@ -872,8 +1092,12 @@ llvm::Expected<std::string> CompilerEngine::Library::emit(
     std::string path, std::string dotExt, std::string linker,
     std::optional<std::vector<std::string>> extraArgs) {
   auto pathDotExt = ensureLibDotExt(path, dotExt);
-  auto error = mlir::concretelang::emitLibrary(objectsPath, pathDotExt, linker,
-                                               extraArgs);
+  std::vector<std::string> allObjectsPath = objectsPath;
+  for (auto &circuitObjectPath : circuitObjectsPath) {
+    allObjectsPath.push_back(circuitObjectPath.second);
+  }
+  auto error = mlir::concretelang::emitLibrary(allObjectsPath, pathDotExt,
+                                               linker, extraArgs);
   if (error) {
     return std::move(error);
   }
@@ -922,10 +1146,7 @@ llvm::Expected<std::string> CompilerEngine::Library::emitShared() {
     }
 #endif
   }
-  auto path = emit(getSharedLibraryPath(outputDirPath), DOT_SHARED_LIB_EXT,
-                   LINKER + LINKER_SHARED_OPT, extraArgs);
-  if (path) {
-    sharedLibraryPath = path.get();
+  auto fixRuntimeDependency = [&](std::string libraryPath) -> llvm::Error {
 #ifdef __APPLE__
     // when dellocate is used to include dependencies in python wheels, the
     // runtime library will have an id that is prefixed with /DLC, and that
@@ -940,13 +1161,43 @@ llvm::Expected<std::string> CompilerEngine::Library::emitShared() {
                                      "/DLC/concrete/.dylibs/" +
                                      fullRuntimeLibraryName + " @rpath/" +
                                      fullRuntimeLibraryName + " " +
-                                     sharedLibraryPath;
-      auto error = mlir::concretelang::callCmd(fixRuntimeDepCmd);
-      if (error) {
-        return std::move(error);
-      }
+                                     libraryPath;
+      return mlir::concretelang::callCmd(fixRuntimeDepCmd);
     }
 #endif
+    return llvm::Error::success();
+  };
+
+  auto path = emit(getSharedLibraryPath(outputDirPath), DOT_SHARED_LIB_EXT,
+                   LINKER + LINKER_SHARED_OPT, extraArgs);
+  if (!path) {
+    return path;
+  }
+  sharedLibraryPath = path.get();
+  if (auto error = fixRuntimeDependency(sharedLibraryPath)) {
+    return std::move(error);
+  }
+
+  // Each circuit emitted separately also gets its own library, which the
+  // server loads on the first use of the circuit. It is marked in the program
+  // info, as the server ignores the circuit libraries left in the directory by
+  // a previous compilation
+  for (auto &circuitObjectPath : circuitObjectsPath) {
+    auto circuitLibraryPath =
+        getCircuitSharedLibraryPath(outputDirPath, circuitObjectPath.first);
+    if (auto error = mlir::concretelang::emitLibrary(
+            {circuitObjectPath.second}, circuitLibraryPath,
+            LINKER + LINKER_SHARED_OPT, extraArgs)) {
+      return std::move(error);
+    }
+    if (auto error = fixRuntimeDependency(circuitLibraryPath)) {
+      return std::move(error);
+    }
+    for (auto circuitInfo : programInfo.asBuilder().getCircuits()) {
+      if (circuitInfo.getName().cStr() == circuitObjectPath.first) {
+        circuitInfo.setHasOwnLibrary(true);
+      }
+    }
   }
 
   return path;
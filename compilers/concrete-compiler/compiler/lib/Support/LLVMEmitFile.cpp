@@ -6,13 +6,20 @@
 #include <errno.h>
 
 #include "llvm/MC/SubtargetFeature.h"
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/xxhash.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/TargetParser/Host.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 
 #include <mlir/Support/FileUtilities.h>
 
@@ -67,7 +74,8 @@ static void packFunctionArguments(llvm::Module *module) {
   llvm::IRBuilder<> builder(ctx);
   llvm::DenseSet<llvm::Function *> interfaceFunctions;
   for (auto &func : module->getFunctionList()) {
-    if (func.isDeclaration()) {
+    // The local functions cannot be called from outside of the object
+    if (func.isDeclaration() || func.hasLocalLinkage()) {
       continue;
     }
     if (interfaceFunctions.count(&func)) {
@@ -162,6 +170,107 @@ llvm::Error emitObject(llvm::Module &module, string objectPath) {
   return llvm::Error::success();
 }
 
+std::unique_ptr<llvm::Module>
+extractCircuitModule(const llvm::Module &module, llvm::StringRef circuitName) {
+  const llvm::Function *circuit = module.getFunction(circuitName);
+  if (circuit == nullptr || circuit->isDeclaration()) {
+    return nullptr;
+  }
+
+  // Collect the functions and globals transitively used by the circuit
+  llvm::SmallPtrSet<const llvm::GlobalValue *, 16> used;
+  llvm::SmallPtrSet<const llvm::User *, 32> visited;
+  llvm::SmallVector<const llvm::User *> worklist{circuit};
+  auto pushConstants = [&](const llvm::User *user) {
+    for (const llvm::Value *operand : user->operands()) {
+      if (auto constant = llvm::dyn_cast<llvm::Constant>(operand)) {
+        worklist.push_back(constant);
+      }
+    }
+  };
+  while (!worklist.empty()) {
+    const llvm::User *user = worklist.pop_back_val();
+    if (!visited.insert(user).second) {
+      continue;
+    }
+    if (auto global = llvm::dyn_cast<llvm::GlobalValue>(user)) {
+      used.insert(global);
+    }
+    if (auto func = llvm::dyn_cast<llvm::Function>(user)) {
+      for (const llvm::Instruction &inst : llvm::instructions(func)) {
+        pushConstants(&inst);
+      }
+    }
+    pushConstants(user);
+  }
+
+  llvm::ValueToValueMapTy mapping;
+  std::unique_ptr<llvm::Module> circuitModule = llvm::CloneModule(
+      module, mapping,
+      [&](const llvm::GlobalValue *global) { return used.contains(global); });
+  circuitModule->setModuleIdentifier(circuitName);
+  circuitModule->setSourceFileName(circuitName);
+
+  // The definitions copied along with the circuit are private to its object,
+  // such that the objects of several circuits can be linked together
+  for (llvm::GlobalValue &global : circuitModule->global_values()) {
+    if (!global.isDeclaration() && global.getName() != circuitName) {
+      global.setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+  }
+  return circuitModule;
+}
+
+llvm::Expected<string> emitCircuitObject(const llvm::Module &module,
+                                         string circuitName,
+                                         string outputDirPath) {
+  auto circuitModule = extractCircuitModule(module, circuitName);
+  if (!circuitModule) {
+    return StreamStringError("Cannot find the circuit " + circuitName);
+  }
+  auto targetMachine = getTargetMachineAndSetupModule(circuitModule.get());
+  if (!targetMachine) {
+    return StreamStringError("No default target machine for object generation");
+  }
+
+  // The object is named after the code of the circuit and the target
+  // machine, such that the object emitted by a previous compilation of the
+  // same circuit is reused
+  string code;
+  llvm::raw_string_ostream codeStream(code);
+  codeStream << targetMachine->getTargetCPU() << " "
+             << targetMachine->getTargetFeatureString() << "\n";
+  circuitModule->print(codeStream, nullptr);
+  codeStream.flush();
+  string prefix = "circuit." + circuitName + ".";
+  string hash = llvm::utohexstr(llvm::xxHash64(code), /*LowerCase=*/true);
+  llvm::SmallString<0> objectPath(outputDirPath);
+  llvm::sys::path::append(objectPath, prefix + hash + ".o");
+  if (llvm::sys::fs::exists(objectPath)) {
+    return objectPath.str().str();
+  }
+
+  // Remove the objects of the previous versions of the circuit, whose names
+  // only differ by the hash. The objects of a circuit named after a dotted
+  // extension of this one have a dot after the prefix and are kept.
+  std::error_code error;
+  for (llvm::sys::fs::directory_iterator it(outputDirPath, error), end;
+       it != end && !error; it.increment(error)) {
+    llvm::StringRef fileName = llvm::sys::path::filename(it->path());
+    if (!fileName.consume_front(prefix) || !fileName.consume_back(".o")) {
+      continue;
+    }
+    if (!fileName.empty() && llvm::all_of(fileName, llvm::isHexDigit)) {
+      llvm::sys::fs::remove(it->path());
+    }
+  }
+
+  if (auto err = emitObject(*circuitModule, objectPath.str().str())) {
+    return std::move(err);
+  }
+  return objectPath.str().str();
+}
+
 string linkerCmd(vector<string> objectsPath, string libraryPath, string linker,
                  std::optional<vector<string>> extraArgs) {
   string cmd = linker + libraryPath;
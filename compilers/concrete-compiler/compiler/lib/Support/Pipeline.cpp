@@ -5,6 +5,9 @@
 
 #include "llvm/Support/TargetSelect.h"
 
+#include <atomic>
+#include <mutex>
+
 #include "mlir/Conversion/BufferizationToMemRef/BufferizationToMemRef.h"
 #include "mlir/Conversion/Passes.h"
 #include "mlir/Dialect/Bufferization/Transforms/Passes.h"
@@ -39,7 +42,10 @@
 #include "concretelang/Dialect/FHE/Transforms/DynamicTLU/DynamicTLU.h"
 #include "concretelang/Dialect/FHE/Transforms/EncryptedMulToDoubleTLU/EncryptedMulToDoubleTLU.h"
 #include "concretelang/Dialect/FHE/Transforms/Max/Max.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/BitWidthMinimization.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/LookupTableComposition.h"
 #include "concretelang/Dialect/FHELinalg/Transforms/Tiling.h"
+#include "concretelang/Dialect/FHELinalg/Transforms/WinogradConv2d.h"
 #include "concretelang/Dialect/RT/Analysis/Autopar.h"
 #include "concretelang/Dialect/TFHE/Analysis/ExtractStatistics.h"
 #include "concretelang/Dialect/TFHE/Transforms/Transforms.h"
@@ -91,6 +97,7 @@ getFHEContextFromFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                      std::function<bool(mlir::Pass *)> enablePass) {
   std::optional<size_t> oMax2norm;
   std::optional<size_t> oMaxWidth;
+  std::mutex maxMutex;
   optimizer::FunctionsDag dags;
 
   mlir::PassManager pm(&context);
@@ -103,6 +110,8 @@ getFHEContextFromFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
       pm,
       mlir::concretelang::createMaxMANPPass(
           [&](const uint64_t manp, unsigned width) {
+            // The pass may run on several functions in parallel
+            std::lock_guard<std::mutex> guard(maxMutex);
             if (!oMax2norm.has_value() || oMax2norm.value() < manp)
               oMax2norm.emplace(manp);
 
@@ -248,6 +257,49 @@ transformFHEBigInt(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+composeLookupTables(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    uint64_t &eliminatedPBS) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("ComposeLookupTables", pm, context);
+  // The pass runs on functions, possibly concurrently
+  std::atomic<uint64_t> eliminated(0);
+  addPotentiallyNestedPass(
+      pm,
+      mlir::concretelang::createLookupTableCompositionPass(
+          [&](uint64_t count) { eliminated += count; }),
+      enablePass);
+  if (pm.run(module.getOperation()).failed())
+    return mlir::failure();
+
+  eliminatedPBS += eliminated;
+  return mlir::success();
+}
+
+mlir::LogicalResult
+minimizeBitWidths(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                  std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("MinimizeBitWidths", pm, context);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createBitWidthMinimizationPass(), enablePass);
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+rewriteWinogradConv2d(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("WinogradConv2d", pm, context);
+  // The rewriting is driven by the noise bounds of the MANP analysis
+  addPotentiallyNestedPass(pm, mlir::concretelang::createMANPPass(),
+                           enablePass);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createWinogradConv2dPass(), enablePass);
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult
 lowerFHEToTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
                std::optional<V0FHEContext> &fheContext,
@@ -309,6 +361,18 @@ parametrizeTFHE(mlir::MLIRContext &context, mlir::ModuleOp &module,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+foldConstantEncodings(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                      std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("FoldConstantEncodings", pm, context);
+
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createConstantDenseFoldingPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult batchTFHE(mlir::MLIRContext &context,
                               mlir::ModuleOp &module,
                               std::function<bool(mlir::Pass *)> enablePass,
@@ -350,16 +414,39 @@ extractTFHEStatistics(mlir::MLIRContext &context, mlir::ModuleOp &module,
 
 mlir::LogicalResult
 lowerTFHEToConcrete(mlir::MLIRContext &context, mlir::ModuleOp &module,
-                    std::function<bool(mlir::Pass *)> enablePass) {
+                    std::function<bool(mlir::Pass *)> enablePass,
+                    unsigned smallLweCiphertextModulusLog) {
   mlir::PassManager pm(&context);
   pipelinePrinting("TFHEToConcrete", pm, context);
 
-  addPotentiallyNestedPass(
-      pm, mlir::concretelang::createConvertTFHEToConcretePass(), enablePass);
+  addPotentiallyNestedPass(pm,
+                           mlir::concretelang::createConvertTFHEToConcretePass(
+                               smallLweCiphertextModulusLog),
+                           enablePass);
 
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+eliminateConcreteBootstraps(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                            std::function<bool(mlir::Pass *)> enablePass,
+                            uint64_t &eliminatedPBS) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("ConcreteBootstrapElimination", pm, context);
+  // The pass runs on functions, possibly concurrently
+  std::atomic<uint64_t> eliminated(0);
+  addPotentiallyNestedPass(
+      pm,
+      mlir::concretelang::createBootstrapEliminationPass(
+          [&](uint64_t count) { eliminated += count; }),
+      enablePass);
+  if (pm.run(module.getOperation()).failed())
+    return mlir::failure();
+
+  eliminatedPBS += eliminated;
+  return mlir::success();
+}
+
 mlir::LogicalResult
 computeMemoryUsage(mlir::MLIRContext &context, mlir::ModuleOp &module,
                    std::function<bool(mlir::Pass *)> enablePass,
@@ -384,6 +471,28 @@ mlir::LogicalResult optimizeTFHE(mlir::MLIRContext &context,
   return pm.run(module.getOperation());
 }
 
+mlir::LogicalResult
+shareTFHEKeyswitches(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                     std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("TFHEKeyswitchSharing", pm, context);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createTFHEKeyswitchSharingPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
+mlir::LogicalResult
+groupTFHEManyLutBootstraps(mlir::MLIRContext &context, mlir::ModuleOp &module,
+                           std::function<bool(mlir::Pass *)> enablePass) {
+  mlir::PassManager pm(&context);
+  pipelinePrinting("TFHEManyLutBootstrap", pm, context);
+  addPotentiallyNestedPass(
+      pm, mlir::concretelang::createTFHEManyLutBootstrapPass(), enablePass);
+
+  return pm.run(module.getOperation());
+}
+
 mlir::LogicalResult simulateTFHE(mlir::MLIRContext &context,
                                  mlir::ModuleOp &module,
                                  std::function<bool(mlir::Pass *)> enablePass) {
@@ -432,7 +541,8 @@ lowerSDFGToStd(mlir::MLIRContext &context, mlir::ModuleOp &module,
 mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
                                mlir::ModuleOp &module,
                                std::function<bool(mlir::Pass *)> enablePass,
-                               bool parallelizeLoops) {
+                               bool parallelizeLoops,
+                               uint64_t loopOutliningThreshold) {
   mlir::PassManager pm(&context);
   pipelinePrinting("Lowering to Std", pm, context);
 
@@ -462,6 +572,13 @@ mlir::LogicalResult lowerToStd(mlir::MLIRContext &context,
   addPotentiallyNestedPass(
       pm, mlir::concretelang::createBufferizeDataflowTaskOpsPass(), enablePass);
 
+  // Split the large functions, such that the following function passes
+  // process their loops in parallel
+  if (loopOutliningThreshold > 0)
+    addPotentiallyNestedPass(
+        pm, mlir::concretelang::createLoopOutliningPass(loopOutliningThreshold),
+        enablePass);
+
   if (parallelizeLoops) {
     addPotentiallyNestedPass(
         pm, mlir::concretelang::createCollapseParallelLoops(), enablePass);
@@ -4,6 +4,7 @@
 // for license information.
 
 #include <cassert>
+#include <cmath>
 #include <map>
 #include <memory>
 #include <optional>
@@ -14,6 +15,7 @@
 #include "concrete-protocol.capnp.h"
 #include "concrete/curves.h"
 #include "concretelang/Common/Protocol.h"
+#include "concretelang/Common/Transformers.h"
 #include "concretelang/Common/Values.h"
 #include "concretelang/Conversion/Utils/GlobalFHEContext.h"
 #include "concretelang/Dialect/Concrete/IR/ConcreteTypes.h"
@@ -234,7 +236,8 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
         bsk.getInputKey().getNormalized().value().index);
     infoMessage.asBuilder().setOutputId(
         bsk.getOutputKey().getNormalized().value().index);
-    if (!compressInputs) {
+    // Seeded multi-bit bootstrap keys are not supported by the backend
+    if (!compressInputs || bsk.getGroupingFactor() > 1) {
       infoMessage.asBuilder().setCompression(
           concreteprotocol::Compression::NONE);
     } else {
@@ -248,6 +251,7 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
     paramsBuilder.setPolynomialSize(bsk.getPolySize());
     paramsBuilder.setInputLweDimension(
         bsk.getInputKey().getNormalized().value().dimension);
+    paramsBuilder.setGroupingFactor(bsk.getGroupingFactor());
     paramsBuilder.setVariance(
         curve.getVariance(bsk.getGlweDim(), bsk.getPolySize(), 64));
     paramsBuilder.setIntegerPrecision(64);
@@ -295,10 +299,71 @@ extractKeysetInfo(TFHE::TFHECircuitKeys circuitKeys,
   return output;
 }
 
+/// The number of bits kept below the decoded bits of a modulus switched
+/// output ciphertext. The standard deviation of the rounding noise of the
+/// switch is then 2^-12 of the decoding step, which is negligible compared to
+/// the noise bound enforced by the optimizer.
+const uint32_t outputModulusSwitchGuardBits = 12;
+
+/// Returns the log2 of the smallest modulus an output ciphertext can be
+/// switched to without impacting its decryption, if it is smaller than the
+/// native one and its encoding supports it.
+std::optional<uint32_t> getOutputCompressionModulusLog(
+    concreteprotocol::LweCiphertextTypeInfo::Reader info) {
+  // The number of most significant bits read by the decoding, padding and
+  // rounding bits included
+  uint32_t decodedBits;
+  if (info.getEncoding().hasBoolean()) {
+    decodedBits = 4;
+  } else if (info.getEncoding().getInteger().getMode().hasNative()) {
+    decodedBits = info.getEncoding().getInteger().getWidth() + 2;
+  } else if (info.getEncoding().getInteger().getMode().hasChunked()) {
+    decodedBits =
+        info.getEncoding().getInteger().getMode().getChunked().getWidth() + 2;
+  } else {
+    // The crt decoding uses the whole ciphertext modulus
+    return std::nullopt;
+  }
+  // The rounding errors of the mask elements are summed by the decryption,
+  // over the half of the binary secret key that is set in average
+  double lweDimension = info.getEncryption().getLweDimension();
+  double roundingLog2Std = 0.5 * std::log2((lweDimension / 2. + 1.) / 12.);
+  uint32_t modulusLog = decodedBits + outputModulusSwitchGuardBits +
+                        (uint32_t)std::ceil(std::max(0., roundingLog2Std));
+  if (modulusLog >= 64) {
+    return std::nullopt;
+  }
+  return modulusLog;
+}
+
+/// Sets the modulus switch compression on an output gate, if its ciphertexts
+/// support it. The raw infos then describe the packed ciphertexts.
+void compressOutputGate(Message<concreteprotocol::GateInfo> &gate) {
+  if (!gate.asReader().getTypeInfo().hasLweCiphertext()) {
+    return;
+  }
+  auto modulusLog = getOutputCompressionModulusLog(
+      gate.asReader().getTypeInfo().getLweCiphertext());
+  if (!modulusLog.has_value()) {
+    return;
+  }
+  auto lweCiphertextGateInfo =
+      gate.asBuilder().getTypeInfo().getLweCiphertext();
+  lweCiphertextGateInfo.setCompression(
+      concreteprotocol::Compression::MODULUS_SWITCH);
+  lweCiphertextGateInfo.setCompressionModulusLog(*modulusLog);
+  auto rawDimensions = gate.asBuilder().getRawInfo().getShape().getDimensions();
+  auto lweSize = rawDimensions[rawDimensions.size() - 1];
+  rawDimensions.set(
+      rawDimensions.size() - 1,
+      ::concretelang::transformers::getModulusSwitchedLweSize(lweSize,
+                                                              *modulusLog));
+}
+
 llvm::Expected<Message<concreteprotocol::CircuitInfo>>
 extractCircuitInfo(mlir::ModuleOp module, llvm::StringRef functionName,
                    Message<concreteprotocol::CircuitEncodingInfo> &encodings,
-                   concrete::SecurityCurve curve) {
+                   concrete::SecurityCurve curve, bool compressOutputs) {
 
   auto output = Message<concreteprotocol::CircuitInfo>();
 
@@ -335,6 +400,9 @@ extractCircuitInfo(mlir::ModuleOp module, llvm::StringRef functionName,
     if (!maybeGate) {
       return maybeGate.takeError();
     }
+    if (compressOutputs) {
+      compressOutputGate(*maybeGate);
+    }
     output.asBuilder().getOutputs().setWithCaveats(i, maybeGate->asReader());
   }
 
@@ -345,7 +413,7 @@ llvm::Expected<Message<concreteprotocol::ProgramInfo>>
 createProgramInfoFromTfheDialect(
     mlir::ModuleOp module, llvm::StringRef functionName, int bitsOfSecurity,
     Message<concreteprotocol::CircuitEncodingInfo> &encodings,
-    bool compressInputs) {
+    bool compressInputs, bool compressOutputs) {
 
   // Check that security curves exist
   const auto curve = concrete::getSecurityCurve(bitsOfSecurity, keyFormat);
@@ -364,7 +432,8 @@ createProgramInfoFromTfheDialect(
 
   // We generate the gates for the inputs aud outputs
   auto maybeCircuitInfo =
-      extractCircuitInfo(module, functionName, encodings, *curve);
+      extractCircuitInfo(module, functionName, encodings, *curve,
+                         compressOutputs);
   if (!maybeCircuitInfo) {
     return maybeCircuitInfo.takeError();
   }
@@ -34,104 +34,84 @@ concrete_optimizer::Options options_from_config(optimizer::Config config) {
       /* .encoding = */ config.encoding,
       /* .cache_on_disk = */ config.cache_on_disk,
       /* .ciphertext_modulus_log = */ config.ciphertext_modulus_log,
+      /* .small_lwe_ciphertext_modulus_log = */
+      config.small_lwe_ciphertext_modulus_log,
       /* .fft_precision = */ config.fft_precision,
+      /* .multi_bit_grouping_factor = */ 1,
+      /* .complexity_model_path = */ config.complexity_model_path,
   };
   return options;
 }
 
 optimizer::DagSolution getV0Solution(V0FHEConstraint constraint,
-                                     optimizer::Config config) {
+                                     optimizer::Config config,
+                                     uint32_t groupingFactor) {
   // the norm2 0 is equivalent to a maximum noise_factor of 2.0
   // norm2 = 0  ==>  1.0 =< noise_factor < 2.0
   // norm2 = k  ==>  2^norm2 =< noise_factor < 2.0^norm2 + 1
   double noise_factor = std::exp2(constraint.norm2 + 1);
 
   auto options = options_from_config(config);
+  options.multi_bit_grouping_factor = groupingFactor;
 
   auto solution = concrete_optimizer::v0::optimize_bootstrap(
       constraint.p, noise_factor, options);
   return concrete_optimizer::utils::convert_to_dag_solution(solution);
 }
 
-const int MAXIMUM_OPTIMIZER_CALL = 10;
-
-template <typename Solution, typename Optimize>
-Solution getSolutionWithGlobalPError(optimizer::Config config,
-                                     Optimize optimize) {
-  // We find the approximate translation between local and global error with a
-  // calibration call
-  auto ref_global_p_success = 1.0 - config.global_p_error;
-
-  auto options = options_from_config(config);
-  options.maximum_acceptable_error_probability =
-      std::min(config.p_error, config.global_p_error);
-
-  auto sol = optimize(options);
-
-  if (sol.global_p_error <= config.global_p_error) {
-    // for levelled circuit the error is almost zero
-    return sol;
-  }
-  for (int i = 2; i <= MAXIMUM_OPTIMIZER_CALL; i++) {
-    auto local_p_success = 1.0 - sol.p_error;
-    auto global_p_success = 1.0 - sol.global_p_error;
-    auto power_global_to_local = log(local_p_success) / log(global_p_success);
-    auto surrogate_p_local_success =
-        pow(ref_global_p_success, power_global_to_local);
-
-    auto surrogate_p_error = 1.0 - surrogate_p_local_success;
-
-    // only valid when p_error is not too small and global_p_error not too high
-    auto valid = 0 < surrogate_p_error && surrogate_p_error < 1.0;
-
-    if (!valid) {
-      // linear approximation, only precise for small p_error
-      auto linear_correction =
-          sol.p_error < 0.1 ? sol.p_error / sol.global_p_error : 0.1;
-      valid = 0.0 < linear_correction && linear_correction < 1.0;
-      if (!valid) {
-        // global_p_error could be 0
-        linear_correction = 1e-5;
-      }
-      surrogate_p_error =
-          options.maximum_acceptable_error_probability * linear_correction;
-    };
-
-    options.maximum_acceptable_error_probability = surrogate_p_error;
-
-    sol = optimize(options);
-    if (sol.global_p_error <= config.global_p_error) {
-      break;
-    }
-  }
-  return sol;
-}
-
+/// When a global p_error is requested, the optimizer looks for the p_error per
+/// operation meeting it by itself, analysing the dag only once.
 optimizer::DagSolution getDagMonoSolution(optimizer::Dag &dag,
-                                          optimizer::Config config) {
-  auto optimize =
-      [&](concrete_optimizer::Options options) -> optimizer::DagSolution {
-    return dag->optimize(options);
-  };
+                                          optimizer::Config config,
+                                          uint32_t groupingFactor) {
+  auto options = options_from_config(config);
+  options.multi_bit_grouping_factor = groupingFactor;
   if (!std::isnan(config.global_p_error)) {
-    return getSolutionWithGlobalPError<optimizer::DagSolution>(config,
-                                                               optimize);
+    return dag->optimize_global_p_error(options, config.global_p_error);
   }
-  return optimize(options_from_config(config));
+  return dag->optimize(options);
 }
 
 optimizer::CircuitSolution getDagMultiSolution(optimizer::Dag &dag,
                                                optimizer::Config config) {
-
-  auto optimize =
-      [&](concrete_optimizer::Options options) -> optimizer::CircuitSolution {
-    return dag->optimize_multi(options);
-  };
+  auto options = options_from_config(config);
   if (!std::isnan(config.global_p_error)) {
-    return getSolutionWithGlobalPError<optimizer::CircuitSolution>(config,
-                                                                   optimize);
+    return dag->optimize_multi_global_p_error(options, config.global_p_error);
+  }
+  return dag->optimize_multi(options);
+}
+
+/// Returns the lowest complexity solution among the classic bootstrap and the
+/// multi-bit bootstraps allowed by `config`, along with its grouping factor
+/// (1 for the classic bootstrap). `optimize` is called once per grouping
+/// factor.
+template <typename Optimize>
+std::pair<optimizer::DagSolution, uint32_t>
+getBestGroupingFactorSolution(optimizer::Config config, Optimize optimize) {
+  auto best = optimize(1);
+  uint32_t bestGroupingFactor = 1;
+  if (config.use_gpu_constraints) {
+    return {best, bestGroupingFactor};
+  }
+  for (uint32_t groupingFactor = 2;
+       groupingFactor <= config.max_multi_bit_grouping_factor;
+       groupingFactor++) {
+    auto sol = optimize(groupingFactor);
+    // The wop-pbs and the circuit bootstrap don't support multi-bit keys
+    bool acceptable = sol.p_error < 1.0 && !sol.use_wop_pbs &&
+                      (std::isnan(config.global_p_error) ||
+                       sol.global_p_error <= config.global_p_error);
+    if (acceptable &&
+        (best.p_error == 1.0 || sol.complexity < best.complexity)) {
+      best = sol;
+      bestGroupingFactor = groupingFactor;
+    }
+  }
+  if (config.display && bestGroupingFactor > 1) {
+    llvm::errs() << "### Multi-bit bootstrap, grouping factor "
+                 << bestGroupingFactor << "\n";
   }
-  return optimize(options_from_config(config));
+  return {best, bestGroupingFactor};
 }
 
 constexpr double WARN_ABOVE_GLOBAL_ERROR_RATE = 1.0 / 1000.0;
@@ -313,6 +293,18 @@ toCompilerSolution(Solution solution, CompilationFeedback &feedback,
   return convertSolution(solution);
 }
 
+/// Sets the multi-bit grouping factor of the bootstrap of a converted
+/// mono-parameter `solution`.
+llvm::Expected<optimizer::Solution>
+withGroupingFactor(llvm::Expected<optimizer::Solution> solution,
+                   uint32_t groupingFactor) {
+  if (!solution) {
+    return solution;
+  }
+  std::get<V0Parameter>(*solution).brGroupingFactor = groupingFactor;
+  return solution;
+}
+
 // Returns an empty solution for non fhe programs
 optimizer::Solution emptySolution() {
   optimizer::CircuitSolution solution;
@@ -351,15 +343,23 @@ llvm::Expected<optimizer::Solution> getSolution(optimizer::Description &descr,
 
   switch (config.strategy) {
   case optimizer::Strategy::V0: {
-    auto sol = getV0Solution(descr.constraint, config);
+    auto [sol, groupingFactor] = getBestGroupingFactorSolution(
+        config, [&](uint32_t groupingFactor) {
+          return getV0Solution(descr.constraint, config, groupingFactor);
+        });
     displayOptimizer(sol, descr, config);
-    return toCompilerSolution(sol, feedback, config);
+    return withGroupingFactor(toCompilerSolution(sol, feedback, config),
+                              groupingFactor);
   }
   case optimizer::Strategy::DAG_MONO: {
     assert(descr.dag.has_value());
-    auto sol = getDagMonoSolution(descr.dag.value(), config);
+    auto [sol, groupingFactor] = getBestGroupingFactorSolution(
+        config, [&](uint32_t groupingFactor) {
+          return getDagMonoSolution(descr.dag.value(), config, groupingFactor);
+        });
     displayOptimizer(sol, descr, config);
-    return toCompilerSolution(sol, feedback, config);
+    return withGroupingFactor(toCompilerSolution(sol, feedback, config),
+                              groupingFactor);
   }
   case optimizer::Strategy::DAG_MULTI: {
     assert(descr.dag.has_value());
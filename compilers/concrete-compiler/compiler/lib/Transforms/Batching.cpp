@@ -266,7 +266,7 @@ static mlir::Value flattenTensor(mlir::ImplicitLocOpBuilder &builder,
   mlir::RankedTensorType type = v.getType().dyn_cast<mlir::RankedTensorType>();
   assert(type && "Value type is not a ranked tensor");
 
-  if (type.getShape().size() == 1) {
+  if (type.getShape().size() - trailingDimensions <= 1) {
     return v;
   } else {
     mlir::ReassociationIndices prefixCollapseGroup;
@@ -288,25 +288,40 @@ static mlir::Value flattenTensor(mlir::ImplicitLocOpBuilder &builder,
   }
 }
 
-// Returns a tensor with all the elements of the flat tensor `v`, but
-// shaped as a tensor with the type `targetType`.
+// Returns a tensor with all the elements of the tensor `v`, whose
+// first dimension is flat, but shaped as a tensor with the type
+// `targetType`. All dimensions of `v` but the first are kept as the
+// trailing dimensions of `targetType`.
 static mlir::Value unflattenTensor(mlir::ImplicitLocOpBuilder &builder,
                                    mlir::Value v,
                                    mlir::RankedTensorType targetType) {
   mlir::RankedTensorType type = v.getType().dyn_cast<mlir::RankedTensorType>();
-  assert(type && type.getShape().size() == 1 &&
-         "Value is not a tensor of rank 1");
+  assert(type && type.getShape().size() <= targetType.getShape().size() &&
+         "Value is not a ranked tensor with a flat first dimension");
 
-  if (targetType.getShape().size() == 1) {
+  unsigned trailingDimensions = type.getShape().size() - 1;
+
+  if (targetType.getShape().size() == type.getShape().size()) {
     return v;
   } else {
     mlir::ReassociationIndices expandGroup;
+    llvm::SmallVector<mlir::ReassociationIndices> expandGroups;
 
-    for (unsigned i = 0; i < targetType.getShape().size(); i++)
+    for (unsigned i = 0;
+         i < targetType.getShape().size() - trailingDimensions; i++)
       expandGroup.push_back(i);
 
-    return builder.create<mlir::tensor::ExpandShapeOp>(
-        targetType, v, llvm::ArrayRef{expandGroup});
+    expandGroups.push_back(expandGroup);
+
+    for (unsigned i = targetType.getShape().size() - trailingDimensions;
+         i < targetType.getShape().size(); i++) {
+      mlir::ReassociationIndices suffixGroup;
+      suffixGroup.push_back(i);
+      expandGroups.push_back(suffixGroup);
+    }
+
+    return builder.create<mlir::tensor::ExpandShapeOp>(targetType, v,
+                                                       expandGroups);
   }
 }
 
@@ -1765,23 +1780,26 @@ public:
       rewriter.replaceOpWithNewOp<mlir::tensor::ExtractOp>(
           targetOp, structuredBatchedResult, idxUse);
     } else {
+      // Extract the rank-reduced slice of the scalar result from the
+      // structured batch of results
       llvm::SmallVector<OpFoldResult> offsets =
           map(idxUse, getValueAsOpFoldResult);
-      llvm::SmallVector<OpFoldResult> strides(1, ilob2.getI64IntegerAttr(1));
-      llvm::SmallVector<OpFoldResult> sizes(1, ilob2.getI64IntegerAttr(1));
-
-      offsets.append(batchedResultType.getShape().size() - 1,
-                     ilob2.getI64IntegerAttr(0));
-      strides.append(batchedResultType.getShape().size() - 1,
-                     ilob2.getI64IntegerAttr(1));
-
-      for (int64_t dim : batchedResultType.getShape().take_front()) {
-        strides.push_back(ilob2.getI64IntegerAttr(dim));
+      llvm::SmallVector<OpFoldResult> strides(idxUse.size(),
+                                              ilob2.getI64IntegerAttr(1));
+      llvm::SmallVector<OpFoldResult> sizes(idxUse.size(),
+                                            ilob2.getI64IntegerAttr(1));
+
+      for (int64_t dim : structuredBatchedResultType.getShape().drop_front(
+               idxUse.size())) {
+        offsets.push_back(ilob2.getI64IntegerAttr(0));
+        strides.push_back(ilob2.getI64IntegerAttr(1));
         sizes.push_back(ilob2.getI64IntegerAttr(dim));
       }
 
       rewriter.replaceOpWithNewOp<mlir::tensor::ExtractSliceOp>(
-          targetOp, batchedResult, offsets, sizes, strides);
+          targetOp,
+          targetOp->getResult(0).getType().cast<mlir::RankedTensorType>(),
+          structuredBatchedResult, offsets, sizes, strides);
     }
 
     return mlir::success();
@@ -2066,6 +2084,7 @@ protected:
     return op->getNumResults() == 1 && mlir::isPure(op) &&
            llvm::TypeSwitch<mlir::Operation *, bool>(op)
                .Case<mlir::arith::AddIOp, mlir::arith::ExtSIOp,
+                     mlir::arith::MulIOp, mlir::arith::ShLIOp,
                      mlir::arith::ConstantOp>([](auto op) { return true; })
                .Default([](auto op) { return false; });
   }
@@ -2417,10 +2436,32 @@ private:
   int64_t maxBatchSize;
 };
 
+// Pass that only applies `ConstantDenseFoldingPattern`, such that the
+// encodings of the clear values extracted from constant tensors are computed
+// at compile time, whether the operations are batched or not
+class ConstantDenseFoldingPass
+    : public ConstantDenseFoldingBase<ConstantDenseFoldingPass> {
+public:
+  void runOnOperation() override {
+    mlir::Operation *op = getOperation();
+
+    mlir::RewritePatternSet patterns(op->getContext());
+    patterns.add<ConstantDenseFoldingPattern>(op->getContext());
+
+    if (mlir::applyPatternsAndFoldGreedily(op, std::move(patterns)).failed())
+      this->signalPassFailure();
+  }
+};
+
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
 createBatchingPass(int64_t maxBatchSize) {
   return std::make_unique<BatchingPass>(maxBatchSize);
 }
 
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createConstantDenseFoldingPass() {
+  return std::make_unique<ConstantDenseFoldingPass>();
+}
+
 } // namespace concretelang
 } // namespace mlir
@@ -0,0 +1,148 @@
+// Part of the Concrete Compiler Project, under the BSD3 License with Zama
+// Exceptions. See
+// https://github.com/zama-ai/concrete-compiler-internal/blob/main/LICENSE.txt
+// for license information.
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <mlir/Dialect/Func/IR/FuncOps.h>
+#include <mlir/Dialect/SCF/IR/SCF.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/IRMapping.h>
+#include <mlir/IR/Matchers.h>
+#include <mlir/Transforms/RegionUtils.h>
+
+#include <concretelang/Dialect/Concrete/IR/ConcreteTypes.h>
+#include <concretelang/Transforms/Passes.h>
+
+namespace {
+
+bool isLoop(mlir::Operation *op) {
+  return llvm::isa<mlir::scf::ForOp, mlir::scf::ParallelOp>(op);
+}
+
+/// Returns the number of operations nested in `op`, or `std::nullopt` if
+/// `op` or one of them prevents `op` from being outlined.
+std::optional<uint64_t> getOutlinableSize(mlir::Operation *op) {
+  // The outlining runs before the buffer deallocation, which cannot follow
+  // the ownership of the buffers returned by a call
+  if (llvm::any_of(op->getResultTypes(), [](mlir::Type type) {
+        return type.isa<mlir::MemRefType>();
+      }))
+    return std::nullopt;
+  uint64_t size = 0;
+  bool outlinable = true;
+  op->walk([&](mlir::Operation *nested) {
+    // The dataflow tasks are outlined by the runtime lowering
+    if (nested->getDialect() != nullptr &&
+        nested->getDialect()->getNamespace() == "RT")
+      outlinable = false;
+    size++;
+  });
+  if (!outlinable)
+    return std::nullopt;
+  return size;
+}
+
+/// Moves `loop` into a new private function of `module` named `name`, and
+/// replaces it by a call to this function. The values used by the loop and
+/// defined outside of it are passed as arguments, except for the constants
+/// which are cloned into the new function. The runtime context of `parent` is
+/// always passed, as the lowering of the Concrete operations looks it up in
+/// the enclosing function.
+void outlineLoop(mlir::ModuleOp module, mlir::func::FuncOp parent,
+                 mlir::Operation *loop, llvm::StringRef name) {
+  llvm::SetVector<mlir::Value> captured;
+  for (mlir::Value operand : loop->getOperands())
+    captured.insert(operand);
+  mlir::getUsedValuesDefinedAbove(loop->getRegions(), captured);
+  for (mlir::BlockArgument arg : parent.getArguments())
+    if (arg.getType().isa<mlir::concretelang::Concrete::ContextType>())
+      captured.insert(arg);
+
+  llvm::SmallVector<mlir::Value> arguments;
+  llvm::SmallVector<mlir::Operation *> constants;
+  for (mlir::Value value : captured) {
+    mlir::Operation *producer = value.getDefiningOp();
+    if (producer != nullptr && producer->getNumOperands() == 0 &&
+        mlir::matchPattern(producer, mlir::m_Constant()))
+      constants.push_back(producer);
+    else
+      arguments.push_back(value);
+  }
+
+  mlir::OpBuilder builder(module.getContext());
+  builder.setInsertionPointAfter(parent);
+  auto funcType = builder.getFunctionType(
+      mlir::ValueRange(arguments).getTypes(), loop->getResultTypes());
+  auto func =
+      builder.create<mlir::func::FuncOp>(loop->getLoc(), name, funcType);
+  func.setPrivate();
+
+  mlir::Block *body = func.addEntryBlock();
+  builder.setInsertionPointToStart(body);
+  mlir::IRMapping mapping;
+  mapping.map(arguments, body->getArguments());
+  for (mlir::Operation *constant : constants)
+    builder.clone(*constant, mapping);
+  mlir::Operation *outlined = builder.clone(*loop, mapping);
+  builder.create<mlir::func::ReturnOp>(loop->getLoc(), outlined->getResults());
+
+  builder.setInsertionPoint(loop);
+  auto call =
+      builder.create<mlir::func::CallOp>(loop->getLoc(), func, arguments);
+  loop->replaceAllUsesWith(call.getResults());
+  loop->erase();
+}
+
+/// Pass that outlines the large loops at the top level of the functions into
+/// separate functions, such that the function passes process them
+/// concurrently.
+class LoopOutliningPass : public LoopOutliningBase<LoopOutliningPass> {
+public:
+  LoopOutliningPass(uint64_t minOperations) : minOperations(minOperations) {}
+
+  void runOnOperation() override {
+    mlir::ModuleOp module = getOperation();
+
+    llvm::SmallVector<mlir::func::FuncOp> funcs(
+        module.getOps<mlir::func::FuncOp>());
+    for (mlir::func::FuncOp func : funcs) {
+      if (func.isDeclaration() || !func.getBody().hasOneBlock())
+        continue;
+
+      llvm::SmallVector<mlir::Operation *> loops;
+      for (mlir::Operation &op : func.getBody().front()) {
+        if (!isLoop(&op))
+          continue;
+        auto size = getOutlinableSize(&op);
+        if (size && *size >= minOperations)
+          loops.push_back(&op);
+      }
+
+      uint64_t index = 0;
+      for (mlir::Operation *loop : loops) {
+        std::string name;
+        do {
+          name = (func.getName() + "_loop_" + llvm::Twine(index++)).str();
+        } while (module.lookupSymbol(name) != nullptr);
+        outlineLoop(module, func, loop, name);
+      }
+    }
+  }
+
+private:
+  uint64_t minOperations;
+};
+
+} // namespace
+
+namespace mlir {
+namespace concretelang {
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>
+createLoopOutliningPass(uint64_t minOperations) {
+  return std::make_unique<LoopOutliningPass>(minOperations);
+}
+} // namespace concretelang
+} // namespace mlir
@@ -101,12 +101,44 @@ llvm::cl::opt<std::string> output("o",
 llvm::cl::opt<bool> verbose("verbose", llvm::cl::desc("verbose logs"),
                             llvm::cl::init<bool>(false));
 
+llvm::cl::opt<bool> emitCircuitLibraries(
+    "emit-circuit-libraries",
+    llvm::cl::desc("Emit one object and one shared library per circuit, "
+                   "reusing the objects of the unchanged circuits"),
+    llvm::cl::init<bool>(false));
+
 llvm::cl::opt<bool>
     optimizeTFHE("optimize-tfhe",
                  llvm::cl::desc("enable/disable optimizations of TFHE "
                                 "dialects. (Enabled by default)"),
                  llvm::cl::init<bool>(true));
 
+llvm::cl::opt<bool> composeLookupTables(
+    "compose-lookup-tables",
+    llvm::cl::desc("enable/disable composition, folding and removal of table "
+                   "lookups with constant tables. (Enabled by default)"),
+    llvm::cl::init<bool>(true));
+
+llvm::cl::opt<bool> minimizeBitWidths(
+    "minimize-bit-widths",
+    llvm::cl::desc("enable/disable the shrinking of encrypted integers to the "
+                   "ranges of their values. (Enabled by default)"),
+    llvm::cl::init<bool>(true));
+
+llvm::cl::opt<bool> foldConstantEncodings(
+    "fold-constant-encodings",
+    llvm::cl::desc("enable/disable the encoding of the clear values extracted "
+                   "from constant tensors at compile time. (Enabled by "
+                   "default)"),
+    llvm::cl::init<bool>(true));
+
+llvm::cl::opt<bool> winogradConv2d(
+    "winograd-conv2d",
+    llvm::cl::desc("enable/disable the Winograd form of 3x3 convolutions with "
+                   "clear weights when the noise bounds allow it. (Disabled "
+                   "by default)"),
+    llvm::cl::init<bool>(false));
+
 llvm::cl::opt<bool>
     simulate("simulate",
              llvm::cl::desc("enable/disable simulation of crypto operations "
@@ -125,6 +157,11 @@ llvm::cl::opt<bool>
                                   "evaluation keys and ciphertexts"),
                    llvm::cl::init<bool>(false));
 
+llvm::cl::opt<bool> compressOutputs(
+    "compress-outputs",
+    llvm::cl::desc("Modulus switch and bit-pack the output ciphertexts"),
+    llvm::cl::init<bool>(false));
+
 llvm::cl::list<std::string> passes(
     "passes",
     llvm::cl::desc("Specify the passes to run (use only for compiler tests)"),
@@ -205,6 +242,18 @@ llvm::cl::opt<int64_t>
                                 "batch for --batch-tfhe-ops"),
                  llvm::cl::init(std::numeric_limits<int64_t>::max()));
 
+llvm::cl::opt<bool> multithreadPasses(
+    "multithread-passes",
+    llvm::cl::desc("Run the passes on the functions of the module in parallel"),
+    llvm::cl::init(false));
+
+llvm::cl::opt<uint64_t> loopOutliningThreshold(
+    "loop-outlining-threshold",
+    llvm::cl::desc("Outline the top-level loops with at least this many "
+                   "operations into separate functions before bufferized "
+                   "lowering, 0 disables the outlining"),
+    llvm::cl::init(0));
+
 llvm::cl::opt<bool> emitSDFGOps(
     "emit-sdfg-ops",
     llvm::cl::desc(
@@ -234,6 +283,13 @@ llvm::cl::opt<bool>
                                  "not, default is false (to not chunk)"),
                   llvm::cl::init<bool>(false));
 
+llvm::cl::opt<bool> chunkIntegersByCost(
+    "chunk-integers-by-cost",
+    llvm::cl::desc("Whether to decompose integer into chunks only if the "
+                   "optimizer finds cheaper parameters for the chunked "
+                   "circuit, default is false"),
+    llvm::cl::init<bool>(false));
+
 llvm::cl::opt<unsigned int> chunkSize(
     "chunk-size",
     llvm::cl::desc(
@@ -292,6 +348,35 @@ llvm::cl::opt<bool> optimizerKeySharing(
         "To enable/disable key sharing in dag-multi parameter strategy"),
     llvm::cl::init(optimizer::DEFAULT_KEY_SHARING));
 
+llvm::cl::opt<unsigned> optimizerMaxManyLutCount(
+    "optimizer-max-many-lut-count",
+    llvm::cl::desc("Maximal number of lookup tables on the same input "
+                   "evaluated by a single bootstrap (power of two, 1 disables "
+                   "the many-lut bootstrap)"),
+    llvm::cl::init(optimizer::DEFAULT_MAX_MANY_LUT_COUNT));
+
+llvm::cl::opt<unsigned> optimizerMaxMultiBitGroupingFactor(
+    "optimizer-max-multi-bit-grouping-factor",
+    llvm::cl::desc("Maximal grouping factor of the multi-bit bootstrap the "
+                   "optimizer can choose, between 1 and 4 (1 disables the "
+                   "multi-bit bootstrap)"),
+    llvm::cl::init(optimizer::DEFAULT_MAX_MULTI_BIT_GROUPING_FACTOR));
+
+llvm::cl::opt<unsigned> smallLweCiphertextModulusLog(
+    "small-lwe-ciphertext-modulus-log",
+    llvm::cl::desc("Log2 of the ciphertext modulus of the LWE ciphertexts "
+                   "between a keyswitch and a bootstrap, 32 to store them on "
+                   "32 bits or 64 (CPU and dag-mono/V0 optimizer only)"),
+    llvm::cl::init(optimizer::DEFAULT_SMALL_LWE_CIPHERTEXT_MODULUS_LOG));
+
+llvm::cl::opt<std::string> optimizerComplexityModel(
+    "optimizer-complexity-model",
+    llvm::cl::desc("Rank the crypto parameters with the host-calibrated "
+                   "complexity model written at this path by the concrete-cpu "
+                   "calibration tool, instead of the analytic model"),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::init(optimizer::DEFAULT_COMPLEXITY_MODEL_PATH));
+
 llvm::cl::opt<double> fallbackLogNormWoppbs(
     "optimizer-fallback-log-norm-woppbs",
     llvm::cl::desc("Select a fallback value for multisum log norm in woppbs "
@@ -393,14 +478,23 @@ cmdlineCompilationOptions() {
   options.dataflowParallelize = cmdline::dataflowParallelize;
   options.batchTFHEOps = cmdline::batchTFHEOps;
   options.maxBatchSize = cmdline::maxBatchSize;
+  options.multithreadPasses = cmdline::multithreadPasses;
+  options.loopOutliningThreshold = cmdline::loopOutliningThreshold;
   options.emitSDFGOps = cmdline::emitSDFGOps;
   options.unrollLoopsWithSDFGConvertibleOps =
       cmdline::unrollLoopsWithSDFGConvertibleOps;
   options.optimizeTFHE = cmdline::optimizeTFHE;
+  options.composeLookupTables = cmdline::composeLookupTables;
+  options.minimizeBitWidths = cmdline::minimizeBitWidths;
+  options.foldConstantEncodings = cmdline::foldConstantEncodings;
+  options.winogradConv2d = cmdline::winogradConv2d;
   options.simulate = cmdline::simulate;
   options.emitGPUOps = cmdline::emitGPUOps;
   options.compressInputs = cmdline::compressInputs;
+  options.compressOutputs = cmdline::compressOutputs;
+  options.emitCircuitLibraries = cmdline::emitCircuitLibraries;
   options.chunkIntegers = cmdline::chunkIntegers;
+  options.chunkIntegersByCost = cmdline::chunkIntegersByCost;
   options.chunkSize = cmdline::chunkSize;
   options.chunkWidth = cmdline::chunkWidth;
 
@@ -478,6 +572,14 @@ cmdlineCompilationOptions() {
   options.optimizerConfig.display = cmdline::displayOptimizerChoice;
   options.optimizerConfig.strategy = cmdline::optimizerStrategy;
   options.optimizerConfig.key_sharing = cmdline::optimizerKeySharing;
+  options.optimizerConfig.max_many_lut_count =
+      cmdline::optimizerMaxManyLutCount;
+  options.optimizerConfig.max_multi_bit_grouping_factor =
+      cmdline::optimizerMaxMultiBitGroupingFactor;
+  options.optimizerConfig.small_lwe_ciphertext_modulus_log =
+      cmdline::smallLweCiphertextModulusLog;
+  options.optimizerConfig.complexity_model_path =
+      cmdline::optimizerComplexityModel;
   options.optimizerConfig.encoding = cmdline::optimizerEncoding;
   options.optimizerConfig.cache_on_disk = !cmdline::optimizerNoCacheOnDisk;
 
@@ -488,6 +590,20 @@ cmdlineCompilationOptions() {
         llvm::inconvertibleErrorCode());
   }
 
+  if (cmdline::optimizerMaxMultiBitGroupingFactor < 1 ||
+      cmdline::optimizerMaxMultiBitGroupingFactor > 4) {
+    return llvm::make_error<llvm::StringError>(
+        "--optimizer-max-multi-bit-grouping-factor must be between 1 and 4",
+        llvm::inconvertibleErrorCode());
+  }
+
+  if (cmdline::smallLweCiphertextModulusLog != 32 &&
+      cmdline::smallLweCiphertextModulusLog != 64) {
+    return llvm::make_error<llvm::StringError>(
+        "--small-lwe-ciphertext-modulus-log must be 32 or 64",
+        llvm::inconvertibleErrorCode());
+  }
+
   if (!cmdline::circuitEncodings.empty()) {
     auto jsonString = cmdline::circuitEncodings.getValue();
     auto encodings = Message<concreteprotocol::CircuitEncodingInfo>();
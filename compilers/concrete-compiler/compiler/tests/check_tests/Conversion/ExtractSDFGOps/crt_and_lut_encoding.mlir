@@ -0,0 +1,47 @@
+// RUN: concretecompiler --split-input-file --passes extract-sdfg-ops --emit-sdfg-ops --action=dump-sdfg %s 2>&1| FileCheck %s
+
+// The encoding of the lookup table is part of the data flow graph, such
+// that only the lookup table itself is sent by the host
+// CHECK-LABEL: func.func @bootstrap_with_lut_encoding
+// CHECK: %[[DFG:.*]] = "SDFG.init"()
+// CHECK: %[[ACC:.*]] = "SDFG.make_stream"(%[[DFG]]) {{.*}}type = #SDFG.stream_kind<on_device>} : (!SDFG.dfg) -> !SDFG.stream<tensor<2048xi64>>
+// CHECK: %[[LUT:.*]] = "SDFG.make_stream"(%[[DFG]]) {{.*}}type = #SDFG.stream_kind<host_to_device>} : (!SDFG.dfg) -> !SDFG.stream<tensor<4xi64>>
+// CHECK: "SDFG.make_process"(%[[DFG]], %[[LUT]], %[[ACC]]) {{.*}}type = #SDFG.process_kind<encode_expand_lut_for_bootstrap>
+// CHECK: "SDFG.make_process"(%[[DFG]], %{{.*}}, %[[ACC]], %{{.*}}) {{.*}}type = #SDFG.process_kind<bootstrap>
+// CHECK-NOT: "Concrete.encode_expand_lut_for_bootstrap_tensor"
+// CHECK-NOT: "Concrete.bootstrap_lwe_tensor"
+func.func @bootstrap_with_lut_encoding(%arg0: tensor<751xi64>) -> tensor<2049xi64> {
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%arg0, %0) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<751xi64>, tensor<2048xi64>) -> tensor<2049xi64>
+  return %1 : tensor<2049xi64>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @wop_pbs_crt
+// CHECK: %[[DFG:.*]] = "SDFG.init"()
+// CHECK: %[[LUTS:.*]] = "SDFG.make_stream"(%[[DFG]]) {{.*}}type = #SDFG.stream_kind<on_device>} : (!SDFG.dfg) -> !SDFG.stream<tensor<5x8192xi64>>
+// CHECK: "SDFG.make_process"(%[[DFG]], %{{.*}}, %[[LUTS]]) {{.*}}type = #SDFG.process_kind<encode_lut_for_crt_woppbs>
+// CHECK: %[[CT:.*]] = "SDFG.make_stream"(%[[DFG]]) {{.*}}type = #SDFG.stream_kind<host_to_device>} : (!SDFG.dfg) -> !SDFG.stream<tensor<5x2049xi64>>
+// CHECK: "SDFG.make_process"(%[[DFG]], %[[CT]], %[[LUTS]], %{{.*}}) {{.*}}type = #SDFG.process_kind<wop_pbs_crt>
+// CHECK-NOT: "Concrete.encode_lut_for_crt_woppbs_tensor"
+// CHECK-NOT: "Concrete.wop_pbs_crt_lwe_tensor"
+func.func @wop_pbs_crt(%arg0: tensor<5x2049xi64>) -> tensor<5x2049xi64> {
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "Concrete.encode_lut_for_crt_woppbs_tensor"(%lut) {crtBits = [1, 2, 3, 3, 4], crtDecomposition = [2, 3, 5, 7, 11], isSigned = false, modulusProduct = 2310 : i32} : (tensor<4xi64>) -> tensor<5x8192xi64>
+  %1 = "Concrete.wop_pbs_crt_lwe_tensor"(%arg0, %0) {bootstrapBaseLog = 23 : i32, bootstrapLevel = 1 : i32, bskIndex = -1 : i32, circuitBootstrapBaseLog = 10 : i32, circuitBootstrapLevel = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], keyswitchBaseLog = 4 : i32, keyswitchLevel = 3 : i32, kskIndex = -1 : i32, packingKeySwitchBaseLog = 15 : i32, packingKeySwitchInputLweDimension = 750 : i32, packingKeySwitchLevel = 1 : i32, packingKeySwitchoutputPolynomialSize = 2048 : i32, pkskIndex = -1 : i32} : (tensor<5x2049xi64>, tensor<5x8192xi64>) -> tensor<5x2049xi64>
+  return %1 : tensor<5x2049xi64>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @encode_plaintext_with_crt
+// CHECK: %[[DFG:.*]] = "SDFG.init"()
+// CHECK: %[[IN:.*]] = "SDFG.make_stream"(%[[DFG]]) {{.*}}type = #SDFG.stream_kind<host_to_device>} : (!SDFG.dfg) -> !SDFG.stream<i64>
+// CHECK: "SDFG.make_process"(%[[DFG]], %[[IN]], %{{.*}}) {{.*}}type = #SDFG.process_kind<encode_plaintext_with_crt>
+// CHECK-NOT: "Concrete.encode_plaintext_with_crt_tensor"
+func.func @encode_plaintext_with_crt(%arg0: i64) -> tensor<5xi64> {
+  %0 = "Concrete.encode_plaintext_with_crt_tensor"(%arg0) {mods = [2, 3, 5, 7, 11], modsProd = 2310 : i64} : (i64) -> tensor<5xi64>
+  return %0 : tensor<5xi64>
+}
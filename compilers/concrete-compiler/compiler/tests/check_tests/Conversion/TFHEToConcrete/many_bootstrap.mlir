@@ -0,0 +1,12 @@
+// RUN: concretecompiler --passes tfhe-to-concrete --action=dump-concrete %s 2>&1| FileCheck %s
+
+//CHECK: func.func @many_bootstrap_lwe(%[[A0:.*]]: tensor<601xi64>, %[[A1:.*]]: tensor<1024xi64>) -> (tensor<1025xi64>, tensor<1025xi64>) {
+//CHECK-NEXT:   %[[V0:.*]] = "Concrete.many_bootstrap_lwe_tensor"(%[[A0]], %[[A1]]) {baseLog = 1 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 600 : i32, level = 3 : i32, lutSize = 4 : i32, polySize = 1024 : i32} : (tensor<601xi64>, tensor<1024xi64>) -> tensor<2x1025xi64>
+//CHECK-NEXT:   %[[V1:.*]] = tensor.extract_slice %[[V0]][0, 0] [1, 1025] [1, 1] : tensor<2x1025xi64> to tensor<1025xi64>
+//CHECK-NEXT:   %[[V2:.*]] = tensor.extract_slice %[[V0]][1, 0] [1, 1025] [1, 1] : tensor<2x1025xi64> to tensor<1025xi64>
+//CHECK-NEXT:   return %[[V1]], %[[V2]] : tensor<1025xi64>, tensor<1025xi64>
+//CHECK-NEXT: }
+func.func @many_bootstrap_lwe(%ciphertext: !TFHE.glwe<sk[1]<1,600>>, %acc: tensor<1024xi64>) -> (!TFHE.glwe<sk[5]<1,1024>>, !TFHE.glwe<sk[5]<1,1024>>) {
+  %bootstraped:2 = "TFHE.many_bootstrap_glwe"(%ciphertext, %acc) {key = #TFHE.bsk<sk[1]<1,600>, sk[1]<1,1024>, 1024, 1, 3, 1>, lutSize = 4 : i32}: (!TFHE.glwe<sk[1]<1,600>>, tensor<1024xi64>) -> (!TFHE.glwe<sk[5]<1,1024>>, !TFHE.glwe<sk[5]<1,1024>>)
+  return %bootstraped#0, %bootstraped#1 : !TFHE.glwe<sk[5]<1,1024>>, !TFHE.glwe<sk[5]<1,1024>>
+}
@@ -0,0 +1,26 @@
+// RUN: concretecompiler --split-input-file --passes tfhe-to-concrete --action=dump-concrete --small-lwe-ciphertext-modulus-log=32 %s 2>&1| FileCheck %s
+
+// The ciphertexts between the keyswitch and the bootstrap are stored on 32 bits
+// CHECK-LABEL: func.func @keyswitch_bootstrap(%arg0: tensor<1025xi64>) -> tensor<1025xi64>
+// CHECK:       "Concrete.keyswitch_lwe_tensor"(%arg0) {{.*}} : (tensor<1025xi64>) -> tensor<601xi32>
+// CHECK:       "Concrete.bootstrap_lwe_tensor"(%{{.*}}, %{{.*}}) {{.*}} : (tensor<601xi32>, tensor<128xi64>) -> tensor<1025xi64>
+func.func @keyswitch_bootstrap(%arg0: !TFHE.glwe<sk[0]<1,1024>>) -> !TFHE.glwe<sk[0]<1,1024>> {
+  %cst = arith.constant dense<0> : tensor<128xi64>
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[0]<1,1024>, sk[1]<1,600>, 2, 3>} : (!TFHE.glwe<sk[0]<1,1024>>) -> !TFHE.glwe<sk[1]<1,600>>
+  %1 = "TFHE.bootstrap_glwe"(%0, %cst) {key = #TFHE.bsk<sk[1]<1,600>, sk[0]<1,1024>, 1024, 1, 3, 1>} : (!TFHE.glwe<sk[1]<1,600>>, tensor<128xi64>) -> !TFHE.glwe<sk[0]<1,1024>>
+  return %1 : !TFHE.glwe<sk[0]<1,1024>>
+}
+
+// -----
+
+// The ciphertexts of a small key used by a levelled operation keep 64 bits
+// CHECK-LABEL: func.func @keyswitch_add_bootstrap(%arg0: tensor<1025xi64>) -> tensor<1025xi64>
+// CHECK:       "Concrete.keyswitch_lwe_tensor"(%arg0) {{.*}} : (tensor<1025xi64>) -> tensor<601xi64>
+// CHECK:       "Concrete.bootstrap_lwe_tensor"(%{{.*}}, %{{.*}}) {{.*}} : (tensor<601xi64>, tensor<128xi64>) -> tensor<1025xi64>
+func.func @keyswitch_add_bootstrap(%arg0: !TFHE.glwe<sk[0]<1,1024>>) -> !TFHE.glwe<sk[0]<1,1024>> {
+  %cst = arith.constant dense<0> : tensor<128xi64>
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[0]<1,1024>, sk[1]<1,600>, 2, 3>} : (!TFHE.glwe<sk[0]<1,1024>>) -> !TFHE.glwe<sk[1]<1,600>>
+  %1 = "TFHE.add_glwe"(%0, %0) : (!TFHE.glwe<sk[1]<1,600>>, !TFHE.glwe<sk[1]<1,600>>) -> !TFHE.glwe<sk[1]<1,600>>
+  %2 = "TFHE.bootstrap_glwe"(%1, %cst) {key = #TFHE.bsk<sk[1]<1,600>, sk[0]<1,1024>, 1024, 1, 3, 1>} : (!TFHE.glwe<sk[1]<1,600>>, tensor<128xi64>) -> !TFHE.glwe<sk[0]<1,1024>>
+  return %2 : !TFHE.glwe<sk[0]<1,1024>>
+}
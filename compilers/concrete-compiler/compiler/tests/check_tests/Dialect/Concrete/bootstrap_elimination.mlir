@@ -0,0 +1,71 @@
+// RUN: concretecompiler --split-input-file --passes concrete-bootstrap-elimination --action=dump-concrete %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @common_bootstrap
+// CHECK: %[[KS:.*]] = "Concrete.keyswitch_lwe_tensor"(%arg0)
+// CHECK: %[[BS:.*]] = "Concrete.bootstrap_lwe_tensor"(%[[KS]], %{{.*}})
+// CHECK-NOT: "Concrete.keyswitch_lwe_tensor"
+// CHECK-NOT: "Concrete.bootstrap_lwe_tensor"
+// CHECK: %[[ADD:.*]] = "Concrete.add_lwe_tensor"(%[[BS]], %[[BS]])
+// CHECK: return %[[ADD]]
+func.func @common_bootstrap(%arg0: tensor<2049xi64>) -> tensor<2049xi64> {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut0) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %1 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, level = 3 : i32, lwe_dim_in = 2048 : i32, lwe_dim_out = 750 : i32, kskIndex = -1 : i32} : (tensor<2049xi64>) -> tensor<751xi64>
+  %2 = "Concrete.bootstrap_lwe_tensor"(%1, %0) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<751xi64>, tensor<2048xi64>) -> tensor<2049xi64>
+  %lut1 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %3 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut1) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %4 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, level = 3 : i32, lwe_dim_in = 2048 : i32, lwe_dim_out = 750 : i32, kskIndex = -1 : i32} : (tensor<2049xi64>) -> tensor<751xi64>
+  %5 = "Concrete.bootstrap_lwe_tensor"(%4, %3) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<751xi64>, tensor<2048xi64>) -> tensor<2049xi64>
+  %6 = "Concrete.add_lwe_tensor"(%2, %5) : (tensor<2049xi64>, tensor<2049xi64>) -> tensor<2049xi64>
+  return %6 : tensor<2049xi64>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @different_lookup_tables
+// CHECK: "Concrete.bootstrap_lwe_tensor"
+// CHECK: "Concrete.bootstrap_lwe_tensor"
+func.func @different_lookup_tables(%arg0: tensor<751xi64>) -> (tensor<2049xi64>, tensor<2049xi64>) {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut0) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %1 = "Concrete.bootstrap_lwe_tensor"(%arg0, %0) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<751xi64>, tensor<2048xi64>) -> tensor<2049xi64>
+  %lut1 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %2 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut1) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %3 = "Concrete.bootstrap_lwe_tensor"(%arg0, %2) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<751xi64>, tensor<2048xi64>) -> tensor<2049xi64>
+  return %1, %3 : tensor<2049xi64>, tensor<2049xi64>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @dead_bootstrap
+// CHECK-NOT: "Concrete.keyswitch_lwe_tensor"
+// CHECK-NOT: "Concrete.bootstrap_lwe_tensor"
+// CHECK: return %arg0
+func.func @dead_bootstrap(%arg0: tensor<2049xi64>) -> tensor<2049xi64> {
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %1 = "Concrete.keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, level = 3 : i32, lwe_dim_in = 2048 : i32, lwe_dim_out = 750 : i32, kskIndex = -1 : i32} : (tensor<2049xi64>) -> tensor<751xi64>
+  %2 = "Concrete.bootstrap_lwe_tensor"(%1, %0) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<751xi64>, tensor<2048xi64>) -> tensor<2049xi64>
+  return %arg0 : tensor<2049xi64>
+}
+
+// -----
+
+// Only the rows 1 and 2 of the batch are used, both the batched bootstrap
+// and the batched keyswitch computing its input are narrowed to them
+// CHECK-LABEL: func.func @narrow_batch
+// CHECK: %[[IN:.*]] = tensor.extract_slice %arg0[1, 0] [2, 2049] [1, 1] : tensor<4x2049xi64> to tensor<2x2049xi64>
+// CHECK: %[[KS:.*]] = "Concrete.batched_keyswitch_lwe_tensor"(%[[IN]]) {{.*}} : (tensor<2x2049xi64>) -> tensor<2x751xi64>
+// CHECK: %[[BS:.*]] = "Concrete.batched_bootstrap_lwe_tensor"(%[[KS]], %{{.*}}) {{.*}} : (tensor<2x751xi64>, tensor<2048xi64>) -> tensor<2x2049xi64>
+// CHECK: %[[R0:.*]] = tensor.extract_slice %[[BS]][0, 0] [1, 2049] [1, 1] : tensor<2x2049xi64> to tensor<2049xi64>
+// CHECK: %[[R1:.*]] = tensor.extract_slice %[[BS]][1, 0] [1, 2049] [1, 1] : tensor<2x2049xi64> to tensor<2049xi64>
+// CHECK: return %[[R0]], %[[R1]]
+func.func @narrow_batch(%arg0: tensor<4x2049xi64>) -> (tensor<2049xi64>, tensor<2049xi64>) {
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "Concrete.encode_expand_lut_for_bootstrap_tensor"(%lut) {isSigned = false, outputBits = 3 : i32, polySize = 2048 : i32} : (tensor<4xi64>) -> tensor<2048xi64>
+  %1 = "Concrete.batched_keyswitch_lwe_tensor"(%arg0) {baseLog = 2 : i32, level = 3 : i32, lwe_dim_in = 2048 : i32, lwe_dim_out = 750 : i32, kskIndex = -1 : i32} : (tensor<4x2049xi64>) -> tensor<4x751xi64>
+  %2 = "Concrete.batched_bootstrap_lwe_tensor"(%1, %0) {baseLog = 23 : i32, bskIndex = -1 : i32, glweDimension = 1 : i32, inputLweDim = 750 : i32, level = 1 : i32, polySize = 2048 : i32} : (tensor<4x751xi64>, tensor<2048xi64>) -> tensor<4x2049xi64>
+  %3 = tensor.extract_slice %2[1, 0] [1, 2049] [1, 1] : tensor<4x2049xi64> to tensor<2049xi64>
+  %4 = tensor.extract_slice %2[2, 0] [1, 2049] [1, 1] : tensor<4x2049xi64> to tensor<2049xi64>
+  return %3, %4 : tensor<2049xi64>, tensor<2049xi64>
+}
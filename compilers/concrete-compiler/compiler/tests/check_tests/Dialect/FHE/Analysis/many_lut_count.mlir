@@ -0,0 +1,20 @@
+// RUN: concretecompiler --compose-lookup-tables=false --action=dump-fhe --optimizer-max-many-lut-count=4 %s 2>&1| FileCheck %s
+
+// Only the lookup tables with a constant table are grouped, by power of two
+// groups in block order: the third constant lookup table and the lookup table
+// with a non-constant table are not budgeted for a many-lut bootstrap
+// CHECK-LABEL: func.func @many_lut_count
+// CHECK: "FHE.apply_lookup_table"(%arg0, %{{.*}}) {{.*}}"TFHE.manyLut" = 2 : i32
+// CHECK-NEXT: "FHE.apply_lookup_table"(%arg0, %arg1) {{(\{"TFHE.OId" = [^}]*\} )?}}: (
+// CHECK-NEXT: "FHE.apply_lookup_table"(%arg0, %{{.*}}) {{.*}}"TFHE.manyLut" = 2 : i32
+// CHECK-NEXT: "FHE.apply_lookup_table"(%arg0, %{{.*}}) {{(\{"TFHE.OId" = [^}]*\} )?}}: (
+func.func @many_lut_count(%arg0: !FHE.eint<2>, %arg1: tensor<4xi64>) -> (!FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>) {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %lut2 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %lut3 = arith.constant dense<[0, 0, 1, 1]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %lut0): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %arg1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %2 = "FHE.apply_lookup_table"(%arg0, %lut2): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %3 = "FHE.apply_lookup_table"(%arg0, %lut3): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %0, %1, %2, %3 : !FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>, !FHE.eint<2>
+}
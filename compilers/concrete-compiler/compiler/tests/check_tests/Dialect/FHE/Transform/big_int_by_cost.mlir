@@ -0,0 +1,21 @@
+// RUN: concretecompiler --split-input-file --chunk-integers-by-cost --chunk-size 4 --chunk-width 2 --action=dump-fhe %s 2>&1| FileCheck %s
+
+// The native encoding of the addition needs no bootstrap, it is cheaper than
+// the propagation of the carries between chunks
+// CHECK-LABEL: func.func @add_native_eint(%arg0: !FHE.eint<8>, %arg1: !FHE.eint<8>) -> !FHE.eint<8>
+// CHECK-NEXT:  %[[V0:.*]] = "FHE.add_eint"(%arg0, %arg1) : (!FHE.eint<8>, !FHE.eint<8>) -> !FHE.eint<8>
+// CHECK-NEXT:  return %[[V0]] : !FHE.eint<8>
+func.func @add_native_eint(%arg0: !FHE.eint<8>, %arg1: !FHE.eint<8>) -> !FHE.eint<8> {
+  %0 = "FHE.add_eint"(%arg0, %arg1) : (!FHE.eint<8>, !FHE.eint<8>) -> !FHE.eint<8>
+  return %0 : !FHE.eint<8>
+}
+
+// -----
+
+// There is no parameter for the native or CRT encoding of 64 bits integers,
+// only for their chunks
+// CHECK-LABEL: func.func @add_chunked_eint(%arg0: tensor<32x!FHE.eint<4>>, %arg1: tensor<32x!FHE.eint<4>>) -> tensor<32x!FHE.eint<4>>
+func.func @add_chunked_eint(%arg0: !FHE.eint<64>, %arg1: !FHE.eint<64>) -> !FHE.eint<64> {
+  %0 = "FHE.add_eint"(%arg0, %arg1) : (!FHE.eint<64>, !FHE.eint<64>) -> !FHE.eint<64>
+  return %0 : !FHE.eint<64>
+}
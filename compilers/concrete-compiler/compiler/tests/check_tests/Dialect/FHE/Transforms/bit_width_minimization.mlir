@@ -0,0 +1,111 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-bit-width-minimization %s 2>&1 | FileCheck %s
+
+// CHECK:      func.func @shrink_lookup_result(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<4> {
+// CHECK-NEXT:   %[[v0:.*]] = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+// CHECK-NEXT:   %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %[[v0]]) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   %[[v2:.*]] = arith.constant dense<[0, 3, 6, 9]> : tensor<4xi64>
+// CHECK-NEXT:   %[[v3:.*]] = "FHE.apply_lookup_table"(%[[v1]], %[[v2]]) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<4>
+// CHECK-NEXT:   return %[[v3]] : !FHE.eint<4>
+// CHECK-NEXT: }
+func.func @shrink_lookup_result(%arg0: !FHE.eint<2>) -> !FHE.eint<4> {
+  %t1 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<4>)
+  %t2 = arith.constant dense<[0, 3, 6, 9, 12, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]> : tensor<16xi64>
+  %1 = "FHE.apply_lookup_table"(%0, %t2): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<4>)
+  return %1: !FHE.eint<4>
+}
+
+// -----
+
+// CHECK:      func.func @shrink_leveled(%[[a0:.*]]: !FHE.eint<3>) -> !FHE.eint<3> {
+// CHECK-NEXT:   %[[v0:.*]] = arith.constant dense<[0, 1, 0, 1, 0, 1, 0, 1]> : tensor<8xi64>
+// CHECK-NEXT:   %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %[[v0]]) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+// CHECK-NEXT:   %[[v2:.*]] = arith.constant 1 : i4
+// CHECK-NEXT:   %[[v3:.*]] = "FHE.add_eint_int"(%[[v1]], %[[v2]]) : (!FHE.eint<3>, i4) -> !FHE.eint<3>
+// CHECK-NEXT:   %[[v4:.*]] = arith.constant 3 : i4
+// CHECK-NEXT:   %[[v5:.*]] = "FHE.mul_eint_int"(%[[v3]], %[[v4]]) : (!FHE.eint<3>, i4) -> !FHE.eint<3>
+// CHECK-NEXT:   %[[v6:.*]] = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xi64>
+// CHECK-NEXT:   %[[v7:.*]] = "FHE.apply_lookup_table"(%[[v5]], %[[v6]]) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<3>
+// CHECK-NEXT:   return %[[v7]] : !FHE.eint<3>
+// CHECK-NEXT: }
+func.func @shrink_leveled(%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %t1 = arith.constant dense<[0, 1, 0, 1, 0, 1, 0, 1]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<4>)
+  %c1 = arith.constant 1 : i5
+  %1 = "FHE.add_eint_int"(%0, %c1): (!FHE.eint<4>, i5) -> (!FHE.eint<4>)
+  %c3 = arith.constant 3 : i5
+  %2 = "FHE.mul_eint_int"(%1, %c3): (!FHE.eint<4>, i5) -> (!FHE.eint<4>)
+  %t2 = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7]> : tensor<16xi64>
+  %3 = "FHE.apply_lookup_table"(%2, %t2): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<3>)
+  return %3: !FHE.eint<3>
+}
+
+// -----
+
+// The multiplication is lowered to lookups on the sum and on the difference
+// of its operands, which need 2 bits
+// CHECK:      func.func @shrink_mul_eint(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<2> {
+// CHECK:        %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   %[[v2:.*]] = "FHE.apply_lookup_table"(%[[a0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   %[[v3:.*]] = "FHE.mul_eint"(%[[v1]], %[[v2]]) : (!FHE.eint<2>, !FHE.eint<2>) -> !FHE.eint<2>
+// CHECK-NEXT:   %[[v4:.*]] = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+// CHECK-NEXT:   %[[v5:.*]] = "FHE.apply_lookup_table"(%[[v3]], %[[v4]]) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   return %[[v5]] : !FHE.eint<2>
+// CHECK-NEXT: }
+func.func @shrink_mul_eint(%arg0: !FHE.eint<2>) -> !FHE.eint<2> {
+  %t1 = arith.constant dense<[0, 1, 1, 0]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<4>)
+  %1 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<4>)
+  %2 = "FHE.mul_eint"(%0, %1): (!FHE.eint<4>, !FHE.eint<4>) -> (!FHE.eint<4>)
+  %t2 = arith.constant dense<[0, 1, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3]> : tensor<16xi64>
+  %3 = "FHE.apply_lookup_table"(%2, %t2): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<2>)
+  return %3: !FHE.eint<2>
+}
+
+// -----
+
+// CHECK:      func.func @shrink_dot(%[[a0:.*]]: tensor<4x!FHE.eint<2>>) -> !FHE.eint<2> {
+// CHECK:        %[[v1:.*]] = "FHELinalg.apply_lookup_table"(%[[a0]], %{{.*}}) : (tensor<4x!FHE.eint<2>>, tensor<4xi64>) -> tensor<4x!FHE.eint<3>>
+// CHECK-NEXT:   %[[v2:.*]] = arith.constant dense<[1, 2, 3, 1]> : tensor<4xi4>
+// CHECK-NEXT:   %[[v3:.*]] = "FHELinalg.dot_eint_int"(%[[v1]], %[[v2]]) : (tensor<4x!FHE.eint<3>>, tensor<4xi4>) -> !FHE.eint<3>
+// CHECK-NEXT:   %[[v4:.*]] = arith.constant dense<[0, 0, 1, 1, 2, 2, 3, 3]> : tensor<8xi64>
+// CHECK-NEXT:   %[[v5:.*]] = "FHE.apply_lookup_table"(%[[v3]], %[[v4]]) : (!FHE.eint<3>, tensor<8xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   return %[[v5]] : !FHE.eint<2>
+// CHECK-NEXT: }
+func.func @shrink_dot(%arg0: tensor<4x!FHE.eint<2>>) -> !FHE.eint<2> {
+  %t1 = arith.constant dense<[0, 1, 1, 0]> : tensor<4xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %t1): (tensor<4x!FHE.eint<2>>, tensor<4xi64>) -> tensor<4x!FHE.eint<4>>
+  %w = arith.constant dense<[1, 2, 3, 1]> : tensor<4xi5>
+  %1 = "FHELinalg.dot_eint_int"(%0, %w) : (tensor<4x!FHE.eint<4>>, tensor<4xi5>) -> !FHE.eint<4>
+  %t2 = arith.constant dense<[0, 0, 1, 1, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3]> : tensor<16xi64>
+  %2 = "FHE.apply_lookup_table"(%1, %t2): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<2>)
+  return %2: !FHE.eint<2>
+}
+
+// -----
+
+// The rounding depends on the width of its input, which is kept
+// CHECK:      func.func @keep_round_input(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<2> {
+// CHECK:        %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<4>
+// CHECK-NEXT:   %[[v2:.*]] = "FHE.round"(%[[v1]]) : (!FHE.eint<4>) -> !FHE.eint<2>
+func.func @keep_round_input(%arg0: !FHE.eint<2>) -> !FHE.eint<2> {
+  %t1 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<4>)
+  %1 = "FHE.round"(%0) : (!FHE.eint<4>) -> !FHE.eint<2>
+  return %1: !FHE.eint<2>
+}
+
+// -----
+
+// The clear operand is not a constant, its range is unknown
+// CHECK:      func.func @keep_unknown_clear(%[[a0:.*]]: !FHE.eint<2>, %[[a1:.*]]: i5) -> !FHE.eint<2> {
+// CHECK:        %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<4>
+// CHECK-NEXT:   %[[v2:.*]] = "FHE.add_eint_int"(%[[v1]], %[[a1]]) : (!FHE.eint<4>, i5) -> !FHE.eint<4>
+func.func @keep_unknown_clear(%arg0: !FHE.eint<2>, %arg1: i5) -> !FHE.eint<2> {
+  %t1 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<4>)
+  %1 = "FHE.add_eint_int"(%0, %arg1): (!FHE.eint<4>, i5) -> (!FHE.eint<4>)
+  %t2 = arith.constant dense<[0, 1, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3]> : tensor<16xi64>
+  %2 = "FHE.apply_lookup_table"(%1, %t2): (!FHE.eint<4>, tensor<16xi64>) -> (!FHE.eint<2>)
+  return %2: !FHE.eint<2>
+}
@@ -0,0 +1,125 @@
+// RUN: concretecompiler --split-input-file --action=dump-fhe --passes fhe-lookup-table-composition %s 2>&1 | FileCheck %s
+
+// CHECK:      func.func @compose(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<3> {
+// CHECK-NEXT:   %[[v0:.*]] = arith.constant dense<[2, 4, 6, 0]> : tensor<4xi64>
+// CHECK-NEXT:   %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %[[v0]]) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<3>
+// CHECK-NEXT:   return %[[v1]] : !FHE.eint<3>
+// CHECK-NEXT: }
+func.func @compose(%arg0: !FHE.eint<2>) -> !FHE.eint<3> {
+  %t1 = arith.constant dense<[1, 2, 3, 0]> : tensor<4xi64>
+  %t2 = arith.constant dense<[0, 2, 4, 6]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%0, %t2): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
+
+// -----
+
+// CHECK:      func.func @compose_signed_intermediate(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<2> {
+// CHECK-NEXT:   %[[v0:.*]] = arith.constant dense<[0, 3, 2, 1]> : tensor<4xi64>
+// CHECK-NEXT:   %[[v1:.*]] = "FHE.apply_lookup_table"(%[[a0]], %[[v0]]) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   return %[[v1]] : !FHE.eint<2>
+// CHECK-NEXT: }
+func.func @compose_signed_intermediate(%arg0: !FHE.eint<2>) -> !FHE.eint<2> {
+  %t1 = arith.constant dense<[0, -1, -2, 1]> : tensor<4xi64>
+  %t2 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.esint<2>)
+  %1 = "FHE.apply_lookup_table"(%0, %t2): (!FHE.esint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %1: !FHE.eint<2>
+}
+
+// -----
+
+// CHECK:      func.func @no_compose_overflow(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<3> {
+// CHECK:        "FHE.apply_lookup_table"(%[[a0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   "FHE.apply_lookup_table"(%{{.*}}, %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<3>
+func.func @no_compose_overflow(%arg0: !FHE.eint<2>) -> !FHE.eint<3> {
+  %t1 = arith.constant dense<[1, 2, 3, 7]> : tensor<4xi64>
+  %t2 = arith.constant dense<[0, 2, 4, 6]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%0, %t2): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
+
+// -----
+
+// CHECK:      func.func @no_compose_multiple_uses(%[[a0:.*]]: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<3>) {
+// CHECK:        %[[v0:.*]] = "FHE.apply_lookup_table"(%[[a0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+// CHECK-NEXT:   %[[v1:.*]] = "FHE.apply_lookup_table"(%[[v0]], %{{.*}}) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<3>
+// CHECK-NEXT:   return %[[v0]], %[[v1]] : !FHE.eint<2>, !FHE.eint<3>
+func.func @no_compose_multiple_uses(%arg0: !FHE.eint<2>) -> (!FHE.eint<2>, !FHE.eint<3>) {
+  %t1 = arith.constant dense<[1, 2, 3, 0]> : tensor<4xi64>
+  %t2 = arith.constant dense<[0, 2, 4, 6]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t1): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  %1 = "FHE.apply_lookup_table"(%0, %t2): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<3>)
+  return %0, %1: !FHE.eint<2>, !FHE.eint<3>
+}
+
+// -----
+
+// CHECK:      func.func @identity(%[[a0:.*]]: !FHE.eint<2>) -> !FHE.eint<2> {
+// CHECK-NEXT:   return %[[a0]] : !FHE.eint<2>
+// CHECK-NEXT: }
+func.func @identity(%arg0: !FHE.eint<2>) -> !FHE.eint<2> {
+  %t = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %0: !FHE.eint<2>
+}
+
+// -----
+
+// CHECK:      func.func @identity_signed(%[[a0:.*]]: !FHE.esint<2>) -> !FHE.esint<2> {
+// CHECK-NEXT:   return %[[a0]] : !FHE.esint<2>
+// CHECK-NEXT: }
+func.func @identity_signed(%arg0: !FHE.esint<2>) -> !FHE.esint<2> {
+  %t = arith.constant dense<[0, 1, -2, -1]> : tensor<4xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %t): (!FHE.esint<2>, tensor<4xi64>) -> (!FHE.esint<2>)
+  return %0: !FHE.esint<2>
+}
+
+// -----
+
+// CHECK:      func.func @fold_zero() -> !FHE.eint<2> {
+// CHECK-DAG:    %[[v0:.*]] = arith.constant 3 : i3
+// CHECK-DAG:    %[[v1:.*]] = "FHE.zero"() : () -> !FHE.eint<2>
+// CHECK-NEXT:   %[[v2:.*]] = "FHE.add_eint_int"(%[[v1]], %[[v0]]) : (!FHE.eint<2>, i3) -> !FHE.eint<2>
+// CHECK-NEXT:   return %[[v2]] : !FHE.eint<2>
+// CHECK-NEXT: }
+func.func @fold_zero() -> !FHE.eint<2> {
+  %t = arith.constant dense<[3, 0, 0, 0]> : tensor<4xi64>
+  %z = "FHE.zero"() : () -> !FHE.eint<2>
+  %0 = "FHE.apply_lookup_table"(%z, %t): (!FHE.eint<2>, tensor<4xi64>) -> (!FHE.eint<2>)
+  return %0: !FHE.eint<2>
+}
+
+// -----
+
+// CHECK:      func.func @compose_tensor(%[[a0:.*]]: tensor<3x!FHE.eint<2>>) -> tensor<3x!FHE.eint<3>> {
+// CHECK-NEXT:   %[[v0:.*]] = arith.constant dense<[2, 4, 6, 0]> : tensor<4xi64>
+// CHECK-NEXT:   %[[v1:.*]] = "FHELinalg.apply_lookup_table"(%[[a0]], %[[v0]]) : (tensor<3x!FHE.eint<2>>, tensor<4xi64>) -> tensor<3x!FHE.eint<3>>
+// CHECK-NEXT:   return %[[v1]] : tensor<3x!FHE.eint<3>>
+// CHECK-NEXT: }
+func.func @compose_tensor(%arg0: tensor<3x!FHE.eint<2>>) -> tensor<3x!FHE.eint<3>> {
+  %t1 = arith.constant dense<[1, 2, 3, 0]> : tensor<4xi64>
+  %t2 = arith.constant dense<[0, 2, 4, 6]> : tensor<4xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %t1): (tensor<3x!FHE.eint<2>>, tensor<4xi64>) -> (tensor<3x!FHE.eint<2>>)
+  %1 = "FHELinalg.apply_lookup_table"(%0, %t2): (tensor<3x!FHE.eint<2>>, tensor<4xi64>) -> (tensor<3x!FHE.eint<3>>)
+  return %1: tensor<3x!FHE.eint<3>>
+}
+
+// -----
+
+// CHECK:      func.func @compose_mapped(%[[a0:.*]]: tensor<3x!FHE.eint<2>>) -> tensor<3x!FHE.eint<2>> {
+// CHECK-DAG:    %[[v0:.*]] = arith.constant dense<{{\[}}[1, 2, 3, 0], [0, 1, 2, 3]{{\]}}> : tensor<2x4xi64>
+// CHECK-DAG:    %[[v1:.*]] = arith.constant dense<[0, 1, 0]> : tensor<3xindex>
+// CHECK-NEXT:   %[[v2:.*]] = "FHELinalg.apply_mapped_lookup_table"(%[[a0]], %[[v0]], %[[v1]]) : (tensor<3x!FHE.eint<2>>, tensor<2x4xi64>, tensor<3xindex>) -> tensor<3x!FHE.eint<2>>
+// CHECK-NEXT:   return %[[v2]] : tensor<3x!FHE.eint<2>>
+// CHECK-NEXT: }
+func.func @compose_mapped(%arg0: tensor<3x!FHE.eint<2>>) -> tensor<3x!FHE.eint<2>> {
+  %t1 = arith.constant dense<[1, 2, 3, 0]> : tensor<4xi64>
+  %luts = arith.constant dense<[[0, 1, 2, 3], [3, 0, 1, 2]]> : tensor<2x4xi64>
+  %map = arith.constant dense<[0, 1, 0]> : tensor<3xindex>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %t1): (tensor<3x!FHE.eint<2>>, tensor<4xi64>) -> (tensor<3x!FHE.eint<2>>)
+  %1 = "FHELinalg.apply_mapped_lookup_table"(%0, %luts, %map): (tensor<3x!FHE.eint<2>>, tensor<2x4xi64>, tensor<3xindex>) -> (tensor<3x!FHE.eint<2>>)
+  return %1: tensor<3x!FHE.eint<2>>
+}
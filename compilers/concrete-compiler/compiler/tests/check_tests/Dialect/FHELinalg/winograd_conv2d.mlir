@@ -0,0 +1,62 @@
+// RUN: concretecompiler --split-input-file --winograd-conv2d --passes MANP --passes fhelinalg-winograd-conv2d --action=dump-fhe %s 2>&1| FileCheck %s
+
+// The noise of the multiplication by 63 bounds the noise of the circuit, the
+// convolution can use the transformed weights
+// CHECK-LABEL: func.func @winograd
+// CHECK-NOT:       "FHELinalg.conv2d"(%arg0
+// CHECK-COUNT-16:  "FHELinalg.conv2d"(%{{.*}}, %{{.*}}) {{.*}}: (tensor<1x1x1x1x!FHE.eint<6>>, tensor<1x1x1x1xi7>) -> tensor<1x1x1x1x!FHE.eint<6>>
+// CHECK:           "FHE.zero_tensor"() {{.*}}: () -> tensor<1x1x2x2x!FHE.eint<6>>
+// CHECK:           tensor.insert_slice %{{.*}} into %{{.*}}[0, 0, 0, 0] [1, 1, 1, 1] [1, 1, 2, 2]
+// CHECK:           tensor.insert_slice %{{.*}} into %{{.*}}[0, 0, 0, 1] [1, 1, 1, 1] [1, 1, 2, 2]
+// CHECK:           tensor.insert_slice %{{.*}} into %{{.*}}[0, 0, 1, 0] [1, 1, 1, 1] [1, 1, 2, 2]
+// CHECK:           tensor.insert_slice %{{.*}} into %{{.*}}[0, 0, 1, 1] [1, 1, 1, 1] [1, 1, 2, 2]
+func.func @winograd(%arg0: tensor<1x1x4x4x!FHE.eint<6>>) -> (tensor<1x1x2x2x!FHE.eint<6>>, tensor<1x1x4x4x!FHE.eint<6>>) {
+  %weight = arith.constant dense<[[[[4, 0, 0], [0, 0, 0], [0, 0, 0]]]]> : tensor<1x1x3x3xi7>
+  %0 = "FHELinalg.conv2d"(%arg0, %weight) : (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x3x3xi7>) -> tensor<1x1x2x2x!FHE.eint<6>>
+  %c63 = arith.constant dense<63> : tensor<1x1x4x4xi7>
+  %1 = "FHELinalg.mul_eint_int"(%arg0, %c63) : (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x4x4xi7>) -> tensor<1x1x4x4x!FHE.eint<6>>
+  return %0, %1 : tensor<1x1x2x2x!FHE.eint<6>>, tensor<1x1x4x4x!FHE.eint<6>>
+}
+
+// -----
+
+// The convolution has the largest MANP of the circuit, but its noise is
+// bounded by the wider addition
+// CHECK-LABEL: func.func @narrow_conv
+// CHECK-NOT:       "FHELinalg.conv2d"(%arg0
+// CHECK-COUNT-16:  "FHELinalg.conv2d"(%{{.*}}, %{{.*}}) {{.*}}: (tensor<1x1x1x1x!FHE.eint<3>>, tensor<1x1x1x1xi4>) -> tensor<1x1x1x1x!FHE.eint<3>>
+// CHECK:           "FHE.zero_tensor"() {{.*}}: () -> tensor<1x1x2x2x!FHE.eint<3>>
+func.func @narrow_conv(%arg0: tensor<1x1x4x4x!FHE.eint<3>>, %arg1: !FHE.eint<7>) -> (tensor<1x1x2x2x!FHE.eint<3>>, !FHE.eint<7>) {
+  %weight = arith.constant dense<[[[[4, 0, 0], [0, 0, 0], [0, 0, 0]]]]> : tensor<1x1x3x3xi4>
+  %0 = "FHELinalg.conv2d"(%arg0, %weight) : (tensor<1x1x4x4x!FHE.eint<3>>, tensor<1x1x3x3xi4>) -> tensor<1x1x2x2x!FHE.eint<3>>
+  %c1 = arith.constant 1 : i8
+  %1 = "FHE.add_eint_int"(%arg1, %c1) : (!FHE.eint<7>, i8) -> !FHE.eint<7>
+  return %0, %1 : tensor<1x1x2x2x!FHE.eint<3>>, !FHE.eint<7>
+}
+
+// -----
+
+// The convolution bounds the noise of the circuit, the transformed weights
+// would raise it
+// CHECK-LABEL: func.func @noise_bound
+// CHECK:       "FHELinalg.conv2d"(%arg0, %{{.*}}) {{.*}}: (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x3x3xi7>) -> tensor<1x1x2x2x!FHE.eint<6>>
+// CHECK-NOT:   "FHELinalg.conv2d"
+func.func @noise_bound(%arg0: tensor<1x1x4x4x!FHE.eint<6>>) -> tensor<1x1x2x2x!FHE.eint<6>> {
+  %weight = arith.constant dense<[[[[4, 0, 0], [0, 0, 0], [0, 0, 0]]]]> : tensor<1x1x3x3xi7>
+  %0 = "FHELinalg.conv2d"(%arg0, %weight) : (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x3x3xi7>) -> tensor<1x1x2x2x!FHE.eint<6>>
+  return %0 : tensor<1x1x2x2x!FHE.eint<6>>
+}
+
+// -----
+
+// The transformed weights are not integral
+// CHECK-LABEL: func.func @not_integral
+// CHECK:       "FHELinalg.conv2d"(%arg0, %{{.*}}) {{.*}}: (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x3x3xi7>) -> tensor<1x1x2x2x!FHE.eint<6>>
+// CHECK-NOT:   "FHELinalg.conv2d"
+func.func @not_integral(%arg0: tensor<1x1x4x4x!FHE.eint<6>>) -> (tensor<1x1x2x2x!FHE.eint<6>>, tensor<1x1x4x4x!FHE.eint<6>>) {
+  %weight = arith.constant dense<[[[[1, 0, 0], [0, 0, 0], [0, 0, 0]]]]> : tensor<1x1x3x3xi7>
+  %0 = "FHELinalg.conv2d"(%arg0, %weight) : (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x3x3xi7>) -> tensor<1x1x2x2x!FHE.eint<6>>
+  %c63 = arith.constant dense<63> : tensor<1x1x4x4xi7>
+  %1 = "FHELinalg.mul_eint_int"(%arg0, %c63) : (tensor<1x1x4x4x!FHE.eint<6>>, tensor<1x1x4x4xi7>) -> tensor<1x1x4x4x!FHE.eint<6>>
+  return %0, %1 : tensor<1x1x2x2x!FHE.eint<6>>, tensor<1x1x4x4x!FHE.eint<6>>
+}
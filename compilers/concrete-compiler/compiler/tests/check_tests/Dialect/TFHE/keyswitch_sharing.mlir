@@ -0,0 +1,87 @@
+// RUN: concretecompiler --split-input-file --passes tfhe-keyswitch-sharing --action=dump-normalized-tfhe %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @share_keyswitch
+// CHECK: %[[KS:.*]] = "TFHE.keyswitch_glwe"(%arg0)
+// CHECK-NOT: "TFHE.keyswitch_glwe"
+// CHECK: "TFHE.bootstrap_glwe"(%[[KS]], %arg1)
+// CHECK-NOT: "TFHE.keyswitch_glwe"
+// CHECK: "TFHE.bootstrap_glwe"(%[[KS]], %arg2)
+func.func @share_keyswitch(%arg0: !TFHE.glwe<sk[1]<1,2048>>, %arg1: tensor<256xi64>, %arg2: tensor<256xi64>) -> (!TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>) {
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+  %1 = "TFHE.bootstrap_glwe"(%0, %arg1) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk[2]<1,750>>, tensor<256xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  %2 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+  %3 = "TFHE.bootstrap_glwe"(%2, %arg2) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk[2]<1,750>>, tensor<256xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  return %1, %3 : !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @no_share_different_keys
+// CHECK: "TFHE.keyswitch_glwe"(%arg0)
+// CHECK: "TFHE.keyswitch_glwe"(%arg0)
+func.func @no_share_different_keys(%arg0: !TFHE.glwe<sk[1]<1,2048>>) -> (!TFHE.glwe<sk[2]<1,750>>, !TFHE.glwe<sk[3]<1,800>>) {
+  %0 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+  %1 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[3]<1,800>, 3, 4>} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[3]<1,800>>
+  return %0, %1 : !TFHE.glwe<sk[2]<1,750>>, !TFHE.glwe<sk[3]<1,800>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @share_signed_offset_keyswitch
+// CHECK: %[[ADD:.*]] = "TFHE.add_glwe_int"(%arg0, %arg1)
+// CHECK-NEXT: %[[KS:.*]] = "TFHE.keyswitch_glwe"(%[[ADD]])
+// CHECK-NOT: "TFHE.add_glwe_int"
+// CHECK-NOT: "TFHE.keyswitch_glwe"
+// CHECK: return %[[KS]], %[[KS]]
+func.func @share_signed_offset_keyswitch(%arg0: !TFHE.glwe<sk[1]<1,2048>>, %arg1: i64) -> (!TFHE.glwe<sk[2]<1,750>>, !TFHE.glwe<sk[2]<1,750>>) {
+  %0 = "TFHE.add_glwe_int"(%arg0, %arg1) {"TFHE.OId" = 1 : i32} : (!TFHE.glwe<sk[1]<1,2048>>, i64) -> !TFHE.glwe<sk[1]<1,2048>>
+  %1 = "TFHE.keyswitch_glwe"(%0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>, "TFHE.OId" = 2 : i32} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+  %2 = "TFHE.add_glwe_int"(%arg0, %arg1) {"TFHE.OId" = 3 : i32} : (!TFHE.glwe<sk[1]<1,2048>>, i64) -> !TFHE.glwe<sk[1]<1,2048>>
+  %3 = "TFHE.keyswitch_glwe"(%2) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>, "TFHE.OId" = 4 : i32} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+  return %1, %3 : !TFHE.glwe<sk[2]<1,750>>, !TFHE.glwe<sk[2]<1,750>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @hoist_loop_invariant_keyswitch
+// CHECK: %[[KS:.*]] = "TFHE.keyswitch_glwe"(%arg0)
+// CHECK-NEXT: scf.for
+// CHECK-NOT: "TFHE.keyswitch_glwe"
+// CHECK: "TFHE.bootstrap_glwe"(%[[KS]], %arg1)
+// CHECK-NOT: "TFHE.keyswitch_glwe"
+// CHECK: "TFHE.bootstrap_glwe"(%[[KS]], %arg1)
+func.func @hoist_loop_invariant_keyswitch(%arg0: !TFHE.glwe<sk[1]<1,2048>>, %arg1: tensor<256xi64>) -> (tensor<4x!TFHE.glwe<sk[1]<1,2048>>>, tensor<4x!TFHE.glwe<sk[1]<1,2048>>>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = bufferization.alloc_tensor() : tensor<4x!TFHE.glwe<sk[1]<1,2048>>>
+  %1 = scf.for %i = %c0 to %c4 step %c1 iter_args(%acc = %0) -> (tensor<4x!TFHE.glwe<sk[1]<1,2048>>>) {
+    %2 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+    %3 = "TFHE.bootstrap_glwe"(%2, %arg1) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk[2]<1,750>>, tensor<256xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+    %4 = tensor.insert %3 into %acc[%i] : tensor<4x!TFHE.glwe<sk[1]<1,2048>>>
+    scf.yield %4 : tensor<4x!TFHE.glwe<sk[1]<1,2048>>>
+  }
+  %5 = scf.for %i = %c0 to %c4 step %c1 iter_args(%acc = %0) -> (tensor<4x!TFHE.glwe<sk[1]<1,2048>>>) {
+    %6 = "TFHE.keyswitch_glwe"(%arg0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (!TFHE.glwe<sk[1]<1,2048>>) -> !TFHE.glwe<sk[2]<1,750>>
+    %7 = "TFHE.bootstrap_glwe"(%6, %arg1) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk[2]<1,750>>, tensor<256xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+    %8 = tensor.insert %7 into %acc[%i] : tensor<4x!TFHE.glwe<sk[1]<1,2048>>>
+    scf.yield %8 : tensor<4x!TFHE.glwe<sk[1]<1,2048>>>
+  }
+  return %1, %5 : tensor<4x!TFHE.glwe<sk[1]<1,2048>>>, tensor<4x!TFHE.glwe<sk[1]<1,2048>>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @share_batched_keyswitch
+// CHECK: %[[COLLAPSED:.*]] = tensor.collapse_shape %arg0
+// CHECK-NEXT: %[[KS:.*]] = "TFHE.batched_keyswitch_glwe"(%[[COLLAPSED]])
+// CHECK-NOT: tensor.collapse_shape
+// CHECK-NOT: "TFHE.batched_keyswitch_glwe"
+// CHECK: return %[[KS]], %[[KS]]
+func.func @share_batched_keyswitch(%arg0: tensor<2x3x!TFHE.glwe<sk[1]<1,2048>>>) -> (tensor<6x!TFHE.glwe<sk[2]<1,750>>>, tensor<6x!TFHE.glwe<sk[2]<1,750>>>) {
+  %0 = tensor.collapse_shape %arg0 [[0, 1]] : tensor<2x3x!TFHE.glwe<sk[1]<1,2048>>> into tensor<6x!TFHE.glwe<sk[1]<1,2048>>>
+  %1 = "TFHE.batched_keyswitch_glwe"(%0) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (tensor<6x!TFHE.glwe<sk[1]<1,2048>>>) -> tensor<6x!TFHE.glwe<sk[2]<1,750>>>
+  %2 = tensor.collapse_shape %arg0 [[0, 1]] : tensor<2x3x!TFHE.glwe<sk[1]<1,2048>>> into tensor<6x!TFHE.glwe<sk[1]<1,2048>>>
+  %3 = "TFHE.batched_keyswitch_glwe"(%2) {key = #TFHE.ksk<sk[1]<1,2048>, sk[2]<1,750>, 3, 4>} : (tensor<6x!TFHE.glwe<sk[1]<1,2048>>>) -> tensor<6x!TFHE.glwe<sk[2]<1,750>>>
+  return %1, %3 : tensor<6x!TFHE.glwe<sk[2]<1,750>>>, tensor<6x!TFHE.glwe<sk[2]<1,750>>>
+}
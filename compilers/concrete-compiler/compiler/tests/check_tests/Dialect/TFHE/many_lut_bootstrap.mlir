@@ -0,0 +1,64 @@
+// RUN: concretecompiler --split-input-file --passes tfhe-many-lut-bootstrap --optimizer-max-many-lut-count=4 --action=dump-normalized-tfhe %s 2>&1| FileCheck %s
+
+// CHECK-LABEL: func.func @many_lut_bootstrap
+// CHECK: %[[LUTS:.*]] = arith.constant dense<{{\[\[}}0, 1, 2, 3], [3, 2, 1, 0]]> : tensor<2x4xi64>
+// CHECK: %[[ACC:.*]] = "TFHE.encode_expand_many_luts_for_bootstrap"(%[[LUTS]]) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<2x4xi64>) -> tensor<1024xi64>
+// CHECK: %[[BS:.*]]:2 = "TFHE.many_bootstrap_glwe"(%arg0, %[[ACC]]) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, lutSize = 4 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> (!TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>)
+// CHECK-NOT: "TFHE.bootstrap_glwe"
+// CHECK: return %[[BS]]#0, %[[BS]]#1
+func.func @many_lut_bootstrap(%arg0: !TFHE.glwe<sk[2]<1,750>>) -> (!TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>) {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %0 = "TFHE.encode_expand_lut_for_bootstrap"(%lut0) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+  %1 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 2 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  %2 = "TFHE.encode_expand_lut_for_bootstrap"(%lut1) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+  %3 = "TFHE.bootstrap_glwe"(%arg0, %2) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 2 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  return %1, %3 : !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>
+}
+
+// -----
+
+// CHECK-LABEL: func.func @no_many_lut_without_budget
+// CHECK-NOT: "TFHE.many_bootstrap_glwe"
+// CHECK: "TFHE.bootstrap_glwe"(%arg0, %{{.*}})
+// CHECK: "TFHE.bootstrap_glwe"(%arg0, %{{.*}})
+func.func @no_many_lut_without_budget(%arg0: !TFHE.glwe<sk[2]<1,750>>) -> (!TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>) {
+  %lut0 = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %lut1 = arith.constant dense<[3, 2, 1, 0]> : tensor<4xi64>
+  %0 = "TFHE.encode_expand_lut_for_bootstrap"(%lut0) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+  %1 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  %2 = "TFHE.encode_expand_lut_for_bootstrap"(%lut1) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+  %3 = "TFHE.bootstrap_glwe"(%arg0, %2) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  return %1, %3 : !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>
+}
+
+// -----
+
+// The three lookup tables are grouped by a power of two, the remaining one
+// being evaluated by a regular bootstrap
+// CHECK-LABEL: func.func @many_lut_power_of_two
+// CHECK: %[[BS:.*]]:2 = "TFHE.many_bootstrap_glwe"(%arg0, %{{.*}})
+// CHECK: %[[LAST:.*]] = "TFHE.bootstrap_glwe"(%arg0, %{{.*}})
+// CHECK-NOT: "TFHE.manyLut"
+// CHECK: return %[[BS]]#0, %[[BS]]#1, %[[LAST]]
+func.func @many_lut_power_of_two(%arg0: !TFHE.glwe<sk[2]<1,750>>) -> (!TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>) {
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "TFHE.encode_expand_lut_for_bootstrap"(%lut) {isSigned = false, outputBits = 3 : i32, polySize = 1024 : i32} : (tensor<4xi64>) -> tensor<1024xi64>
+  %1 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 4 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  %2 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 4 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  %3 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 4 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<1024xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  return %1, %2, %3 : !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>
+}
+
+// -----
+
+// The accumulator is too small to hold a slot of two coefficients per entry
+// CHECK-LABEL: func.func @no_many_lut_small_accumulator
+// CHECK-NOT: "TFHE.many_bootstrap_glwe"
+func.func @no_many_lut_small_accumulator(%arg0: !TFHE.glwe<sk[2]<1,750>>) -> (!TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>) {
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = "TFHE.encode_expand_lut_for_bootstrap"(%lut) {isSigned = false, outputBits = 3 : i32, polySize = 8 : i32} : (tensor<4xi64>) -> tensor<8xi64>
+  %1 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 2 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<8xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  %2 = "TFHE.bootstrap_glwe"(%arg0, %0) {key = #TFHE.bsk<sk[2]<1,750>, sk[1]<1,2048>, 1024, 2, 1, 23>, "TFHE.manyLut" = 2 : i32} : (!TFHE.glwe<sk[2]<1,750>>, tensor<8xi64>) -> !TFHE.glwe<sk[1]<1,2048>>
+  return %1, %2 : !TFHE.glwe<sk[1]<1,2048>>, !TFHE.glwe<sk[1]<1,2048>>
+}
@@ -16,3 +16,19 @@ func.func @bootstrap_glwe(%glwe: !TFHE.glwe<sk[1]<527,1>>, %lut: tensor<128xi64>
     return %0 : !TFHE.glwe<sk[1]<1024,1>>
 }
 
+// CHECK: func.func @multi_bit_bootstrap_glwe(%[[GLWE:.*]]: !TFHE.glwe<sk[1]<528,1>>, %[[LUT:.*]]: tensor<128xi64>) -> !TFHE.glwe<sk[1]<1024,1>> {
+func.func @multi_bit_bootstrap_glwe(%glwe: !TFHE.glwe<sk[1]<528,1>>, %lut: tensor<128xi64>) -> !TFHE.glwe<sk[1]<1024,1>> {
+    // CHECK-NEXT: %[[V0:.*]] = "TFHE.bootstrap_glwe"(%[[GLWE]], %[[LUT]]) {key = #TFHE.bsk<sk[1]<528,1>, sk[1]<1024,1>, 512, 2, 4, 4, grouping 2>} : (!TFHE.glwe<sk[1]<528,1>>, tensor<128xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+    // CHECK-NEXT: return %[[V0]] : !TFHE.glwe<sk[1]<1024,1>>
+    %0 = "TFHE.bootstrap_glwe"(%glwe, %lut) {key=#TFHE.bsk<sk[1]<528,1>,sk[1]<1024,1>,512,2,4,4, grouping 2>} : (!TFHE.glwe<sk[1]<528,1>>, tensor<128xi64>) -> !TFHE.glwe<sk[1]<1024,1>>
+    return %0 : !TFHE.glwe<sk[1]<1024,1>>
+}
+
+// CHECK: func.func @many_bootstrap_glwe(%[[GLWE:.*]]: !TFHE.glwe<sk[1]<527,1>>, %[[LUT:.*]]: tensor<512xi64>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>) {
+func.func @many_bootstrap_glwe(%glwe: !TFHE.glwe<sk[1]<527,1>>, %lut: tensor<512xi64>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>) {
+    // CHECK-NEXT: %[[V0:.*]]:2 = "TFHE.many_bootstrap_glwe"(%[[GLWE]], %[[LUT]]) {key = #TFHE.bsk<sk[1]<527,1>, sk[1]<1024,1>, 512, 2, 4, 4>, lutSize = 8 : i32} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>)
+    // CHECK-NEXT: return %[[V0]]#0, %[[V0]]#1 : !TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>
+    %0:2 = "TFHE.many_bootstrap_glwe"(%glwe, %lut) {key=#TFHE.bsk<sk[1]<527,1>,sk[1]<1024,1>,512,2,4,4>, lutSize = 8 : i32} : (!TFHE.glwe<sk[1]<527,1>>, tensor<512xi64>) -> (!TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>)
+    return %0#0, %0#1 : !TFHE.glwe<sk[1]<1024,1>>, !TFHE.glwe<sk[1]<1024,1>>
+}
+
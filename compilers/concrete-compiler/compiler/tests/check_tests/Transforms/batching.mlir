@@ -278,3 +278,54 @@ func.func @apply_lookup_table_contiguous_hoistable_nonbatchable(%arg0: tensor<2x
   }
   return %1 : tensor<2x3x4x!TFHE.glwe<sk<0,1,2048>>>
 }
+
+// -----
+
+// CHECK-LABEL: func.func @apply_wop_pbs_crt
+// CHECK: (%arg0: tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK_IN:.*]]{{\]}}<1,2048>>>, %arg1: tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>> {
+// CHECK:   %[[V0:.*]] = "TFHE.batched_wop_pbs_glwe"(%[[Varg0:.*]], %arg1) {{.*}} : (tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>, tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>
+// CHECK-NOT: "TFHE.wop_pbs_glwe"
+func.func @apply_wop_pbs_crt(%arg0: tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>, %arg1: tensor<5x8192xi64>) -> tensor<4x5x!TFHE.glwe<sk<0,1,2048>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = bufferization.alloc_tensor() : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+  %1 = scf.for %arg2 = %c0 to %c4 step %c1 iter_args(%arg3 = %0) -> (tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>) {
+    %extracted = tensor.extract_slice %arg0[%arg2, 0] [1, 5] [1, 1] : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>> to tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+    %2 = "TFHE.wop_pbs_glwe"(%extracted, %arg1) {bsk = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>, cbsBaseLog = 10 : i32, cbsLevels = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], ksk = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>, pksk = #TFHE.pksk<sk<0,1,2048>, sk<0,1,2048>, 1024, 2048, 1, 1, 15>} : (tensor<5x!TFHE.glwe<sk<0,1,2048>>>, tensor<5x8192xi64>) -> tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+    %inserted = tensor.insert_slice %2 into %arg3[%arg2, 0] [1, 5] [1, 1] : tensor<5x!TFHE.glwe<sk<0,1,2048>>> into tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+    scf.yield %inserted : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+  }
+  return %1 : tensor<4x5x!TFHE.glwe<sk<0,1,2048>>>
+}
+
+// -----
+
+// The batched results are used in the loop nest through rank-reduced slices
+// of the structured batch of results
+// CHECK-LABEL: func.func @apply_wop_pbs_crt_used_in_nest
+// CHECK: %[[V0:.*]] = tensor.collapse_shape %arg0 {{\[\[0, 1\], \[2\]\]}} : tensor<2x3x5x!TFHE.glwe<sk{{\[}}[[SK_IN:.*]]{{\]}}<1,2048>>> into tensor<6x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>
+// CHECK: %[[V1:.*]] = "TFHE.batched_wop_pbs_glwe"(%[[V0]], %arg1) {{.*}} : (tensor<6x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>, tensor<5x8192xi64>) -> tensor<6x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>
+// CHECK: %[[V2:.*]] = tensor.expand_shape %[[V1]] {{\[\[0, 1\], \[2\]\]}} : tensor<6x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>> into tensor<2x3x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>
+// CHECK: scf.for %[[I:.*]] = %c0 to %c2
+// CHECK: scf.for %[[J:.*]] = %c0 to %c3
+// CHECK: tensor.extract_slice %[[V2]][%[[I]], %[[J]], 0] [1, 1, 5] [1, 1, 1] : tensor<2x3x5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>> to tensor<5x!TFHE.glwe<sk{{\[}}[[SK_IN]]{{\]}}<1,2048>>>
+// CHECK-NOT: "TFHE.wop_pbs_glwe"
+func.func @apply_wop_pbs_crt_used_in_nest(%arg0: tensor<2x3x5x!TFHE.glwe<sk<0,1,2048>>>, %arg1: tensor<5x8192xi64>) -> tensor<2x3x!TFHE.glwe<sk<0,1,2048>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c3 = arith.constant 3 : index
+  %0 = bufferization.alloc_tensor() : tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>
+  %1 = scf.for %arg2 = %c0 to %c2 step %c1 iter_args(%arg3 = %0) -> (tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>) {
+    %2 = scf.for %arg4 = %c0 to %c3 step %c1 iter_args(%arg5 = %arg3) -> (tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>) {
+      %extracted = tensor.extract_slice %arg0[%arg2, %arg4, 0] [1, 1, 5] [1, 1, 1] : tensor<2x3x5x!TFHE.glwe<sk<0,1,2048>>> to tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+      %3 = "TFHE.wop_pbs_glwe"(%extracted, %arg1) {bsk = #TFHE.bsk<sk<1,1,750>, sk<0,1,2048>, 1024, 2, 1, 23>, cbsBaseLog = 10 : i32, cbsLevels = 2 : i32, crtDecomposition = [2, 3, 5, 7, 11], ksk = #TFHE.ksk<sk<0,1,2048>, sk<1,1,750>, 3, 4>, pksk = #TFHE.pksk<sk<0,1,2048>, sk<0,1,2048>, 1024, 2048, 1, 1, 15>} : (tensor<5x!TFHE.glwe<sk<0,1,2048>>>, tensor<5x8192xi64>) -> tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+      %4 = tensor.extract %3[%c0] : tensor<5x!TFHE.glwe<sk<0,1,2048>>>
+      %inserted = tensor.insert %4 into %arg5[%arg2, %arg4] : tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>
+      scf.yield %inserted : tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>
+    }
+    scf.yield %2 : tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>
+  }
+  return %1 : tensor<2x3x!TFHE.glwe<sk<0,1,2048>>>
+}
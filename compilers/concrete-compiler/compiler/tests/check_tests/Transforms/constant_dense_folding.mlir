@@ -0,0 +1,51 @@
+// RUN: concretecompiler --split-input-file --action=dump-batched-tfhe %s 2>&1| FileCheck %s
+
+// The sign extension of the clear weights is computed at compile time
+// CHECK-LABEL: func.func @fold_mul_cleartexts
+// CHECK:       %[[CST:.*]] = arith.constant dense<[1, -2, 3, -4]> : tensor<4xi64>
+// CHECK-NOT:   arith.extsi
+// CHECK:       %[[V:.*]] = tensor.extract %[[CST]][%{{.*}}] : tensor<4xi64>
+// CHECK-NEXT:  "TFHE.mul_glwe_int"(%{{.*}}, %[[V]])
+func.func @fold_mul_cleartexts(%arg0: tensor<4x!TFHE.glwe<sk<0,1,2048>>>) -> tensor<4x!TFHE.glwe<sk<0,1,2048>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %cst = arith.constant dense<[1, -2, 3, -4]> : tensor<4xi5>
+  %0 = bufferization.alloc_tensor() : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+  %1 = scf.for %i = %c0 to %c4 step %c1 iter_args(%acc = %0) -> (tensor<4x!TFHE.glwe<sk<0,1,2048>>>) {
+    %2 = tensor.extract %arg0[%i] : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+    %3 = tensor.extract %cst[%i] : tensor<4xi5>
+    %4 = arith.extsi %3 : i5 to i64
+    %5 = "TFHE.mul_glwe_int"(%2, %4) : (!TFHE.glwe<sk<0,1,2048>>, i64) -> !TFHE.glwe<sk<0,1,2048>>
+    %6 = tensor.insert %5 into %acc[%i] : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+    scf.yield %6 : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+  }
+  return %1 : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+}
+
+// -----
+
+// The shift encoding of the clear values is computed at compile time
+// CHECK-LABEL: func.func @fold_add_plaintexts
+// CHECK:       %[[CST:.*]] = arith.constant dense<[288230376151711744, -576460752303423488, 864691128455135232, -1152921504606846976]> : tensor<4xi64>
+// CHECK-NOT:   arith.shli
+// CHECK:       %[[V:.*]] = tensor.extract %[[CST]][%{{.*}}] : tensor<4xi64>
+// CHECK-NEXT:  "TFHE.add_glwe_int"(%{{.*}}, %[[V]])
+func.func @fold_add_plaintexts(%arg0: tensor<4x!TFHE.glwe<sk<0,1,2048>>>) -> tensor<4x!TFHE.glwe<sk<0,1,2048>>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c58 = arith.constant 58 : i64
+  %cst = arith.constant dense<[1, -2, 3, -4]> : tensor<4xi5>
+  %0 = bufferization.alloc_tensor() : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+  %1 = scf.for %i = %c0 to %c4 step %c1 iter_args(%acc = %0) -> (tensor<4x!TFHE.glwe<sk<0,1,2048>>>) {
+    %2 = tensor.extract %arg0[%i] : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+    %3 = tensor.extract %cst[%i] : tensor<4xi5>
+    %4 = arith.extsi %3 : i5 to i64
+    %5 = arith.shli %4, %c58 : i64
+    %6 = "TFHE.add_glwe_int"(%2, %5) : (!TFHE.glwe<sk<0,1,2048>>, i64) -> !TFHE.glwe<sk<0,1,2048>>
+    %7 = tensor.insert %6 into %acc[%i] : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+    scf.yield %7 : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+  }
+  return %1 : tensor<4x!TFHE.glwe<sk<0,1,2048>>>
+}
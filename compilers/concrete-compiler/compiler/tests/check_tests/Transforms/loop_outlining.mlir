@@ -0,0 +1,32 @@
+// RUN: concretecompiler %s --action=dump-std --multithread-passes --loop-outlining-threshold=1 2>&1| FileCheck %s
+
+// The loop nest is outlined into a private function, which also receives the
+// runtime context
+// CHECK-LABEL: func.func @apply_lookup_table
+// CHECK:       call @apply_lookup_table_loop_0({{.*}}) : ({{.*}}!Concrete.context)
+// CHECK:       func.func private @apply_lookup_table_loop_0({{.*}}!Concrete.context)
+// CHECK:       scf.for
+func.func @apply_lookup_table(%arg0: tensor<2x3x4x!FHE.eint<2>>) -> tensor<2x3x4x!FHE.eint<2>> {
+  %arg1 = arith.constant dense<"0x0000000000000000000000000000000100000000000000020000000000000003"> : tensor<4xi64>
+  %1 = "FHELinalg.apply_lookup_table"(%arg0, %arg1): (tensor<2x3x4x!FHE.eint<2>>, tensor<4xi64>) -> (tensor<2x3x4x!FHE.eint<2>>)
+  return %1: tensor<2x3x4x!FHE.eint<2>>
+}
+
+// The loop returns a buffer, whose deallocation cannot be placed across a
+// call, it is not outlined
+// CHECK-LABEL: func.func @loop_result
+// CHECK-NOT:   call @loop_result_loop_0
+// CHECK:       scf.for
+func.func @loop_result(%arg0: tensor<4x!FHE.eint<2>>) -> tensor<4x!FHE.eint<2>> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %lut = arith.constant dense<[0, 1, 2, 3]> : tensor<4xi64>
+  %0 = scf.for %i = %c0 to %c4 step %c1 iter_args(%t = %arg0) -> tensor<4x!FHE.eint<2>> {
+    %e = tensor.extract %t[%i] : tensor<4x!FHE.eint<2>>
+    %v = "FHE.apply_lookup_table"(%e, %lut) : (!FHE.eint<2>, tensor<4xi64>) -> !FHE.eint<2>
+    %u = tensor.insert %v into %t[%i] : tensor<4x!FHE.eint<2>>
+    scf.yield %u : tensor<4x!FHE.eint<2>>
+  }
+  return %0 : tensor<4x!FHE.eint<2>>
+}
@@ -1,5 +1,6 @@
 #include "../end_to_end_tests/end_to_end_test.h"
 #include "concretelang/Common/Compat.h"
+#include "concretelang/Runtime/context.h"
 #include "concretelang/TestLib/TestCircuit.h"
 
 #include <benchmark/benchmark.h>
@@ -90,11 +91,79 @@ static void BM_Evaluate(benchmark::State &state, EndToEndDesc description,
   }
 }
 
+/// Benchmark time of the program evaluation with the fourier bootstrap keys
+/// placed on the NUMA nodes according to `placement`. The keys are converted
+/// and placed once, before the timed loop.
+static void BM_EvaluateKeyPlacement(
+    benchmark::State &state, EndToEndDesc description,
+    mlir::concretelang::CompilationOptions options, std::string placement) {
+  TestCircuit tc(options);
+  assert(tc.compile(description.program));
+  assert(tc.generateKeyset());
+  auto clientCircuit = tc.getClientCircuit().value();
+
+  assert(description.tests.size() > 0);
+  auto test = description.tests[0];
+  auto inputArguments = std::vector<TransportValue>();
+  inputArguments.reserve(test.inputs.size());
+
+  for (size_t i = 0; i < test.inputs.size(); i++) {
+    auto input =
+        clientCircuit.prepareInput(test.inputs[i].getValue(), i).value();
+    inputArguments.push_back(input);
+  }
+
+  auto serverCircuit = tc.getServerCircuit().value();
+
+  // The placement is read when the runtime context prepares the keys
+  setenv("CONCRETE_KEY_PLACEMENT", placement.c_str(), 1);
+  mlir::concretelang::RuntimeContext runtimeContext(
+      tc.getKeyset().value().server);
+  unsetenv("CONCRETE_KEY_PLACEMENT");
+
+  // Warmup
+  assert(serverCircuit.call(runtimeContext, inputArguments));
+
+  for (auto _ : state) {
+    assert(serverCircuit.call(runtimeContext, inputArguments));
+  }
+}
+
+/// Benchmark time of the decryption
+static void BM_ProcessResults(benchmark::State &state, EndToEndDesc description,
+                              mlir::concretelang::CompilationOptions options) {
+  TestCircuit tc(options);
+  assert(tc.compile(description.program));
+  assert(tc.generateKeyset());
+  auto clientCircuit = tc.getClientCircuit().value();
+
+  assert(description.tests.size() > 0);
+  auto test = description.tests[0];
+  auto inputArguments = std::vector<TransportValue>();
+  inputArguments.reserve(test.inputs.size());
+
+  for (size_t i = 0; i < test.inputs.size(); i++) {
+    auto input =
+        clientCircuit.prepareInput(test.inputs[i].getValue(), i).value();
+    inputArguments.push_back(input);
+  }
+
+  auto results = tc.callServer(inputArguments).value();
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < results.size(); i++) {
+      assert(clientCircuit.processOutput(results[i], i));
+    }
+  }
+}
+
 enum Action {
   COMPILE,
   KEYGEN,
   ENCRYPT,
   EVALUATE,
+  DECRYPT,
+  KEY_PLACEMENT,
 };
 
 void registerEndToEndBenchmark(std::string suiteName,
@@ -142,6 +211,21 @@ void registerEndToEndBenchmark(std::string suiteName,
                                        BM_Evaluate(st, description, options);
                                      });
         break;
+      case Action::DECRYPT:
+        benchmark::RegisterBenchmark(
+            benchName("decrypt").c_str(), [=](::benchmark::State &st) {
+              BM_ProcessResults(st, description, options);
+            });
+        break;
+      case Action::KEY_PLACEMENT:
+        for (std::string placement : {"default", "replicate", "interleave"}) {
+          benchmark::RegisterBenchmark(
+              benchName("evaluate-" + placement).c_str(),
+              [=](::benchmark::State &st) {
+                BM_EvaluateKeyPlacement(st, description, options, placement);
+              });
+        }
+        break;
       }
     }
   }
@@ -162,7 +246,12 @@ int main(int argc, char **argv) {
       llvm::cl::values(
           clEnumValN(Action::ENCRYPT, "encrypt", "Run encrypt benchmark")),
       llvm::cl::values(
-          clEnumValN(Action::EVALUATE, "evaluate", "Run evaluate benchmark")));
+          clEnumValN(Action::EVALUATE, "evaluate", "Run evaluate benchmark")),
+      llvm::cl::values(
+          clEnumValN(Action::DECRYPT, "decrypt", "Run decrypt benchmark")),
+      llvm::cl::values(clEnumValN(
+          Action::KEY_PLACEMENT, "key-placement",
+          "Run evaluate benchmark for each placement of the bootstrap keys")));
 
   // parse end to end test compiler options
   auto options = parseEndToEndCommandLine(argc, argv);
@@ -172,7 +261,7 @@ int main(int argc, char **argv) {
   std::vector<enum Action> actions = clActions;
   if (actions.empty()) {
     actions = {Action::COMPILE, Action::KEYGEN, Action::ENCRYPT,
-               Action::EVALUATE};
+               Action::EVALUATE, Action::DECRYPT};
   }
 
   auto stackSizeRequirement = 0;
@@ -165,3 +165,48 @@ TEST(ParallelizeAndRunFHE, nn_small_sequential) {
     }
   }
 }
+
+TEST(ParallelizeAndRunFHE, multi_parameters_sum_of_squares) {
+  auto options = mlir::concretelang::CompilationOptions("main");
+  options.optimizerConfig.strategy =
+      mlir::concretelang::optimizer::Strategy::DAG_MULTI;
+  options.dataflowParallelize = true;
+  TestCircuit testCircuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(testCircuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<3>, %arg1: !FHE.eint<3>, %arg2: !FHE.eint<3>, %arg3: !FHE.eint<3>) -> !FHE.eint<8> {
+  %tlu = arith.constant dense<[0, 1, 4, 9, 16, 25, 36, 49]> : tensor<8xi64>
+  %0 = "FHE.apply_lookup_table"(%arg0, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<8>)
+  %1 = "FHE.apply_lookup_table"(%arg1, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<8>)
+  %2 = "FHE.apply_lookup_table"(%arg2, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<8>)
+  %3 = "FHE.apply_lookup_table"(%arg3, %tlu): (!FHE.eint<3>, tensor<8xi64>) -> (!FHE.eint<8>)
+  %4 = "FHE.add_eint"(%0, %1): (!FHE.eint<8>, !FHE.eint<8>) -> (!FHE.eint<8>)
+  %5 = "FHE.add_eint"(%2, %3): (!FHE.eint<8>, !FHE.eint<8>) -> (!FHE.eint<8>)
+  %6 = "FHE.add_eint"(%4, %5): (!FHE.eint<8>, !FHE.eint<8>) -> (!FHE.eint<8>)
+  return %6: !FHE.eint<8>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(testCircuit.generateKeyset());
+
+  auto lambda = [&](std::vector<concretelang::values::Value> args) {
+    return testCircuit.call(args)
+        .value()[0]
+        .template getTensor<uint64_t>()
+        .value()[0];
+  };
+
+  if (mlir::concretelang::dfr::_dfr_is_root_node()) {
+    ASSERT_EQ(lambda({Tensor<uint64_t>(1), Tensor<uint64_t>(2),
+                      Tensor<uint64_t>(3), Tensor<uint64_t>(4)}),
+              (uint64_t)30);
+    ASSERT_EQ(lambda({Tensor<uint64_t>(5), Tensor<uint64_t>(6),
+                      Tensor<uint64_t>(2), Tensor<uint64_t>(3)}),
+              (uint64_t)74);
+    ASSERT_EQ(lambda({Tensor<uint64_t>(7), Tensor<uint64_t>(7),
+                      Tensor<uint64_t>(7), Tensor<uint64_t>(7)}),
+              (uint64_t)196);
+  } else {
+    ASSERT_OUTCOME_HAS_FAILURE(testCircuit.call({}));
+    ASSERT_OUTCOME_HAS_FAILURE(testCircuit.call({}));
+    ASSERT_OUTCOME_HAS_FAILURE(testCircuit.call({}));
+  }
+}
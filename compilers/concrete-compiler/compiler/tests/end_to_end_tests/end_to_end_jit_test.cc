@@ -1,12 +1,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <type_traits>
 
 #include "concretelang/TestLib/TestCircuit.h"
 #include "end_to_end_jit_test.h"
 #include "tests_tools/GtestEnvironment.h"
+#include "llvm/Support/FileSystem.h"
 
 TEST(CompileAndRunClear, add_u64) {
   checkedJit(testCircuit, R"XXX(
@@ -27,6 +29,129 @@ func.func @main(%arg0: i64, %arg1: i64) -> i64 {
   ASSERT_EQ(lambda({Tensor<uint64_t>(1), Tensor<uint64_t>(1)}), (uint64_t)2);
 }
 
+TEST(CompileAndRunClear, add_u64_circuit_libraries) {
+  auto options = mlir::concretelang::CompilationOptions("main");
+  options.emitCircuitLibraries = true;
+  TestCircuit testCircuit(options);
+  ASSERT_OUTCOME_HAS_VALUE(testCircuit.compile(R"XXX(
+func.func @main(%arg0: i64, %arg1: i64) -> i64 {
+  %1 = arith.addi %arg0, %arg1 : i64
+  return %1: i64
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(testCircuit.generateKeyset());
+  auto lambda = [&](std::vector<concretelang::values::Value> args) {
+    return testCircuit.call(args)
+        .value()[0]
+        .template getTensor<uint64_t>()
+        .value()[0];
+  };
+  ASSERT_EQ(lambda({Tensor<uint64_t>(1), Tensor<uint64_t>(2)}), (uint64_t)3);
+  ASSERT_EQ(lambda({Tensor<uint64_t>(4), Tensor<uint64_t>(5)}), (uint64_t)9);
+}
+
+TEST(CompileAndRunEncrypted, circuit_libraries_several_circuits) {
+  // Compiles the circuits separately into the same directory, and loads them
+  // as a single program, with the library of the program removed such that
+  // each circuit can only be loaded from its own library
+  llvm::SmallString<0> outputDir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("circuit_libraries",
+                                                    outputDir));
+  std::string outputDirPath = outputDir.str().str();
+  auto compile = [&](std::string name, std::string op)
+      -> llvm::Expected<mlir::concretelang::CompilerEngine::Library> {
+    auto options = mlir::concretelang::CompilationOptions(name);
+    options.emitCircuitLibraries = true;
+    mlir::concretelang::CompilerEngine compiler(
+        mlir::concretelang::CompilationContext::createShared());
+    compiler.setCompilationOptions(options);
+    return compiler.compile({R"XXX(
+func.func @)XXX" + name + R"XXX((%arg0: !FHE.eint<3>) -> !FHE.eint<3> {
+  %c1 = arith.constant 1 : i4
+  %1 = "FHE.)XXX" + op + R"XXX("(%arg0, %c1): (!FHE.eint<3>, i4) -> (!FHE.eint<3>)
+  return %1: !FHE.eint<3>
+}
+)XXX"},
+                            outputDirPath);
+  };
+  auto incLib = compile("inc", "add_eint_int");
+  ASSERT_EXPECTED_SUCCESS(incLib);
+  auto decLib = compile("dec", "sub_eint_int");
+  ASSERT_EXPECTED_SUCCESS(decLib);
+  auto incInfo = incLib->getProgramInfo();
+  auto decInfo = decLib->getProgramInfo();
+  ASSERT_EQ(Message<concreteprotocol::KeysetInfo>(
+                incInfo.asReader().getKeyset())
+                .debugString(),
+            Message<concreteprotocol::KeysetInfo>(
+                decInfo.asReader().getKeyset())
+                .debugString());
+  Message<concreteprotocol::ProgramInfo> programInfo = incInfo;
+  auto circuits = programInfo.asBuilder().initCircuits(2);
+  circuits.setWithCaveats(0, incInfo.asReader().getCircuits()[0]);
+  circuits.setWithCaveats(1, decInfo.asReader().getCircuits()[0]);
+
+  auto sharedLibPath =
+      mlir::concretelang::CompilerEngine::Library::getSharedLibraryPath(
+          outputDirPath);
+  ASSERT_FALSE(llvm::sys::fs::remove(sharedLibPath));
+
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      keyset, getTestKeySetCachePtr()->getKeyset(
+                  programInfo.asReader().getKeyset(), 0, 0));
+  auto encryptionCsprng =
+      std::make_shared<concretelang::csprng::EncryptionCSPRNG>(0);
+  ASSERT_ASSIGN_OUTCOME_VALUE(clientProgram,
+                              ClientProgram::create(programInfo, keyset.client,
+                                                    encryptionCsprng, false));
+  ASSERT_ASSIGN_OUTCOME_VALUE(
+      serverProgram, ServerProgram::load(programInfo, sharedLibPath, false));
+  auto call = [&](std::string name, uint64_t input) -> Result<uint64_t> {
+    OUTCOME_TRY(auto clientCircuit, clientProgram.getClientCircuit(name));
+    OUTCOME_TRY(auto serverCircuit, serverProgram.getServerCircuit(name));
+    OUTCOME_TRY(auto arg, clientCircuit.prepareInput(Tensor<uint64_t>(input),
+                                                     0));
+    std::vector<TransportValue> args{arg};
+    OUTCOME_TRY(auto results, serverCircuit.call(keyset.server, args));
+    OUTCOME_TRY(auto result, clientCircuit.processOutput(results[0], 0));
+    return result.template getTensor<uint64_t>().value()[0];
+  };
+  for (uint64_t input : {1, 2, 5}) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(incResult, call("inc", input));
+    ASSERT_EQ(incResult, input + 1);
+    ASSERT_ASSIGN_OUTCOME_VALUE(decResult, call("dec", input));
+    ASSERT_EQ(decResult, input - 1);
+  }
+  std::filesystem::remove_all(outputDirPath);
+}
+
+TEST(CompileAndRunEncrypted, circuit_libraries_recompile) {
+  // Recompiles different versions of the circuit into the same directory,
+  // each run must use the code of the last compilation
+  auto options = mlir::concretelang::CompilationOptions("main");
+  TestCircuit testCircuit(options);
+  auto check = [&](bool emitCircuitLibraries, int64_t value) {
+    options.emitCircuitLibraries = emitCircuitLibraries;
+    testCircuit.setCompilationOptions(options);
+    ASSERT_OUTCOME_HAS_VALUE(testCircuit.compile(R"XXX(
+func.func @main(%arg0: !FHE.eint<4>) -> !FHE.eint<4> {
+  %c = arith.constant )XXX" + std::to_string(value) + R"XXX( : i5
+  %1 = "FHE.add_eint_int"(%arg0, %c): (!FHE.eint<4>, i5) -> (!FHE.eint<4>)
+  return %1: !FHE.eint<4>
+}
+)XXX"));
+    ASSERT_OUTCOME_HAS_VALUE(testCircuit.generateKeyset());
+    std::vector<concretelang::values::Value> args{Tensor<uint64_t>(3)};
+    ASSERT_ASSIGN_OUTCOME_VALUE(res, testCircuit.call(args));
+    ASSERT_EQ(res[0].template getTensor<uint64_t>().value()[0],
+              (uint64_t)(3 + value));
+  };
+  check(true, 1);
+  check(false, 2);
+  check(true, 3);
+  check(true, 1);
+}
+
 TEST(CompileAndRunTensorEncrypted, extract_5) {
   checkedJit(testCircuit, R"XXX(
 func.func @main(%t: tensor<10x!FHE.eint<5>>, %i: index) -> !FHE.eint<5>{
@@ -363,3 +488,102 @@ func.func @main(%arg0: tensor<2x!FHE.eint<7>>, %arg1: tensor<2xi8>, %acc:
 
   ASSERT_EQ(lambda({arg0, arg1, acc}), 76_u64);
 }
+
+TEST(CompileAndRunTensorEncrypted, conv2d_winograd) {
+  // The multiplication of the wider integer bounds the noise, such that the
+  // convolution is rewritten into its Winograd form
+  std::string src = R"XXX(
+func.func @main(%x: tensor<1x1x4x4x!FHE.eint<4>>, %y: !FHE.eint<7>) -> (tensor<1x1x2x2x!FHE.eint<4>>, !FHE.eint<7>) {
+  %weight = arith.constant dense<[[[[4, 0, 0], [0, 4, 0], [0, 0, 0]]]]> : tensor<1x1x3x3xi5>
+  %0 = "FHELinalg.conv2d"(%x, %weight) : (tensor<1x1x4x4x!FHE.eint<4>>, tensor<1x1x3x3xi5>) -> tensor<1x1x2x2x!FHE.eint<4>>
+  %c3 = arith.constant 3 : i8
+  %1 = "FHE.mul_eint_int"(%y, %c3) : (!FHE.eint<7>, i8) -> !FHE.eint<7>
+  return %0, %1 : tensor<1x1x2x2x!FHE.eint<4>>, !FHE.eint<7>
+}
+)XXX";
+  Tensor<uint64_t> x({1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 0, 0, 1, 0, 1},
+                     {1, 1, 4, 4});
+  // out[r][s] = 4 * x[r][s] + 4 * x[r + 1][s + 1]
+  std::vector<uint64_t> expected = {8, 4, 4, 4};
+
+  for (bool winograd : {false, true}) {
+    auto options = mlir::concretelang::CompilationOptions("main");
+    options.winogradConv2d = winograd;
+    TestCircuit testCircuit(options);
+    ASSERT_OUTCOME_HAS_VALUE(testCircuit.compile({src}));
+    ASSERT_OUTCOME_HAS_VALUE(testCircuit.generateKeyset());
+    std::vector<concretelang::values::Value> args{x, Tensor<uint64_t>(5)};
+    ASSERT_ASSIGN_OUTCOME_VALUE(res, testCircuit.call(args));
+    ASSERT_EQ(res[0].template getTensor<uint64_t>().value().values, expected);
+    ASSERT_EQ(res[1].template getTensor<uint64_t>().value()[0], (uint64_t)15);
+  }
+}
+
+TEST(CompileAndRunTensorEncrypted, loop_outlining) {
+  auto options = mlir::concretelang::CompilationOptions("main");
+  options.multithreadPasses = true;
+  options.loopOutliningThreshold = 1;
+  TestCircuit testCircuit(options);
+  // The lookup table is applied by a loop without results, which is
+  // outlined, and the accumulation by a loop returning its buffer, which is
+  // not
+  ASSERT_OUTCOME_HAS_VALUE(testCircuit.compile(R"XXX(
+func.func @main(%arg0: tensor<4x!FHE.eint<4>>) -> (tensor<4x!FHE.eint<4>>, tensor<4x!FHE.eint<4>>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c3 = arith.constant 3 : index
+  %lut = arith.constant dense<[15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0]> : tensor<16xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %lut) : (tensor<4x!FHE.eint<4>>, tensor<16xi64>) -> tensor<4x!FHE.eint<4>>
+  %1 = scf.for %i = %c1 to %c3 step %c1 iter_args(%t = %arg0) -> tensor<4x!FHE.eint<4>> {
+    %prev = arith.subi %i, %c1 : index
+    %a = tensor.extract %t[%prev] : tensor<4x!FHE.eint<4>>
+    %b = tensor.extract %t[%i] : tensor<4x!FHE.eint<4>>
+    %s = "FHE.add_eint"(%a, %b) : (!FHE.eint<4>, !FHE.eint<4>) -> !FHE.eint<4>
+    %u = tensor.insert %s into %t[%i] : tensor<4x!FHE.eint<4>>
+    scf.yield %u : tensor<4x!FHE.eint<4>>
+  }
+  return %0, %1 : tensor<4x!FHE.eint<4>>, tensor<4x!FHE.eint<4>>
+}
+)XXX"));
+  ASSERT_OUTCOME_HAS_VALUE(testCircuit.generateKeyset());
+
+  Tensor<uint64_t> in({1, 2, 3, 4}, {4});
+  std::vector<concretelang::values::Value> args{in};
+  for (size_t run = 0; run < 2; run++) {
+    ASSERT_ASSIGN_OUTCOME_VALUE(res, testCircuit.call(args));
+    ASSERT_EQ(res[0].template getTensor<uint64_t>().value().values,
+              std::vector<uint64_t>({14, 13, 12, 11}));
+    ASSERT_EQ(res[1].template getTensor<uint64_t>().value().values,
+              std::vector<uint64_t>({1, 3, 6, 4}));
+  }
+}
+
+TEST(CompileAndRunTensorEncrypted, small_lwe_ciphertext_modulus_log_32) {
+  // The lookup tables are bootstrapped from 32 bits ciphertexts, one by one
+  // or batched, with the same lookup table or with mapped ones
+  for (bool batchTFHEOps : {false, true}) {
+    auto options = mlir::concretelang::CompilationOptions("main");
+    options.optimizerConfig.small_lwe_ciphertext_modulus_log = 32;
+    options.batchTFHEOps = batchTFHEOps;
+    TestCircuit testCircuit(options);
+    ASSERT_OUTCOME_HAS_VALUE(testCircuit.compile(R"XXX(
+func.func @main(%arg0: tensor<4x!FHE.eint<3>>) -> (tensor<4x!FHE.eint<3>>, tensor<4x!FHE.eint<3>>) {
+  %lut = arith.constant dense<[7, 6, 5, 4, 3, 2, 1, 0]> : tensor<8xi64>
+  %0 = "FHELinalg.apply_lookup_table"(%arg0, %lut) : (tensor<4x!FHE.eint<3>>, tensor<8xi64>) -> tensor<4x!FHE.eint<3>>
+  %luts = arith.constant dense<[[0, 1, 2, 3, 4, 5, 6, 7], [0, 2, 4, 6, 0, 2, 4, 6]]> : tensor<2x8xi64>
+  %map = arith.constant dense<[0, 1, 0, 1]> : tensor<4xindex>
+  %1 = "FHELinalg.apply_mapped_lookup_table"(%arg0, %luts, %map) : (tensor<4x!FHE.eint<3>>, tensor<2x8xi64>, tensor<4xindex>) -> tensor<4x!FHE.eint<3>>
+  return %0, %1 : tensor<4x!FHE.eint<3>>, tensor<4x!FHE.eint<3>>
+}
+)XXX"));
+    ASSERT_OUTCOME_HAS_VALUE(testCircuit.generateKeyset());
+
+    Tensor<uint64_t> in({1, 2, 5, 7}, {4});
+    std::vector<concretelang::values::Value> args{in};
+    ASSERT_ASSIGN_OUTCOME_VALUE(res, testCircuit.call(args));
+    ASSERT_EQ(res[0].template getTensor<uint64_t>().value().values,
+              std::vector<uint64_t>({6, 5, 2, 0}));
+    ASSERT_EQ(res[1].template getTensor<uint64_t>().value().values,
+              std::vector<uint64_t>({1, 4, 5, 6}));
+  }
+}
@@ -74,6 +74,10 @@ parseEndToEndCommandLine(int argc, char **argv) {
       "input-compression",
       llvm::cl::desc("Enable the compression of input ciphertext"),
       llvm::cl::init(false));
+  llvm::cl::opt<bool> outputCompression(
+      "output-compression",
+      llvm::cl::desc("Enable the compression of output ciphertext"),
+      llvm::cl::init(false));
 
   // Optimizer options
   llvm::cl::opt<int> securityLevel(
@@ -135,6 +139,7 @@ parseEndToEndCommandLine(int argc, char **argv) {
     compilationOptions.batchTFHEOps = batchTFHEOps.getValue().value();
   compilationOptions.simulate = simulate.getValue();
   compilationOptions.compressInputs = inputCompression.getValue();
+  compilationOptions.compressOutputs = outputCompression.getValue();
   compilationOptions.optimizerConfig.display = optimizerDisplay.getValue();
   compilationOptions.optimizerConfig.security = securityLevel.getValue();
   compilationOptions.optimizerConfig.strategy = optimizerStrategy.getValue();
@@ -5,6 +5,7 @@ import tempfile
 
 from concrete.compiler import (
     ClientSupport,
+    CompilationOptions,
     EvaluationKeys,
     LibrarySupport,
     PublicArguments,
@@ -134,3 +135,48 @@ def test_client_server_end_to_end(mlir, args, expected_result, keyset_cache):
             client_parameters, keyset, result_deserialized
         )
         assert np.array_equal(output, expected_result)
+
+
+def test_client_server_compressed_outputs(keyset_cache):
+    mlir = """
+
+func.func @main(%arg0: tensor<4x!FHE.eint<5>>) -> tensor<4x!FHE.eint<5>> {
+    %lut = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31]> : tensor<32xi64>
+    %res = "FHELinalg.apply_lookup_table"(%arg0, %lut): (tensor<4x!FHE.eint<5>>, tensor<32xi64>) -> (tensor<4x!FHE.eint<5>>)
+    return %res: tensor<4x!FHE.eint<5>>
+}
+
+    """
+    args = (np.array([1, 2, 30, 31], dtype=np.uint64),)
+
+    result_sizes = []
+    for compress_outputs in (False, True):
+        with tempfile.TemporaryDirectory() as tmpdirname:
+            support = LibrarySupport.new(str(tmpdirname))
+            options = CompilationOptions.new("main")
+            options.set_compress_outputs(compress_outputs)
+            compilation_result = support.compile(mlir, options)
+            server_lambda = support.load_server_lambda(compilation_result, False)
+
+            client_parameters = support.load_client_parameters(compilation_result)
+            keyset = ClientSupport.key_set(client_parameters, keyset_cache)
+
+            public_args = ClientSupport.encrypt_arguments(
+                client_parameters, keyset, args
+            )
+            result = support.server_call(
+                server_lambda, public_args, keyset.get_evaluation_keys()
+            )
+            result_serialized = result.serialize()
+            result_sizes.append(len(result_serialized))
+            result_deserialized = PublicResult.deserialize(
+                client_parameters, result_serialized
+            )
+
+            output = ClientSupport.decrypt_result(
+                client_parameters, keyset, result_deserialized
+            )
+            assert np.array_equal(output, args[0])
+
+    # the modulus switched ciphertexts are at least twice smaller
+    assert 2 * result_sizes[1] < result_sizes[0]
@@ -45,6 +45,7 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         maximum_acceptable_error_probability: p_error,
         key_sharing: true,
         ciphertext_modulus_log,
+        small_lwe_ciphertext_modulus_log: ciphertext_modulus_log,
         fft_precision,
         complexity_model: &CpuComplexity::default(),
     };
@@ -56,6 +57,7 @@ fn main() -> Result<(), Box<dyn std::error::Error>> {
         true,
         ciphertext_modulus_log,
         53,
+        1,
     );
 
     let solutions: Vec<_> = precisions
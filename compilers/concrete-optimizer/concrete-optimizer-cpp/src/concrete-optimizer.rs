@@ -1,4 +1,5 @@
-use concrete_optimizer::computing_cost::cpu::CpuComplexity;
+use concrete_optimizer::computing_cost::calibrated::CalibratedCpuComplexity;
+use concrete_optimizer::computing_cost::complexity_model::ComplexityModel;
 use concrete_optimizer::config;
 use concrete_optimizer::config::ProcessingUnit;
 use concrete_optimizer::dag::operator::{
@@ -13,6 +14,8 @@ use concrete_optimizer::optimization::dag::solo_key::optimize_generic::{
 use concrete_optimizer::optimization::decomposition;
 use concrete_optimizer::parameters::{BrDecompositionParameters, KsDecompositionParameters};
 use concrete_optimizer::utils::cache::persistent::default_cache_dir;
+use std::collections::BTreeMap;
+use std::sync::{Arc, Mutex};
 
 fn no_solution() -> ffi::Solution {
     ffi::Solution {
@@ -28,8 +31,49 @@ fn no_dag_solution() -> ffi::DagSolution {
     }
 }
 
-fn caches_from(options: ffi::Options) -> decomposition::PersistDecompCaches {
-    if !options.cache_on_disk {
+// The calibrated complexity models, loaded once per compilation by check_complexity_model
+static CALIBRATED_COMPLEXITY_MODELS: Mutex<BTreeMap<String, Arc<CalibratedCpuComplexity>>> =
+    Mutex::new(BTreeMap::new());
+
+fn check_complexity_model(path: &str) -> String {
+    let mut complexity_models = CALIBRATED_COMPLEXITY_MODELS.lock().unwrap();
+    match CalibratedCpuComplexity::from_file(path) {
+        Ok(complexity_model) => {
+            let _ = complexity_models.insert(path.into(), Arc::new(complexity_model));
+            String::new()
+        }
+        Err(err) => {
+            let _ = complexity_models.remove(path);
+            err
+        }
+    }
+}
+
+fn complexity_model_from(options: &ffi::Options) -> Result<Arc<dyn ComplexityModel>, String> {
+    let path = &options.complexity_model_path;
+    if path.is_empty() {
+        return Ok(ProcessingUnit::Cpu.complexity_model());
+    }
+    let mut complexity_models = CALIBRATED_COMPLEXITY_MODELS.lock().unwrap();
+    if let Some(complexity_model) = complexity_models.get(path) {
+        return Ok(complexity_model.clone());
+    }
+    let complexity_model = Arc::new(CalibratedCpuComplexity::from_file(path)?);
+    let _ = complexity_models.insert(path.clone(), complexity_model.clone());
+    Ok(complexity_model)
+}
+
+fn caches_from(
+    options: &ffi::Options,
+    complexity_model: &Arc<dyn ComplexityModel>,
+) -> decomposition::PersistDecompCaches {
+    // The caches on disk hold the decompositions ranked by the analytic complexity model
+    let calibrated = !options.complexity_model_path.is_empty();
+    let cache_on_disk = options.cache_on_disk && !calibrated;
+    if options.cache_on_disk && calibrated {
+        println!("optimizer: Using stateless cache, as the cache on disk is only valid for the");
+        println!("optimizer: analytic complexity model and a calibrated model is used.");
+    } else if !cache_on_disk {
         println!("optimizer: Using stateless cache.");
         let cache_dir = default_cache_dir();
         println!("optimizer: To clear the cache, remove directory {cache_dir}");
@@ -38,28 +82,37 @@ fn caches_from(options: ffi::Options) -> decomposition::PersistDecompCaches {
     decomposition::cache(
         options.security_level,
         processing_unit,
-        Some(ProcessingUnit::Cpu.complexity_model()),
-        options.cache_on_disk,
+        Some(complexity_model.clone()),
+        cache_on_disk,
         options.ciphertext_modulus_log,
         options.fft_precision,
+        options.multi_bit_grouping_factor,
     )
 }
 
-fn optimize_bootstrap(precision: u64, noise_factor: f64, options: ffi::Options) -> ffi::Solution {
-    let processing_unit = processing_unit(options);
+fn search_space_from(options: &ffi::Options) -> SearchSpace {
+    SearchSpace::default(processing_unit(options))
+        .with_grouping_factor(options.multi_bit_grouping_factor)
+}
 
+fn optimize_bootstrap(precision: u64, noise_factor: f64, options: ffi::Options) -> ffi::Solution {
+    let complexity_model = match complexity_model_from(&options) {
+        Ok(complexity_model) => complexity_model,
+        Err(_) => return no_solution(),
+    };
     let config = Config {
         security_level: options.security_level,
         maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
         key_sharing: options.key_sharing,
         ciphertext_modulus_log: options.ciphertext_modulus_log,
+        small_lwe_ciphertext_modulus_log: options.small_lwe_ciphertext_modulus_log,
         fft_precision: options.fft_precision,
-        complexity_model: &CpuComplexity::default(),
+        complexity_model: complexity_model.as_ref(),
     };
 
     let sum_size = 1;
 
-    let search_space = SearchSpace::default(processing_unit);
+    let search_space = search_space_from(&options);
 
     let result = concrete_optimizer::optimization::atomic_pattern::optimize_one(
         sum_size,
@@ -67,7 +120,7 @@ fn optimize_bootstrap(precision: u64, noise_factor: f64, options: ffi::Options)
         config,
         noise_factor,
         &search_space,
-        &caches_from(options),
+        &caches_from(&options, &complexity_model),
     );
     result
         .best_solution
@@ -501,24 +554,27 @@ impl OperationDag {
     }
 
     fn optimize_v0(&self, options: ffi::Options) -> ffi::Solution {
-        let processing_unit = processing_unit(options);
-
+        let complexity_model = match complexity_model_from(&options) {
+            Ok(complexity_model) => complexity_model,
+            Err(_) => return no_solution(),
+        };
         let config = Config {
             security_level: options.security_level,
             maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
+            small_lwe_ciphertext_modulus_log: options.small_lwe_ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: complexity_model.as_ref(),
         };
 
-        let search_space = SearchSpace::default(processing_unit);
+        let search_space = search_space_from(&options);
 
         let result = concrete_optimizer::optimization::dag::solo_key::optimize::optimize(
             &self.0,
             config,
             &search_space,
-            &caches_from(options),
+            &caches_from(&options, &complexity_model),
         );
         result
             .best_solution
@@ -526,17 +582,21 @@ impl OperationDag {
     }
 
     fn optimize(&self, options: ffi::Options) -> ffi::DagSolution {
-        let processing_unit = processing_unit(options);
+        let complexity_model = match complexity_model_from(&options) {
+            Ok(complexity_model) => complexity_model,
+            Err(_) => return no_dag_solution(),
+        };
         let config = Config {
             security_level: options.security_level,
             maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
+            small_lwe_ciphertext_modulus_log: options.small_lwe_ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: complexity_model.as_ref(),
         };
 
-        let search_space = SearchSpace::default(processing_unit);
+        let search_space = search_space_from(&options);
 
         let encoding = options.encoding.into();
         let result = concrete_optimizer::optimization::dag::solo_key::optimize_generic::optimize(
@@ -545,7 +605,7 @@ impl OperationDag {
             &search_space,
             encoding,
             options.default_log_norm2_woppbs,
-            &caches_from(options),
+            &caches_from(&options, &complexity_model),
         );
         result.map_or_else(no_dag_solution, |solution| solution.into())
     }
@@ -555,14 +615,24 @@ impl OperationDag {
     }
 
     fn optimize_multi(&self, options: ffi::Options) -> ffi::CircuitSolution {
-        let processing_unit = processing_unit(options);
+        // Circuit solutions cannot describe multi-bit bootstrap keys
+        let options = ffi::Options {
+            multi_bit_grouping_factor: 1,
+            ..options
+        };
+        let processing_unit = processing_unit(&options);
+        let complexity_model = match complexity_model_from(&options) {
+            Ok(complexity_model) => complexity_model,
+            Err(err) => return CircuitSolution::no_solution(err).into(),
+        };
         let config = Config {
             security_level: options.security_level,
             maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
             key_sharing: options.key_sharing,
             ciphertext_modulus_log: options.ciphertext_modulus_log,
+            small_lwe_ciphertext_modulus_log: options.small_lwe_ciphertext_modulus_log,
             fft_precision: options.fft_precision,
-            complexity_model: &CpuComplexity::default(),
+            complexity_model: complexity_model.as_ref(),
         };
         let search_space = SearchSpace::default(processing_unit);
 
@@ -574,8 +644,83 @@ impl OperationDag {
                 &search_space,
                 encoding,
                 options.default_log_norm2_woppbs,
-                &caches_from(options),
+                &caches_from(&options, &complexity_model),
+                &None,
+            );
+        circuit_sol.into()
+    }
+
+    fn optimize_global_p_error(
+        &self,
+        options: ffi::Options,
+        maximum_global_p_error: f64,
+    ) -> ffi::DagSolution {
+        let complexity_model = match complexity_model_from(&options) {
+            Ok(complexity_model) => complexity_model,
+            Err(_) => return no_dag_solution(),
+        };
+        let config = Config {
+            security_level: options.security_level,
+            maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
+            key_sharing: options.key_sharing,
+            ciphertext_modulus_log: options.ciphertext_modulus_log,
+            small_lwe_ciphertext_modulus_log: options.small_lwe_ciphertext_modulus_log,
+            fft_precision: options.fft_precision,
+            complexity_model: complexity_model.as_ref(),
+        };
+
+        let search_space = search_space_from(&options);
+
+        let encoding = options.encoding.into();
+        let result = concrete_optimizer::optimization::dag::solo_key::optimize_generic::optimize_for_global_p_error(
+            &self.0,
+            config,
+            &search_space,
+            encoding,
+            options.default_log_norm2_woppbs,
+            &caches_from(&options, &complexity_model),
+            maximum_global_p_error,
+        );
+        result.map_or_else(no_dag_solution, |solution| solution.into())
+    }
+
+    fn optimize_multi_global_p_error(
+        &self,
+        options: ffi::Options,
+        maximum_global_p_error: f64,
+    ) -> ffi::CircuitSolution {
+        // Circuit solutions cannot describe multi-bit bootstrap keys
+        let options = ffi::Options {
+            multi_bit_grouping_factor: 1,
+            ..options
+        };
+        let processing_unit = processing_unit(&options);
+        let complexity_model = match complexity_model_from(&options) {
+            Ok(complexity_model) => complexity_model,
+            Err(err) => return CircuitSolution::no_solution(err).into(),
+        };
+        let config = Config {
+            security_level: options.security_level,
+            maximum_acceptable_error_probability: options.maximum_acceptable_error_probability,
+            key_sharing: options.key_sharing,
+            ciphertext_modulus_log: options.ciphertext_modulus_log,
+            small_lwe_ciphertext_modulus_log: options.small_lwe_ciphertext_modulus_log,
+            fft_precision: options.fft_precision,
+            complexity_model: complexity_model.as_ref(),
+        };
+        let search_space = SearchSpace::default(processing_unit);
+
+        let encoding = options.encoding.into();
+        let circuit_sol =
+            concrete_optimizer::optimization::dag::multi_parameters::optimize_generic::optimize_for_global_p_error(
+                &self.0,
+                config,
+                &search_space,
+                encoding,
+                options.default_log_norm2_woppbs,
+                &caches_from(&options, &complexity_model),
                 &None,
+                maximum_global_p_error,
             );
         circuit_sol.into()
     }
@@ -634,6 +779,9 @@ mod ffi {
             dag: &OperationDag,
         ) -> CircuitSolution;
 
+        #[namespace = "concrete_optimizer::utils"]
+        fn check_complexity_model(path: &str) -> String;
+
         type OperationDag;
 
         #[namespace = "concrete_optimizer::dag"]
@@ -702,6 +850,18 @@ mod ffi {
 
         fn optimize_multi(self: &OperationDag, _options: Options) -> CircuitSolution;
 
+        fn optimize_global_p_error(
+            self: &OperationDag,
+            options: Options,
+            maximum_global_p_error: f64,
+        ) -> DagSolution;
+
+        fn optimize_multi_global_p_error(
+            self: &OperationDag,
+            options: Options,
+            maximum_global_p_error: f64,
+        ) -> CircuitSolution;
+
         fn NO_KEY_ID() -> u64;
     }
 
@@ -759,7 +919,7 @@ mod ffi {
     }
 
     #[namespace = "concrete_optimizer"]
-    #[derive(Debug, Clone, Copy)]
+    #[derive(Debug, Clone)]
     pub struct Options {
         pub security_level: u64,
         pub maximum_acceptable_error_probability: f64,
@@ -769,7 +929,10 @@ mod ffi {
         pub encoding: Encoding,
         pub cache_on_disk: bool,
         pub ciphertext_modulus_log: u32,
+        pub small_lwe_ciphertext_modulus_log: u32,
         pub fft_precision: u32,
+        pub multi_bit_grouping_factor: u32,
+        pub complexity_model_path: String,
     }
 
     #[namespace = "concrete_optimizer::dag"]
@@ -881,7 +1044,7 @@ mod ffi {
     }
 }
 
-fn processing_unit(options: ffi::Options) -> ProcessingUnit {
+fn processing_unit(options: &ffi::Options) -> ProcessingUnit {
     if options.use_gpu_constraints {
         config::ProcessingUnit::Gpu {
             pbs_type: config::GpuPbsType::Amortized,
@@ -916,6 +916,13 @@ std::size_t align_of() {
 }
 #endif // CXXBRIDGE1_LAYOUT
 
+template <typename T>
+union ManuallyDrop {
+  T value;
+  ManuallyDrop(T &&value) : value(::std::move(value)) {}
+  ~ManuallyDrop() {}
+};
+
 namespace detail {
 template <typename T, typename = void *>
 struct operator_new {
@@ -977,6 +984,8 @@ struct OperationDag final : public ::rust::Opaque {
   ::concrete_optimizer::dag::DagSolution optimize(::concrete_optimizer::Options options) const noexcept;
   ::rust::String dump() const noexcept;
   ::concrete_optimizer::dag::CircuitSolution optimize_multi(::concrete_optimizer::Options _options) const noexcept;
+  ::concrete_optimizer::dag::DagSolution optimize_global_p_error(::concrete_optimizer::Options options, double maximum_global_p_error) const noexcept;
+  ::concrete_optimizer::dag::CircuitSolution optimize_multi_global_p_error(::concrete_optimizer::Options options, double maximum_global_p_error) const noexcept;
   ~OperationDag() = delete;
 
 private:
@@ -1082,7 +1091,10 @@ struct Options final {
   ::concrete_optimizer::Encoding encoding;
   bool cache_on_disk;
   ::std::uint32_t ciphertext_modulus_log;
+  ::std::uint32_t small_lwe_ciphertext_modulus_log;
   ::std::uint32_t fft_precision;
+  ::std::uint32_t multi_bit_grouping_factor;
+  ::rust::String complexity_model_path;
 
   using IsRelocatable = ::std::true_type;
 };
@@ -1239,7 +1251,7 @@ struct CircuitSolution final {
 
 namespace v0 {
 extern "C" {
-::concrete_optimizer::v0::Solution concrete_optimizer$v0$cxxbridge1$optimize_bootstrap(::std::uint64_t precision, double noise_factor, ::concrete_optimizer::Options options) noexcept;
+::concrete_optimizer::v0::Solution concrete_optimizer$v0$cxxbridge1$optimize_bootstrap(::std::uint64_t precision, double noise_factor, ::concrete_optimizer::Options *options) noexcept;
 } // extern "C"
 } // namespace v0
 
@@ -1248,6 +1260,8 @@ extern "C" {
 void concrete_optimizer$utils$cxxbridge1$convert_to_dag_solution(::concrete_optimizer::v0::Solution const &solution, ::concrete_optimizer::dag::DagSolution *return$) noexcept;
 
 void concrete_optimizer$utils$cxxbridge1$convert_to_circuit_solution(::concrete_optimizer::dag::DagSolution const &solution, ::concrete_optimizer::OperationDag const &dag, ::concrete_optimizer::dag::CircuitSolution *return$) noexcept;
+
+void concrete_optimizer$utils$cxxbridge1$check_complexity_model(::rust::Str path, ::rust::String *return$) noexcept;
 } // extern "C"
 } // namespace utils
 
@@ -1275,9 +1289,9 @@ extern "C" {
 
 ::concrete_optimizer::dag::OperatorIndex concrete_optimizer$cxxbridge1$OperationDag$add_unsafe_cast_op(::concrete_optimizer::OperationDag &self, ::concrete_optimizer::dag::OperatorIndex input, ::std::uint8_t rounded_precision) noexcept;
 
-::concrete_optimizer::v0::Solution concrete_optimizer$cxxbridge1$OperationDag$optimize_v0(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options options) noexcept;
+::concrete_optimizer::v0::Solution concrete_optimizer$cxxbridge1$OperationDag$optimize_v0(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options *options) noexcept;
 
-void concrete_optimizer$cxxbridge1$OperationDag$optimize(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options options, ::concrete_optimizer::dag::DagSolution *return$) noexcept;
+void concrete_optimizer$cxxbridge1$OperationDag$optimize(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options *options, ::concrete_optimizer::dag::DagSolution *return$) noexcept;
 
 void concrete_optimizer$cxxbridge1$OperationDag$dump(::concrete_optimizer::OperationDag const &self, ::rust::String *return$) noexcept;
 } // extern "C"
@@ -1304,14 +1318,19 @@ extern "C" {
 } // namespace weights
 
 extern "C" {
-void concrete_optimizer$cxxbridge1$OperationDag$optimize_multi(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options _options, ::concrete_optimizer::dag::CircuitSolution *return$) noexcept;
+void concrete_optimizer$cxxbridge1$OperationDag$optimize_multi(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options *_options, ::concrete_optimizer::dag::CircuitSolution *return$) noexcept;
+
+void concrete_optimizer$cxxbridge1$OperationDag$optimize_global_p_error(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options *options, double maximum_global_p_error, ::concrete_optimizer::dag::DagSolution *return$) noexcept;
+
+void concrete_optimizer$cxxbridge1$OperationDag$optimize_multi_global_p_error(::concrete_optimizer::OperationDag const &self, ::concrete_optimizer::Options *options, double maximum_global_p_error, ::concrete_optimizer::dag::CircuitSolution *return$) noexcept;
 
 ::std::uint64_t concrete_optimizer$cxxbridge1$NO_KEY_ID() noexcept;
 } // extern "C"
 
 namespace v0 {
 ::concrete_optimizer::v0::Solution optimize_bootstrap(::std::uint64_t precision, double noise_factor, ::concrete_optimizer::Options options) noexcept {
-  return concrete_optimizer$v0$cxxbridge1$optimize_bootstrap(precision, noise_factor, options);
+  ::rust::ManuallyDrop<::concrete_optimizer::Options> options$(::std::move(options));
+  return concrete_optimizer$v0$cxxbridge1$optimize_bootstrap(precision, noise_factor, &options$.value);
 }
 } // namespace v0
 
@@ -1327,6 +1346,12 @@ namespace utils {
   concrete_optimizer$utils$cxxbridge1$convert_to_circuit_solution(solution, dag, &return$.value);
   return ::std::move(return$.value);
 }
+
+::rust::String check_complexity_model(::rust::Str path) noexcept {
+  ::rust::MaybeUninit<::rust::String> return$;
+  concrete_optimizer$utils$cxxbridge1$check_complexity_model(path, &return$.value);
+  return ::std::move(return$.value);
+}
 } // namespace utils
 
 ::std::size_t OperationDag::layout::size() noexcept {
@@ -1368,12 +1393,14 @@ namespace dag {
 }
 
 ::concrete_optimizer::v0::Solution OperationDag::optimize_v0(::concrete_optimizer::Options options) const noexcept {
-  return concrete_optimizer$cxxbridge1$OperationDag$optimize_v0(*this, options);
+  ::rust::ManuallyDrop<::concrete_optimizer::Options> options$(::std::move(options));
+  return concrete_optimizer$cxxbridge1$OperationDag$optimize_v0(*this, &options$.value);
 }
 
 ::concrete_optimizer::dag::DagSolution OperationDag::optimize(::concrete_optimizer::Options options) const noexcept {
+  ::rust::ManuallyDrop<::concrete_optimizer::Options> options$(::std::move(options));
   ::rust::MaybeUninit<::concrete_optimizer::dag::DagSolution> return$;
-  concrete_optimizer$cxxbridge1$OperationDag$optimize(*this, options, &return$.value);
+  concrete_optimizer$cxxbridge1$OperationDag$optimize(*this, &options$.value, &return$.value);
   return ::std::move(return$.value);
 }
 
@@ -1416,8 +1443,23 @@ namespace weights {
 } // namespace weights
 
 ::concrete_optimizer::dag::CircuitSolution OperationDag::optimize_multi(::concrete_optimizer::Options _options) const noexcept {
+  ::rust::ManuallyDrop<::concrete_optimizer::Options> _options$(::std::move(_options));
+  ::rust::MaybeUninit<::concrete_optimizer::dag::CircuitSolution> return$;
+  concrete_optimizer$cxxbridge1$OperationDag$optimize_multi(*this, &_options$.value, &return$.value);
+  return ::std::move(return$.value);
+}
+
+::concrete_optimizer::dag::DagSolution OperationDag::optimize_global_p_error(::concrete_optimizer::Options options, double maximum_global_p_error) const noexcept {
+  ::rust::ManuallyDrop<::concrete_optimizer::Options> options$(::std::move(options));
+  ::rust::MaybeUninit<::concrete_optimizer::dag::DagSolution> return$;
+  concrete_optimizer$cxxbridge1$OperationDag$optimize_global_p_error(*this, &options$.value, maximum_global_p_error, &return$.value);
+  return ::std::move(return$.value);
+}
+
+::concrete_optimizer::dag::CircuitSolution OperationDag::optimize_multi_global_p_error(::concrete_optimizer::Options options, double maximum_global_p_error) const noexcept {
+  ::rust::ManuallyDrop<::concrete_optimizer::Options> options$(::std::move(options));
   ::rust::MaybeUninit<::concrete_optimizer::dag::CircuitSolution> return$;
-  concrete_optimizer$cxxbridge1$OperationDag$optimize_multi(*this, _options, &return$.value);
+  concrete_optimizer$cxxbridge1$OperationDag$optimize_multi_global_p_error(*this, &options$.value, maximum_global_p_error, &return$.value);
   return ::std::move(return$.value);
 }
 
@@ -958,6 +958,8 @@ struct OperationDag final : public ::rust::Opaque {
   ::concrete_optimizer::dag::DagSolution optimize(::concrete_optimizer::Options options) const noexcept;
   ::rust::String dump() const noexcept;
   ::concrete_optimizer::dag::CircuitSolution optimize_multi(::concrete_optimizer::Options _options) const noexcept;
+  ::concrete_optimizer::dag::DagSolution optimize_global_p_error(::concrete_optimizer::Options options, double maximum_global_p_error) const noexcept;
+  ::concrete_optimizer::dag::CircuitSolution optimize_multi_global_p_error(::concrete_optimizer::Options options, double maximum_global_p_error) const noexcept;
   ~OperationDag() = delete;
 
 private:
@@ -1063,7 +1065,10 @@ struct Options final {
   ::concrete_optimizer::Encoding encoding;
   bool cache_on_disk;
   ::std::uint32_t ciphertext_modulus_log;
+  ::std::uint32_t small_lwe_ciphertext_modulus_log;
   ::std::uint32_t fft_precision;
+  ::std::uint32_t multi_bit_grouping_factor;
+  ::rust::String complexity_model_path;
 
   using IsRelocatable = ::std::true_type;
 };
@@ -1226,6 +1231,8 @@ namespace utils {
 ::concrete_optimizer::dag::DagSolution convert_to_dag_solution(::concrete_optimizer::v0::Solution const &solution) noexcept;
 
 ::concrete_optimizer::dag::CircuitSolution convert_to_circuit_solution(::concrete_optimizer::dag::DagSolution const &solution, ::concrete_optimizer::OperationDag const &dag) noexcept;
+
+::rust::String check_complexity_model(::rust::Str path) noexcept;
 } // namespace utils
 
 namespace dag {
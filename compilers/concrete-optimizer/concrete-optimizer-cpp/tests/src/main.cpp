@@ -1,5 +1,7 @@
 #include "concrete-optimizer.hpp"
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include <vector>
 
 template <typename T>
@@ -28,7 +30,10 @@ concrete_optimizer::Options default_options() {
       .encoding = concrete_optimizer::Encoding::Auto,
       .cache_on_disk = true,
       .ciphertext_modulus_log = CIPHERTEXT_MODULUS_LOG,
+      .small_lwe_ciphertext_modulus_log = CIPHERTEXT_MODULUS_LOG,
       .fft_precision = 53,
+      .multi_bit_grouping_factor = 1,
+      .complexity_model_path = "",
   };
 }
 
@@ -213,6 +218,39 @@ void test_multi_parameters_2_precision_crt() {
   assert(circuit_solution.circuit_keys.conversion_keyswitch_keys.size() == 0);
 }
 
+void test_calibrated_complexity_model() {
+  const char *path = "calibrated_complexity_model.txt";
+  assert(!concrete_optimizer::utils::check_complexity_model(path).empty());
+
+  std::ofstream model(path);
+  model << "# host calibration\n"
+        << "levelled 1024 400\n"
+        << "keyswitch 1024 512 3 3000000\n"
+        << "keyswitch 4096 512 6 40000000\n"
+        << "pbs 128 1 10 1 2000000\n"
+        << "pbs 128 1 12 2 20000000\n";
+  model.close();
+  assert(concrete_optimizer::utils::check_complexity_model(path).empty());
+
+  auto dag = concrete_optimizer::dag::empty();
+
+  std::vector<uint64_t> shape = {3};
+
+  concrete_optimizer::dag::OperatorIndex input =
+      dag->add_input(PRECISION_8B, slice(shape));
+
+  std::vector<u_int64_t> table = {};
+  dag->add_lut(input, slice(table), PRECISION_8B);
+
+  auto options = default_options();
+  options.complexity_model_path = path;
+  auto solution = dag->optimize(options);
+  assert(solution.p_error < 1.0);
+  assert(!solution.use_wop_pbs);
+
+  std::remove(path);
+}
+
 int main() {
   test_v0();
   test_dag_no_lut();
@@ -222,6 +260,7 @@ int main() {
   test_multi_parameters_1_precision();
   test_multi_parameters_2_precision();
   test_multi_parameters_2_precision_crt();
+  test_calibrated_complexity_model();
 
   return 0;
 }
@@ -0,0 +1,381 @@
+use super::complexity::Complexity;
+use super::complexity_model::ComplexityModel;
+use super::cpu::CpuComplexity;
+use crate::parameters::{
+    BrDecompositionParameters, CmuxParameters, GlweParameters, KeyswitchParameters,
+    KsDecompositionParameters, LweDimension, PbsParameters,
+};
+
+// The calibration measures the native 64 bits operations
+const CALIBRATION_CIPHERTEXT_MODULUS_LOG: u32 = 64;
+
+// A measured ratio between the host cost and the analytic cost, at a given log2 of key size
+#[derive(Clone, Copy, Debug)]
+struct CalibrationPoint {
+    log2_key_size: f64,
+    factor: f64,
+}
+
+/// Cpu complexity model scaling the analytic costs of `CpuComplexity` by factors measured on the
+/// host.
+///
+/// The model file is written by the `calibrate_complexity` example of concrete-cpu. Each line is
+/// either a comment starting with `#`, or a timing in nanoseconds of one operation:
+/// ```text
+/// levelled <lwe_dimension> <ns>
+/// keyswitch <input_lwe_dimension> <output_lwe_dimension> <level> <ns>
+/// pbs <internal_lwe_dimension> <glwe_dimension> <log2_polynomial_size> <level> <ns>
+/// ```
+/// The levelled timings give the duration of one unit of levelled complexity. The keyswitch and
+/// pbs factors are interpolated over the log2 of the size of the key read by the operation,
+/// i.e. of the keyswitch key and of one ggsw of the bootstrap key, such that cache effects are
+/// accounted for. Costs stay expressed in units of levelled complexity.
+#[derive(Clone)]
+pub struct CalibratedCpuComplexity {
+    analytic: CpuComplexity,
+    ks_points: Vec<CalibrationPoint>,
+    pbs_points: Vec<CalibrationPoint>,
+}
+
+fn ks_log2_key_size(params: KeyswitchParameters) -> f64 {
+    let input_lwe_dimension = params.input_lwe_dimension.0 as f64;
+    let output_lwe_size = (params.output_lwe_dimension.0 + 1) as f64;
+    let level = params.ks_decomposition_parameter.level as f64;
+    (input_lwe_dimension * level * output_lwe_size * 8.0).log2()
+}
+
+fn ggsw_log2_key_size(params: CmuxParameters) -> f64 {
+    let glwe_size = (params.output_glwe_params.glwe_dimension + 1) as f64;
+    let polynomial_size = params.output_glwe_params.polynomial_size() as f64;
+    let level = params.br_decomposition_parameter.level as f64;
+    // polynomial_size / 2 complex f64 per fourier polynomial
+    (level * glwe_size * glwe_size * polynomial_size * 8.0).log2()
+}
+
+// Piecewise linear interpolation of the factors, constant outside of the measured range
+fn interpolate(points: &[CalibrationPoint], log2_key_size: f64) -> f64 {
+    let first = points[0];
+    if log2_key_size <= first.log2_key_size {
+        return first.factor;
+    }
+    for window in points.windows(2) {
+        let (low, high) = (window[0], window[1]);
+        if log2_key_size <= high.log2_key_size {
+            let t = (log2_key_size - low.log2_key_size) / (high.log2_key_size - low.log2_key_size);
+            return low.factor + t * (high.factor - low.factor);
+        }
+    }
+    points[points.len() - 1].factor
+}
+
+// Sorts the points and averages the factors measured at the same key size
+#[allow(clippy::float_cmp)]
+fn normalize(mut points: Vec<CalibrationPoint>) -> Vec<CalibrationPoint> {
+    points.sort_by(|a, b| a.log2_key_size.total_cmp(&b.log2_key_size));
+    let mut merged: Vec<(CalibrationPoint, f64)> = vec![];
+    for point in points {
+        match merged.last_mut() {
+            Some((last, count)) if last.log2_key_size == point.log2_key_size => {
+                last.factor = (last.factor * *count + point.factor) / (*count + 1.0);
+                *count += 1.0;
+            }
+            _ => merged.push((point, 1.0)),
+        }
+    }
+    merged.into_iter().map(|(point, _)| point).collect()
+}
+
+fn parse_values(line_number: usize, fields: &[&str], count: usize) -> Result<Vec<f64>, String> {
+    if fields.len() != count {
+        return Err(format!(
+            "line {line_number}: expected {count} values, got {}",
+            fields.len()
+        ));
+    }
+    let values = fields
+        .iter()
+        .map(|field| {
+            field
+                .parse::<f64>()
+                .map_err(|_| format!("line {line_number}: invalid value {field}"))
+        })
+        .collect::<Result<Vec<f64>, String>>()?;
+    if values
+        .iter()
+        .any(|value| !value.is_finite() || *value <= 0.0)
+    {
+        return Err(format!("line {line_number}: values must be positive"));
+    }
+    Ok(values)
+}
+
+impl CalibratedCpuComplexity {
+    /// Loads the model written at `path`.
+    ///
+    /// # Errors
+    /// When the file cannot be read or is not a valid model.
+    pub fn from_file(path: &str) -> Result<Self, String> {
+        let content = std::fs::read_to_string(path)
+            .map_err(|err| format!("cannot read complexity model {path}: {err}"))?;
+        Self::parse(&content).map_err(|err| format!("invalid complexity model {path}, {err}"))
+    }
+
+    /// Parses a model from the content of its file.
+    ///
+    /// # Errors
+    /// When a line is malformed, or a kind of operation has no timing.
+    #[allow(clippy::cast_sign_loss)]
+    pub fn parse(content: &str) -> Result<Self, String> {
+        let analytic = CpuComplexity::default();
+        let mut levelled_ns = vec![];
+        let mut ks_timings = vec![];
+        let mut pbs_timings = vec![];
+        for (i, line) in content.lines().enumerate() {
+            let line_number = i + 1;
+            let line = line.trim();
+            if line.is_empty() || line.starts_with('#') {
+                continue;
+            }
+            let fields: Vec<&str> = line.split_whitespace().collect();
+            match fields[0] {
+                "levelled" => {
+                    let values = parse_values(line_number, &fields[1..], 2)?;
+                    let complexity = analytic.levelled_complexity(
+                        1,
+                        LweDimension(values[0] as u64),
+                        CALIBRATION_CIPHERTEXT_MODULUS_LOG,
+                    );
+                    levelled_ns.push(values[1] / complexity);
+                }
+                "keyswitch" => {
+                    let values = parse_values(line_number, &fields[1..], 4)?;
+                    let params = KeyswitchParameters {
+                        input_lwe_dimension: LweDimension(values[0] as u64),
+                        output_lwe_dimension: LweDimension(values[1] as u64),
+                        ks_decomposition_parameter: KsDecompositionParameters {
+                            level: values[2] as u64,
+                            log2_base: 0,
+                        },
+                    };
+                    ks_timings.push((params, values[3]));
+                }
+                "pbs" => {
+                    let values = parse_values(line_number, &fields[1..], 5)?;
+                    let params = PbsParameters {
+                        internal_lwe_dimension: LweDimension(values[0] as u64),
+                        br_decomposition_parameter: BrDecompositionParameters {
+                            level: values[3] as u64,
+                            log2_base: 0,
+                        },
+                        output_glwe_params: GlweParameters {
+                            log2_polynomial_size: values[2] as u64,
+                            glwe_dimension: values[1] as u64,
+                        },
+                    };
+                    pbs_timings.push((params, values[4]));
+                }
+                kind => return Err(format!("line {line_number}: unknown operation {kind}")),
+            }
+        }
+        if levelled_ns.is_empty() || ks_timings.is_empty() || pbs_timings.is_empty() {
+            return Err("levelled, keyswitch and pbs timings are all required".into());
+        }
+        let ns_per_levelled_op = levelled_ns.iter().sum::<f64>() / levelled_ns.len() as f64;
+
+        let ks_points = ks_timings
+            .into_iter()
+            .map(|(params, ns)| CalibrationPoint {
+                log2_key_size: ks_log2_key_size(params),
+                factor: ns
+                    / ns_per_levelled_op
+                    / analytic.ks_complexity(params, CALIBRATION_CIPHERTEXT_MODULUS_LOG),
+            })
+            .collect();
+        let pbs_points = pbs_timings
+            .into_iter()
+            .map(|(params, ns)| CalibrationPoint {
+                log2_key_size: ggsw_log2_key_size(params.cmux_parameters()),
+                factor: ns
+                    / ns_per_levelled_op
+                    / analytic.pbs_complexity(params, CALIBRATION_CIPHERTEXT_MODULUS_LOG),
+            })
+            .collect();
+
+        Ok(Self {
+            analytic,
+            ks_points: normalize(ks_points),
+            pbs_points: normalize(pbs_points),
+        })
+    }
+
+    fn pbs_factor(&self, params: CmuxParameters) -> f64 {
+        interpolate(&self.pbs_points, ggsw_log2_key_size(params))
+    }
+}
+
+impl ComplexityModel for CalibratedCpuComplexity {
+    fn pbs_complexity(&self, params: PbsParameters, ciphertext_modulus_log: u32) -> Complexity {
+        self.pbs_factor(params.cmux_parameters())
+            * self.analytic.pbs_complexity(params, ciphertext_modulus_log)
+    }
+
+    fn multi_bit_pbs_complexity(
+        &self,
+        params: PbsParameters,
+        ciphertext_modulus_log: u32,
+        grouping_factor: u32,
+        jit_fft: bool,
+    ) -> Complexity {
+        self.pbs_factor(params.cmux_parameters())
+            * self.analytic.multi_bit_pbs_complexity(
+                params,
+                ciphertext_modulus_log,
+                grouping_factor,
+                jit_fft,
+            )
+    }
+
+    fn cmux_complexity(&self, params: CmuxParameters, ciphertext_modulus_log: u32) -> Complexity {
+        self.pbs_factor(params)
+            * self
+                .analytic
+                .cmux_complexity(params, ciphertext_modulus_log)
+    }
+
+    fn ks_complexity(
+        &self,
+        params: KeyswitchParameters,
+        ciphertext_modulus_log: u32,
+    ) -> Complexity {
+        interpolate(&self.ks_points, ks_log2_key_size(params))
+            * self.analytic.ks_complexity(params, ciphertext_modulus_log)
+    }
+
+    #[allow(clippy::cast_sign_loss)]
+    fn fft_complexity(&self, glwe_polynomial_size: f64, ciphertext_modulus_log: u32) -> Complexity {
+        // The smallest ggsw of this polynomial size
+        let params = CmuxParameters {
+            br_decomposition_parameter: BrDecompositionParameters {
+                level: 1,
+                log2_base: 0,
+            },
+            output_glwe_params: GlweParameters {
+                log2_polynomial_size: glwe_polynomial_size.log2() as u64,
+                glwe_dimension: 1,
+            },
+        };
+        self.pbs_factor(params)
+            * self
+                .analytic
+                .fft_complexity(glwe_polynomial_size, ciphertext_modulus_log)
+    }
+
+    fn levelled_complexity(
+        &self,
+        sum_size: u64,
+        lwe_dimension: LweDimension,
+        ciphertext_modulus_log: u32,
+    ) -> Complexity {
+        self.analytic
+            .levelled_complexity(sum_size, lwe_dimension, ciphertext_modulus_log)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn ks_params(input_lwe_dimension: u64, level: u64) -> KeyswitchParameters {
+        KeyswitchParameters {
+            input_lwe_dimension: LweDimension(input_lwe_dimension),
+            output_lwe_dimension: LweDimension(511),
+            ks_decomposition_parameter: KsDecompositionParameters {
+                level,
+                log2_base: 0,
+            },
+        }
+    }
+
+    fn pbs_params(log2_polynomial_size: u64) -> PbsParameters {
+        PbsParameters {
+            internal_lwe_dimension: LweDimension(128),
+            br_decomposition_parameter: BrDecompositionParameters {
+                level: 1,
+                log2_base: 0,
+            },
+            output_glwe_params: GlweParameters {
+                log2_polynomial_size,
+                glwe_dimension: 1,
+            },
+        }
+    }
+
+    // Timings following the analytic model with 2ns per levelled op, except for the
+    // keyswitch with the largest key which is 4 times slower
+    fn model_content() -> String {
+        let analytic = CpuComplexity::default();
+        let small_ks = 2.0 * analytic.ks_complexity(ks_params(1024, 1), 64);
+        let large_ks = 8.0 * analytic.ks_complexity(ks_params(4096, 4), 64);
+        let small_pbs = 2.0 * analytic.pbs_complexity(pbs_params(10), 64);
+        let large_pbs = 2.0 * analytic.pbs_complexity(pbs_params(12), 64);
+        format!(
+            "# host calibration\n\
+             levelled 1024 2048\n\
+             keyswitch 1024 511 1 {small_ks}\n\
+             keyswitch 4096 511 4 {large_ks}\n\
+             pbs 128 1 10 1 {small_pbs}\n\
+             pbs 128 1 12 1 {large_pbs}\n"
+        )
+    }
+
+    #[test]
+    #[allow(clippy::float_cmp)]
+    fn calibrated_factors() {
+        let analytic = CpuComplexity::default();
+        let model = CalibratedCpuComplexity::parse(&model_content()).unwrap();
+
+        let small_ks = ks_params(1024, 1);
+        approx::assert_relative_eq!(
+            model.ks_complexity(small_ks, 64),
+            analytic.ks_complexity(small_ks, 64),
+            max_relative = 1e-9
+        );
+        let large_ks = ks_params(4096, 4);
+        approx::assert_relative_eq!(
+            model.ks_complexity(large_ks, 64),
+            4.0 * analytic.ks_complexity(large_ks, 64),
+            max_relative = 1e-9
+        );
+        // The factor is interpolated between the measured key sizes
+        let medium_ks = ks_params(2048, 2);
+        let factor = model.ks_complexity(medium_ks, 64) / analytic.ks_complexity(medium_ks, 64);
+        assert!(1.0 < factor && factor < 4.0);
+        // and constant outside of them
+        let huge_ks = ks_params(8192, 8);
+        approx::assert_relative_eq!(
+            model.ks_complexity(huge_ks, 64),
+            4.0 * analytic.ks_complexity(huge_ks, 64),
+            max_relative = 1e-9
+        );
+
+        let pbs = pbs_params(11);
+        approx::assert_relative_eq!(
+            model.pbs_complexity(pbs, 64),
+            analytic.pbs_complexity(pbs, 64),
+            max_relative = 1e-9
+        );
+        assert_eq!(
+            model.levelled_complexity(10, LweDimension(512), 64),
+            analytic.levelled_complexity(10, LweDimension(512), 64)
+        );
+    }
+
+    #[test]
+    fn invalid_models() {
+        assert!(CalibratedCpuComplexity::parse("").is_err());
+        assert!(CalibratedCpuComplexity::parse("levelled 1024 2048\n").is_err());
+        assert!(CalibratedCpuComplexity::parse(&(model_content() + "keyswitch 1 2\n")).is_err());
+        assert!(CalibratedCpuComplexity::parse(&(model_content() + "cmux 1 2 3 4\n")).is_err());
+        assert!(CalibratedCpuComplexity::parse(&(model_content() + "levelled 1024 -1\n")).is_err());
+    }
+}
@@ -1,4 +1,5 @@
 mod atomic_pattern;
+pub mod calibrated;
 pub mod complexity;
 pub mod complexity_model;
 pub mod cpu;
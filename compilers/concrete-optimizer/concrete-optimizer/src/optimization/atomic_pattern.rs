@@ -1,4 +1,4 @@
-use concrete_cpu_noise_model::gaussian_noise::noise::modulus_switching::estimate_modulus_switching_noise_with_binary_key;
+use concrete_cpu_noise_model::gaussian_noise::noise::modulus_switching::estimate_modulus_switching_noise_with_binary_key_and_storage_modulus;
 
 use super::config::{Config, SearchSpace};
 use super::decomposition::cmux::CmuxComplexityNoise;
@@ -59,11 +59,13 @@ fn update_state_with_best_decompositions(
     ks_quantities: &[KsComplexityNoise],
 ) {
     let input_lwe_dimension = glwe_params.sample_extract_lwe_dimension();
-    let noise_modulus_switching = estimate_modulus_switching_noise_with_binary_key(
-        internal_dim,
-        glwe_params.log2_polynomial_size,
-        consts.config.ciphertext_modulus_log,
-    );
+    let noise_modulus_switching =
+        estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+            internal_dim,
+            glwe_params.log2_polynomial_size,
+            consts.config.small_lwe_ciphertext_modulus_log,
+            consts.config.ciphertext_modulus_log,
+        );
     let safe_variance = consts.safe_variance;
     if CUTS && noise_modulus_switching > safe_variance {
         return;
@@ -180,9 +182,10 @@ pub fn optimize_one(
     let min_internal_lwe_dimensions = search_space.internal_lwe_dimensions[0];
     let lower_bound_cut = |glwe_log_poly_size| {
         // TODO: cut if min complexity is higher than current best
-        CUTS && estimate_modulus_switching_noise_with_binary_key(
+        CUTS && estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
             min_internal_lwe_dimensions,
             glwe_log_poly_size,
+            config.small_lwe_ciphertext_modulus_log,
             ciphertext_modulus_log,
         ) > consts.safe_variance
     };
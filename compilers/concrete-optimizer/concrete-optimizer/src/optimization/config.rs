@@ -16,6 +16,9 @@ pub struct Config<'a> {
     pub maximum_acceptable_error_probability: f64,
     pub key_sharing: bool,
     pub ciphertext_modulus_log: u32,
+    /// Modulus log of the ciphertexts stored under the small keyswitch output
+    /// key, between the keyswitch and the blind rotation.
+    pub small_lwe_ciphertext_modulus_log: u32,
     pub fft_precision: u32,
     pub complexity_model: &'a dyn ComplexityModel,
 }
@@ -76,6 +79,15 @@ impl SearchSpace {
             levelled_only_lwe_dimensions,
         }
     }
+    /// Restricts the internal lwe dimensions to the ones supported by multi-bit bootstrap keys of
+    /// `grouping_factor`, i.e. its multiples.
+    pub fn with_grouping_factor(mut self, grouping_factor: u32) -> Self {
+        let grouping_factor = grouping_factor.max(1) as u64;
+        self.internal_lwe_dimensions
+            .retain(|dimension| dimension % grouping_factor == 0);
+        self
+    }
+
     pub fn default(processing_unit: config::ProcessingUnit) -> Self {
         match processing_unit {
             config::ProcessingUnit::Cpu => Self::default_cpu(),
@@ -0,0 +1,111 @@
+// Search of the maximum acceptable error probability per operation that meets a global error
+// probability for the full dag.
+
+// The maximum number of searches done to meet the global error probability
+pub const MAXIMUM_OPTIMIZER_CALL: usize = 10;
+
+// The next error probability per operation, approximating the relation between the error
+// probability per operation and the global one by the last solution
+fn surrogate_p_error(
+    maximum_acceptable_error_probability: f64,
+    p_error: f64,
+    global_p_error: f64,
+    maximum_global_p_error: f64,
+) -> f64 {
+    let ref_global_p_success = 1.0 - maximum_global_p_error;
+    let local_p_success = 1.0 - p_error;
+    let global_p_success = 1.0 - global_p_error;
+    let power_global_to_local = local_p_success.ln() / global_p_success.ln();
+    let surrogate_p_local_success = ref_global_p_success.powf(power_global_to_local);
+
+    let surrogate_p_error = 1.0 - surrogate_p_local_success;
+
+    // only valid when p_error is not too small and global_p_error not too high
+    if 0.0 < surrogate_p_error && surrogate_p_error < 1.0 {
+        return surrogate_p_error;
+    }
+    // linear approximation, only precise for small p_error
+    let mut linear_correction = if p_error < 0.1 {
+        p_error / global_p_error
+    } else {
+        0.1
+    };
+    if !(0.0 < linear_correction && linear_correction < 1.0) {
+        // global_p_error could be 0
+        linear_correction = 1e-5;
+    }
+    maximum_acceptable_error_probability * linear_correction
+}
+
+// Repeats `optimize` with decreasing maximum acceptable error probabilities until its solution
+// meets `maximum_global_p_error`. `errors` gives the error probability per operation and the
+// global one of a solution, or None if there is no solution.
+pub fn optimize<S>(
+    maximum_acceptable_error_probability: f64,
+    maximum_global_p_error: f64,
+    mut optimize: impl FnMut(f64) -> S,
+    errors: impl Fn(&S) -> Option<(f64, f64)>,
+) -> S {
+    let mut maximum_acceptable_error_probability =
+        maximum_acceptable_error_probability.min(maximum_global_p_error);
+    let mut sol = optimize(maximum_acceptable_error_probability);
+    for _ in 1..MAXIMUM_OPTIMIZER_CALL {
+        // A lower error probability cannot give a solution if there is none
+        let (p_error, global_p_error) = match errors(&sol) {
+            Some(errors) => errors,
+            None => break,
+        };
+        if global_p_error <= maximum_global_p_error {
+            // for levelled circuit the error is almost zero
+            break;
+        }
+        maximum_acceptable_error_probability = surrogate_p_error(
+            maximum_acceptable_error_probability,
+            p_error,
+            global_p_error,
+            maximum_global_p_error,
+        );
+        sol = optimize(maximum_acceptable_error_probability);
+    }
+    sol
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::noise_estimator::p_error::repeat_p_error;
+
+    #[test]
+    fn test_global_p_error_is_met() {
+        let nb_luts = 1000;
+        let mut nb_calls = 0;
+        let (p_error, global_p_error) = optimize(
+            0.01,
+            0.001,
+            |p_error| {
+                nb_calls += 1;
+                (p_error, repeat_p_error(p_error, nb_luts))
+            },
+            |&errors| Some(errors),
+        );
+        assert!(global_p_error <= 0.001);
+        assert!(p_error <= 0.001 / nb_luts as f64 * 1.01);
+        assert!(nb_calls <= MAXIMUM_OPTIMIZER_CALL);
+    }
+
+    #[test]
+    fn test_no_solution_stops() {
+        let mut nb_calls = 0;
+        let sol: Option<f64> = optimize(
+            0.01,
+            0.001,
+            |_| {
+                nb_calls += 1;
+                None
+            },
+            |sol| sol.map(|p_error| (p_error, 1.0)),
+        );
+        assert!(sol.is_none());
+        assert_eq!(nb_calls, 1);
+    }
+}
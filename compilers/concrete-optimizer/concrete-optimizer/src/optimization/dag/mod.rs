@@ -1,2 +1,3 @@
+pub mod global_p_error;
 pub mod multi_parameters;
 pub mod solo_key;
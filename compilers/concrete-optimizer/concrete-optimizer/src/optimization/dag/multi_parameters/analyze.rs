@@ -87,6 +87,20 @@ pub fn analyze(
     }
 }
 
+impl AnalyzedDag {
+    // The symbolic variances do not depend on the error probability, only the bounds are updated.
+    // They are all scaled by the same factor, so the dominated constraints stay dominated.
+    pub fn update_noise_bound(&mut self, noise_config: &NoiseBoundConfig) {
+        for constraint in self
+            .variance_constraints
+            .iter_mut()
+            .chain(self.undominated_variance_constraints.iter_mut())
+        {
+            constraint.safe_variance_bound = safe_noise_bound(constraint.precision, noise_config);
+        }
+    }
+}
+
 pub fn original_instrs_partition(
     dag: &AnalyzedDag,
     keys: &keys_spec::ExpandedCircuitKeys,
@@ -14,6 +14,8 @@ use crate::optimization::decomposition::cmux::CmuxComplexityNoise;
 use crate::optimization::decomposition::keyswitch::KsComplexityNoise;
 use crate::optimization::decomposition::{cmux, keyswitch, DecompCaches, PersistDecompCaches};
 use crate::parameters::GlweParameters;
+use crate::utils::f64::SharedMin;
+use rayon::prelude::*;
 
 use crate::optimization::dag::multi_parameters::complexity::Complexity;
 use crate::optimization::dag::multi_parameters::feasible::Feasible;
@@ -60,6 +62,14 @@ pub struct Parameters {
     pub complexity: f64,
 }
 
+// Best parameters found for the partition with some glwe parameters
+struct MacroSearch {
+    // None if the initial parameters were not improved
+    parameters: Option<Parameters>,
+    partition_p_error: f64,
+    lb_message: Option<&'static str>,
+}
+
 #[derive(Debug, Clone)]
 struct OperationsCV {
     variance: OperationsValue,
@@ -640,11 +650,6 @@ fn optimize_macro(
         )
     };
 
-    let mut best_parameters = init_parameters.clone();
-    let mut best_complexity = best_complexity;
-    let mut best_p_error = best_p_error;
-    let mut best_partition_p_error = f64::INFINITY;
-
     let fks_to_optimize = fks_to_optimize(nb_partitions, used_conversion_keyswitch, partition);
     let operations = OperationsCV {
         variance: feasible.zero_variance(),
@@ -652,24 +657,42 @@ fn optimize_macro(
     };
     let partition_feasible = feasible.filter_constraints(partition);
 
-    let glwe_params_domain = search_space.glwe_dimensions.iter().flat_map(|a| {
-        search_space
-            .glwe_log_polynomial_sizes
-            .iter()
-            .map(|b| (*a, *b))
-    });
-    let mut lb_message = None;
-    for (glwe_dimension, log2_polynomial_size) in glwe_params_domain {
-        let glwe_params = GlweParameters {
+    let glwe_params_domain: Vec<_> = search_space
+        .glwe_dimensions
+        .iter()
+        .flat_map(|a| {
+            search_space
+                .glwe_log_polynomial_sizes
+                .iter()
+                .map(|b| (*a, *b))
+        })
+        .collect();
+
+    // The best complexity found so far by any glwe parameters, to prune the others
+    let shared_best_complexity = SharedMin::new(best_complexity);
+
+    // Each glwe parameters is searched independently, from the initial parameters
+    let search_glwe = |caches: &mut DecompCaches, glwe_params: GlweParameters| {
+        let GlweParameters {
             log2_polynomial_size,
             glwe_dimension,
-        };
+        } = glwe_params;
+        let mut best_parameters = init_parameters.clone();
+        let mut improved = false;
+        let mut best_complexity = best_complexity;
+        let mut best_p_error = best_p_error;
+        let mut best_partition_p_error = f64::INFINITY;
+        let mut lb_message = None;
 
         let input_variance = glwe_params.minimal_variance(ciphertext_modulus_log, security_level);
         if glwe_dimension == 1 && log2_polynomial_size == 8 {
             // this is insecure and so minimal variance will be above 1
             assert!(input_variance > 1.0);
-            continue;
+            return MacroSearch {
+                parameters: None,
+                partition_p_error: best_partition_p_error,
+                lb_message,
+            };
         }
 
         for &internal_dim in &search_space.internal_lwe_dimensions {
@@ -712,7 +735,9 @@ fn optimize_macro(
                 break;
             }
 
-            if complexity.complexity(&operations.cost) > best_complexity {
+            if complexity.complexity(&operations.cost)
+                > best_complexity.min(shared_best_complexity.get())
+            {
                 continue;
             }
 
@@ -752,7 +777,9 @@ fn optimize_macro(
                 continue;
             }
 
-            if complexity.complexity(&operations.cost) > best_complexity {
+            if complexity.complexity(&operations.cost)
+                > best_complexity.min(shared_best_complexity.get())
+            {
                 continue;
             }
 
@@ -776,6 +803,7 @@ fn optimize_macro(
                     continue;
                 }
                 best_partition_p_error = partition_p_error;
+                improved = true;
                 let p_error = feasible.p_error(&operations.variance);
                 let global_p_error = feasible.global_p_error(&operations.variance);
                 let mut pbs = init_parameters.micro_params.pbs.clone();
@@ -797,10 +825,20 @@ fn optimize_macro(
                 continue;
             }
 
-            if complexity.complexity(&operations.cost) > best_complexity {
+            if complexity.complexity(&operations.cost)
+                > best_complexity.min(shared_best_complexity.get())
+            {
                 continue;
             }
 
+            // Solutions of the same complexity as the ones of other glwe parameters are kept
+            // whatever their p_error, the best one is selected once all are searched
+            let shared_complexity = shared_best_complexity.get();
+            let (cut_complexity, cut_p_error) = if shared_complexity < best_complexity {
+                (shared_complexity, f64::INFINITY)
+            } else {
+                (best_complexity, best_p_error)
+            };
             let micro_opt = optimize_1_cmux_and_dst_exclusive_fks_subset_and_all_ks(
                 partition,
                 &macros,
@@ -812,8 +850,8 @@ fn optimize_macro(
                 feasible,
                 complexity,
                 &mut caches.keyswitch,
-                best_complexity,
-                best_p_error,
+                cut_complexity,
+                cut_p_error,
                 ciphertext_modulus_log,
                 fft_precision,
             );
@@ -870,6 +908,8 @@ fn optimize_macro(
                 };
                 best_complexity = some_micro_params.complexity;
                 best_p_error = some_micro_params.p_error;
+                improved = true;
+                shared_best_complexity.update(best_complexity);
                 best_parameters = Parameters {
                     p_error: best_p_error,
                     global_p_error: some_micro_params.global_p_error,
@@ -882,21 +922,81 @@ fn optimize_macro(
             } else {
                 // the macro parameters are feasible
                 // but the complexity is not good enough due to previous feasible solution
-                assert!(best_parameters.is_feasible);
+                // or to the solution of other glwe parameters
+                assert!(best_parameters.is_feasible || cut_complexity < best_complexity);
             }
         }
+        MacroSearch {
+            parameters: improved.then_some(best_parameters),
+            partition_p_error: best_partition_p_error,
+            lb_message,
+        }
+    };
+
+    // The caches are forked for each thread and merged back once the search is done
+    let searches: Vec<(DecompCaches, Vec<(usize, MacroSearch)>)> = glwe_params_domain
+        .par_iter()
+        .enumerate()
+        .fold(
+            || (caches.fork(), vec![]),
+            |(mut caches, mut searches), (i, &(glwe_dimension, log2_polynomial_size))| {
+                let glwe_params = GlweParameters {
+                    log2_polynomial_size,
+                    glwe_dimension,
+                };
+                searches.push((i, search_glwe(&mut caches, glwe_params)));
+                (caches, searches)
+            },
+        )
+        .collect();
+    let mut ordered_searches = vec![];
+    for (thread_caches, thread_searches) in searches {
+        caches.merge(thread_caches);
+        ordered_searches.extend(thread_searches);
     }
-    if DEBUG && lb_message.is_some() {
-        eprintln!("{}", lb_message.unwrap());
+    // The searches are reduced in the order of the glwe parameters, so that the result does not
+    // depend on the scheduling of the threads
+    ordered_searches.sort_by_key(|(i, _)| *i);
+
+    let mut best_search: Option<MacroSearch> = None;
+    for (_, search) in ordered_searches {
+        let parameters = match &search.parameters {
+            Some(parameters) => parameters,
+            None => continue,
+        };
+        let is_better = best_search.as_ref().map_or(true, |best| {
+            let best_parameters = best.parameters.as_ref().unwrap();
+            if parameters.is_feasible != best_parameters.is_feasible {
+                parameters.is_feasible
+            } else if parameters.is_feasible {
+                #[allow(clippy::float_cmp)]
+                let same_complexity_less_errors = parameters.complexity
+                    == best_parameters.complexity
+                    && parameters.p_error < best_parameters.p_error;
+                parameters.complexity < best_parameters.complexity || same_complexity_less_errors
+            } else {
+                search.partition_p_error < best.partition_p_error
+            }
+        });
+        if is_better {
+            best_search = Some(search);
+        }
+    }
+    match best_search {
+        Some(best_search) => {
+            if DEBUG && best_search.lb_message.is_some() {
+                eprintln!("{}", best_search.lb_message.unwrap());
+            }
+            best_search.parameters.unwrap()
+        }
+        None => init_parameters.clone(),
     }
-    best_parameters
 }
 
 fn cross_partition(nb_partitions: usize) -> impl Iterator<Item = (usize, usize)> {
     (0..nb_partitions).flat_map(move |a: usize| (0..nb_partitions).map(move |b: usize| (a, b)))
 }
 
-#[allow(clippy::too_many_lines)]
 pub fn optimize(
     dag: &unparametrized::OperationDag,
     config: Config,
@@ -905,26 +1005,38 @@ pub fn optimize(
     p_cut: &Option<PrecisionCut>,
     default_partition: PartitionIndex,
 ) -> Option<(AnalyzedDag, Parameters)> {
+    let dag = analyze(dag, &noise_bound_config(&config), p_cut, default_partition);
+    let mut caches = persistent_caches.caches();
+    let best_params = optimize_analyzed(&dag, config, search_space, &mut caches);
+    best_params.map(|best_params| (dag, best_params))
+}
+
+fn noise_bound_config(config: &Config) -> NoiseBoundConfig {
+    NoiseBoundConfig {
+        security_level: config.security_level,
+        maximum_acceptable_error_probability: config.maximum_acceptable_error_probability,
+        ciphertext_modulus_log: config.ciphertext_modulus_log,
+    }
+}
+
+#[allow(clippy::too_many_lines)]
+fn optimize_analyzed(
+    dag: &AnalyzedDag,
+    config: Config,
+    search_space: &SearchSpace,
+    caches: &mut DecompCaches,
+) -> Option<Parameters> {
     let ciphertext_modulus_log = config.ciphertext_modulus_log;
     let fft_precision = config.fft_precision;
     let security_level = config.security_level;
-    let noise_config = NoiseBoundConfig {
-        security_level,
-        maximum_acceptable_error_probability: config.maximum_acceptable_error_probability,
-        ciphertext_modulus_log,
-    };
-
-    let dag = analyze(dag, &noise_config, p_cut, default_partition);
 
     let kappa =
         error::sigma_scale_of_error_probability(config.maximum_acceptable_error_probability);
 
-    let mut caches = persistent_caches.caches();
-
     let feasible = Feasible::of(&dag.variance_constraints, kappa, None).compressed();
     let complexity = Complexity::of(&dag.operations_count).compressed();
-    let used_tlu_keyswitch = used_tlu_keyswitch(&dag);
-    let used_conversion_keyswitch = used_conversion_keyswitch(&dag);
+    let used_tlu_keyswitch = used_tlu_keyswitch(dag);
+    let used_conversion_keyswitch = used_conversion_keyswitch(dag);
 
     let nb_partitions = dag.nb_partitions;
     let init_parameters = Parameters {
@@ -959,7 +1071,7 @@ pub fn optimize(
                 &used_conversion_keyswitch,
                 &feasible,
                 &complexity,
-                &mut caches,
+                caches,
                 &params,
                 best_complexity,
                 best_p_error,
@@ -1031,7 +1143,7 @@ pub fn optimize(
         &feasible,
         &complexity,
     );
-    Some((dag, best_params))
+    Some(best_params)
 }
 
 fn used_tlu_keyswitch(dag: &AnalyzedDag) -> Vec<Vec<bool>> {
@@ -1153,6 +1265,107 @@ fn sanity_check(
     }
 }
 
+fn to_circuit_solution(
+    dag: &AnalyzedDag,
+    params: &Parameters,
+    key_sharing: bool,
+) -> keys_spec::CircuitSolution {
+    let ext_keys = keys_spec::ExpandedCircuitKeys::of(params);
+    let instructions_keys = analyze::original_instrs_partition(dag, &ext_keys);
+    let (ext_keys, instructions_keys) = if key_sharing {
+        let (ext_keys, key_sharing) = ext_keys.shared_keys();
+        let instructions_keys = InstructionKeys::shared_keys(&instructions_keys, &key_sharing);
+        (ext_keys, instructions_keys)
+    } else {
+        (ext_keys, instructions_keys)
+    };
+    let circuit_keys = ext_keys.compacted();
+    keys_spec::CircuitSolution {
+        circuit_keys,
+        instructions_keys,
+        crt_decomposition: vec![],
+        complexity: params.complexity,
+        p_error: params.p_error,
+        global_p_error: params.global_p_error,
+        is_feasible: true,
+        error_msg: String::default(),
+    }
+}
+
+// A search of the parameters of a dag that can be repeated with decreasing maximum acceptable error
+// probabilities, e.g. to meet a global error probability. The dag is analyzed once and the
+// decomposition caches are kept between the searches.
+pub struct Search<'a> {
+    dag: &'a unparametrized::OperationDag,
+    // None for a dag without luts
+    analyzed_dag: Option<AnalyzedDag>,
+    config: Config<'a>,
+    search_space: &'a SearchSpace,
+    persistent_caches: &'a PersistDecompCaches,
+    caches: Option<DecompCaches>,
+}
+
+impl<'a> Search<'a> {
+    pub fn new(
+        dag: &'a unparametrized::OperationDag,
+        config: Config<'a>,
+        search_space: &'a SearchSpace,
+        persistent_caches: &'a PersistDecompCaches,
+        p_cut: &Option<PrecisionCut>,
+    ) -> Self {
+        let analyzed_dag = (lut_count_from_dag(dag) != 0).then(|| {
+            let default_partition = 0;
+            analyze(dag, &noise_bound_config(&config), p_cut, default_partition)
+        });
+        Self {
+            dag,
+            analyzed_dag,
+            config,
+            search_space,
+            persistent_caches,
+            caches: None,
+        }
+    }
+
+    pub fn optimize_to_circuit_solution(
+        &mut self,
+        maximum_acceptable_error_probability: f64,
+    ) -> keys_spec::CircuitSolution {
+        let config = Config {
+            maximum_acceptable_error_probability,
+            ..self.config
+        };
+        let analyzed_dag = match &mut self.analyzed_dag {
+            Some(analyzed_dag) => analyzed_dag,
+            None => {
+                let nb_instr = self.dag.operators.len();
+                if let Some(sol) =
+                    optimize_mono(self.dag, config, self.search_space, self.persistent_caches)
+                        .best_solution
+                {
+                    return keys_spec::CircuitSolution::from_native_solution(sol, nb_instr);
+                }
+                return keys_spec::CircuitSolution::no_solution(
+                    "No crypto-parameters for the given constraints",
+                );
+            }
+        };
+        analyzed_dag.update_noise_bound(&noise_bound_config(&config));
+        let persistent_caches = self.persistent_caches;
+        let caches = self
+            .caches
+            .get_or_insert_with(|| persistent_caches.caches());
+        #[allow(clippy::option_if_let_else)]
+        if let Some(params) = optimize_analyzed(analyzed_dag, config, self.search_space, caches) {
+            to_circuit_solution(analyzed_dag, &params, config.key_sharing)
+        } else {
+            keys_spec::CircuitSolution::no_solution(
+                "No crypto-parameters for the given constraints",
+            )
+        }
+    }
+}
+
 pub fn optimize_to_circuit_solution(
     dag: &unparametrized::OperationDag,
     config: Config,
@@ -1160,50 +1373,8 @@ pub fn optimize_to_circuit_solution(
     persistent_caches: &PersistDecompCaches,
     p_cut: &Option<PrecisionCut>,
 ) -> keys_spec::CircuitSolution {
-    if lut_count_from_dag(dag) == 0 {
-        let nb_instr = dag.operators.len();
-        if let Some(sol) = optimize_mono(dag, config, search_space, persistent_caches).best_solution
-        {
-            return keys_spec::CircuitSolution::from_native_solution(sol, nb_instr);
-        }
-        return keys_spec::CircuitSolution::no_solution(
-            "No crypto-parameters for the given constraints",
-        );
-    }
-    let default_partition = 0;
-    let dag_and_params = optimize(
-        dag,
-        config,
-        search_space,
-        persistent_caches,
-        p_cut,
-        default_partition,
-    );
-    #[allow(clippy::option_if_let_else)]
-    if let Some((dag, params)) = dag_and_params {
-        let ext_keys = keys_spec::ExpandedCircuitKeys::of(&params);
-        let instructions_keys = analyze::original_instrs_partition(&dag, &ext_keys);
-        let (ext_keys, instructions_keys) = if config.key_sharing {
-            let (ext_keys, key_sharing) = ext_keys.shared_keys();
-            let instructions_keys = InstructionKeys::shared_keys(&instructions_keys, &key_sharing);
-            (ext_keys, instructions_keys)
-        } else {
-            (ext_keys, instructions_keys)
-        };
-        let circuit_keys = ext_keys.compacted();
-        keys_spec::CircuitSolution {
-            circuit_keys,
-            instructions_keys,
-            crt_decomposition: vec![],
-            complexity: params.complexity,
-            p_error: params.p_error,
-            global_p_error: params.global_p_error,
-            is_feasible: true,
-            error_msg: String::default(),
-        }
-    } else {
-        keys_spec::CircuitSolution::no_solution("No crypto-parameters for the given constraints")
-    }
+    Search::new(dag, config, search_space, persistent_caches, p_cut)
+        .optimize_to_circuit_solution(config.maximum_acceptable_error_probability)
 }
 
 #[cfg(test)]
@@ -1,7 +1,9 @@
 use crate::dag::unparametrized::OperationDag;
 use crate::optimization::config::{Config, SearchSpace};
+use crate::optimization::dag::global_p_error;
 use crate::optimization::dag::multi_parameters::keys_spec::CircuitSolution;
 use crate::optimization::dag::multi_parameters::optimize::optimize_to_circuit_solution as native_optimize;
+use crate::optimization::dag::multi_parameters::optimize::Search as NativeSearch;
 use crate::optimization::dag::solo_key::analyze;
 use crate::optimization::dag::solo_key::optimize_generic::{max_precision, Encoding};
 use crate::optimization::decomposition::PersistDecompCaches;
@@ -70,3 +72,48 @@ pub fn optimize(
         Encoding::Crt => crt(),
     }
 }
+
+// Same as `optimize` with the lowest maximum acceptable error probability meeting
+// `maximum_global_p_error`. The dag is analyzed once for all the searches.
+#[allow(clippy::too_many_arguments)]
+pub fn optimize_for_global_p_error(
+    dag: &OperationDag,
+    config: Config,
+    search_space: &SearchSpace,
+    encoding: Encoding,
+    default_log_norm2_woppbs: f64,
+    caches: &PersistDecompCaches,
+    p_cut: &Option<PrecisionCut>,
+    maximum_global_p_error: f64,
+) -> CircuitSolution {
+    let mut native_search = match encoding {
+        Encoding::Auto | Encoding::Native => {
+            Some(NativeSearch::new(dag, config, search_space, caches, p_cut))
+        }
+        Encoding::Crt => None,
+    };
+    let optimize_with = |maximum_acceptable_error_probability| {
+        let config = Config {
+            maximum_acceptable_error_probability,
+            ..config
+        };
+        let mut native = || {
+            native_search
+                .as_mut()
+                .unwrap()
+                .optimize_to_circuit_solution(maximum_acceptable_error_probability)
+        };
+        let crt = || crt_optimize(dag, config, search_space, default_log_norm2_woppbs, caches);
+        match encoding {
+            Encoding::Auto => best_complexity_solution(native(), crt()),
+            Encoding::Native => native(),
+            Encoding::Crt => crt(),
+        }
+    };
+    global_p_error::optimize(
+        config.maximum_acceptable_error_probability,
+        maximum_global_p_error,
+        optimize_with,
+        |sol| sol.is_feasible.then_some((sol.p_error, sol.global_p_error)),
+    )
+}
@@ -26,6 +26,7 @@ mod tests {
             true,
             CIPHERTEXT_MODULUS_LOG,
             FFT_PRECISION,
+            1,
         )
     });
 
@@ -43,6 +44,7 @@ mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
@@ -538,6 +540,33 @@ mod tests {
         test_partition_chain(true);
     }
 
+    #[test]
+    fn test_deterministic_parallel_search() {
+        // the parameters must not depend on the number of threads searching them
+        let mut dag = unparametrized::OperationDag::new();
+        let mut lut_input = dag.add_input(8, Shape::number());
+        for out_precision in [6, 7, 8] {
+            lut_input = dag.add_lut(lut_input, FunctionTable::UNKWOWN, out_precision);
+        }
+        let p_cut = Some(PrecisionCut { p_cut: vec![6, 7] });
+        let optimize_with_threads = |num_threads| {
+            rayon::ThreadPoolBuilder::new()
+                .num_threads(num_threads)
+                .build()
+                .unwrap()
+                .install(|| optimize(&dag, &p_cut, 0).unwrap())
+        };
+        let sequential = optimize_with_threads(1);
+        let parallel = optimize_with_threads(4);
+        assert_eq!(sequential.complexity, parallel.complexity);
+        assert_eq!(sequential.p_error, parallel.p_error);
+        assert_eq!(sequential.macro_params, parallel.macro_params);
+        assert_eq!(
+            format!("{:?}", sequential.micro_params),
+            format!("{:?}", parallel.micro_params)
+        );
+    }
+
     const MAX_WEIGHT: &[u64] = &[
         // max v0 weight for each precision
         1_073_741_824,
@@ -640,6 +669,7 @@ mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
@@ -671,6 +701,7 @@ mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
@@ -720,6 +751,7 @@ mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
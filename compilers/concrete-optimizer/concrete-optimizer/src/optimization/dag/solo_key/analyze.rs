@@ -597,6 +597,13 @@ impl OperationDag {
         p_error
     }
 
+    // The symbolic variances do not depend on the error probability, only the bounds are updated
+    pub fn update_noise_bound(&mut self, noise_config: &NoiseBoundConfig) {
+        for ns in &mut self.constraints_by_precisions {
+            ns.safe_variance_bound = safe_noise_bound(ns.precision, noise_config);
+        }
+    }
+
     pub fn feasible(
         &self,
         input_noise_out: f64,
@@ -1,4 +1,4 @@
-use concrete_cpu_noise_model::gaussian_noise::noise::modulus_switching::estimate_modulus_switching_noise_with_binary_key;
+use concrete_cpu_noise_model::gaussian_noise::noise::modulus_switching::estimate_modulus_switching_noise_with_binary_key_and_storage_modulus;
 use concrete_security_curves::gaussian::security::minimal_variance_lwe;
 
 use super::analyze;
@@ -16,8 +16,10 @@ use crate::optimization::decomposition::cmux::{
 use crate::optimization::decomposition::keyswitch::{
     lowest_complexity_ks, lowest_noise_ks, KsComplexityNoise,
 };
-use crate::optimization::decomposition::PersistDecompCaches;
+use crate::optimization::decomposition::{DecompCaches, PersistDecompCaches};
 use crate::parameters::GlweParameters;
+use crate::utils::f64::SharedMin;
+use rayon::prelude::*;
 
 #[allow(clippy::too_many_lines)]
 fn update_best_solution_with_best_decompositions(
@@ -239,18 +241,13 @@ fn not_feasible_macro_parameters(
 }
 
 fn too_complex_macro_parameters(
-    state: &OptimizationState,
+    best_complexity: f64,
     dag: &analyze::OperationDag,
     internal_dim: u64,
     glwe_params: GlweParameters,
     cmux_pareto: &[CmuxComplexityNoise],
     ks_pareto: &[KsComplexityNoise],
 ) -> bool {
-    let best_complexity = if let Some(sol) = state.best_solution {
-        sol.complexity
-    } else {
-        return false;
-    };
     let input_lwe_dimension = glwe_params.sample_extract_lwe_dimension();
     let lowest_complexity_br = lowest_complexity_br(cmux_pareto, internal_dim);
     let lowest_complexity_ks = lowest_complexity_ks(ks_pareto, internal_dim);
@@ -259,83 +256,174 @@ fn too_complex_macro_parameters(
     dag.complexity(input_lwe_dimension, lower_one_lut_complexity) > best_complexity
 }
 
-#[allow(clippy::too_many_lines)]
-pub fn optimize(
-    dag: &unparametrized::OperationDag,
-    config: Config,
-    search_space: &SearchSpace,
-    persistent_caches: &PersistDecompCaches,
-) -> OptimizationState {
-    let ciphertext_modulus_log = config.ciphertext_modulus_log;
-    let security_level = config.security_level;
-    let noise_config = NoiseBoundConfig {
-        security_level,
-        maximum_acceptable_error_probability: config.maximum_acceptable_error_probability,
-        ciphertext_modulus_log,
-    };
-    let &min_precision = dag.out_precisions.iter().min().unwrap();
-
-    let dag = analyze::analyze(dag, &noise_config);
+// The macro parameters found not feasible by a search. The safe variance bounds only decrease with
+// the maximum acceptable error probability, so they stay not feasible for the next searches with
+// a lower error probability.
+struct NotFeasibleMacroParameters {
+    maximum_acceptable_error_probability: f64,
+    // For each glwe parameters, whether each internal dimension is not feasible
+    internal_dims: Vec<Vec<bool>>,
+}
 
-    let safe_variance = error::safe_variance_bound_2padbits(
-        min_precision as u64,
-        ciphertext_modulus_log,
-        config.maximum_acceptable_error_probability,
-    );
-    let kappa =
-        error::sigma_scale_of_error_probability(config.maximum_acceptable_error_probability);
-
-    let consts = OptimizationDecompositionsConsts {
-        config,
-        kappa,
-        sum_size: 0,            // superseeded by dag.complexity_cost
-        noise_factor: f64::NAN, // superseeded by dag.lut_variance_max
-        safe_variance,
-    };
+// A search of the parameters of a dag that can be repeated with decreasing maximum acceptable error
+// probabilities, e.g. to meet a global error probability. The dag is analyzed once, the
+// decomposition caches are kept between the searches and each search is warm-started by skipping
+// the macro parameters found not feasible by the previous ones.
+pub struct Search<'a> {
+    dag: analyze::OperationDag,
+    min_precision: Precision,
+    config: Config<'a>,
+    search_space: &'a SearchSpace,
+    persistent_caches: &'a PersistDecompCaches,
+    caches: Option<DecompCaches>,
+    not_feasible: Option<NotFeasibleMacroParameters>,
+}
 
-    let mut state = OptimizationState {
-        best_solution: None,
-    };
+fn noise_bound_config(config: &Config) -> NoiseBoundConfig {
+    NoiseBoundConfig {
+        security_level: config.security_level,
+        maximum_acceptable_error_probability: config.maximum_acceptable_error_probability,
+        ciphertext_modulus_log: config.ciphertext_modulus_log,
+    }
+}
 
-    if dag.nb_luts == 0 {
-        return optimize_no_luts(state, &consts, &dag, search_space);
+impl<'a> Search<'a> {
+    pub fn new(
+        dag: &unparametrized::OperationDag,
+        config: Config<'a>,
+        search_space: &'a SearchSpace,
+        persistent_caches: &'a PersistDecompCaches,
+    ) -> Self {
+        let &min_precision = dag.out_precisions.iter().min().unwrap();
+        Self {
+            dag: analyze::analyze(dag, &noise_bound_config(&config)),
+            min_precision,
+            config,
+            search_space,
+            persistent_caches,
+            caches: None,
+            not_feasible: None,
+        }
     }
-    let mut caches = persistent_caches.caches();
 
-    let noise_modulus_switching = |glwe_log2_poly_size, internal_lwe_dimensions| {
-        estimate_modulus_switching_noise_with_binary_key(
-            internal_lwe_dimensions,
-            glwe_log2_poly_size,
+    #[allow(clippy::too_many_lines)]
+    pub fn optimize(&mut self, maximum_acceptable_error_probability: f64) -> OptimizationState {
+        #[allow(clippy::float_cmp)]
+        if maximum_acceptable_error_probability != self.config.maximum_acceptable_error_probability
+        {
+            self.config.maximum_acceptable_error_probability = maximum_acceptable_error_probability;
+            self.dag
+                .update_noise_bound(&noise_bound_config(&self.config));
+        }
+        let config = self.config;
+        let search_space = self.search_space;
+        let dag = &self.dag;
+        let ciphertext_modulus_log = config.ciphertext_modulus_log;
+
+        let safe_variance = error::safe_variance_bound_2padbits(
+            self.min_precision as u64,
             ciphertext_modulus_log,
-        )
-    };
+            config.maximum_acceptable_error_probability,
+        );
+        let kappa =
+            error::sigma_scale_of_error_probability(config.maximum_acceptable_error_probability);
 
-    let not_feasible = |input_noise_out, noise_modulus_switching| {
-        !dag.feasible(input_noise_out, 0.0, 0.0, noise_modulus_switching)
-    };
+        let consts = OptimizationDecompositionsConsts {
+            config,
+            kappa,
+            sum_size: 0,            // superseeded by dag.complexity_cost
+            noise_factor: f64::NAN, // superseeded by dag.lut_variance_max
+            safe_variance,
+        };
+
+        let mut state = OptimizationState {
+            best_solution: None,
+        };
 
-    for &glwe_dim in &search_space.glwe_dimensions {
-        for &glwe_log_poly_size in &search_space.glwe_log_polynomial_sizes {
-            let glwe_params = GlweParameters {
-                log2_polynomial_size: glwe_log_poly_size,
-                glwe_dimension: glwe_dim,
+        if dag.nb_luts == 0 {
+            return optimize_no_luts(state, &consts, dag, search_space);
+        }
+        let persistent_caches = self.persistent_caches;
+        let caches = self
+            .caches
+            .get_or_insert_with(|| persistent_caches.caches());
+
+        // Only the not feasible macro parameters of a search with a higher error probability can
+        // be skipped
+        let previously_not_feasible = self.not_feasible.as_ref().filter(|not_feasible| {
+            maximum_acceptable_error_probability
+                <= not_feasible.maximum_acceptable_error_probability
+        });
+
+        let noise_modulus_switching = |glwe_log2_poly_size, internal_lwe_dimensions| {
+            estimate_modulus_switching_noise_with_binary_key_and_storage_modulus(
+                internal_lwe_dimensions,
+                glwe_log2_poly_size,
+                config.small_lwe_ciphertext_modulus_log,
+                ciphertext_modulus_log,
+            )
+        };
+
+        let not_feasible = |input_noise_out, noise_modulus_switching| {
+            !dag.feasible(input_noise_out, 0.0, 0.0, noise_modulus_switching)
+        };
+
+        let glwe_params_domain: Vec<_> = search_space
+            .glwe_dimensions
+            .iter()
+            .flat_map(|&glwe_dimension| {
+                search_space
+                    .glwe_log_polynomial_sizes
+                    .iter()
+                    .map(move |&log2_polynomial_size| GlweParameters {
+                        log2_polynomial_size,
+                        glwe_dimension,
+                    })
+            })
+            .collect();
+
+        // The best complexity found so far by any glwe parameters, to prune the others
+        let shared_best_complexity = SharedMin::new(f64::INFINITY);
+
+        // Each glwe parameters is searched independently
+        let search_glwe = |caches: &mut DecompCaches, i: usize, glwe_params: GlweParameters| {
+            let mut state = OptimizationState {
+                best_solution: None,
             };
+            let nb_internal_dims = search_space.internal_lwe_dimensions.len();
+            let mut not_feasible_dims = previously_not_feasible.map_or_else(
+                || vec![false; nb_internal_dims],
+                |not_feasible| not_feasible.internal_dims[i].clone(),
+            );
+            if not_feasible_dims.iter().all(|&not_feasible| not_feasible) {
+                return (state, not_feasible_dims);
+            }
             let input_noise_out = minimal_variance(&config, glwe_params);
 
             let cmux_pareto = caches.cmux.pareto_quantities(glwe_params);
 
-            for &internal_dim in &search_space.internal_lwe_dimensions {
+            for (j, &internal_dim) in search_space.internal_lwe_dimensions.iter().enumerate() {
+                if not_feasible_dims[j] {
+                    continue;
+                }
                 let ks_pareto = caches.keyswitch.pareto_quantities(internal_dim);
 
                 let noise_modulus_switching =
-                    noise_modulus_switching(glwe_log_poly_size, internal_dim);
+                    noise_modulus_switching(glwe_params.log2_polynomial_size, internal_dim);
                 if not_feasible(input_noise_out, noise_modulus_switching) {
                     // noise_modulus_switching is increasing with internal_dim
+                    for not_feasible in &mut not_feasible_dims[j..] {
+                        *not_feasible = true;
+                    }
                     break;
                 }
+                let best_complexity = state
+                    .best_solution
+                    .map_or(f64::INFINITY, |s| s.complexity)
+                    .min(shared_best_complexity.get());
                 if too_complex_macro_parameters(
-                    &state,
-                    &dag,
+                    best_complexity,
+                    dag,
                     internal_dim,
                     glwe_params,
                     cmux_pareto,
@@ -344,19 +432,20 @@ pub fn optimize(
                     break;
                 }
                 if not_feasible_macro_parameters(
-                    &dag,
+                    dag,
                     internal_dim,
                     input_noise_out,
                     noise_modulus_switching,
                     cmux_pareto,
                     ks_pareto,
                 ) {
+                    not_feasible_dims[j] = true;
                     continue;
                 }
                 update_best_solution_with_best_decompositions(
                     &mut state,
                     &consts,
-                    &dag,
+                    dag,
                     internal_dim,
                     glwe_params,
                     input_noise_out,
@@ -364,23 +453,83 @@ pub fn optimize(
                     cmux_pareto,
                     ks_pareto,
                 );
-                if dag.nb_luts == 0 && state.best_solution.is_some() {
-                    return state;
+                if let Some(sol) = state.best_solution {
+                    shared_best_complexity.update(sol.complexity);
                 }
             }
+            (state, not_feasible_dims)
+        };
+
+        type GlweSearch = (usize, (OptimizationState, Vec<bool>));
+        // The caches are forked for each thread and merged back once the search is done
+        let searches: Vec<(DecompCaches, Vec<GlweSearch>)> = glwe_params_domain
+            .par_iter()
+            .enumerate()
+            .fold(
+                || (caches.fork(), vec![]),
+                |(mut caches, mut searches), (i, &glwe_params)| {
+                    searches.push((i, search_glwe(&mut caches, i, glwe_params)));
+                    (caches, searches)
+                },
+            )
+            .collect();
+        let mut ordered_searches = vec![];
+        for (thread_caches, thread_searches) in searches {
+            caches.merge(thread_caches);
+            ordered_searches.extend(thread_searches);
         }
-    }
+        // The searches are reduced in the order of the glwe parameters, so that the result does
+        // not depend on the scheduling of the threads
+        ordered_searches.sort_by_key(|(i, _)| *i);
+        let mut not_feasible_internal_dims = Vec::with_capacity(ordered_searches.len());
+        for (_, (search, not_feasible_dims)) in ordered_searches {
+            not_feasible_internal_dims.push(not_feasible_dims);
+            let sol = match search.best_solution {
+                Some(sol) => sol,
+                None => continue,
+            };
+            let is_better = state.best_solution.map_or(true, |best| {
+                #[allow(clippy::float_cmp)]
+                let same_complexity_less_errors =
+                    sol.complexity == best.complexity && sol.p_error < best.p_error;
+                sol.complexity < best.complexity || same_complexity_less_errors
+            });
+            if is_better {
+                state.best_solution = Some(sol);
+            }
+        }
+        self.not_feasible = Some(NotFeasibleMacroParameters {
+            maximum_acceptable_error_probability,
+            internal_dims: not_feasible_internal_dims,
+        });
 
-    persistent_caches.backport(caches);
+        if let Some(sol) = state.best_solution {
+            assert!(0.0 <= sol.p_error && sol.p_error <= 1.0);
+            assert!(0.0 <= sol.global_p_error && sol.global_p_error <= 1.0);
+            assert!(sol.p_error <= config.maximum_acceptable_error_probability * REL_EPSILON_PROBA);
+            assert!(sol.p_error <= sol.global_p_error * REL_EPSILON_PROBA);
+        }
 
-    if let Some(sol) = state.best_solution {
-        assert!(0.0 <= sol.p_error && sol.p_error <= 1.0);
-        assert!(0.0 <= sol.global_p_error && sol.global_p_error <= 1.0);
-        assert!(sol.p_error <= config.maximum_acceptable_error_probability * REL_EPSILON_PROBA);
-        assert!(sol.p_error <= sol.global_p_error * REL_EPSILON_PROBA);
+        state
     }
+}
 
-    state
+impl Drop for Search<'_> {
+    fn drop(&mut self) {
+        if let Some(caches) = self.caches.take() {
+            self.persistent_caches.backport(caches);
+        }
+    }
+}
+
+pub fn optimize(
+    dag: &unparametrized::OperationDag,
+    config: Config,
+    search_space: &SearchSpace,
+    persistent_caches: &PersistDecompCaches,
+) -> OptimizationState {
+    Search::new(dag, config, search_space, persistent_caches)
+        .optimize(config.maximum_acceptable_error_probability)
 }
 
 pub fn add_v0_dag(dag: &mut OperationDag, sum_size: u64, precision: u64, noise_factor: f64) {
@@ -469,6 +618,7 @@ pub(crate) mod tests {
             true,
             CIPHERTEXT_MODULUS_LOG,
             FFT_PRECISION,
+            1,
         )
     });
 
@@ -478,6 +628,7 @@ pub(crate) mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
@@ -487,6 +638,58 @@ pub(crate) mod tests {
         super::optimize(dag, config, &search_space, &SHARED_CACHES)
     }
 
+    #[test]
+    fn test_warm_search_same_as_cold_search() {
+        let dag = v0_dag(1, 4, 256.0);
+        let config = Config {
+            security_level: 128,
+            maximum_acceptable_error_probability: _4_SIGMA,
+            key_sharing: true,
+            ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
+            fft_precision: 53,
+            complexity_model: &CpuComplexity::default(),
+        };
+        let search_space = SearchSpace::default_cpu();
+        let mut search = super::Search::new(&dag, config, &search_space, &SHARED_CACHES);
+        for maximum_acceptable_error_probability in [_4_SIGMA, 1e-7, 1e-10, 1e-13] {
+            let warm = search.optimize(maximum_acceptable_error_probability);
+            let config = Config {
+                maximum_acceptable_error_probability,
+                ..config
+            };
+            let cold = super::optimize(&dag, config, &search_space, &SHARED_CACHES);
+            assert_eq!(warm.best_solution, cold.best_solution);
+        }
+    }
+
+    #[test]
+    fn test_small_lwe_storage_on_32_bits() {
+        let dag = v0_dag(1, 4, 256.0);
+        let config = Config {
+            security_level: 128,
+            maximum_acceptable_error_probability: _4_SIGMA,
+            key_sharing: true,
+            ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
+            fft_precision: 53,
+            complexity_model: &CpuComplexity::default(),
+        };
+        let search_space = SearchSpace::default_cpu();
+        let native = super::optimize(&dag, config, &search_space, &SHARED_CACHES)
+            .best_solution
+            .unwrap();
+        let config = Config {
+            small_lwe_ciphertext_modulus_log: 32,
+            ..config
+        };
+        let small = super::optimize(&dag, config, &search_space, &SHARED_CACHES)
+            .best_solution
+            .unwrap();
+        // the rounding to 32 bits only adds noise
+        assert!(native.complexity <= small.complexity);
+    }
+
     struct Times {
         worst_time: u128,
         dag_time: u128,
@@ -523,6 +726,7 @@ pub(crate) mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
@@ -621,6 +825,7 @@ pub(crate) mod tests {
             maximum_acceptable_error_probability: _4_SIGMA,
             key_sharing: true,
             ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
             fft_precision: 53,
             complexity_model: &CpuComplexity::default(),
         };
@@ -1055,4 +1260,43 @@ pub(crate) mod tests {
             }
         }
     }
+
+    #[test]
+    fn test_multi_bit_bootstrap() {
+        let grouping_factor = 2;
+        let multi_bit_caches = decomposition::cache(
+            128,
+            config::ProcessingUnit::Cpu,
+            None,
+            false,
+            CIPHERTEXT_MODULUS_LOG,
+            FFT_PRECISION,
+            grouping_factor,
+        );
+        let search_space = SearchSpace::default_cpu().with_grouping_factor(grouping_factor);
+        let config = Config {
+            security_level: 128,
+            maximum_acceptable_error_probability: _4_SIGMA,
+            key_sharing: true,
+            ciphertext_modulus_log: 64,
+            small_lwe_ciphertext_modulus_log: 64,
+            fft_precision: 53,
+            complexity_model: &CpuComplexity::default(),
+        };
+        for precision in 1..=4 {
+            let mut dag = unparametrized::OperationDag::new();
+            let input = dag.add_input(precision, Shape::number());
+            let _lut = dag.add_lut(input, FunctionTable::UNKWOWN, precision);
+
+            let sol = super::optimize(&dag, config, &search_space, &multi_bit_caches)
+                .best_solution
+                .unwrap();
+
+            assert_eq!(
+                sol.internal_ks_output_lwe_dimension % grouping_factor as u64,
+                0
+            );
+            assert!(sol.p_error <= _4_SIGMA);
+        }
+    }
 }
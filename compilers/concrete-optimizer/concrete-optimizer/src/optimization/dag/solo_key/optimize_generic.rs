@@ -3,6 +3,7 @@ use crate::dag::unparametrized::OperationDag;
 use crate::noise_estimator::p_error::repeat_p_error;
 use crate::optimization::atomic_pattern::Solution as WpSolution;
 use crate::optimization::config::{Config, SearchSpace};
+use crate::optimization::dag::global_p_error;
 use crate::optimization::dag::solo_key::{analyze, optimize};
 use crate::optimization::decomposition::PersistDecompCaches;
 use crate::optimization::wop_atomic_pattern::optimize::optimize_one as wop_optimize;
@@ -22,6 +23,13 @@ impl Solution {
             Self::WopSolution(v) => v.complexity,
         }
     }
+
+    fn errors(&self) -> (f64, f64) {
+        match self {
+            Self::WpSolution(v) => (v.p_error, v.global_p_error),
+            Self::WopSolution(v) => (v.p_error, v.global_p_error),
+        }
+    }
 }
 
 #[derive(Clone, Copy)]
@@ -104,3 +112,49 @@ pub fn optimize(
         Encoding::Crt => crt(),
     }
 }
+
+// Same as `optimize` with the lowest maximum acceptable error probability meeting
+// `maximum_global_p_error`. The dag is analyzed once for all the searches.
+pub fn optimize_for_global_p_error(
+    dag: &OperationDag,
+    config: Config,
+    search_space: &SearchSpace,
+    encoding: Encoding,
+    default_log_norm2_woppbs: f64,
+    caches: &PersistDecompCaches,
+    maximum_global_p_error: f64,
+) -> Option<Solution> {
+    let mut native_search = match encoding {
+        Encoding::Auto | Encoding::Native => {
+            Some(optimize::Search::new(dag, config, search_space, caches))
+        }
+        Encoding::Crt => None,
+    };
+    let optimize_with = |maximum_acceptable_error_probability| {
+        let config = Config {
+            maximum_acceptable_error_probability,
+            ..config
+        };
+        let native = native_search.as_mut().and_then(|search| {
+            search
+                .optimize(maximum_acceptable_error_probability)
+                .best_solution
+                .map(Solution::WpSolution)
+        });
+        let crt = || {
+            optimize_with_wop_pbs(dag, config, search_space, default_log_norm2_woppbs, caches)
+                .map(Solution::WopSolution)
+        };
+        match encoding {
+            Encoding::Auto => best_complexity_solution(native, crt()),
+            Encoding::Native => native,
+            Encoding::Crt => crt(),
+        }
+    };
+    global_p_error::optimize(
+        config.maximum_acceptable_error_probability,
+        maximum_global_p_error,
+        optimize_with,
+        |sol| sol.as_ref().map(Solution::errors),
+    )
+}
@@ -1,14 +1,20 @@
 use crate::computing_cost::complexity_model::ComplexityModel;
 use crate::config;
-use crate::parameters::{BrDecompositionParameters, CmuxParameters, GlweParameters};
+use crate::parameters::{
+    BrDecompositionParameters, CmuxParameters, GlweParameters, LweDimension, PbsParameters,
+};
 use crate::utils::cache::ephemeral::{CacheHashMap, EphemeralCache};
 use crate::utils::cache::persistent::{default_cache_dir, PersistentCacheHashMap};
 use concrete_cpu_noise_model::gaussian_noise::noise::cmux::variance_cmux;
+use concrete_cpu_noise_model::gaussian_noise::noise::multi_bit_external_product_glwe::variance_multi_bit_external_product_glwe;
 use serde::{Deserialize, Serialize};
 use std::sync::Arc;
 
 use super::common::VERSION;
 
+/// Complexity and noise of the blind rotation, per input lwe dimension. For a multi-bit blind
+/// rotation, the quantities of a group of `grouping_factor` elements are evenly shared between
+/// its elements.
 #[derive(Clone, Copy, Debug, Serialize, Deserialize)]
 pub struct CmuxComplexityNoise {
     pub decomp: BrDecompositionParameters,
@@ -25,6 +31,65 @@ impl CmuxComplexityNoise {
     }
 }
 
+// The multi-bit bootstrap of the CPU backend keeps its keys in the fourier domain
+const MULTI_BIT_JIT_FFT: bool = false;
+
+#[allow(clippy::too_many_arguments)]
+fn variance_br_per_dimension(
+    glwe_params: GlweParameters,
+    log2_base: u64,
+    level: u64,
+    ciphertext_modulus_log: u32,
+    fft_precision: u32,
+    variance_bsk: f64,
+    grouping_factor: u32,
+) -> f64 {
+    if grouping_factor <= 1 {
+        return variance_cmux(
+            glwe_params.glwe_dimension,
+            glwe_params.polynomial_size(),
+            log2_base,
+            level,
+            ciphertext_modulus_log,
+            fft_precision,
+            variance_bsk,
+        );
+    }
+    variance_multi_bit_external_product_glwe(
+        glwe_params.glwe_dimension,
+        glwe_params.polynomial_size(),
+        log2_base,
+        level,
+        ciphertext_modulus_log,
+        fft_precision,
+        variance_bsk,
+        grouping_factor,
+        MULTI_BIT_JIT_FFT,
+    ) / grouping_factor as f64
+}
+
+fn complexity_br_per_dimension(
+    complexity_model: &dyn ComplexityModel,
+    params: CmuxParameters,
+    ciphertext_modulus_log: u32,
+    grouping_factor: u32,
+) -> f64 {
+    if grouping_factor <= 1 {
+        return complexity_model.cmux_complexity(params, ciphertext_modulus_log);
+    }
+    let group = PbsParameters {
+        internal_lwe_dimension: LweDimension(grouping_factor as u64),
+        br_decomposition_parameter: params.br_decomposition_parameter,
+        output_glwe_params: params.output_glwe_params,
+    };
+    complexity_model.multi_bit_pbs_complexity(
+        group,
+        ciphertext_modulus_log,
+        grouping_factor,
+        MULTI_BIT_JIT_FFT,
+    ) / grouping_factor as f64
+}
+
 /* This is stricly variance decreasing and strictly complexity increasing */
 pub fn pareto_quantities(
     complexity_model: &dyn ComplexityModel,
@@ -32,6 +97,7 @@ pub fn pareto_quantities(
     fft_precision: u32,
     security_level: u64,
     glwe_params: GlweParameters,
+    grouping_factor: u32,
 ) -> Vec<CmuxComplexityNoise> {
     let variance_bsk = glwe_params.minimal_variance(ciphertext_modulus_log, security_level);
 
@@ -52,14 +118,14 @@ pub fn pareto_quantities(
         let range = (1..=prev_best_log2_base).rev();
 
         for log2_base in range {
-            let base_noise = variance_cmux(
-                glwe_params.glwe_dimension,
-                glwe_params.polynomial_size(),
+            let base_noise = variance_br_per_dimension(
+                glwe_params,
                 log2_base,
                 level,
                 ciphertext_modulus_log,
                 fft_precision,
                 variance_bsk,
+                grouping_factor,
             );
             if base_noise > level_decreasing_base_noise {
                 break;
@@ -88,7 +154,12 @@ pub fn pareto_quantities(
             output_glwe_params: glwe_params,
         };
 
-        let complexity = complexity_model.cmux_complexity(params, ciphertext_modulus_log);
+        let complexity = complexity_br_per_dimension(
+            complexity_model,
+            params,
+            ciphertext_modulus_log,
+            grouping_factor,
+        );
 
         quantities.push(CmuxComplexityNoise {
             decomp: params.br_decomposition_parameter,
@@ -130,11 +201,17 @@ pub fn cache(
     complexity_model: Arc<dyn ComplexityModel>,
     ciphertext_modulus_log: u32,
     fft_precision: u32,
+    grouping_factor: u32,
 ) -> PersistDecompCache {
     let cache_dir: String = default_cache_dir();
     let hardware = processing_unit.br_to_string();
+    let multi_bit = if grouping_factor > 1 {
+        format!("-multi-bit-{grouping_factor}")
+    } else {
+        String::new()
+    };
     let path =
-        format!("{cache_dir}/cmux-decomp-{hardware}-{ciphertext_modulus_log}-{fft_precision}-{security_level}");
+        format!("{cache_dir}/cmux-decomp-{hardware}{multi_bit}-{ciphertext_modulus_log}-{fft_precision}-{security_level}");
 
     let function = move |glwe_params: GlweParameters| {
         pareto_quantities(
@@ -143,6 +220,7 @@ pub fn cache(
             fft_precision,
             security_level,
             glwe_params,
+            grouping_factor,
         )
     };
     PersistentCacheHashMap::new_no_read(&path, VERSION, function)
@@ -26,6 +26,27 @@ pub struct DecompCaches {
     pub cb_pbs: circuit_bootstrap::Cache,
 }
 
+impl DecompCaches {
+    /// Returns caches sharing the content of these ones, to be used by another thread.
+    pub fn fork(&self) -> Self {
+        Self {
+            cmux: self.cmux.fork(),
+            keyswitch: self.keyswitch.fork(),
+            pp_switch: self.pp_switch.fork(),
+            cb_pbs: self.cb_pbs.fork(),
+        }
+    }
+
+    /// Merges back the entries computed by the fork `caches`, such that they are backported
+    /// together with the ones of these caches.
+    pub fn merge(&mut self, caches: Self) {
+        self.cmux.merge(caches.cmux);
+        self.keyswitch.merge(caches.keyswitch);
+        self.pp_switch.merge(caches.pp_switch);
+        self.cb_pbs.merge(caches.cb_pbs);
+    }
+}
+
 pub fn cache(
     security_level: u64,
     processing_unit: config::ProcessingUnit,
@@ -33,6 +54,7 @@ pub fn cache(
     cache_on_disk: bool,
     ciphertext_modulus_log: u32,
     fft_precision: u32,
+    grouping_factor: u32,
 ) -> PersistDecompCaches {
     PersistDecompCaches::new(
         security_level,
@@ -41,6 +63,7 @@ pub fn cache(
         cache_on_disk,
         ciphertext_modulus_log,
         fft_precision,
+        grouping_factor,
     )
 }
 
@@ -52,6 +75,7 @@ impl PersistDecompCaches {
         cache_on_disk: bool,
         ciphertext_modulus_log: u32,
         fft_precision: u32,
+        grouping_factor: u32,
     ) -> Self {
         let complexity_model =
             complexity_model.unwrap_or_else(|| processing_unit.complexity_model());
@@ -68,6 +92,7 @@ impl PersistDecompCaches {
                 complexity_model.clone(),
                 ciphertext_modulus_log,
                 fft_precision,
+                grouping_factor,
             ),
             pp: pp_switch::cache(
                 security_level,
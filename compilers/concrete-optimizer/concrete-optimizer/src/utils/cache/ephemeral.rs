@@ -58,4 +58,26 @@ where
     }
 }
 
+impl<ROC> Cache<ROC>
+where
+    ROC: ReadOnlyCache,
+    ROC::K: Hash + std::cmp::Eq + Copy,
+{
+    /* A fork shares the content of the cache and can be used by another thread */
+    pub fn fork(&self) -> Self {
+        Self {
+            initial_content: self.initial_content.clone(),
+            updated_content: self.updated_content.clone(),
+            function: self.function.clone(),
+        }
+    }
+
+    /* Merges back the entries computed by a fork */
+    pub fn merge(&mut self, fork: Self) {
+        for (k, v) in fork.updated_content {
+            let _unused = self.updated_content.entry(k).or_insert(v);
+        }
+    }
+}
+
 pub type CacheHashMap<K, V> = Cache<Map<K, V>>;
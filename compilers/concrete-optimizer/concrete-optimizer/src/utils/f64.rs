@@ -1,3 +1,5 @@
+use std::sync::atomic::{AtomicU64, Ordering};
+
 pub fn f64_max(values: &[f64], default: f64) -> f64 {
     values.iter().copied().reduce(f64::max).unwrap_or(default)
 }
@@ -15,3 +17,40 @@ pub fn f64_dot(a: &[f64], b: &[f64]) -> f64 {
     }
     sum
 }
+
+/// Minimum of non-negative values, shared and updated by several threads, e.g. the best
+/// complexity found so far by a parallel search.
+/// The bits of non-negative floats are ordered as their values, so it is kept as an atomic integer.
+pub struct SharedMin(AtomicU64);
+
+impl SharedMin {
+    pub fn new(value: f64) -> Self {
+        assert!(value.is_sign_positive() && !value.is_nan());
+        Self(AtomicU64::new(value.to_bits()))
+    }
+
+    pub fn get(&self) -> f64 {
+        f64::from_bits(self.0.load(Ordering::Relaxed))
+    }
+
+    pub fn update(&self, value: f64) {
+        assert!(value.is_sign_positive() && !value.is_nan());
+        let _unused = self.0.fetch_min(value.to_bits(), Ordering::Relaxed);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[allow(clippy::float_cmp)]
+    fn test_shared_min() {
+        let min = SharedMin::new(f64::INFINITY);
+        min.update(2.5);
+        min.update(10.0);
+        assert_eq!(min.get(), 2.5);
+        min.update(0.0);
+        assert_eq!(min.get(), 0.0);
+    }
+}
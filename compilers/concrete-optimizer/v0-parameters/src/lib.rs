@@ -120,6 +120,7 @@ pub fn all_results(args: &Args) -> Vec<Vec<Option<Solution>>> {
         maximum_acceptable_error_probability,
         key_sharing: true,
         ciphertext_modulus_log: args.ciphertext_modulus_log,
+        small_lwe_ciphertext_modulus_log: args.ciphertext_modulus_log,
         fft_precision: args.fft_precision,
         complexity_model: &CpuComplexity::default(),
     };
@@ -131,6 +132,7 @@ pub fn all_results(args: &Args) -> Vec<Vec<Option<Solution>>> {
         cache_on_disk,
         args.ciphertext_modulus_log,
         args.fft_precision,
+        1,
     );
 
     precisions_iter
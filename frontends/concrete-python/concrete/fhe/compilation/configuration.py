@@ -880,6 +880,7 @@ class Configuration:
     dataflow_parallelize: bool
     auto_parallelize: bool
     compress_inputs: bool
+    compress_outputs: bool
     p_error: Optional[float]
     global_p_error: Optional[float]
     insecure_key_cache_location: Optional[str]
@@ -887,6 +888,7 @@ class Configuration:
     auto_adjust_truncators: bool
     single_precision: bool
     parameter_selection_strategy: ParameterSelectionStrategy
+    complexity_model_location: Optional[str]
     show_progress: bool
     progress_title: str
     progress_tag: Union[bool, int]
@@ -919,6 +921,7 @@ class Configuration:
         dataflow_parallelize: bool = False,
         auto_parallelize: bool = False,
         compress_inputs: bool = False,
+        compress_outputs: bool = False,
         p_error: Optional[float] = None,
         global_p_error: Optional[float] = None,
         auto_adjust_rounders: bool = False,
@@ -927,6 +930,7 @@ class Configuration:
         parameter_selection_strategy: Union[
             ParameterSelectionStrategy, str
         ] = ParameterSelectionStrategy.MULTI,
+        complexity_model_location: Optional[Union[Path, str]] = None,
         show_progress: bool = False,
         progress_title: str = "",
         progress_tag: Union[bool, int] = False,
@@ -970,6 +974,7 @@ class Configuration:
         self.dataflow_parallelize = dataflow_parallelize
         self.auto_parallelize = auto_parallelize
         self.compress_inputs = compress_inputs
+        self.compress_outputs = compress_outputs
         self.p_error = p_error
         self.global_p_error = global_p_error
         self.auto_adjust_rounders = auto_adjust_rounders
@@ -978,6 +983,11 @@ class Configuration:
         self.parameter_selection_strategy = ParameterSelectionStrategy.parse(
             parameter_selection_strategy
         )
+        self.complexity_model_location = (
+            str(complexity_model_location)
+            if isinstance(complexity_model_location, Path)
+            else complexity_model_location
+        )
         self.show_progress = show_progress
         self.progress_title = progress_title
         self.progress_tag = progress_tag
@@ -1051,12 +1061,14 @@ class Configuration:
         dataflow_parallelize: Union[Keep, bool] = KEEP,
         auto_parallelize: Union[Keep, bool] = KEEP,
         compress_inputs: Union[Keep, bool] = KEEP,
+        compress_outputs: Union[Keep, bool] = KEEP,
         p_error: Union[Keep, Optional[float]] = KEEP,
         global_p_error: Union[Keep, Optional[float]] = KEEP,
         auto_adjust_rounders: Union[Keep, bool] = KEEP,
         auto_adjust_truncators: Union[Keep, bool] = KEEP,
         single_precision: Union[Keep, bool] = KEEP,
         parameter_selection_strategy: Union[Keep, Union[ParameterSelectionStrategy, str]] = KEEP,
+        complexity_model_location: Union[Keep, Optional[Union[Path, str]]] = KEEP,
         show_progress: Union[Keep, bool] = KEEP,
         progress_title: Union[Keep, str] = KEEP,
         progress_tag: Union[Keep, Union[bool, int]] = KEEP,
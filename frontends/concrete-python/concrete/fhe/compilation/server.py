@@ -113,6 +113,7 @@ class Server:
         options.set_dataflow_parallelize(configuration.dataflow_parallelize)
         options.set_auto_parallelize(configuration.auto_parallelize)
         options.set_compress_inputs(configuration.compress_inputs)
+        options.set_compress_outputs(configuration.compress_outputs)
 
         if configuration.auto_parallelize or configuration.dataflow_parallelize:
             # pylint: disable=c-extension-no-member,no-member
@@ -159,6 +160,10 @@ class Server:
             options.set_optimizer_strategy(OptimizerStrategy.DAG_MONO)
         elif parameter_selection_strategy == ParameterSelectionStrategy.MULTI:  # pragma: no cover
             options.set_optimizer_strategy(OptimizerStrategy.DAG_MULTI)
+
+        if configuration.complexity_model_location is not None:  # pragma: no cover
+            options.set_complexity_model_path(configuration.complexity_model_location)
+
         try:
             if configuration.compiler_debug_mode:  # pragma: no cover
                 set_llvm_debug_flag(True)
@@ -344,6 +344,11 @@ def find_single_lca(graph: Graph, nodes: List[Node]) -> Optional[Node]:
     """
     Find the single lowest common ancestor of a list of nodes.
 
+    The single common ancestors of `nodes` are the nodes every path to `nodes` goes through,
+    ignoring constants as they don't affect fusability. They are the common dominators
+    of `nodes`, so the single lowest common ancestor is their lowest common ancestor
+    in the dominator tree of the variable nodes of the graph.
+
     Args:
         graph (Graph):
             graph to search for single lca
@@ -358,36 +363,92 @@ def find_single_lca(graph: Graph, nodes: List[Node]) -> Optional[Node]:
 
     nx_graph = graph.graph
 
-    # find all ancestors of `nodes`
-    # nodes themselves need to be in this set because the single lca can be within `nodes`
-    all_ancestors = [set(list(nx.ancestors(nx_graph, node)) + [node]) for node in nodes]
+    if len(nodes) == 0:
+        # every variable node is a single common ancestor of no nodes
+        variable_nodes = [
+            node for node in nx.topological_sort(nx_graph) if node.operation != Operation.Constant
+        ]
+        return variable_nodes[-1] if len(variable_nodes) > 0 else None
 
-    # find common ancestors among `nodes`
-    # if the single lca exists, it's in this set
-    common_ancestors = {
-        node
-        for node in nx_graph.nodes()
-        if node.operation != Operation.Constant
-        and all(node in ancestors for ancestors in all_ancestors)
-    }
+    if any(node.operation == Operation.Constant for node in nodes):
+        # constants have no variable ancestors
+        return None
 
-    # iterate over every node in the graph reversed topological order
-    # this is to ensure result, if found, is the single "lowest" common ancestor
-    for candidate in reversed(list(nx.topological_sort(nx_graph))):
-        # check if node is a common ancestor of all `nodes`
-        if candidate not in common_ancestors:
-            # if not, it cannot be the single lca
-            continue
+    # only the variable ancestors of `nodes` are on their paths
+    # so the dominator tree is built on them only,
+    # with a virtual root preceding the ancestors without variable predecessors
+    ancestors = variable_ancestors(graph, nodes)
+    root = object()
+
+    dominator_graph = nx.DiGraph()
+    dominator_graph.add_node(root)
+    for node in ancestors:
+        dominator_graph.add_node(node)
+        variable_predecessors = [
+            pred for pred in nx_graph.predecessors(node) if pred.operation != Operation.Constant
+        ]
+        if len(variable_predecessors) == 0:
+            dominator_graph.add_edge(root, node)
+        for pred in variable_predecessors:
+            dominator_graph.add_edge(pred, node)
+
+    immediate_dominators = nx.immediate_dominators(dominator_graph, root)
+
+    depths = {root: 0}
+
+    def depth(node) -> int:
+        chain = []
+        while node not in depths:
+            chain.append(node)
+            node = immediate_dominators[node]
+        for dominated in reversed(chain):
+            depths[dominated] = depths[node] + 1
+            node = dominated
+        return depths[node]
+
+    lca = nodes[0]
+    for node in nodes[1:]:
+        while depth(lca) > depth(node):
+            lca = immediate_dominators[lca]
+        while depth(node) > depth(lca):
+            node = immediate_dominators[node]
+        while lca is not node:
+            lca = immediate_dominators[lca]
+            node = immediate_dominators[node]
+
+    # if the lca is the virtual root
+    # there is no single lca of this set of nodes, so return None
+    return None if lca is root else lca
 
-        # check if node is a single common ancestor of `nodes`
-        if is_single_common_ancestor(graph, candidate, nodes):
-            # if so, it's the single lca of `nodes`
-            # so return it
-            return candidate
 
-    # if none of the nodes in `common_ancestors` is the single lca
-    # there is no single lca of this set of nodes, so return None
-    return None
+def variable_ancestors(graph: Graph, nodes: Iterable[Node]) -> Dict[Node, None]:
+    """
+    Find the non-constant ancestors of a set of nodes, including the nodes themselves.
+
+    Args:
+        graph (Graph):
+            graph to traverse
+
+        nodes (Iterable[Node]):
+            nodes to find the ancestors of
+
+    Returns:
+        Dict[Node, None]:
+            ancestors of `nodes`
+    """
+
+    nx_graph = graph.graph
+
+    ancestors = {node: None for node in nodes}
+    worklist = list(ancestors)
+    while worklist:
+        node = worklist.pop()
+        for pred in nx_graph.predecessors(node):
+            if pred.operation != Operation.Constant and pred not in ancestors:
+                ancestors[pred] = None
+                worklist.append(pred)
+
+    return ancestors
 
 
 def is_single_common_ancestor(
@@ -417,41 +478,40 @@ def is_single_common_ancestor(
 
     nx_graph = graph.graph
 
-    # create a subgraph with `candidate` node
-    subgraph = nx.DiGraph()
-    subgraph.add_node(candidate)
-
-    # iterate over `nodes` to add them to the subgraph
-    # along with every path from `candidate` to them
-    for node in nodes:
-        subgraph.add_node(node)
-        for path in nx.all_simple_paths(nx_graph, source=candidate, target=node):
-            nx.add_path(subgraph, path)
-
-    # iterate over the nodes of the subgraph
-    for node in subgraph.nodes():
+    # find the nodes on the paths from `candidate` to `nodes`
+    # i.e., the ancestors of `nodes` reachable from `candidate`
+    ancestors = variable_ancestors(graph, nodes)
+    ancestors[candidate] = None
+
+    on_paths = {candidate: None}
+    worklist = [candidate]
+    while worklist:
+        node = worklist.pop()
+        for succ in nx_graph.successors(node):
+            if succ in ancestors and succ not in on_paths:
+                on_paths[succ] = None
+                worklist.append(succ)
+
+    # iterate over the nodes on the paths and `nodes`
+    for node in list(on_paths) + nodes:
         # the condition below doesn't apply to `candidate`
-        # as its predecessors are not in the subgraph
+        # as its predecessors are not on the paths
         if node == candidate:
             continue
 
-        # find number of predecessors in the subgraph and in the original graph
-        # except constant nodes in the original graph as
-        #   - they are not in the subgraph
-        #   - they don't affect fusability status
-        predecessor_count_in_subgraph = len(list(subgraph.predecessors(node)))
-        predecessor_count_in_nx_graph = len(
-            [pred for pred in nx_graph.predecessors(node) if pred.operation != Operation.Constant]
-        )
-
-        # see if number of predecessors are different
-        if predecessor_count_in_subgraph != predecessor_count_in_nx_graph:
-            # if so, `candidate` cannot be a single common ancestor
+        # see if every variable predecessor is on the paths
+        # constant predecessors are not on the paths but they don't affect fusability status
+        # `nodes` which are not reachable from `candidate` need to have no variable predecessor
+        variable_predecessors = [
+            pred for pred in nx_graph.predecessors(node) if pred.operation != Operation.Constant
+        ]
+        if any(pred not in on_paths for pred in variable_predecessors):
+            # if not, `candidate` cannot be a single common ancestor
             # reasoning for is explained below
             return False
 
-    # if every node in the subgraph has the same number of predecessors
-    # as in the original graph `candidate` is in fact a single common ancestor
+    # if every variable predecessor of the nodes on the paths is on the paths
+    # `candidate` is in fact a single common ancestor
     return True
 
     # Here is why this function works.
@@ -478,7 +538,7 @@ def is_single_common_ancestor(
     # So we want to know if multiplication node is a single common ancestor of
     # multiplication and addition nodes. The result is no in this case for our purposes.
     #
-    # Once you apply the subgraph creation above, you'll get the following graph:
+    # Once you only keep the nodes on the paths from the candidate, you'll get the following graph:
     #
     # (*)
     #  |
@@ -503,7 +563,7 @@ def is_single_common_ancestor(
     # So we want to know if the input node 'x' is the single common ancestor of
     # multiplication and addition nodes. The result is yes in this case.
     #
-    # Once you apply the subgraph creation above, you'll get the following graph:
+    # Once you only keep the nodes on the paths from the candidate, you'll get the following graph:
     #
     #     {x}
     #    /   \
@@ -989,3 +989,32 @@ def test_dynamic_indexing_hack(helpers):
     helpers.check_execution(circuit, function, [sample, 1], retries=3)
     helpers.check_execution(circuit, function, [sample, 2], retries=3)
     helpers.check_execution(circuit, function, [sample, 3], retries=3)
+
+
+def test_others_large_fusion(helpers):
+    """
+    Test fusing a large subgraph with many paths between its input and output.
+    """
+
+    configuration = helpers.configuration()
+
+    def function(x):
+        # each block doubles the number of paths from `x` to the output
+        y = x + 0.5
+        for _ in range(100):
+            y = np.sin(y) + np.cos(y)
+        return (y * 10).astype(np.int64)
+
+    compiler = fhe.Compiler(function, {"x": "encrypted"})
+    circuit = compiler.compile(range(10), configuration)
+
+    subgraphs = [
+        node
+        for node in circuit.graph.graph.nodes()
+        if node.operation == fhe.representation.Operation.Generic
+        and "subgraph" in node.properties["kwargs"]
+    ]
+    assert len(subgraphs) == 1
+
+    sample = np.random.randint(0, 10)
+    helpers.check_execution(circuit, function, sample, retries=3)